@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <iostream>
 #include <vector>
+#include <unordered_map>
 #include <iomanip>
 #include <string>
 #include <sstream>
@@ -92,7 +93,7 @@ cmd_line::cmd_line(void (*notification_callback)(void *, int32_t, uint64_t, uint
                    void (*acmp_notification_callback)(void *, int32_t, uint16_t, uint64_t, uint16_t, uint64_t, uint16_t,
                                                       uint32_t, void *),
                    void (*log_callback)(void *, int32_t, const char *, int32_t),
-                   bool test_mode, char * interface, int32_t log_level)
+                   bool test_mode, char * interface, int32_t log_level, uint32_t rx_worker_count)
     : test_mode(test_mode), output_redirected(false)
 {
     cout_buf = std::cout.rdbuf();
@@ -112,6 +113,8 @@ cmd_line::cmd_line(void (*notification_callback)(void *, int32_t, uint64_t, uint
     sys = avdecc_lib::create_system(avdecc_lib::system::LAYER2_MULTITHREADED_CALLBACK, netif, controller_obj);
     atomic_cout << "AVDECC Controller version: " << controller_obj->get_version() << std::endl;
     print_interfaces_and_select(interface);
+    if (rx_worker_count)
+        sys->set_rx_worker_count(rx_worker_count);
     sys->process_start();
 }
 
@@ -2024,51 +2027,6 @@ int cmd_line::do_view_descriptor(std::string desc_name, uint16_t desc_index)
     avdecc_lib::configuration_descriptor * configuration;
     get_current_entity_and_descriptor(end_station, &entity, &configuration);
 
-    // test field output
-    if (desc_type_value == avdecc_lib::AEM_DESC_EXTERNAL_PORT_INPUT)
-    {
-        avdecc_lib::descriptor_base * desc = configuration->get_external_port_input_desc_by_index(desc_index)->get_external_port_input_response();
-        uint32_t v = 0;
-
-        for (unsigned int i = 0; i < desc->field_count(); i++)
-        {
-            avdecc_lib::descriptor_field * f = desc->field(i);
-            switch (f->get_type())
-            {
-            case avdecc_lib::descriptor_field::TYPE_CHAR:
-                atomic_cout << "\n"
-                            << f->get_name() << " = " << f->get_char();
-                break;
-            case avdecc_lib::descriptor_field::TYPE_UINT16:
-                atomic_cout << "\n"
-                            << f->get_name() << " = " << f->get_uint16();
-                break;
-            case avdecc_lib::descriptor_field::TYPE_UINT32:
-                atomic_cout << "\n"
-                            << f->get_name() << " = " << f->get_uint32();
-                break;
-            // Don't have to handle these separately here, but internal to the library they have different types.
-            case avdecc_lib::descriptor_field::TYPE_FLAGS16:
-            case avdecc_lib::descriptor_field::TYPE_FLAGS32:
-                v = f->get_flags();
-                atomic_cout << "\nFlags " << f->get_name() << " = 0x" << std::setfill('0') << std::setw(8) << std::hex << v;
-                for (unsigned int j = 0; j < f->get_flags_count(); j++)
-                {
-                    uint32_t the_bit;
-                    avdecc_lib::descriptor_field_flags * fl = f->get_flag_by_index(j);
-
-                    the_bit = ((v & fl->get_flag_mask()) != 0);
-                    atomic_cout << "\n\t" << std::setw(32) << fl->get_flag_name() << " = " << the_bit << " (mask is 0x" << std::setfill('0') << std::setw(8) << std::hex << fl->get_flag_mask() << ")";
-                }
-                break;
-            default:
-                atomic_cout << "\nUNHANDLED FIELD TYPE";
-            }
-        }
-        delete desc;
-        return 0;
-    }
-
     switch (desc_type_value)
     {
     case avdecc_lib::AEM_DESC_ENTITY:
@@ -2577,15 +2535,7 @@ int cmd_line::do_view_descriptor(std::string desc_name, uint16_t desc_index)
         if (desc)
         {
             avdecc_lib::external_port_input_descriptor_response * external_port_input_resp_ref = desc->get_external_port_input_response();
-            atomic_cout << "\nport_flags = " << std::hex << external_port_input_resp_ref->port_flags();
-            atomic_cout << "\nclock_domain_index = " << std::dec << external_port_input_resp_ref->clock_domain_index();
-            atomic_cout << "\nnumber_of_controls = " << std::dec << external_port_input_resp_ref->number_of_controls();
-            atomic_cout << "\nbase_control = " << std::dec << external_port_input_resp_ref->base_control();
-            atomic_cout << "\nsignal_type = " << std::dec << external_port_input_resp_ref->signal_type();
-            atomic_cout << "\nsignal_index = " << std::dec << external_port_input_resp_ref->signal_index();
-            atomic_cout << "\nsignal_output = " << std::dec << external_port_input_resp_ref->signal_output();
-            atomic_cout << "\nblock_latency = " << std::dec << external_port_input_resp_ref->block_latency();
-            atomic_cout << "\njack_index = " << std::dec << external_port_input_resp_ref->jack_index();
+            print_descriptor_fields(external_port_input_resp_ref);
             delete (external_port_input_resp_ref);
         }
     }
@@ -2600,15 +2550,7 @@ int cmd_line::do_view_descriptor(std::string desc_name, uint16_t desc_index)
         if (desc)
         {
             avdecc_lib::external_port_output_descriptor_response * external_port_output_resp_ref = desc->get_external_port_output_response();
-            atomic_cout << "\nport_flags = " << std::hex << external_port_output_resp_ref->port_flags();
-            atomic_cout << "\nclock_domain_index = " << std::dec << external_port_output_resp_ref->clock_domain_index();
-            atomic_cout << "\nnumber_of_controls = " << std::dec << external_port_output_resp_ref->number_of_controls();
-            atomic_cout << "\nbase_control = " << std::dec << external_port_output_resp_ref->base_control();
-            atomic_cout << "\nsignal_type = " << std::dec << external_port_output_resp_ref->signal_type();
-            atomic_cout << "\nsignal_index = " << std::dec << external_port_output_resp_ref->signal_index();
-            atomic_cout << "\nsignal_output = " << std::dec << external_port_output_resp_ref->signal_output();
-            atomic_cout << "\nblock_latency = " << std::dec << external_port_output_resp_ref->block_latency();
-            atomic_cout << "\njack_index = " << std::dec << external_port_output_resp_ref->jack_index();
+            print_descriptor_fields(external_port_output_resp_ref);
             delete (external_port_output_resp_ref);
         }
     }
@@ -2650,6 +2592,45 @@ int cmd_line::do_view_descriptor(std::string desc_name, uint16_t desc_index)
     return 0;
 }
 
+void cmd_line::print_descriptor_fields(avdecc_lib::descriptor_base * desc)
+{
+    for (size_t i = 0; i < desc->field_count(); i++)
+    {
+        avdecc_lib::descriptor_field * f = desc->field(i);
+        uint32_t v;
+
+        switch (f->get_type())
+        {
+        case avdecc_lib::descriptor_field::TYPE_CHAR:
+            atomic_cout << "\n"
+                        << f->get_name() << " = " << f->get_char();
+            break;
+        case avdecc_lib::descriptor_field::TYPE_UINT16:
+            atomic_cout << "\n"
+                        << f->get_name() << " = " << std::dec << f->get_uint16();
+            break;
+        case avdecc_lib::descriptor_field::TYPE_UINT32:
+            atomic_cout << "\n"
+                        << f->get_name() << " = " << std::dec << f->get_uint32();
+            break;
+        // Don't have to handle these separately here, but internal to the library they have different types.
+        case avdecc_lib::descriptor_field::TYPE_FLAGS16:
+        case avdecc_lib::descriptor_field::TYPE_FLAGS32:
+            v = f->get_flags();
+            atomic_cout << "\n"
+                        << f->get_name() << " = 0x" << std::setfill('0') << std::setw(4) << std::hex << v;
+            for (uint32_t j = 0; j < f->get_flags_count(); j++)
+            {
+                avdecc_lib::descriptor_field_flags * fl = f->get_flag_by_index(j);
+                atomic_cout << "\n\t" << fl->get_flag_name() << " = " << std::dec << ((v & fl->get_flag_mask()) != 0);
+            }
+            break;
+        default:
+            atomic_cout << "\nUNHANDLED FIELD TYPE";
+        }
+    }
+}
+
 int cmd_line::cmd_read_descriptor(int total_matched, std::vector<cli_argument *> args)
 {
     std::string desc_name = args[0]->get_value_str();
@@ -3073,6 +3054,38 @@ int cmd_line::cmd_show_connections(int total_matched, std::vector<cli_argument *
         }
     }
 
+    // Index the connected stream outputs by stream id, so every stream input is matched without
+    // walking all the stream outputs again.
+    struct connected_output
+    {
+        uint64_t entity_id;
+        uint32_t stream_index;
+    };
+    std::unordered_map<uint64_t, std::vector<connected_output>> outputs_by_stream_id;
+    avdecc_lib::stream_output_get_tx_state_view tx_state;
+
+    for (uint32_t out_index = 0; out_index < controller_obj->get_end_station_count(); out_index++)
+    {
+        avdecc_lib::end_station * out_end_station = controller_obj->get_end_station_by_index(out_index);
+        avdecc_lib::entity_descriptor * out_entity;
+        avdecc_lib::configuration_descriptor * out_descriptor;
+        if (get_current_entity_and_descriptor(out_end_station, &out_entity, &out_descriptor))
+            continue;
+
+        size_t stream_output_desc_count = out_descriptor->stream_output_desc_count();
+        for (uint32_t out_stream_index = 0; out_stream_index < stream_output_desc_count; out_stream_index++)
+        {
+            avdecc_lib::stream_output_descriptor * outstream = out_descriptor->get_stream_output_desc_by_index(out_stream_index);
+            if (!outstream->get_tx_state_view(tx_state) || !tx_state.get_tx_state_connection_count())
+                continue;
+
+            connected_output output = {out_end_station->entity_id(), out_stream_index};
+            outputs_by_stream_id[tx_state.get_tx_state_stream_id()].push_back(output);
+        }
+    }
+
+    avdecc_lib::stream_input_get_rx_state_view rx_state;
+
     for (uint32_t in_index = 0; in_index < controller_obj->get_end_station_count(); in_index++)
     {
         avdecc_lib::end_station * in_end_station = controller_obj->get_end_station_by_index(in_index);
@@ -3085,45 +3098,20 @@ int cmd_line::cmd_show_connections(int total_matched, std::vector<cli_argument *
         for (uint32_t in_stream_index = 0; in_stream_index < stream_input_desc_count; in_stream_index++)
         {
             avdecc_lib::stream_input_descriptor * instream = in_descriptor->get_stream_input_desc_by_index(in_stream_index);
-            avdecc_lib::stream_input_get_rx_state_response * stream_input_resp_ref = instream->get_stream_input_get_rx_state_response();
-            if (!stream_input_resp_ref->get_rx_state_connection_count())
-            {
-                delete stream_input_resp_ref;
+            if (!instream->get_rx_state_view(rx_state) || !rx_state.get_rx_state_connection_count())
                 continue;
-            }
-            delete stream_input_resp_ref;
-
-            for (uint32_t out_index = 0; out_index < controller_obj->get_end_station_count(); out_index++)
-            {
-                avdecc_lib::end_station * out_end_station = controller_obj->get_end_station_by_index(out_index);
-                avdecc_lib::entity_descriptor * out_entity;
-                avdecc_lib::configuration_descriptor * out_descriptor;
-                if (get_current_entity_and_descriptor(out_end_station, &out_entity, &out_descriptor))
-                    continue;
-
-                size_t stream_output_desc_count = out_descriptor->stream_output_desc_count();
-                for (uint32_t out_stream_index = 0; out_stream_index < stream_output_desc_count; out_stream_index++)
-                {
-                    avdecc_lib::stream_input_get_rx_state_response * stream_input_resp_ref = instream->get_stream_input_get_rx_state_response();
-                    avdecc_lib::stream_output_descriptor * outstream = out_descriptor->get_stream_output_desc_by_index(out_stream_index);
-                    avdecc_lib::stream_output_get_tx_state_response * stream_output_resp_ref = outstream->get_stream_output_get_tx_state_response();
-                    if (!stream_output_resp_ref->get_tx_state_connection_count() ||
-                        (stream_input_resp_ref->get_rx_state_stream_id() != stream_output_resp_ref->get_tx_state_stream_id()))
-                    {
-                        delete stream_input_resp_ref;
-                        delete stream_output_resp_ref;
-
-                        continue;
-                    }
 
-                    atomic_cout << "0x" << std::setw(16) << std::hex << std::setfill('0') << out_end_station->entity_id()
-                                << "[" << out_stream_index << "] -> "
-                                << "0x" << std::setw(16) << std::hex << std::setfill('0') << in_end_station->entity_id()
-                                << "[" << in_stream_index << "]" << std::endl;
+            std::unordered_map<uint64_t, std::vector<connected_output>>::const_iterator outputs =
+                outputs_by_stream_id.find(rx_state.get_rx_state_stream_id());
+            if (outputs == outputs_by_stream_id.end())
+                continue;
 
-                    delete stream_input_resp_ref;
-                    delete stream_output_resp_ref;
-                }
+            for (std::vector<connected_output>::const_iterator it = outputs->second.begin(); it != outputs->second.end(); ++it)
+            {
+                atomic_cout << "0x" << std::setw(16) << std::hex << std::setfill('0') << it->entity_id
+                            << "[" << it->stream_index << "] -> "
+                            << "0x" << std::setw(16) << std::hex << std::setfill('0') << in_end_station->entity_id()
+                            << "[" << in_stream_index << "]" << std::endl;
             }
         }
     }
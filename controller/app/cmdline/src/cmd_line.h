@@ -97,7 +97,7 @@ public:
     cmd_line(void (*notification_callback)(void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *),
              void (*acmp_notification_callback)(void *, int32_t, uint16_t, uint64_t, uint16_t, uint64_t, uint16_t, uint32_t, void *),
              void (*log_callback)(void *, int32_t, const char *, int32_t),
-             bool test_mode, char * interface, int32_t log_level);
+             bool test_mode, char * interface, int32_t log_level, uint32_t rx_worker_count = 0);
 
     ~cmd_line();
 
@@ -220,6 +220,11 @@ private:
 
     int do_view_descriptor(std::string desc_name, uint16_t desc_index);
 
+    ///
+    /// Display every field of a descriptor through the descriptor field interface.
+    ///
+    void print_descriptor_fields(avdecc_lib::descriptor_base * desc);
+
     ///
     /// Display all the available instreams for all End Stations.
     ///
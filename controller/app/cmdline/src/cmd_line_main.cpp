@@ -287,6 +287,7 @@ static void usage(char * argv[])
                     Valid options are IP Address and MAC Address (must be in the form 'n:n:n:n:n:n', where 0<=n<=FF in hexidecimal" << std::endl;
     std::cerr << "  -l log_level :  Sets the log level to use." << std::endl;
     std::cerr << log_level_help << std::endl;
+    std::cerr << "  -w workers   :  Sets the number of threads processing received frames." << std::endl;
     exit(1);
 }
 
@@ -298,8 +299,9 @@ int main(int argc, char * argv[])
     char * interface = NULL;
     int c = 0;
     int32_t log_level = avdecc_lib::LOGGING_LEVEL_ERROR;
+    uint32_t rx_worker_count = 0;
 
-    while ((c = getopt(argc, argv, "spti:l:")) != -1)
+    while ((c = getopt(argc, argv, "spti:l:w:")) != -1)
     {
         switch (c)
         {
@@ -319,6 +321,9 @@ int main(int argc, char * argv[])
         case 'l':
             log_level = atoi(optarg);
             break;
+        case 'w':
+            rx_worker_count = (uint32_t)atoi(optarg);
+            break;
         case ':':
             fprintf(stderr, "Option -%c requires an operand\n", optopt);
             error++;
@@ -347,7 +352,7 @@ int main(int argc, char * argv[])
     }
 
     cmd_line avdecc_cmd_line_ref(notification_callback, acmp_notification_callback, log_callback,
-                                 test_mode, interface, log_level);
+                                 test_mode, interface, log_level, rx_worker_count);
 
     std::vector<std::string> input_argv;
     size_t pos = 0;
@@ -0,0 +1,184 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_adp_expiry_test.cpp
+ *
+ * Checks that every ADP entity whose valid time has expired departs in one tick of the ADP
+ * discovery state machine, and that their END_STATION_DISCONNECTED notifications take one entry of
+ * the notification buffer. More entities depart than the buffer holds, while the notification
+ * callback is held up by another notification.
+ *
+ * The first tick sends ENTITY_DISCOVER on the loopback interface. Needs the privileges to open
+ * it, and is skipped without them.
+ *
+ * Usage: test_adp_expiry
+ */
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include "test_fixture.h"
+#include "adp_discovery_state_machine.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+static const uint64_t base_entity_id = UINT64_C(0x001b92fffe000000);
+static const uint64_t entity_model_id = UINT64_C(0x001b92fffe000200);
+static const uint32_t entity_count = 100;                  // More than the notification buffer holds
+static const uint64_t gate_entity_id = base_entity_id + 0xffff; // Announced with the longest valid time
+
+static std::mutex notification_locker;
+static std::condition_variable notification_cv;
+static uint32_t connected = 0;
+static std::set<uint64_t> disconnected;
+static uint32_t disconnected_callbacks = 0;
+static bool gate_open = true;
+
+static void expiry_notification_callback(void *, int32_t notification_type, uint64_t entity_id, uint16_t, uint16_t, uint16_t, uint32_t, void *)
+{
+    std::unique_lock<std::mutex> lock(notification_locker);
+
+    // The notification of the gate entity holds up the notification thread until the gate opens
+    if (notification_type == avdecc_lib::END_STATION_CONNECTED && entity_id == gate_entity_id)
+        notification_cv.wait(lock, [] { return gate_open; });
+
+    if (notification_type == avdecc_lib::END_STATION_CONNECTED)
+        connected++;
+    else if (notification_type == avdecc_lib::END_STATION_DISCONNECTED)
+    {
+        disconnected.insert(entity_id);
+        disconnected_callbacks++;
+    }
+    notification_cv.notify_all();
+}
+
+static void announce(uint64_t entity_id, uint32_t valid_time)
+{
+    std::vector<uint8_t> frame = make_adp_frame(entity_id, entity_model_id, NULL);
+    uint8_t * pdu = &frame[avdecc_lib::ETHER_HDR_SIZE];
+    jdksavdecc_uint16_set((uint16_t)(valid_time << 11 | (jdksavdecc_uint16_get(pdu, 2) & 0x7ff)), pdu, 2);
+    avdecc_lib::adp_discovery_state_machine_ref->state_avail(frame.data(), frame.size());
+}
+
+static bool wait_notifications(uint32_t connected_count, uint32_t disconnected_count)
+{
+    std::unique_lock<std::mutex> lock(notification_locker);
+    return notification_cv.wait_for(lock, std::chrono::seconds(5), [=] {
+        return connected == connected_count && disconnected_callbacks == disconnected_count;
+    });
+}
+
+static void test_expiry(avdecc_lib::controller * controller)
+{
+    uint64_t start_ms = avdecc_lib::timer::clk_monotonic_ms();
+
+    // The entities are announced with a valid time of 10 seconds, so they expire after 20
+    for (uint32_t i = 1; i <= entity_count; i++)
+    {
+        announce(base_entity_id + i, 10);
+        if (i % 16 == 0)
+            CHECK(wait_notifications(i, 0));
+    }
+    CHECK(wait_notifications(entity_count, 0));
+
+    // Announcing an entity again only extends its valid time
+    announce(base_entity_id + 1, 10);
+    CHECK(avdecc_lib::adp_discovery_state_machine_ref->tick(start_ms + 1000).empty());
+    CHECK(wait_notifications(entity_count, 0));
+
+    {
+        std::lock_guard<std::mutex> guard(notification_locker);
+        gate_open = false;
+    }
+    announce(gate_entity_id, 31);
+
+    const std::vector<uint64_t> & departed = avdecc_lib::adp_discovery_state_machine_ref->tick(start_ms + 30000);
+    CHECK(departed.size() == entity_count);
+    std::set<uint64_t> departed_ids(departed.begin(), departed.end());
+    CHECK(departed_ids.size() == entity_count);
+    CHECK(departed_ids.count(base_entity_id + 1) == 1);
+    CHECK(departed_ids.count(base_entity_id + entity_count) == 1);
+    CHECK(departed_ids.count(gate_entity_id) == 0);
+
+    // The departures were posted while the notification callback was held up, without a missed notification
+    CHECK(controller->missed_notification_count() == 0);
+    {
+        std::lock_guard<std::mutex> guard(notification_locker);
+        CHECK(disconnected_callbacks == 0);
+        gate_open = true;
+    }
+    notification_cv.notify_all();
+
+    // The application is still notified once for every departed entity
+    CHECK(wait_notifications(entity_count + 1, entity_count));
+    {
+        std::lock_guard<std::mutex> guard(notification_locker);
+        CHECK(disconnected == departed_ids);
+    }
+
+    // Only the gate entity is left
+    uint64_t deadline_ms = 0;
+    CHECK(avdecc_lib::adp_discovery_state_machine_ref->next_deadline(deadline_ms));
+    CHECK(deadline_ms > start_ms + 30000);
+    CHECK(avdecc_lib::adp_discovery_state_machine_ref->tick(start_ms + 30000).empty());
+
+    // A departed entity announced again connects again
+    announce(base_entity_id + 1, 10);
+    CHECK(wait_notifications(entity_count + 2, entity_count));
+}
+
+int main()
+{
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    uint32_t interface_num = loopback_interface_num(netif);
+    if (!interface_num || netif->select_interface_by_num(interface_num) != 0)
+    {
+        std::cout << "skipped, the loopback interface cannot be opened" << std::endl;
+        netif->destroy();
+        return 77;
+    }
+
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, expiry_notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+
+    test_expiry(controller);
+
+    controller->destroy();
+    netif->destroy();
+
+    std::cout << (failures ? "FAILED" : "passed") << std::endl;
+    return failures ? 1 : 0;
+}
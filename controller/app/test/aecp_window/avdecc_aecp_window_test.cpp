@@ -0,0 +1,212 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_aecp_window_test.cpp
+ *
+ * Checks that the AECP controller state machine queues the commands to an End Station whose
+ * window is full, and sends the first queued command as soon as a command completes or times out.
+ * The commands are sent on the loopback interface, where nothing answers them, and the test hands
+ * the responses to the state machine itself.
+ *
+ * Needs the privileges to open the loopback interface, and is skipped without them.
+ *
+ * Usage: test_aecp_window
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include "test_fixture.h"
+#include "aecp_controller_state_machine.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+static const uint64_t entity_id = UINT64_C(0x001b92fffe000001);
+static const uint64_t entity_mac = UINT64_C(0x001b92000001);
+
+static char cmd_a;
+static char cmd_b;
+static char cmd_c;
+
+// Send ENTITY_AVAILABLE, as end_station_imp does once the command leaves the transmit queue
+static uint16_t send_cmd(void * notification_id)
+{
+    struct jdksavdecc_frame cmd_frame;
+    struct jdksavdecc_aem_command_entity_available aem_cmd;
+    memset(&aem_cmd, 0, sizeof(aem_cmd));
+    aem_cmd.aem_header.command_type = JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE;
+
+    avdecc_lib::aecp_controller_state_machine_ref->ether_frame_init(entity_mac, &cmd_frame,
+                                                                    avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE_COMMAND_LEN);
+    jdksavdecc_aem_command_entity_available_write(&aem_cmd, cmd_frame.payload, avdecc_lib::ETHER_HDR_SIZE, sizeof(cmd_frame.payload));
+    avdecc_lib::aecp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND, &cmd_frame, entity_id,
+                                                                   JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE_COMMAND_LEN -
+                                                                       JDKSAVDECC_COMMON_CONTROL_HEADER_LEN);
+    avdecc_lib::aecp_controller_state_machine_ref->state_send_cmd(notification_id, avdecc_lib::CMD_WITH_NOTIFICATION, &cmd_frame);
+
+    // The sequence id is only written to the frame of a command sent at once
+    return jdksavdecc_aecpdu_common_get_sequence_id(cmd_frame.payload, avdecc_lib::ETHER_HDR_SIZE);
+}
+
+// Hand the state machine the response of the End Station to the command with seq_id
+static void rcvd_resp(uint16_t seq_id, uint32_t status)
+{
+    std::vector<uint8_t> resp = make_aem_resp(entity_id, JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE,
+                                              JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE_RESPONSE_LEN);
+    uint8_t * pdu = &resp[avdecc_lib::ETHER_HDR_SIZE];
+    jdksavdecc_uint16_set((uint16_t)(status << 11 | jdksavdecc_uint16_get(pdu, 2)), pdu, 2);
+    jdksavdecc_aecpdu_common_set_sequence_id(seq_id, resp.data(), avdecc_lib::ETHER_HDR_SIZE);
+
+    struct jdksavdecc_frame frame;
+    memcpy(frame.payload, resp.data(), resp.size());
+    frame.length = (uint16_t)resp.size();
+
+    void * notification_id = NULL;
+    avdecc_lib::aecp_controller_state_machine_ref->update_inflight_for_rcvd_resp(notification_id, JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE,
+                                                                                 false, &frame);
+}
+
+static uint32_t occupancy()
+{
+    return avdecc_lib::aecp_controller_state_machine_ref->get_window_occupancy(entity_id);
+}
+
+static uint32_t queue_depth()
+{
+    return avdecc_lib::aecp_controller_state_machine_ref->get_queue_depth(entity_id);
+}
+
+static bool is_inflight(void * notification_id)
+{
+    return avdecc_lib::aecp_controller_state_machine_ref->is_inflight_cmd_with_notification_id(notification_id);
+}
+
+static void test_response()
+{
+    avdecc_lib::aecp_controller_state_machine_ref->set_window(entity_id, 2);
+
+    uint16_t seq_a = send_cmd(&cmd_a);
+    uint16_t seq_b = send_cmd(&cmd_b);
+    send_cmd(&cmd_c);
+    uint16_t seq_c = (uint16_t)(seq_b + 1);
+    CHECK(seq_b == (uint16_t)(seq_a + 1));
+    CHECK(occupancy() == 2);
+    CHECK(queue_depth() == 1);
+    CHECK(is_inflight(&cmd_c));
+
+    // A command still in progress keeps its slot
+    rcvd_resp(seq_a, avdecc_lib::AEM_STATUS_IN_PROGRESS);
+    CHECK(occupancy() == 2);
+    CHECK(queue_depth() == 1);
+
+    // The queued command takes the slot of the command that completes
+    rcvd_resp(seq_b, avdecc_lib::AEM_STATUS_SUCCESS);
+    CHECK(!is_inflight(&cmd_b));
+    CHECK(is_inflight(&cmd_c));
+    CHECK(occupancy() == 2);
+    CHECK(queue_depth() == 0);
+
+    // A response to no inflight command frees no slot
+    rcvd_resp(seq_b, avdecc_lib::AEM_STATUS_SUCCESS);
+    CHECK(occupancy() == 2);
+
+    rcvd_resp(seq_c, avdecc_lib::AEM_STATUS_SUCCESS);
+    CHECK(!is_inflight(&cmd_c));
+    CHECK(occupancy() == 1);
+    rcvd_resp(seq_a, avdecc_lib::AEM_STATUS_SUCCESS);
+    CHECK(!is_inflight(&cmd_a));
+    CHECK(occupancy() == 0);
+}
+
+static void test_timeout()
+{
+    avdecc_lib::aecp_controller_state_machine_ref->set_window(entity_id, 1);
+
+    uint16_t seq_a = send_cmd(&cmd_a);
+    send_cmd(&cmd_b);
+    CHECK(occupancy() == 1);
+    CHECK(queue_depth() == 1);
+
+    // The queued command is sent once every retry of the command ahead of it has timed out. The
+    // timeouts are measured from the monotonic clock, so the ticks wait for them to expire.
+    std::vector<void *> timed_out;
+    uint64_t deadline_ms;
+    while (timed_out.empty() && avdecc_lib::aecp_controller_state_machine_ref->next_deadline(deadline_ms))
+    {
+        CHECK(queue_depth() == 1);
+        while (avdecc_lib::timer::clk_monotonic_ms() < deadline_ms)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        avdecc_lib::aecp_controller_state_machine_ref->tick(avdecc_lib::timer::clk_monotonic_ms(), timed_out);
+        CHECK(occupancy() == 1);
+    }
+    CHECK(timed_out.size() == 1 && timed_out[0] == &cmd_a);
+    CHECK(!is_inflight(&cmd_a));
+    CHECK(is_inflight(&cmd_b));
+    CHECK(queue_depth() == 0);
+
+    uint32_t avg_ms = 0;
+    uint32_t max_ms = 0;
+    avdecc_lib::aecp_controller_state_machine_ref->get_queue_wait_ms(entity_id, avg_ms, max_ms);
+    CHECK(max_ms >= avdecc_lib::AVDECC_MSG_TIMEOUT_MS);
+
+    rcvd_resp((uint16_t)(seq_a + 1), avdecc_lib::AEM_STATUS_SUCCESS);
+    CHECK(!is_inflight(&cmd_b));
+    CHECK(occupancy() == 0);
+}
+
+int main()
+{
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    uint32_t interface_num = loopback_interface_num(netif);
+    if (!interface_num || netif->select_interface_by_num(interface_num) != 0)
+    {
+        std::cout << "skipped, the loopback interface cannot be opened" << std::endl;
+        netif->destroy();
+        return 77;
+    }
+
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+
+    test_response();
+    test_timeout();
+
+    controller->destroy();
+    netif->destroy();
+
+    std::cout << (failures ? "FAILED" : "passed") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_aem_dispatch_main.cpp
+ *
+ * Measures the processing rate of the AEM responses a controller monitoring a 32 channel stage
+ * box receives. The lookup of the handler and the descriptor through aem_resp_dispatch and
+ * configuration_descriptor_imp::lookup_slot() is measured alone, and with the responses processed
+ * by end_station_imp::proc_rcvd_aem_resp(). The responses are unsolicited, so they are processed
+ * in full without a command in flight. The End Station is added by an ADP frame passed to
+ * controller_imp::rx_packet_event(), and populated from a descriptor cache file written to
+ * cache_dir.
+ *
+ * Usage: bench_aem_dispatch [responses] [cache_dir]
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "end_station_imp.h"
+#include "configuration_descriptor_imp.h"
+#include "aem_resp_dispatch.h"
+#include "test_fixture.h"
+
+static const uint64_t entity_id = UINT64_C(0x001b92fffe000001);
+static const uint64_t entity_model_id = UINT64_C(0x001b92fffe000100);
+
+struct bench_resp
+{
+    uint16_t cmd_type;
+    uint16_t desc_type;
+    uint16_t desc_count;
+    uint16_t len;         // Length of the AECPDU
+    uint16_t desc_offset; // Offset of the descriptor type and index in the AECPDU
+};
+
+// The responses a controller monitoring the stage box receives
+static const bench_resp resp_mix[] = {
+    {avdecc_lib::AEM_CMD_GET_COUNTERS, avdecc_lib::AEM_DESC_STREAM_INPUT, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_COUNTERS, avdecc_lib::AEM_DESC_AVB_INTERFACE, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_COUNTERS, avdecc_lib::AEM_DESC_ENTITY, 1,
+     JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_STREAM_INFO, avdecc_lib::AEM_DESC_STREAM_INPUT, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_STREAM_INFO, avdecc_lib::AEM_DESC_STREAM_OUTPUT, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_STREAM_FORMAT, avdecc_lib::AEM_DESC_STREAM_INPUT, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_STREAM_FORMAT, avdecc_lib::AEM_DESC_STREAM_OUTPUT, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_AUDIO_MAP, avdecc_lib::AEM_DESC_STREAM_PORT_INPUT, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_AUDIO_MAP, avdecc_lib::AEM_DESC_STREAM_PORT_OUTPUT, 2,
+     JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_SAMPLING_RATE, avdecc_lib::AEM_DESC_AUDIO_UNIT, 1,
+     JDKSAVDECC_AEM_COMMAND_GET_SAMPLING_RATE_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_SAMPLING_RATE_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_GET_NAME, avdecc_lib::AEM_DESC_JACK_INPUT, 32,
+     JDKSAVDECC_AEM_COMMAND_GET_NAME_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_GET_NAME_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+    {avdecc_lib::AEM_CMD_ACQUIRE_ENTITY, avdecc_lib::AEM_DESC_ENTITY, 1,
+     JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY_RESPONSE_LEN, JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY_RESPONSE_OFFSET_DESCRIPTOR_TYPE},
+};
+
+static std::vector<std::vector<uint8_t>> make_resp_frames()
+{
+    std::vector<std::vector<uint8_t>> frames;
+
+    for (size_t r = 0; r < sizeof(resp_mix) / sizeof(resp_mix[0]); r++)
+    {
+        for (uint16_t i = 0; i < resp_mix[r].desc_count; i++)
+        {
+            // Unsolicited, as sent to a controller registered for unsolicited notifications
+            std::vector<uint8_t> frame = make_aem_resp(entity_id, resp_mix[r].cmd_type | 0x8000, resp_mix[r].len);
+            jdksavdecc_uint16_set(resp_mix[r].desc_type, frame.data(), avdecc_lib::ETHER_HDR_SIZE + resp_mix[r].desc_offset);
+            jdksavdecc_uint16_set(i, frame.data(), avdecc_lib::ETHER_HDR_SIZE + resp_mix[r].desc_offset + 2);
+            frames.push_back(frame);
+        }
+    }
+
+    return frames;
+}
+
+///
+/// The handler and descriptor lookup of end_station_imp::proc_rcvd_aem_resp(), without processing the response.
+///
+struct lookup_dispatch
+{
+    avdecc_lib::configuration_descriptor_imp * cd;
+    uint64_t found;
+
+    void operator()(const std::vector<uint8_t> & frame)
+    {
+        uint16_t cmd_type = jdksavdecc_aecpdu_aem_get_command_type(frame.data(), avdecc_lib::ETHER_HDR_SIZE) & 0x7FFF;
+        uint16_t desc_type;
+        uint16_t desc_index;
+
+        if (!avdecc_lib::aem_resp_dispatch_ref->has_handlers(cmd_type) ||
+            !avdecc_lib::aem_resp_dispatch_ref->get_desc(cmd_type, frame.data(), desc_type, desc_index))
+            return;
+
+        avdecc_lib::aem_resp_handler handler = avdecc_lib::aem_resp_dispatch_ref->handler(cmd_type, desc_type);
+        if (handler && (desc_type == avdecc_lib::AEM_DESC_ENTITY || cd->lookup_slot(desc_type, desc_index)))
+            found++;
+    }
+};
+
+struct proc_dispatch
+{
+    avdecc_lib::end_station_imp * es;
+    uint64_t found;
+
+    void operator()(const std::vector<uint8_t> & frame)
+    {
+        void * notification_id = NULL;
+        int status = -1;
+        uint16_t operation_id = 0;
+        bool is_operation_id_valid = false;
+
+        es->proc_rcvd_aem_resp(notification_id, frame.data(), frame.size(), status, operation_id, is_operation_id_valid);
+        if (status == avdecc_lib::AEM_STATUS_SUCCESS)
+            found++;
+    }
+};
+
+template <typename D>
+static void run(const char * name, D dispatch, const std::vector<std::vector<uint8_t>> & frames, long responses)
+{
+    long rounds = responses / (long)frames.size();
+    bench_clock::time_point start = bench_clock::now();
+    for (long n = 0; n < rounds; n++)
+    {
+        for (size_t f = 0; f < frames.size(); f++)
+            dispatch(frames[f]);
+    }
+    double s = std::chrono::duration<double>(bench_clock::now() - start).count();
+    responses = rounds * (long)frames.size();
+
+    std::cout << name << ": " << (uint64_t)(responses / s) << " responses/s, "
+              << s * 1e9 / responses << " ns per response (" << dispatch.found << " handled)" << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    long responses = (argc > 1) ? atol(argv[1]) : 2000000;
+    const char * cache_dir = (argc > 2) ? argv[2] : ".";
+
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+
+    if (!write_model_cache(controller, cache_dir, entity_model_id, make_model_frames(entity_id, entity_model_id, stage_box, stage_box_types)))
+        return 1;
+
+    rx_frame(make_adp_frame(entity_id, entity_model_id, NULL));
+    remove_model_cache(cache_dir, entity_model_id);
+
+    avdecc_lib::end_station_imp * es = dynamic_cast<avdecc_lib::end_station_imp *>(controller->get_end_station_by_index(0));
+    avdecc_lib::entity_descriptor * ed = es ? es->get_entity_desc_by_index(0) : NULL;
+    avdecc_lib::configuration_descriptor_imp * cd =
+        ed ? dynamic_cast<avdecc_lib::configuration_descriptor_imp *>(ed->get_config_desc_by_index(0)) : NULL;
+    if (!cd)
+    {
+        std::cerr << "The End Station was not populated from the descriptor cache" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::vector<uint8_t>> frames = make_resp_frames();
+    lookup_dispatch lookup = {cd, 0};
+    proc_dispatch proc = {es, 0};
+
+    run("lookup            ", lookup, frames, responses);
+    run("proc_rcvd_aem_resp", proc, frames, responses);
+
+    controller->destroy();
+    netif->destroy();
+    return 0;
+}
@@ -0,0 +1,336 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_cmd_completion_main.cpp
+ *
+ * Measures the command rate of app threads waiting for the completion of their commands, through
+ * the controller and system_layer2_multithreaded_callback on the loopback interface. A responder
+ * thread with its own raw socket on the interface stands for an End Station, announcing it by
+ * ADP and answering every AEM command after a fixed latency. The End Station is populated from a
+ * descriptor cache file written to cache_dir, so that it is not enumerated. With
+ * set_wait_for_next_cmd() every thread blocks on each ENTITY_AVAILABLE command it sends, so it has
+ * one command outstanding at a time. With completion handles every thread keeps a number of
+ * commands outstanding, each with its own cmd_completion, and reuses a handle once complete.
+ *
+ * Needs the privileges to open a raw socket.
+ *
+ * Usage: bench_cmd_completion [threads] [commands per thread] [outstanding per thread] [latency us] [cache_dir]
+ */
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include "system.h"
+#include "end_station.h"
+#include "cmd_completion.h"
+#include "test_fixture.h"
+
+static const uint64_t entity_id = UINT64_C(0x001b92fffe000001);
+static const uint64_t entity_model_id = UINT64_C(0x001b92fffe000100);
+static const uint8_t entity_mac[6] = {0x00, 0x1b, 0x92, 0x00, 0x00, 0x01};
+
+// Announces the End Station and answers its AEM commands once their latency has elapsed. The
+// descriptors of the entity model are read back, as they are once it is populated from the cache.
+class responder
+{
+private:
+    struct pending
+    {
+        bench_clock::time_point due;
+        std::vector<uint8_t> frame;
+    };
+
+    int sock;
+    int ifindex;
+    std::vector<std::vector<uint8_t>> model;
+    std::deque<pending> cmds;
+    std::atomic<bool> stop;
+    std::chrono::microseconds latency;
+    std::thread thread;
+
+    void send(const std::vector<uint8_t> & frame)
+    {
+        struct sockaddr_ll addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sll_family = AF_PACKET;
+        addr.sll_ifindex = ifindex;
+        addr.sll_halen = ETH_ALEN;
+        memcpy(addr.sll_addr, &frame[0], ETH_ALEN);
+        sendto(sock, frame.data(), frame.size(), 0, (struct sockaddr *)&addr, sizeof(addr));
+    }
+
+    const std::vector<uint8_t> * find_desc(uint16_t desc_type, uint16_t desc_index) const
+    {
+        for (size_t i = 0; i < model.size(); i++)
+        {
+            if (jdksavdecc_uint16_get(model[i].data(), read_desc_pos) == desc_type &&
+                jdksavdecc_uint16_get(model[i].data(), read_desc_pos + 2) == desc_index)
+                return &model[i];
+        }
+        return NULL;
+    }
+
+    // Queue the response to an AEM command for the End Station
+    void rx(const uint8_t * frame, size_t len)
+    {
+        const uint8_t * pdu = frame + avdecc_lib::ETHER_HDR_SIZE;
+        if (len < avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AECPDU_AEM_LEN ||
+            jdksavdecc_uint16_get(frame, 12) != JDKSAVDECC_AVTP_ETHERTYPE ||
+            pdu[0] != (0x80 | JDKSAVDECC_SUBTYPE_AECP) ||
+            (pdu[1] & 0x0f) != JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND ||
+            jdksavdecc_uint64_get(pdu, 4) != entity_id)
+            return;
+
+        pending p;
+        p.due = bench_clock::now() + latency;
+        p.frame.assign(frame, frame + len);
+        if (jdksavdecc_aecpdu_aem_get_command_type(frame, avdecc_lib::ETHER_HDR_SIZE) == JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR)
+        {
+            const std::vector<uint8_t> * desc = find_desc(jdksavdecc_uint16_get(pdu, JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_TYPE),
+                                                          jdksavdecc_uint16_get(pdu, JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_INDEX));
+            if (!desc)
+                return;
+
+            p.frame.resize(read_desc_pos);
+            p.frame.insert(p.frame.end(), desc->begin() + read_desc_pos, desc->end());
+            jdksavdecc_uint16_set((uint16_t)(p.frame.size() - avdecc_lib::ETHER_HDR_SIZE - JDKSAVDECC_COMMON_CONTROL_HEADER_LEN),
+                                  &p.frame[avdecc_lib::ETHER_HDR_SIZE], 2);
+        }
+        memcpy(&p.frame[0], frame + 6, 6);
+        memcpy(&p.frame[6], entity_mac, sizeof(entity_mac));
+        p.frame[avdecc_lib::ETHER_HDR_SIZE + 1] = (pdu[1] & 0xf0) | JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE;
+        p.frame[avdecc_lib::ETHER_HDR_SIZE + 2] &= 0x07; // SUCCESS
+        cmds.push_back(p);
+    }
+
+    void run()
+    {
+        std::vector<uint8_t> adp = make_adp_frame(entity_id, entity_model_id, entity_mac);
+        bench_clock::time_point next_adp = bench_clock::now();
+        uint8_t buf[1600];
+
+        while (!stop.load())
+        {
+            bench_clock::time_point now = bench_clock::now();
+            if (now >= next_adp)
+            {
+                send(adp);
+                next_adp = now + std::chrono::seconds(2);
+            }
+
+            while (!cmds.empty() && cmds.front().due <= now)
+            {
+                send(cmds.front().frame);
+                cmds.pop_front();
+            }
+
+            bench_clock::time_point wake = cmds.empty() ? next_adp : std::min(next_adp, cmds.front().due);
+            long timeout_us = std::max(0L, (long)std::chrono::duration_cast<std::chrono::microseconds>(wake - now).count());
+            struct timespec ts = {timeout_us / 1000000, (timeout_us % 1000000) * 1000};
+            struct pollfd pfd = {sock, POLLIN, 0};
+            if (ppoll(&pfd, 1, &ts, NULL) <= 0)
+                continue;
+
+            struct sockaddr_ll from;
+            socklen_t from_len = sizeof(from);
+            ssize_t len;
+            while ((len = recvfrom(sock, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len)) > 0)
+            {
+                // The interface passes every frame sent on it to the raw sockets twice
+                if (from.sll_pkttype != PACKET_OUTGOING)
+                    rx(buf, (size_t)len);
+                from_len = sizeof(from);
+            }
+        }
+    }
+
+public:
+    responder(const char * ifname, long latency_us) : sock(-1), model(make_model_frames(entity_id, entity_model_id, NULL, 0)), stop(false), latency(latency_us)
+    {
+        ifindex = if_nametoindex(ifname);
+        sock = socket(AF_PACKET, SOCK_RAW, htons(JDKSAVDECC_AVTP_ETHERTYPE));
+        if (sock < 0 || !ifindex)
+            return;
+
+        struct sockaddr_ll addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sll_family = AF_PACKET;
+        addr.sll_ifindex = ifindex;
+        addr.sll_protocol = htons(JDKSAVDECC_AVTP_ETHERTYPE);
+        bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+        thread = std::thread(&responder::run, this);
+    }
+
+    ~responder()
+    {
+        stop.store(true);
+        if (thread.joinable())
+            thread.join();
+        if (sock >= 0)
+            close(sock);
+    }
+
+    bool is_open() const
+    {
+        return sock >= 0 && ifindex;
+    }
+};
+
+// One command outstanding per thread, each blocking until complete
+static void blocking(avdecc_lib::system * sys, avdecc_lib::end_station * es, long commands, long, std::atomic<long> & failed)
+{
+    int id;
+    for (long n = 0; n < commands; n++)
+    {
+        sys->set_wait_for_next_cmd(&id);
+        es->send_entity_avail_cmd(&id);
+        if (sys->get_last_resp_status() != avdecc_lib::AEM_STATUS_SUCCESS)
+            failed++;
+    }
+}
+
+// A window of outstanding handles per thread
+static void handles(avdecc_lib::controller * controller, avdecc_lib::end_station * es, long commands, long outstanding, std::atomic<long> & failed)
+{
+    std::vector<avdecc_lib::cmd_completion *> window(outstanding);
+    long sent = 0;
+
+    for (long i = 0; i < outstanding; i++)
+        window[i] = controller->create_cmd_completion(NULL, NULL);
+
+    for (long i = 0; i < outstanding && sent < commands; i++, sent++)
+        es->send_entity_avail_cmd(window[i]->notification_id());
+
+    for (long done = 0; done < commands; done++)
+    {
+        avdecc_lib::cmd_completion * c = window[done % outstanding];
+        while (c->wait(1000) != 0)
+            ;
+        if (c->status() != avdecc_lib::AEM_STATUS_SUCCESS)
+            failed++;
+        if (sent < commands)
+        {
+            es->send_entity_avail_cmd(c->notification_id());
+            sent++;
+        }
+    }
+
+    for (long i = 0; i < outstanding; i++)
+        window[i]->destroy();
+}
+
+template <typename F>
+static void run(const char * name, F fn, long threads, long commands, long outstanding)
+{
+    std::atomic<long> failed(0);
+    std::vector<std::thread> app_threads;
+
+    bench_clock::time_point start = bench_clock::now();
+    for (long t = 0; t < threads; t++)
+        app_threads.push_back(std::thread([&]() { fn(commands, outstanding, failed); }));
+    for (size_t t = 0; t < app_threads.size(); t++)
+        app_threads[t].join();
+    double s = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+    std::cout << name << ": " << (uint64_t)(threads * commands / s) << " commands/s";
+    if (failed.load())
+        std::cout << ", " << failed.load() << " failed";
+    std::cout << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    long threads = (argc > 1) ? atol(argv[1]) : 8;
+    long commands = (argc > 2) ? atol(argv[2]) : 200;
+    long outstanding = (argc > 3) ? atol(argv[3]) : 64;
+    long latency_us = (argc > 4) ? atol(argv[4]) : 1000;
+    const char * cache_dir = (argc > 5) ? argv[5] : ".";
+
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    uint32_t interface_num = loopback_interface_num(netif);
+    if (!interface_num)
+    {
+        std::cerr << "No loopback interface" << std::endl;
+        return 1;
+    }
+
+    responder r("lo", latency_us);
+    if (!r.is_open())
+    {
+        std::cerr << "Cannot open a raw socket on the loopback interface" << std::endl;
+        return 1;
+    }
+
+    netif->select_interface_by_num(interface_num);
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+    // An ENTITY and an empty CONFIGURATION descriptor, so that nothing is read in the background
+    if (!write_model_cache(controller, cache_dir, entity_model_id, make_model_frames(entity_id, entity_model_id, NULL, 0)))
+        return 1;
+
+    avdecc_lib::system * sys = avdecc_lib::create_system(avdecc_lib::system::LAYER2_MULTITHREADED_CALLBACK, netif, controller);
+    sys->process_start();
+
+    avdecc_lib::end_station * es = NULL;
+    for (int i = 0; i < 500 && !es; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (controller->get_end_station_count())
+            es = controller->get_end_station_by_index(0);
+    }
+
+    remove_model_cache(cache_dir, entity_model_id);
+
+    if (es)
+    {
+        std::cout << threads << " threads, " << latency_us << " us response latency" << std::endl;
+        run("set_wait_for_next_cmd",
+            [&](long n, long o, std::atomic<long> & failed) { blocking(sys, es, n, o, failed); },
+            threads, commands, 1);
+        run("completion handles   ",
+            [&](long n, long o, std::atomic<long> & failed) { handles(controller, es, n, o, failed); },
+            threads, commands * 10, outstanding);
+    }
+    else
+    {
+        std::cerr << "The End Station was not discovered" << std::endl;
+    }
+
+    sys->process_close();
+    sys->destroy();
+    controller->destroy();
+    netif->destroy();
+    return es ? 0 : 1;
+}
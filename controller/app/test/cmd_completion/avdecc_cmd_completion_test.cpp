@@ -0,0 +1,247 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_cmd_completion_test.cpp
+ *
+ * Checks the completion handles of cmd_completions through the events that the system layer and
+ * the state machines signal for the commands sent with a handle. A controller is created for the
+ * inflight commands the handles are checked against, without selecting an interface.
+ *
+ * Usage: test_cmd_completion
+ */
+
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include "enumeration.h"
+#include "net_interface.h"
+#include "controller.h"
+#include "cmd_completion_imp.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+static const uint8_t resp_a[] = {0x01, 0x02, 0x03, 0x04};
+static const uint8_t resp_b[] = {0x05, 0x06};
+
+static void count_callback(void * user_obj, avdecc_lib::cmd_completion *)
+{
+    (*(int *)user_obj)++;
+}
+
+// A command with the handle is queued for transmission and handed to the state machines
+static void send_cmd(void * id)
+{
+    avdecc_lib::cmd_completions_ref->cmd_queued(id, avdecc_lib::CMD_WITH_NOTIFICATION);
+    avdecc_lib::cmd_completions_ref->cmd_sent(id, avdecc_lib::CMD_WITH_NOTIFICATION);
+}
+
+static void test_response()
+{
+    int calls = 0;
+    avdecc_lib::cmd_completion_imp * c = avdecc_lib::cmd_completions_ref->create(count_callback, &calls);
+    void * id = c->notification_id();
+
+    avdecc_lib::cmd_completions_ref->cmd_queued(id, avdecc_lib::CMD_WITH_NOTIFICATION);
+    CHECK(!c->is_complete());
+    CHECK(c->wait(0) == -1);
+    CHECK(c->status() == avdecc_lib::AVDECC_LIB_STATUS_INVALID);
+
+    avdecc_lib::cmd_completions_ref->cmd_sent(id, avdecc_lib::CMD_WITH_NOTIFICATION);
+    avdecc_lib::cmd_completions_ref->resp_received(id, avdecc_lib::AEM_STATUS_SUCCESS, resp_a, sizeof(resp_a));
+    CHECK(c->is_complete());
+    CHECK(c->wait(0) == 0);
+    CHECK(c->status() == avdecc_lib::AEM_STATUS_SUCCESS);
+    CHECK(c->resp_frame_len() == sizeof(resp_a) && memcmp(c->resp_frame(), resp_a, sizeof(resp_a)) == 0);
+    CHECK(calls == 1);
+
+    // Commands sent without notification do not belong to the handle
+    avdecc_lib::cmd_completions_ref->cmd_queued(id, avdecc_lib::CMD_WITHOUT_NOTIFICATION);
+    CHECK(c->is_complete());
+
+    c->destroy();
+}
+
+static void test_reuse()
+{
+    int calls = 0;
+    avdecc_lib::cmd_completion_imp * c = avdecc_lib::cmd_completions_ref->create(count_callback, &calls);
+    void * id = c->notification_id();
+
+    send_cmd(id);
+    avdecc_lib::cmd_completions_ref->resp_received(id, avdecc_lib::AEM_STATUS_SUCCESS, resp_a, sizeof(resp_a));
+    CHECK(c->is_complete());
+
+    // A new command clears the status and the frame of the last one
+    avdecc_lib::cmd_completions_ref->cmd_queued(id, avdecc_lib::CMD_WITH_NOTIFICATION);
+    CHECK(!c->is_complete());
+    CHECK(c->status() == avdecc_lib::AVDECC_LIB_STATUS_INVALID);
+    CHECK(c->resp_frame() == NULL && c->resp_frame_len() == 0);
+
+    avdecc_lib::cmd_completions_ref->cmd_sent(id, avdecc_lib::CMD_WITH_NOTIFICATION);
+    avdecc_lib::cmd_completions_ref->resp_received(id, avdecc_lib::AEM_STATUS_NOT_IMPLEMENTED, resp_b, sizeof(resp_b));
+    CHECK(c->is_complete());
+    CHECK(c->status() == avdecc_lib::AEM_STATUS_NOT_IMPLEMENTED);
+    CHECK(c->resp_frame_len() == sizeof(resp_b) && memcmp(c->resp_frame(), resp_b, sizeof(resp_b)) == 0);
+    CHECK(calls == 2);
+
+    c->destroy();
+}
+
+static void test_timeout()
+{
+    int calls = 0;
+    avdecc_lib::cmd_completion_imp * c = avdecc_lib::cmd_completions_ref->create(count_callback, &calls);
+    void * id = c->notification_id();
+
+    send_cmd(id);
+    avdecc_lib::cmd_completions_ref->cmd_timed_out(id);
+    CHECK(c->is_complete());
+    CHECK(c->status() == avdecc_lib::AVDECC_LIB_STATUS_TICK_TIMEOUT);
+    CHECK(c->resp_frame() == NULL && c->resp_frame_len() == 0);
+    CHECK(calls == 1);
+
+    // A late response does not complete the handle again
+    avdecc_lib::cmd_completions_ref->resp_received(id, avdecc_lib::AEM_STATUS_SUCCESS, resp_a, sizeof(resp_a));
+    CHECK(c->status() == avdecc_lib::AVDECC_LIB_STATUS_TICK_TIMEOUT);
+    CHECK(calls == 1);
+
+    c->destroy();
+}
+
+static void test_dropped()
+{
+    int calls = 0;
+    avdecc_lib::cmd_completion_imp * c = avdecc_lib::cmd_completions_ref->create(count_callback, &calls);
+    void * id = c->notification_id();
+
+    // The state machines did not keep the command, so it was not sent
+    send_cmd(id);
+    CHECK(!c->is_complete());
+    avdecc_lib::cmd_completions_ref->complete_sent();
+    CHECK(c->is_complete());
+    CHECK(c->status() == avdecc_lib::AVDECC_LIB_STATUS_INVALID);
+    CHECK(c->resp_frame() == NULL);
+    CHECK(calls == 1);
+
+    c->destroy();
+}
+
+static void destroy_callback(void * user_obj, avdecc_lib::cmd_completion * c)
+{
+    (*(int *)user_obj)++;
+    c->destroy();
+}
+
+static void test_destroy_in_callback()
+{
+    int calls = 0;
+    avdecc_lib::cmd_completion_imp * c = avdecc_lib::cmd_completions_ref->create(destroy_callback, &calls);
+    void * id = c->notification_id();
+
+    send_cmd(id);
+    avdecc_lib::cmd_completions_ref->resp_received(id, avdecc_lib::AEM_STATUS_SUCCESS, resp_a, sizeof(resp_a));
+    CHECK(calls == 1);
+
+    // The responses of the commands sent with a destroyed handle are ignored
+    avdecc_lib::cmd_completions_ref->resp_received(id, avdecc_lib::AEM_STATUS_SUCCESS, resp_a, sizeof(resp_a));
+    avdecc_lib::cmd_completions_ref->cmd_timed_out(id);
+    avdecc_lib::cmd_completions_ref->complete_sent();
+    CHECK(calls == 1);
+}
+
+struct slow_callback_state
+{
+    std::atomic<bool> entered;
+    std::atomic<bool> returned;
+};
+
+static void slow_callback(void * user_obj, avdecc_lib::cmd_completion *)
+{
+    slow_callback_state * s = (slow_callback_state *)user_obj;
+    s->entered.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    s->returned.store(true);
+}
+
+static void test_destroy_during_callback()
+{
+    slow_callback_state s;
+    s.entered.store(false);
+    s.returned.store(false);
+    avdecc_lib::cmd_completion_imp * c = avdecc_lib::cmd_completions_ref->create(slow_callback, &s);
+    void * id = c->notification_id();
+
+    send_cmd(id);
+    std::thread lib_thread([id]() {
+        avdecc_lib::cmd_completions_ref->resp_received(id, avdecc_lib::AEM_STATUS_SUCCESS, resp_a, sizeof(resp_a));
+    });
+    while (!s.entered.load())
+        std::this_thread::yield();
+
+    // Another thread destroying the handle waits for its callback to return
+    c->destroy();
+    CHECK(s.returned.load());
+    lib_thread.join();
+}
+
+static void notification_callback(void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *) {}
+
+static void acmp_notification_callback(void *, int32_t, uint16_t, uint64_t, uint16_t, uint64_t, uint16_t, uint32_t, void *) {}
+
+static void log_callback(void *, int32_t, const char * msg, int32_t)
+{
+    std::cerr << msg << std::endl;
+}
+
+int main()
+{
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+
+    test_response();
+    test_reuse();
+    test_timeout();
+    test_dropped();
+    test_destroy_in_callback();
+    test_destroy_during_callback();
+
+    controller->destroy();
+    netif->destroy();
+
+    std::cout << (failures ? "FAILED" : "passed") << std::endl;
+    return failures ? 1 : 0;
+}
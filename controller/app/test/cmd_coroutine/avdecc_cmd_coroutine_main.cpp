@@ -0,0 +1,333 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_cmd_coroutine_main.cpp
+ *
+ * Measures the number of device procedures run concurrently, with a blocking thread per procedure
+ * against coroutines on a small cmd_executor. A procedure erases a device, writes a number of
+ * chunks one command at a time and reboots it. A responder thread stands for the network and the
+ * End Stations, completing every command after a fixed latency through the completion callback,
+ * as the library thread does.
+ *
+ * Usage: bench_cmd_coroutine [procedures] [chunks per procedure] [executor threads] [latency us]
+ */
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include "cmd_coroutine.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+// Answers each command once its latency has elapsed
+class responder
+{
+public:
+    typedef void (*complete_fn)(void *);
+
+private:
+    struct pending
+    {
+        bench_clock::time_point due;
+        complete_fn fn;
+        void * obj;
+    };
+
+    std::mutex lock;
+    std::condition_variable queued;
+    std::deque<pending> cmds;
+    bool stop;
+    std::chrono::microseconds latency;
+    std::thread thread;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        while (!stop || !cmds.empty())
+        {
+            if (cmds.empty())
+            {
+                queued.wait(guard);
+                continue;
+            }
+
+            pending p = cmds.front();
+            if (bench_clock::now() < p.due)
+            {
+                queued.wait_until(guard, p.due);
+                continue;
+            }
+
+            cmds.pop_front();
+            guard.unlock();
+            p.fn(p.obj);
+            guard.lock();
+        }
+    }
+
+public:
+    responder(long latency_us) : stop(false), latency(latency_us)
+    {
+        thread = std::thread(&responder::run, this);
+    }
+
+    ~responder()
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stop = true;
+        }
+        queued.notify_one();
+        thread.join();
+    }
+
+    void send(complete_fn fn, void * obj)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pending p = {bench_clock::now() + latency, fn, obj};
+        cmds.push_back(p);
+        queued.notify_one();
+    }
+};
+
+// A handle as cmd_completion_imp, completed by the responder thread
+class fake_completion : public avdecc_lib::cmd_completion
+{
+private:
+    std::mutex m_lock;
+    std::condition_variable m_done;
+    void (*m_callback)(void *, avdecc_lib::cmd_completion *);
+    void * m_user_obj;
+    bool m_complete;
+    int m_status;
+
+public:
+    fake_completion(void (*callback)(void *, avdecc_lib::cmd_completion *), void * user_obj)
+        : m_callback(callback), m_user_obj(user_obj), m_complete(false), m_status(1023) {}
+
+    virtual ~fake_completion() {}
+
+    void STDCALL destroy()
+    {
+        delete this;
+    }
+
+    void * STDCALL notification_id()
+    {
+        return this;
+    }
+
+    bool STDCALL is_complete()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_complete;
+    }
+
+    int STDCALL wait(uint32_t)
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        while (!m_complete)
+            m_done.wait(guard);
+        return 0;
+    }
+
+    int STDCALL status()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        return m_status;
+    }
+
+    const uint8_t * STDCALL resp_frame()
+    {
+        return NULL;
+    }
+
+    size_t STDCALL resp_frame_len()
+    {
+        return 0;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_complete = false;
+    }
+
+    static void complete(void * obj)
+    {
+        fake_completion * c = static_cast<fake_completion *>(obj);
+        void (*callback)(void *, avdecc_lib::cmd_completion *) = c->m_callback;
+        void * user_obj = c->m_user_obj;
+
+        // A waiter can destroy the handle as soon as it is complete, and a callback is its only user
+        {
+            std::lock_guard<std::mutex> guard(c->m_lock);
+            c->m_complete = true;
+            c->m_status = 0;
+            c->m_done.notify_all();
+        }
+        if (callback)
+            callback(user_obj, c);
+    }
+};
+
+// Only creates completion handles; the rest of the controller is not used
+class fake_controller : public avdecc_lib::controller
+{
+public:
+    void STDCALL destroy() {}
+    const char * STDCALL get_version() const { return "bench"; }
+    size_t STDCALL get_end_station_count() { return 0; }
+    uint64_t STDCALL get_entity_id() { return 0; }
+    void STDCALL set_entity_id(uint64_t) {}
+    avdecc_lib::end_station * STDCALL get_end_station_by_index(size_t) { return NULL; }
+    bool STDCALL is_end_station_found_by_entity_id(uint64_t, uint32_t &) { return false; }
+    bool STDCALL is_end_station_found_by_mac_addr(uint64_t, uint32_t &) { return false; }
+    avdecc_lib::configuration_descriptor * STDCALL get_current_config_desc(size_t, bool) { return NULL; }
+    avdecc_lib::configuration_descriptor * STDCALL get_config_desc_by_entity_id(uint64_t, uint16_t, uint16_t) { return NULL; }
+    void STDCALL set_logging_level(int32_t) {}
+    void STDCALL apply_end_station_capabilities_filters(uint32_t, uint32_t, uint32_t) {}
+    uint32_t STDCALL missed_notification_count() { return 0; }
+    uint32_t STDCALL missed_log_count() { return 0; }
+    int STDCALL send_controller_avail_cmd(void *, uint32_t) { return -1; }
+    void STDCALL set_aecp_default_window(uint32_t) {}
+    void STDCALL set_enumeration_max_inflight(uint32_t) {}
+    uint32_t STDCALL get_enumeration_inflight() { return 0; }
+    uint32_t STDCALL get_enumeration_queue_depth() { return 0; }
+    void STDCALL set_descriptor_cache_dir(const char *) {}
+    void STDCALL get_descriptor_frame_bytes(uint64_t & referenced_bytes, uint64_t & stored_bytes) { referenced_bytes = stored_bytes = 0; }
+
+    avdecc_lib::cmd_completion * STDCALL create_cmd_completion(void (*callback)(void *, avdecc_lib::cmd_completion *), void * user_obj)
+    {
+        return new fake_completion(callback, user_obj);
+    }
+
+    avdecc_lib::cmd_batch * STDCALL send_cmd_batch(const struct avdecc_lib::cmd_batch_item *, size_t,
+                                                   void (*)(void *, avdecc_lib::cmd_batch *), void *)
+    {
+        return NULL;
+    }
+};
+
+static int send_cmd(responder & r, void * notification_id)
+{
+    r.send(fake_completion::complete, notification_id);
+    return 0;
+}
+
+// A thread per procedure, blocking on every command
+static void blocking_procedure(fake_controller & ctrl, responder & r, long chunks, std::atomic<long> & done)
+{
+    avdecc_lib::cmd_completion * c = ctrl.create_cmd_completion(NULL, NULL);
+    fake_completion * f = static_cast<fake_completion *>(c);
+
+    for (long n = 0; n < chunks + 2; n++) // Erase, the chunks and reboot
+    {
+        f->reset();
+        send_cmd(r, c->notification_id());
+        c->wait(0);
+    }
+
+    c->destroy();
+    done++;
+}
+
+// The same procedure as a coroutine
+static avdecc_lib::cmd_task<void> coroutine_procedure(fake_controller & ctrl, avdecc_lib::cmd_executor & exec,
+                                                       responder & r, long chunks, std::atomic<long> & done)
+{
+    auto send = [&r](void * id) { return send_cmd(r, id); };
+
+    co_await avdecc_lib::send_cmd_async(ctrl, exec, send); // Erase
+    for (long n = 0; n < chunks; n++)
+    {
+        avdecc_lib::cmd_result result = co_await avdecc_lib::send_cmd_async(ctrl, exec, send);
+        if (result.status != 0)
+            co_return;
+    }
+    co_await avdecc_lib::send_cmd_async(ctrl, exec, send); // Reboot
+    done++;
+}
+
+static void report(const char * name, long procedures, long completed, long chunks, bench_clock::time_point start)
+{
+    double s = std::chrono::duration<double>(bench_clock::now() - start).count();
+    std::cout << name << ": " << completed << "/" << procedures << " procedures, "
+              << (uint64_t)(completed * (chunks + 2) / s) << " commands/s" << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    long procedures = (argc > 1) ? atol(argv[1]) : 2000;
+    long chunks = (argc > 2) ? atol(argv[2]) : 50;
+    long executor_threads = (argc > 3) ? atol(argv[3]) : 2;
+    long latency_us = (argc > 4) ? atol(argv[4]) : 1000;
+    long blocking_threads = 64; // A thread pool of typical size
+
+    fake_controller ctrl;
+    std::cout << procedures << " procedures, " << latency_us << " us response latency" << std::endl;
+
+    {
+        responder r(latency_us);
+        std::atomic<long> done(0);
+        std::atomic<long> next(0);
+        std::vector<std::thread> pool;
+
+        bench_clock::time_point start = bench_clock::now();
+        for (long t = 0; t < blocking_threads; t++)
+        {
+            pool.push_back(std::thread([&]() {
+                while (next++ < procedures)
+                    blocking_procedure(ctrl, r, chunks, done);
+            }));
+        }
+        for (size_t t = 0; t < pool.size(); t++)
+            pool[t].join();
+        report("64 blocking threads", procedures, done, chunks, start);
+    }
+
+    {
+        responder r(latency_us);
+        avdecc_lib::cmd_executor exec;
+        std::atomic<long> done(0);
+        std::vector<std::thread> pool;
+
+        bench_clock::time_point start = bench_clock::now();
+        for (long p = 0; p < procedures; p++)
+            exec.spawn(coroutine_procedure(ctrl, exec, r, chunks, done));
+        for (long t = 0; t < executor_threads; t++)
+            pool.push_back(std::thread([&exec]() { exec.run(); }));
+        for (size_t t = 0; t < pool.size(); t++)
+            pool[t].join();
+        report("coroutines         ", procedures, done, chunks, start);
+    }
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_deadline_queue_test.cpp
+ *
+ * Checks that deadline_queue hands back expired keys in deadline order, skips the heap entries
+ * left behind by rescheduled and cancelled keys, and rebuilds its heap before they pile up.
+ *
+ * Usage: test_deadline_queue
+ */
+
+#include <iostream>
+#include <stdint.h>
+#include "deadline_queue.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+typedef avdecc_lib::deadline_queue<uint64_t> queue;
+
+static void test_order()
+{
+    queue q;
+    uint64_t key = 0;
+    uint64_t deadline = 0;
+
+    q.schedule(3, 300);
+    q.schedule(1, 100);
+    q.schedule(2, 200);
+    CHECK(q.size() == 3);
+    CHECK(q.next_deadline(deadline) && deadline == 100);
+
+    CHECK(!q.pop_expired(99, key));
+    CHECK(q.pop_expired(250, key) && key == 1);
+    CHECK(q.pop_expired(250, key) && key == 2);
+    CHECK(!q.pop_expired(250, key));
+    CHECK(!q.is_scheduled(1));
+    CHECK(q.is_scheduled(3));
+    CHECK(q.pop_expired(300, key) && key == 3);
+    CHECK(q.size() == 0);
+    CHECK(!q.next_deadline(deadline));
+}
+
+static void test_reschedule()
+{
+    queue q;
+    uint64_t key = 0;
+    uint64_t deadline = 0;
+
+    // A key moved later is not handed back at its old deadline
+    q.schedule(1, 100);
+    q.schedule(2, 200);
+    q.schedule(1, 300);
+    CHECK(q.size() == 2);
+    CHECK(q.next_deadline(deadline) && deadline == 200);
+    CHECK(q.pop_expired(250, key) && key == 2);
+    CHECK(!q.pop_expired(250, key));
+
+    // A key moved earlier is handed back once, at its new deadline
+    q.schedule(1, 50);
+    CHECK(q.pop_expired(300, key) && key == 1);
+    CHECK(!q.pop_expired(300, key));
+
+    // Scheduling the pending deadline again adds no heap entry
+    q.schedule(4, 400);
+    size_t entries = q.heap_entries();
+    q.schedule(4, 400);
+    CHECK(q.heap_entries() == entries);
+}
+
+static void test_cancel()
+{
+    queue q;
+    uint64_t key = 0;
+    uint64_t deadline = 0;
+
+    q.schedule(1, 100);
+    q.schedule(2, 200);
+    q.cancel(1);
+    q.cancel(5);
+    CHECK(!q.is_scheduled(1));
+    CHECK(q.size() == 1);
+
+    // The entry of the cancelled key stays in the heap until it reaches the top
+    CHECK(q.heap_entries() == 2);
+    CHECK(q.next_deadline(deadline) && deadline == 200);
+    CHECK(q.heap_entries() == 1);
+    CHECK(q.pop_expired(1000, key) && key == 2);
+    CHECK(!q.pop_expired(1000, key));
+
+    // A cancelled key scheduled again at its old deadline is live again
+    q.schedule(3, 300);
+    q.cancel(3);
+    q.schedule(3, 300);
+    CHECK(q.pop_expired(300, key) && key == 3);
+    CHECK(!q.pop_expired(300, key));
+}
+
+static void test_compact()
+{
+    queue q;
+    uint64_t key = 0;
+    const uint64_t keys = 10;
+
+    // Every reschedule later leaves a stale entry that never reaches the top
+    for (uint64_t deadline = 1000; deadline < 11000; deadline++)
+    {
+        q.schedule(deadline % keys, deadline);
+        CHECK(q.heap_entries() <= 2 * keys + 32 + 1);
+    }
+    CHECK(q.size() == keys);
+
+    for (uint64_t k = 0; k < keys; k++)
+    {
+        CHECK(q.pop_expired(20000, key) && key == k);
+    }
+    CHECK(!q.pop_expired(20000, key));
+    CHECK(q.heap_entries() == 0);
+
+    // Cancelled keys are dropped by the next rebuild
+    for (uint64_t k = 0; k < 1000; k++)
+    {
+        q.schedule(k, 5000 + k);
+        q.cancel(k);
+    }
+    CHECK(q.size() == 0);
+    CHECK(q.heap_entries() <= 32 + 1);
+}
+
+int main()
+{
+    test_order();
+    test_reschedule();
+    test_cancel();
+    test_compact();
+
+    std::cout << (failures ? "FAILED" : "passed") << std::endl;
+    return failures ? 1 : 0;
+}
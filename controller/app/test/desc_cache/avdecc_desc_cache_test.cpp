@@ -0,0 +1,384 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_desc_cache_test.cpp
+ *
+ * Checks that an End Station populated from the descriptor cache reports its own names and current
+ * values, not those of the End Station the cache was saved from. A responder thread with its own
+ * raw socket on the loopback interface announces two End Stations of one entity model, with
+ * different names and sampling rates, and answers their READ_DESCRIPTOR commands. The first is
+ * enumerated and saved to a descriptor cache in a temporary directory, and the second announced
+ * once it has been.
+ *
+ * Needs the privileges to open a raw socket, and is skipped without them.
+ *
+ * Usage: test_desc_cache
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <cstdlib>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include "system.h"
+#include "end_station_imp.h"
+#include "configuration_descriptor_imp.h"
+#include "test_fixture.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+static const uint64_t base_entity_id = UINT64_C(0x001b92fffe000000);
+static const uint64_t entity_model_id = UINT64_C(0x001b92fffe000200);
+static const uint32_t sampling_rates[2] = {48000, 96000};
+
+// The named descriptors, and a LOCALE and a STREAM_PORT_INPUT without a name that are taken from the cache
+static const model_desc model[] = {
+    {avdecc_lib::AEM_DESC_AUDIO_UNIT, 1, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_LEN},
+    {avdecc_lib::AEM_DESC_JACK_INPUT, 2, JDKSAVDECC_DESCRIPTOR_JACK_LEN},
+    {avdecc_lib::AEM_DESC_AVB_INTERFACE, 1, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_LEN},
+    {avdecc_lib::AEM_DESC_CLOCK_SOURCE, 2, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_LEN},
+    {avdecc_lib::AEM_DESC_CONTROL, 2, JDKSAVDECC_DESCRIPTOR_CONTROL_LEN},
+    {avdecc_lib::AEM_DESC_LOCALE, 1, JDKSAVDECC_DESCRIPTOR_LOCALE_LEN},
+    {avdecc_lib::AEM_DESC_STREAM_PORT_INPUT, 1, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_LEN},
+};
+
+static const size_t model_types = sizeof(model) / sizeof(model[0]);
+
+static bool is_named(uint16_t desc_type)
+{
+    return desc_type != avdecc_lib::AEM_DESC_ENTITY && desc_type != avdecc_lib::AEM_DESC_LOCALE &&
+           desc_type != avdecc_lib::AEM_DESC_STREAM_PORT_INPUT;
+}
+
+static std::string desc_name(uint32_t entity, uint16_t desc_type, uint16_t desc_index)
+{
+    return "End Station " + std::to_string(entity) + " descriptor " + std::to_string(desc_type) + "." + std::to_string(desc_index);
+}
+
+static void entity_mac(uint32_t entity, uint8_t * mac)
+{
+    static const uint8_t oui[3] = {0x00, 0x1b, 0x92};
+    memcpy(mac, oui, sizeof(oui));
+    mac[3] = 0;
+    mac[4] = 0;
+    mac[5] = (uint8_t)entity;
+}
+
+// Announces the End Stations it is told to and answers their READ_DESCRIPTOR commands at once
+class responder
+{
+private:
+    int sock;
+    int ifindex;
+    std::vector<std::vector<uint8_t>> models[2];
+    std::atomic<uint32_t> announced;
+    std::mutex reads_locker;
+    std::map<std::pair<uint32_t, uint16_t>, int> reads; // By End Station and descriptor type
+    std::atomic<bool> stop;
+    std::thread thread;
+
+    void send(const std::vector<uint8_t> & frame)
+    {
+        struct sockaddr_ll addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sll_family = AF_PACKET;
+        addr.sll_ifindex = ifindex;
+        addr.sll_halen = ETH_ALEN;
+        memcpy(addr.sll_addr, &frame[0], ETH_ALEN);
+        sendto(sock, frame.data(), frame.size(), 0, (struct sockaddr *)&addr, sizeof(addr));
+    }
+
+    // The descriptors of an End Station, with its own names and sampling rate
+    static std::vector<std::vector<uint8_t>> make_entity_frames(uint32_t entity)
+    {
+        std::vector<std::vector<uint8_t>> frames = make_model_frames(base_entity_id + entity, entity_model_id, model, model_types);
+
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            uint8_t * desc = &frames[i][read_desc_pos];
+            uint16_t desc_type = jdksavdecc_uint16_get(desc, 0);
+            if (is_named(desc_type))
+                snprintf((char *)desc + 4, 64, "%s", desc_name(entity, desc_type, jdksavdecc_uint16_get(desc, 2)).c_str());
+            if (desc_type == avdecc_lib::AEM_DESC_AUDIO_UNIT)
+                jdksavdecc_uint32_set(sampling_rates[entity - 1], desc, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_CURRENT_SAMPLING_RATE);
+        }
+        return frames;
+    }
+
+    void rx(const uint8_t * frame, size_t len)
+    {
+        const uint8_t * pdu = frame + avdecc_lib::ETHER_HDR_SIZE;
+        if (len < avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_LEN ||
+            jdksavdecc_uint16_get(frame, 12) != JDKSAVDECC_AVTP_ETHERTYPE ||
+            pdu[0] != (0x80 | JDKSAVDECC_SUBTYPE_AECP) ||
+            (pdu[1] & 0x0f) != JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND ||
+            jdksavdecc_aecpdu_aem_get_command_type(frame, avdecc_lib::ETHER_HDR_SIZE) != JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR)
+            return;
+
+        uint64_t entity_id = jdksavdecc_uint64_get(pdu, 4);
+        if (entity_id <= base_entity_id || entity_id > base_entity_id + 2)
+            return;
+
+        uint32_t entity = (uint32_t)(entity_id - base_entity_id);
+        uint16_t desc_type = jdksavdecc_uint16_get(pdu, JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_TYPE);
+        uint16_t desc_index = jdksavdecc_uint16_get(pdu, JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_INDEX);
+        {
+            std::lock_guard<std::mutex> guard(reads_locker);
+            reads[std::make_pair(entity, desc_type)]++;
+        }
+
+        const std::vector<std::vector<uint8_t>> & frames = models[entity - 1];
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            if (jdksavdecc_uint16_get(frames[i].data(), read_desc_pos) != desc_type ||
+                jdksavdecc_uint16_get(frames[i].data(), read_desc_pos + 2) != desc_index)
+                continue;
+
+            std::vector<uint8_t> resp(frame, frame + read_desc_pos);
+            resp.insert(resp.end(), frames[i].begin() + read_desc_pos, frames[i].end());
+            memcpy(&resp[0], frame + 6, 6);
+            entity_mac(entity, &resp[6]);
+            uint8_t * resp_pdu = &resp[avdecc_lib::ETHER_HDR_SIZE];
+            resp_pdu[1] = (pdu[1] & 0xf0) | JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE;
+            jdksavdecc_uint16_set((uint16_t)(resp.size() - avdecc_lib::ETHER_HDR_SIZE - JDKSAVDECC_COMMON_CONTROL_HEADER_LEN), resp_pdu, 2); // SUCCESS
+            send(resp);
+            return;
+        }
+    }
+
+    void run()
+    {
+        bench_clock::time_point next_adp = bench_clock::now();
+        uint32_t adp_sent = 0;
+        uint8_t buf[1600];
+
+        while (!stop.load())
+        {
+            // An End Station is announced as soon as it is told to, then every second
+            if (bench_clock::now() >= next_adp || adp_sent != announced.load())
+            {
+                adp_sent = announced.load();
+                for (uint32_t entity = 1; entity <= adp_sent; entity++)
+                {
+                    uint8_t mac[6];
+                    entity_mac(entity, mac);
+                    send(make_adp_frame(base_entity_id + entity, entity_model_id, mac));
+                }
+                next_adp = bench_clock::now() + std::chrono::seconds(1);
+            }
+
+            struct pollfd pfd = {sock, POLLIN, 0};
+            if (poll(&pfd, 1, 1) <= 0)
+                continue;
+
+            struct sockaddr_ll from;
+            socklen_t from_len = sizeof(from);
+            ssize_t len;
+            while ((len = recvfrom(sock, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len)) > 0)
+            {
+                // The interface passes every frame sent on it to the raw sockets twice
+                if (from.sll_pkttype != PACKET_OUTGOING)
+                    rx(buf, (size_t)len);
+                from_len = sizeof(from);
+            }
+        }
+    }
+
+public:
+    responder(const char * ifname) : sock(-1), announced(0), stop(false)
+    {
+        models[0] = make_entity_frames(1);
+        models[1] = make_entity_frames(2);
+
+        ifindex = if_nametoindex(ifname);
+        sock = socket(AF_PACKET, SOCK_RAW, htons(JDKSAVDECC_AVTP_ETHERTYPE));
+        if (sock < 0 || !ifindex)
+            return;
+
+        struct sockaddr_ll addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sll_family = AF_PACKET;
+        addr.sll_ifindex = ifindex;
+        addr.sll_protocol = htons(JDKSAVDECC_AVTP_ETHERTYPE);
+        bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+        thread = std::thread(&responder::run, this);
+    }
+
+    ~responder()
+    {
+        stop.store(true);
+        if (thread.joinable())
+            thread.join();
+        if (sock >= 0)
+            close(sock);
+    }
+
+    bool is_open() const
+    {
+        return sock >= 0 && ifindex;
+    }
+
+    void announce(uint32_t entities)
+    {
+        announced.store(entities);
+    }
+
+    int read_count(uint32_t entity, uint16_t desc_type)
+    {
+        std::lock_guard<std::mutex> guard(reads_locker);
+        return reads[std::make_pair(entity, desc_type)];
+    }
+};
+
+// Wait for an End Station to be discovered and enumerated
+static avdecc_lib::end_station * wait_enumerated(avdecc_lib::controller * controller, uint32_t entity)
+{
+    for (int i = 0; i < 1000; i++)
+    {
+        for (uint32_t n = 0; n < controller->get_end_station_count(); n++)
+        {
+            avdecc_lib::end_station * es = controller->get_end_station_by_index(n);
+            if (es->entity_id() == base_entity_id + entity && es->get_enumeration_time_ms())
+                return es;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return NULL;
+}
+
+static bool has_name(uint8_t * object_name, const std::string & name)
+{
+    return strncmp((const char *)object_name, name.c_str(), 64) == 0;
+}
+
+// The names and sampling rate an End Station reports are its own
+static void check_entity(avdecc_lib::end_station * es, uint32_t entity)
+{
+    avdecc_lib::entity_descriptor * ed = es->get_entity_desc_by_index(0);
+    avdecc_lib::configuration_descriptor_imp * cd =
+        ed ? dynamic_cast<avdecc_lib::configuration_descriptor_imp *>(ed->get_config_desc_by_index(0)) : NULL;
+    CHECK(cd != NULL);
+    if (!cd)
+        return;
+
+    CHECK(has_name(cd->object_name(), desc_name(entity, avdecc_lib::AEM_DESC_CONFIGURATION, 0)));
+
+    for (size_t t = 0; t < model_types; t++)
+    {
+        CHECK(cd->desc_count(model[t].type) == model[t].count);
+        if (!is_named(model[t].type))
+            continue;
+
+        for (uint16_t i = 0; i < cd->desc_count(model[t].type); i++)
+        {
+            avdecc_lib::descriptor_response_base * resp = cd->lookup_desc(model[t].type, i)->get_descriptor_response();
+            CHECK(has_name(resp->object_name(), desc_name(entity, model[t].type, i)));
+            delete resp;
+        }
+    }
+
+    avdecc_lib::audio_unit_descriptor_response * aud = cd->get_audio_unit_desc_by_index(0)->get_audio_unit_response();
+    CHECK(aud->current_sampling_rate() == sampling_rates[entity - 1]);
+    delete aud;
+}
+
+int main()
+{
+    char cache_dir[] = "/tmp/avdecc_desc_cache_XXXXXX";
+    if (!mkdtemp(cache_dir))
+    {
+        std::cerr << "Cannot create a descriptor cache directory" << std::endl;
+        return 1;
+    }
+
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    uint32_t interface_num = loopback_interface_num(netif);
+    responder r("lo");
+    if (!interface_num || !r.is_open())
+    {
+        std::cout << "skipped, the loopback interface cannot be opened" << std::endl;
+        netif->destroy();
+        rmdir(cache_dir);
+        return 77;
+    }
+
+    netif->select_interface_by_num(interface_num);
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+    controller->set_descriptor_cache_dir(cache_dir);
+    avdecc_lib::system * sys = avdecc_lib::create_system(avdecc_lib::system::LAYER2_MULTITHREADED_CALLBACK, netif, controller);
+    sys->process_start();
+
+    // The first End Station is enumerated in full, which saves its descriptors to the cache
+    r.announce(1);
+    avdecc_lib::end_station * first = wait_enumerated(controller, 1);
+    CHECK(first != NULL);
+
+    // The second is populated from the cache, which holds the names of the first
+    r.announce(2);
+    avdecc_lib::end_station * second = first ? wait_enumerated(controller, 2) : NULL;
+    CHECK(second != NULL);
+
+    if (first && second)
+    {
+        check_entity(first, 1);
+        check_entity(second, 2);
+
+        // The descriptors without a name or a current value were not read again
+        CHECK(r.read_count(1, avdecc_lib::AEM_DESC_LOCALE) == 1);
+        CHECK(r.read_count(2, avdecc_lib::AEM_DESC_LOCALE) == 0);
+        CHECK(r.read_count(2, avdecc_lib::AEM_DESC_STREAM_PORT_INPUT) == 0);
+        CHECK(r.read_count(2, avdecc_lib::AEM_DESC_JACK_INPUT) == 2);
+    }
+
+    sys->process_close();
+    sys->destroy();
+    controller->destroy();
+    netif->destroy();
+
+    remove_model_cache(cache_dir, entity_model_id);
+    rmdir(cache_dir);
+
+    std::cout << (failures ? "FAILED" : "passed") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_descriptor_arena_main.cpp
+ *
+ * Measures the heap allocations and walk time of the descriptor trees of End Stations enumerated
+ * together, with every descriptor, response frame and stored command response a heap block as
+ * before against the descriptor arena of each End Station. The descriptors of the End Stations are
+ * created interleaved, as their READ_DESCRIPTOR responses arrive.
+ *
+ * Usage: bench_descriptor_arena [end_stations] [descriptors] [walks]
+ */
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "descriptor_arena.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static uint64_t heap_allocations = 0;
+
+struct heap_policy
+{
+    static void * allocate(avdecc_lib::descriptor_arena &, size_t size)
+    {
+        heap_allocations++;
+        return malloc(size);
+    }
+
+    static void release(void * p)
+    {
+        free(p);
+    }
+};
+
+struct arena_policy
+{
+    static void * allocate(avdecc_lib::descriptor_arena & arena, size_t size)
+    {
+        return arena.allocate(size);
+    }
+
+    static void release(void * p)
+    {
+        avdecc_lib::descriptor_arena::release(p);
+    }
+};
+
+///
+/// A descriptor with its response frame and stored command responses, laid out as the library's.
+///
+template <class P>
+class fake_descriptor
+{
+public:
+    struct frame
+    {
+        uint8_t * buffer;
+        size_t size;
+    };
+
+    uint16_t desc_type;
+    uint16_t desc_index;
+    frame * resp;
+    std::map<uint16_t, frame *> cmd_resps;
+
+    static void * operator new(size_t size, avdecc_lib::descriptor_arena & arena)
+    {
+        return P::allocate(arena, size);
+    }
+
+    static void operator delete(void * p, avdecc_lib::descriptor_arena &)
+    {
+        P::release(p);
+    }
+
+    static void operator delete(void * p)
+    {
+        P::release(p);
+    }
+
+    fake_descriptor(avdecc_lib::descriptor_arena & arena, uint16_t type, uint16_t index) : desc_type(type), desc_index(index)
+    {
+        resp = (frame *)P::allocate(arena, sizeof(frame));
+        resp->size = 64;
+        resp->buffer = (uint8_t *)P::allocate(arena, resp->size);
+        memset(resp->buffer, type + index, resp->size);
+
+        // A GET_COUNTERS response stored for every other descriptor
+        if (index & 1)
+        {
+            frame * f = (frame *)P::allocate(arena, sizeof(frame) + 80);
+            f->buffer = (uint8_t *)(f + 1);
+            f->size = 80;
+            memset(f->buffer, index, f->size);
+            cmd_resps[0x29] = f;
+        }
+    }
+
+    virtual ~fake_descriptor()
+    {
+        for (typename std::map<uint16_t, frame *>::iterator it = cmd_resps.begin(); it != cmd_resps.end(); ++it)
+            P::release(it->second);
+        P::release(resp->buffer);
+        P::release(resp);
+    }
+
+    virtual uint32_t checksum() const
+    {
+        return desc_type + desc_index + resp->buffer[resp->size / 2];
+    }
+};
+
+template <class P>
+static void run(const char * name, uint32_t count, uint32_t descs, int walks)
+{
+    std::vector<avdecc_lib::descriptor_arena *> arenas;
+    std::vector<std::vector<fake_descriptor<P> *>> trees(count);
+    heap_allocations = 0;
+
+    for (uint32_t s = 0; s < count; s++)
+        arenas.push_back(new avdecc_lib::descriptor_arena());
+
+    // One descriptor of every End Station in turn, as the responses of a concurrent enumeration arrive
+    for (uint32_t d = 0; d < descs; d++)
+    {
+        for (uint32_t s = 0; s < count; s++)
+            trees[s].push_back(new (*arenas[s]) fake_descriptor<P>(*arenas[s], (uint16_t)(d % 26), (uint16_t)d));
+    }
+
+    uint64_t arena_blocks = 0;
+    uint64_t chunks = 0;
+    for (uint32_t s = 0; s < count; s++)
+    {
+        arena_blocks += arenas[s]->get_allocation_count();
+        chunks += arenas[s]->get_chunk_count();
+    }
+
+    // Walk every End Station model, as the CLI and applications do
+    uint64_t sum = 0;
+    bench_clock::time_point start = bench_clock::now();
+    for (int w = 0; w < walks; w++)
+    {
+        for (uint32_t s = 0; s < count; s++)
+        {
+            for (size_t d = 0; d < trees[s].size(); d++)
+                sum += trees[s][d]->checksum();
+        }
+    }
+    double walk_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / ((double)walks * count * descs);
+
+    start = bench_clock::now();
+    for (uint32_t s = 0; s < count; s++)
+    {
+        for (size_t d = 0; d < trees[s].size(); d++)
+            delete trees[s][d];
+        arenas[s]->reset();
+        delete arenas[s];
+    }
+    double free_us = std::chrono::duration<double, std::micro>(bench_clock::now() - start).count() / count;
+
+    std::cout << name << ": " << (heap_allocations + chunks) / count << " heap blocks per end station ("
+              << arena_blocks / count << " arena blocks), walk " << walk_ns << " ns per descriptor, free "
+              << free_us << " us per end station (" << (sum & 0xff) << ")" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    uint32_t count = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200;
+    uint32_t descs = (argc > 2) ? (uint32_t)atoi(argv[2]) : 2000;
+    int walks = (argc > 3) ? atoi(argv[3]) : 10;
+
+    std::cout << count << " end stations, " << descs << " descriptors each" << std::endl;
+    run<heap_policy>("heap ", count, descs, walks);
+    run<arena_policy>("arena", count, descs, walks);
+
+    return 0;
+}
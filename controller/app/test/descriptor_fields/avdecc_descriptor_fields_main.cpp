@@ -0,0 +1,143 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_descriptor_fields_main.cpp
+ *
+ * Measures the descriptor field interface of the library for EXTERNAL_PORT_INPUT descriptors.
+ * Each external_port_input_descriptor_imp is created from a READ_DESCRIPTOR response, its fields
+ * are read through descriptor_base_imp::field() for none, one in 100 or every descriptor, and it
+ * is destroyed. The field views are created on the first field() call and decode the stored
+ * frame through the layout table of the descriptor type, so the same reads are also timed
+ * through descriptor_layout_for() and descriptor_field_value() without a descriptor.
+ *
+ * Usage: bench_descriptor_fields [descriptors]
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include "enumeration.h"
+#include "descriptor_field.h"
+#include "descriptor_field_layout.h"
+#include "external_port_input_descriptor_imp.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const size_t read_desc_pos = avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
+static const size_t frame_len = read_desc_pos + JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_LEN;
+
+// A READ_DESCRIPTOR response for EXTERNAL_PORT_INPUT 0, with every field set to a distinct value
+static void make_frame(uint8_t * frame)
+{
+    memset(frame, 0, frame_len);
+    for (size_t i = read_desc_pos + 4; i < frame_len; i++)
+        frame[i] = (uint8_t)(i * 7);
+    jdksavdecc_uint16_set(avdecc_lib::AEM_DESC_EXTERNAL_PORT_INPUT, frame, avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR);
+    jdksavdecc_uint16_set(0, frame, avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR + 2);
+    jdksavdecc_uint16_set(avdecc_lib::AEM_DESC_EXTERNAL_PORT_INPUT, frame, read_desc_pos);
+}
+
+static uint32_t read_fields(const avdecc_lib::descriptor_base_imp & d)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < d.field_count(); i++)
+    {
+        avdecc_lib::descriptor_field * f = d.field(i);
+        switch (f->get_type())
+        {
+        case avdecc_lib::descriptor_field::TYPE_UINT16:
+            sum += f->get_uint16();
+            break;
+        case avdecc_lib::descriptor_field::TYPE_UINT32:
+            sum += f->get_uint32();
+            break;
+        case avdecc_lib::descriptor_field::TYPE_FLAGS16:
+        case avdecc_lib::descriptor_field::TYPE_FLAGS32:
+            sum += f->get_flags();
+            break;
+        default:
+            break;
+        }
+    }
+    return sum;
+}
+
+// Create count descriptors, read the fields of one in read_every if read_every is not 0, and destroy them
+static void run(const char * name, const uint8_t * frame, long count, long read_every)
+{
+    uint64_t sum = 0;
+    bench_clock::time_point start = bench_clock::now();
+    for (long n = 0; n < count; n++)
+    {
+        avdecc_lib::external_port_input_descriptor_imp * d =
+            new avdecc_lib::external_port_input_descriptor_imp(NULL, frame, read_desc_pos, frame_len);
+        if (read_every && n % read_every == 0)
+            sum += read_fields(*d);
+        delete d;
+    }
+    double s = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+    std::cout << name << ": " << s * 1e9 / count << " ns per descriptor (" << sum << ")" << std::endl;
+}
+
+// Read the fields of count descriptors through the layout table alone
+static void run_layout(const char * name, const uint8_t * frame, long count)
+{
+    uint64_t sum = 0;
+    bench_clock::time_point start = bench_clock::now();
+    for (long n = 0; n < count; n++)
+    {
+        const avdecc_lib::descriptor_layout * layout = avdecc_lib::descriptor_layout_for(avdecc_lib::AEM_DESC_EXTERNAL_PORT_INPUT);
+        for (uint16_t i = 0; i < layout->field_count; i++)
+            sum += avdecc_lib::descriptor_field_value(layout->fields[i], frame, read_desc_pos);
+    }
+    double s = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+    std::cout << name << ": " << s * 1e9 / count << " ns per descriptor (" << sum << ")" << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    long count = (argc > 1) ? atol(argv[1]) : 2000000;
+
+    uint8_t frame[frame_len];
+    make_frame(frame);
+
+    const avdecc_lib::descriptor_layout * layout = avdecc_lib::descriptor_layout_for(avdecc_lib::AEM_DESC_EXTERNAL_PORT_INPUT);
+    if (!layout || !avdecc_lib::descriptor_layout_fits(layout, frame_len, read_desc_pos))
+    {
+        std::cout << "No field layout for EXTERNAL_PORT_INPUT" << std::endl;
+        return 1;
+    }
+
+    std::cout << "external_port_input_descriptor_imp, " << layout->field_count << " fields" << std::endl;
+    run("  fields never read                    ", frame, count, 0);
+    run("  fields read for one descriptor in 100", frame, count, 100);
+    run("  fields read for every descriptor     ", frame, count, 1);
+    std::cout << "descriptor_field_value" << std::endl;
+    run_layout("  fields read without a descriptor     ", frame, count);
+    return 0;
+}
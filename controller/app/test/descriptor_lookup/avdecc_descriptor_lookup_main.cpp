@@ -0,0 +1,155 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_descriptor_lookup_main.cpp
+ *
+ * Measures a walk of every descriptor of a configuration_descriptor_imp through its typed
+ * accessors, against the same walk through lookup_desc() and a dynamic_cast to the public
+ * descriptor class as the accessors did before. The End Station is added by an ADP frame passed
+ * to controller_imp::rx_packet_event(), and populated from a descriptor cache file of a 32 channel
+ * stage box written to cache_dir, so the descriptors are stored by the library as when read from
+ * the network.
+ *
+ * Usage: bench_descriptor_lookup [walks] [cache_dir]
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "end_station_imp.h"
+#include "configuration_descriptor_imp.h"
+#include "test_fixture.h"
+
+static const uint64_t entity_id = UINT64_C(0x001b92fffe000001);
+static const uint64_t entity_model_id = UINT64_C(0x001b92fffe000100);
+
+#define WALK_TYPE(NAME)                                  \
+    for (size_t i = 0; i < cd->NAME##_desc_count(); i++) \
+        sum += cd->get_##NAME##_desc_by_index(i)->descriptor_index();
+
+static uint32_t walk_typed(avdecc_lib::configuration_descriptor * cd)
+{
+    uint32_t sum = 0;
+
+    WALK_TYPE(audio_unit)
+    WALK_TYPE(stream_input)
+    WALK_TYPE(stream_output)
+    WALK_TYPE(jack_input)
+    WALK_TYPE(jack_output)
+    WALK_TYPE(avb_interface)
+    WALK_TYPE(clock_source)
+    WALK_TYPE(locale)
+    WALK_TYPE(strings)
+    WALK_TYPE(stream_port_input)
+    WALK_TYPE(stream_port_output)
+    WALK_TYPE(external_port_input)
+    WALK_TYPE(external_port_output)
+    WALK_TYPE(audio_cluster)
+    WALK_TYPE(audio_map)
+    WALK_TYPE(control)
+    WALK_TYPE(clock_domain)
+    return sum;
+}
+
+#undef WALK_TYPE
+
+template <typename T>
+static uint32_t walk_cast_type(avdecc_lib::configuration_descriptor_imp * cd, uint16_t desc_type, size_t count)
+{
+    uint32_t sum = 0;
+    for (size_t i = 0; i < count; i++)
+        sum += dynamic_cast<T *>(cd->lookup_desc(desc_type, i))->descriptor_index();
+    return sum;
+}
+
+static uint32_t walk_cast(avdecc_lib::configuration_descriptor_imp * cd)
+{
+    return walk_cast_type<avdecc_lib::audio_unit_descriptor>(cd, avdecc_lib::AEM_DESC_AUDIO_UNIT, cd->audio_unit_desc_count()) +
+           walk_cast_type<avdecc_lib::stream_input_descriptor>(cd, avdecc_lib::AEM_DESC_STREAM_INPUT, cd->stream_input_desc_count()) +
+           walk_cast_type<avdecc_lib::stream_output_descriptor>(cd, avdecc_lib::AEM_DESC_STREAM_OUTPUT, cd->stream_output_desc_count()) +
+           walk_cast_type<avdecc_lib::jack_input_descriptor>(cd, avdecc_lib::AEM_DESC_JACK_INPUT, cd->jack_input_desc_count()) +
+           walk_cast_type<avdecc_lib::jack_output_descriptor>(cd, avdecc_lib::AEM_DESC_JACK_OUTPUT, cd->jack_output_desc_count()) +
+           walk_cast_type<avdecc_lib::avb_interface_descriptor>(cd, avdecc_lib::AEM_DESC_AVB_INTERFACE, cd->avb_interface_desc_count()) +
+           walk_cast_type<avdecc_lib::clock_source_descriptor>(cd, avdecc_lib::AEM_DESC_CLOCK_SOURCE, cd->clock_source_desc_count()) +
+           walk_cast_type<avdecc_lib::locale_descriptor>(cd, avdecc_lib::AEM_DESC_LOCALE, cd->locale_desc_count()) +
+           walk_cast_type<avdecc_lib::strings_descriptor>(cd, avdecc_lib::AEM_DESC_STRINGS, cd->strings_desc_count()) +
+           walk_cast_type<avdecc_lib::stream_port_input_descriptor>(cd, avdecc_lib::AEM_DESC_STREAM_PORT_INPUT, cd->stream_port_input_desc_count()) +
+           walk_cast_type<avdecc_lib::stream_port_output_descriptor>(cd, avdecc_lib::AEM_DESC_STREAM_PORT_OUTPUT, cd->stream_port_output_desc_count()) +
+           walk_cast_type<avdecc_lib::external_port_input_descriptor>(cd, avdecc_lib::AEM_DESC_EXTERNAL_PORT_INPUT, cd->external_port_input_desc_count()) +
+           walk_cast_type<avdecc_lib::external_port_output_descriptor>(cd, avdecc_lib::AEM_DESC_EXTERNAL_PORT_OUTPUT, cd->external_port_output_desc_count()) +
+           walk_cast_type<avdecc_lib::audio_cluster_descriptor>(cd, avdecc_lib::AEM_DESC_AUDIO_CLUSTER, cd->audio_cluster_desc_count()) +
+           walk_cast_type<avdecc_lib::audio_map_descriptor>(cd, avdecc_lib::AEM_DESC_AUDIO_MAP, cd->audio_map_desc_count()) +
+           walk_cast_type<avdecc_lib::control_descriptor>(cd, avdecc_lib::AEM_DESC_CONTROL, cd->control_desc_count()) +
+           walk_cast_type<avdecc_lib::clock_domain_descriptor>(cd, avdecc_lib::AEM_DESC_CLOCK_DOMAIN, cd->clock_domain_desc_count());
+}
+
+template <typename W>
+static void run(const char * name, W walk, avdecc_lib::configuration_descriptor_imp * cd, size_t descs, int walks)
+{
+    uint64_t sum = 0;
+    bench_clock::time_point start = bench_clock::now();
+    for (int w = 0; w < walks; w++)
+        sum += walk(cd);
+    double ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / ((double)walks * descs);
+
+    std::cout << name << ": " << descs << " descriptors, " << ns << " ns per descriptor (" << sum << ")" << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    int walks = (argc > 1) ? atoi(argv[1]) : 100000;
+    const char * cache_dir = (argc > 2) ? argv[2] : ".";
+
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+
+    if (!write_model_cache(controller, cache_dir, entity_model_id, make_model_frames(entity_id, entity_model_id, stage_box, stage_box_types)))
+        return 1;
+
+    rx_frame(make_adp_frame(entity_id, entity_model_id, NULL));
+    remove_model_cache(cache_dir, entity_model_id);
+
+    avdecc_lib::end_station * es = controller->get_end_station_by_index(0);
+    avdecc_lib::entity_descriptor * ed = es ? es->get_entity_desc_by_index(0) : NULL;
+    avdecc_lib::configuration_descriptor_imp * cd =
+        ed ? dynamic_cast<avdecc_lib::configuration_descriptor_imp *>(ed->get_config_desc_by_index(0)) : NULL;
+    if (!cd)
+    {
+        std::cerr << "The End Station was not populated from the descriptor cache" << std::endl;
+        return 1;
+    }
+
+    size_t descs = 0;
+    for (size_t t = 0; t < stage_box_types; t++)
+        descs += stage_box[t].count;
+
+    run("dynamic_cast", walk_cast, cd, descs, walks);
+    run("typed       ", walk_typed, cd, descs, walks);
+
+    controller->destroy();
+    netif->destroy();
+    return 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_end_station_index_main.cpp
+ *
+ * Measures the cost of finding the End Station a received packet is for, scanning the
+ * End Station list as the receive path used to against the entity id and MAC indexes, and
+ * the cost of reading the list while End Stations are being discovered, with a mutex taken
+ * by every at() as before against the lock-free snapshot reads.
+ *
+ * Usage: bench_end_station_index [lookups] [readers]
+ */
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+#include "end_stations.h"
+
+class fake_end_station
+{
+private:
+    uint64_t m_entity_id;
+    uint64_t m_mac;
+
+public:
+    fake_end_station(uint64_t entity_id, uint64_t mac) : m_entity_id(entity_id), m_mac(mac) {}
+
+    uint64_t entity_id()
+    {
+        return m_entity_id;
+    }
+
+    uint64_t mac()
+    {
+        return m_mac;
+    }
+};
+
+typedef avdecc_lib::end_station_list<fake_end_station> fake_end_stations;
+typedef std::chrono::steady_clock bench_clock;
+
+///
+/// The End Station list as it was, with every at() taking the mutex.
+///
+class locked_end_stations
+{
+private:
+    size_t m_count;
+    std::mutex locker;
+    std::vector<fake_end_station *> end_station_vec;
+
+public:
+    locked_end_stations() : m_count(0) {}
+
+    ~locked_end_stations()
+    {
+        for (size_t i = 0; i < end_station_vec.size(); i++)
+            delete end_station_vec[i];
+    }
+
+    size_t size()
+    {
+        return m_count;
+    }
+
+    fake_end_station * at(size_t i)
+    {
+        std::lock_guard<std::mutex> guard(locker);
+        return end_station_vec.at(i);
+    }
+
+    void push_back(fake_end_station * ep)
+    {
+        std::lock_guard<std::mutex> guard(locker);
+        end_station_vec.push_back(ep);
+        m_count++;
+    }
+};
+
+static bool scan_by_entity_id(fake_end_stations & list, uint64_t entity_id, uint32_t & index)
+{
+    for (uint32_t i = 0; i < list.size(); i++)
+    {
+        if (list.at(i)->entity_id() == entity_id)
+        {
+            index = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void run(uint32_t count, int lookups)
+{
+    fake_end_stations list;
+    uint32_t index = 0;
+    uint64_t found = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+        list.push_back(new fake_end_station(UINT64_C(0x001b92fffe000000) + i, UINT64_C(0x001b92000000) + i));
+
+    bench_clock::time_point start = bench_clock::now();
+    for (int i = 0; i < lookups; i++)
+    {
+        // Look up every End Station in turn, as advertisements and responses arrive from all of them
+        if (scan_by_entity_id(list, UINT64_C(0x001b92fffe000000) + (i % count), index))
+            found += index;
+    }
+    double scan_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / lookups;
+
+    start = bench_clock::now();
+    for (int i = 0; i < lookups; i++)
+    {
+        if (list.find_by_entity_id(UINT64_C(0x001b92fffe000000) + (i % count), index))
+            found += index;
+    }
+    double entity_id_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / lookups;
+
+    start = bench_clock::now();
+    for (int i = 0; i < lookups; i++)
+    {
+        if (list.find_by_mac(UINT64_C(0x001b92000000) + (i % count), index))
+            found += index;
+    }
+    double mac_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / lookups;
+
+    std::cout << count << " end stations: scan " << scan_ns << " ns, entity id index " << entity_id_ns
+              << " ns, MAC index " << mac_ns << " ns per lookup (" << found << ")" << std::endl;
+}
+
+template <typename L>
+static void run_concurrent(const char * name, int readers, uint32_t count)
+{
+    L list;
+    std::atomic<bool> discovering(true);
+    std::vector<uint64_t> reads(readers, 0);
+    std::vector<double> elapsed(readers, 0);
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; r++)
+    {
+        threads.push_back(std::thread([&, r]() {
+            uint64_t n = 0;
+            uint64_t sum = 0;
+            bench_clock::time_point start = bench_clock::now();
+
+            // Walk the whole list the way the CLI and applications do, until discovery ends
+            while (discovering.load())
+            {
+                for (size_t i = 0; i < list.size(); i++)
+                {
+                    sum += list.at(i)->entity_id();
+                    n++;
+                }
+            }
+
+            elapsed[r] = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+            reads[r] = n + (sum & 1);
+        }));
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        list.push_back(new fake_end_station(UINT64_C(0x001b92fffe000000) + i, UINT64_C(0x001b92000000) + i));
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    discovering.store(false);
+
+    double ns = 0;
+    uint64_t total = 0;
+    for (int r = 0; r < readers; r++)
+    {
+        threads[r].join();
+        ns += elapsed[r];
+        total += reads[r];
+    }
+
+    std::cout << name << ": " << readers << " readers during discovery of " << count << " end stations, "
+              << (total ? ns / total : 0) << " ns per at()" << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    int lookups = argc > 1 ? atoi(argv[1]) : 100000;
+    int readers = argc > 2 ? atoi(argv[2]) : 2;
+
+    if (lookups < 1 || readers < 1)
+    {
+        std::cout << "Usage: " << argv[0] << " [lookups] [readers]" << std::endl;
+        return 1;
+    }
+
+    run(10, lookups);
+    run(100, lookups);
+    run(1000, lookups);
+    run(5000, lookups);
+
+    run_concurrent<locked_end_stations>("mutex", readers, 2000);
+    run_concurrent<fake_end_stations>("snapshot", readers, 2000);
+
+    return 0;
+}
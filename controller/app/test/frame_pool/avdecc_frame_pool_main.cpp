@@ -0,0 +1,136 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_frame_pool_main.cpp
+ *
+ * Measures the descriptor frame memory of End Stations of one entity model, each holding its own
+ * copy of every frame as before against the frames shared through the frame pool. Every End Station
+ * has its own entity name, and every other one its own stream format.
+ *
+ * Usage: bench_frame_pool [end_stations]
+ */
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include "frame_pool.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const size_t header_len = 14 + 28; // Ethernet header and READ_DESCRIPTOR response up to the descriptor
+
+struct model_desc
+{
+    uint16_t type;
+    uint16_t count;
+    uint16_t len; // Descriptor length in bytes
+};
+
+// A 32 channel stage box
+static const model_desc stage_box[] = {
+    {0x0000, 1, 312},  // ENTITY
+    {0x0001, 1, 122},  // CONFIGURATION
+    {0x0002, 1, 164},  // AUDIO_UNIT
+    {0x0005, 2, 168},  // STREAM_INPUT
+    {0x0006, 2, 168},  // STREAM_OUTPUT
+    {0x0007, 32, 74},  // JACK_INPUT
+    {0x0008, 32, 74},  // JACK_OUTPUT
+    {0x0009, 2, 98},   // AVB_INTERFACE
+    {0x000a, 3, 86},   // CLOCK_SOURCE
+    {0x000c, 1, 72},   // LOCALE
+    {0x000d, 2, 452},  // STRINGS
+    {0x000e, 2, 20},   // STREAM_PORT_INPUT
+    {0x000f, 2, 20},   // STREAM_PORT_OUTPUT
+    {0x0010, 32, 22},  // EXTERNAL_PORT_INPUT
+    {0x0011, 32, 22},  // EXTERNAL_PORT_OUTPUT
+    {0x0014, 64, 83},  // AUDIO_CLUSTER
+    {0x0016, 4, 108},  // AUDIO_MAP
+    {0x0018, 1, 76},   // CLOCK_DOMAIN
+    {0x001a, 16, 104}, // CONTROL
+};
+
+static std::vector<uint8_t> make_frame(uint32_t station, uint16_t type, uint16_t index, uint16_t len, bool own_format)
+{
+    std::vector<uint8_t> frame(header_len + len, 0);
+
+    // Addresses and sequence id differ in every response
+    for (size_t i = 0; i < header_len; i++)
+        frame[i] = (uint8_t)(station * 31 + index * 7 + i);
+
+    uint8_t * desc = &frame[header_len];
+    desc[0] = (uint8_t)(type >> 8);
+    desc[1] = (uint8_t)type;
+    desc[2] = (uint8_t)(index >> 8);
+    desc[3] = (uint8_t)index;
+    for (size_t i = 4; i < len; i++)
+        desc[i] = (uint8_t)(type * 13 + index * 3 + i);
+
+    if (type == 0x0000)
+        snprintf((char *)desc + 28, 64, "Stage box %u", station); // Entity name
+    else if ((type == 0x0005 || type == 0x0006) && own_format)
+        desc[132] ^= 0xff; // Current format
+
+    return frame;
+}
+
+int main(int argc, char ** argv)
+{
+    uint32_t count = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200;
+    avdecc_lib::frame_pool pool;
+    std::vector<std::shared_ptr<const avdecc_lib::shared_frame>> held;
+    uint64_t copied_bytes = 0;
+    uint64_t frames = 0;
+
+    bench_clock::time_point start = bench_clock::now();
+    for (uint32_t s = 0; s < count; s++)
+    {
+        for (size_t d = 0; d < sizeof(stage_box) / sizeof(stage_box[0]); d++)
+        {
+            for (uint16_t i = 0; i < stage_box[d].count; i++)
+            {
+                std::vector<uint8_t> frame = make_frame(s, stage_box[d].type, i, stage_box[d].len, (s & 1) != 0);
+                held.push_back(pool.intern(frame.data(), frame.size(), header_len));
+                copied_bytes += frame.size();
+                frames++;
+            }
+        }
+    }
+    double intern_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / frames;
+
+    std::cout << count << " end stations, " << frames / count << " descriptors each" << std::endl;
+    std::cout << "Own copies:    " << copied_bytes / count << " bytes of descriptor frames per end station" << std::endl;
+    std::cout << "Shared frames: " << pool.get_stored_bytes() / count << " bytes per end station, "
+              << pool.get_stored_bytes() << " bytes in total for " << pool.get_referenced_bytes() << " referenced" << std::endl;
+    std::cout << "Intern: " << intern_ns << " ns per frame" << std::endl;
+
+    for (size_t i = 0; i < held.size(); i++)
+        pool.unreference(*held[i]);
+    held.clear();
+    std::cout << "Released: " << pool.get_stored_bytes() << " bytes stored, " << pool.get_referenced_bytes() << " referenced" << std::endl;
+
+    return 0;
+}
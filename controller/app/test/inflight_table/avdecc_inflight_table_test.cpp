@@ -0,0 +1,163 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_inflight_table_test.cpp
+ *
+ * Checks the lookup of inflight commands by sequence id and by notification id in
+ * inflight_table, across the wraparound of the 16 bit AECP sequence id.
+ *
+ * Usage: test_inflight_table
+ */
+
+#include <iostream>
+#include <stdint.h>
+#include <cstring>
+#include "jdksavdecc_frame.h"
+#include "inflight.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do                                                                               \
+    {                                                                                \
+        if (!(cond))                                                                 \
+        {                                                                            \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; \
+            failures++;                                                              \
+        }                                                                            \
+    } while (0)
+
+static char handle_a;
+static char handle_b;
+
+// The frame length tells apart commands sent with the same sequence id
+static avdecc_lib::inflight make_cmd(uint16_t seq_id, void * notification_id, uint16_t length)
+{
+    struct jdksavdecc_frame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.length = length;
+
+    return avdecc_lib::inflight(&frame, seq_id, notification_id, avdecc_lib::CMD_WITH_NOTIFICATION, 250);
+}
+
+static bool is_cmd(avdecc_lib::inflight * cmd, uint16_t seq_id, uint16_t length)
+{
+    return cmd && cmd->cmd_seq_id == seq_id && cmd->frame().length == length;
+}
+
+static void test_wraparound()
+{
+    avdecc_lib::inflight_table table;
+    const uint16_t seq_ids[] = {65534, 65535, 0, 1};
+
+    for (size_t i = 0; i < 4; i++)
+        table.insert(make_cmd(seq_ids[i], &handle_a, (uint16_t)(100 + i)));
+    CHECK(table.size() == 4);
+    for (size_t i = 0; i < 4; i++)
+        CHECK(is_cmd(table.find(seq_ids[i]), seq_ids[i], (uint16_t)(100 + i)));
+    CHECK(table.find(2) == NULL);
+    CHECK(table.find(65533) == NULL);
+
+    // Erasing the first command moves the last one into its place
+    table.erase(65534);
+    CHECK(table.size() == 3);
+    CHECK(table.find(65534) == NULL);
+    CHECK(is_cmd(table.find(65535), 65535, 101));
+    CHECK(is_cmd(table.find(0), 0, 102));
+    CHECK(is_cmd(table.find(1), 1, 103));
+
+    // Erasing a sequence id that is not inflight changes nothing
+    table.erase(65534);
+    table.erase(2);
+    CHECK(table.size() == 3);
+
+    table.erase(1);
+    table.erase(0);
+    table.erase(65535);
+    CHECK(table.size() == 0);
+    CHECK(!table.has_notification_id(&handle_a));
+}
+
+static void test_reuse()
+{
+    avdecc_lib::inflight_table table;
+
+    table.insert(make_cmd(65535, &handle_a, 1));
+    table.insert(make_cmd(0, &handle_b, 2));
+
+    // A sequence id reused after the wraparound replaces the command still inflight with it
+    table.insert(make_cmd(65535, &handle_b, 3));
+    CHECK(table.size() == 2);
+    CHECK(is_cmd(table.find(65535), 65535, 3));
+    CHECK(is_cmd(table.find(0), 0, 2));
+    CHECK(!table.has_notification_id(&handle_a));
+    CHECK(table.has_notification_id(&handle_b));
+
+    table.erase(0);
+    CHECK(table.has_notification_id(&handle_b));
+    table.erase(65535);
+    CHECK(!table.has_notification_id(&handle_b));
+    CHECK(table.size() == 0);
+}
+
+static void test_rolling_window()
+{
+    avdecc_lib::inflight_table table;
+    const uint32_t window = 8;
+    const uint32_t sends = 70000;
+
+    // A window of commands moving through the sequence ids past the wraparound
+    for (uint32_t n = 0; n < sends; n++)
+    {
+        uint16_t seq_id = (uint16_t)n;
+        table.insert(make_cmd(seq_id, (n & 1) ? &handle_b : &handle_a, (uint16_t)(n >> 16)));
+        if (n >= window)
+            table.erase((uint16_t)(n - window));
+
+        CHECK(table.size() == (n < window ? n + 1 : window));
+        CHECK(is_cmd(table.find(seq_id), seq_id, (uint16_t)(n >> 16)));
+    }
+
+    for (uint32_t n = sends - window; n < sends; n++)
+        CHECK(is_cmd(table.find((uint16_t)n), (uint16_t)n, (uint16_t)(n >> 16)));
+    CHECK(table.find((uint16_t)(sends - window - 1)) == NULL);
+    CHECK(table.has_notification_id(&handle_a));
+    CHECK(table.has_notification_id(&handle_b));
+
+    for (uint32_t n = sends - window; n < sends; n++)
+        table.erase((uint16_t)n);
+    CHECK(table.size() == 0);
+    CHECK(!table.has_notification_id(&handle_a));
+    CHECK(!table.has_notification_id(&handle_b));
+}
+
+int main()
+{
+    test_wraparound();
+    test_reuse();
+    test_rolling_window();
+
+    std::cout << (failures ? "FAILED" : "passed") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_rx_ring_main.cpp
+ *
+ * Compare AVDECC frame capture throughput and CPU cost between read(), batched
+ * recvmmsg() and the memory mapped TPACKET_V3 receive ring.
+ *
+ * Usage: bench_rx_ring <interface number> <read|batch|ring> [seconds] [batch size]
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <time.h>
+#include "net_interface_imp.h"
+
+static double elapsed_s(const struct timespec & start, const struct timespec & end)
+{
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+static double cpu_s(const struct rusage & usage)
+{
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+int main(int argc, char * argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <interface number> <read|batch|ring> [seconds] [batch size]" << std::endl;
+        return 1;
+    }
+
+    uint32_t interface_num = (uint32_t)atoi(argv[1]);
+    bool use_ring = strcmp(argv[2], "ring") == 0;
+    bool use_batch = strcmp(argv[2], "batch") == 0;
+    int seconds = argc > 3 ? atoi(argv[3]) : 10;
+
+    avdecc_lib::net_interface_imp * netif = dynamic_cast<avdecc_lib::net_interface_imp *>(avdecc_lib::create_net_interface());
+    if (!netif || interface_num < 1 || interface_num > netif->devs_count())
+    {
+        std::cout << "Invalid interface number" << std::endl;
+        return 1;
+    }
+
+    netif->set_rx_ring_enabled(use_ring);
+    if (use_batch)
+        netif->set_rx_batch_size(argc > 4 ? (uint32_t)atoi(argv[4]) : netif->rx_batch_size());
+    else
+        netif->set_rx_batch_size(1);
+    netif->select_interface_by_num(interface_num);
+    if (use_ring && !netif->rx_ring_enabled())
+        std::cout << "Receive ring unavailable, measuring read()" << std::endl;
+
+    int epollfd = epoll_create(1);
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = netif->get_fd();
+    epoll_ctl(epollfd, EPOLL_CTL_ADD, netif->get_fd(), &ev);
+
+    std::vector<const uint8_t *> batch_frames(netif->rx_batch_size());
+    std::vector<uint16_t> batch_lengths(netif->rx_batch_size());
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t wakeups = 0;
+    struct timespec start, now;
+    struct rusage usage_start, usage_end;
+
+    getrusage(RUSAGE_SELF, &usage_start);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    now = start;
+
+    while (elapsed_s(start, now) < seconds)
+    {
+        struct epoll_event events[1];
+        int n = epoll_wait(epollfd, events, 1, 100);
+        if (n > 0)
+        {
+            const uint8_t * frame;
+            uint16_t length;
+
+            wakeups++;
+            if (!netif->rx_ring_enabled() && netif->rx_batch_size() > 1)
+            {
+                int count;
+                while ((count = netif->capture_frame_batch(&batch_frames[0], &batch_lengths[0])) > 0)
+                {
+                    for (int i = 0; i < count; i++)
+                        bytes += batch_lengths[i];
+                    frames += count;
+                    if ((uint32_t)count < netif->rx_batch_size())
+                        break;
+                }
+            }
+            else
+            {
+                while (netif->capture_frame(&frame, &length) > 0)
+                {
+                    frames++;
+                    bytes += length;
+                    if (!netif->rx_ring_enabled())
+                        break;
+                }
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+
+    getrusage(RUSAGE_SELF, &usage_end);
+    double wall = elapsed_s(start, now);
+    double cpu = cpu_s(usage_end) - cpu_s(usage_start);
+
+    const char * mode = netif->rx_ring_enabled() ? "ring" : (netif->rx_batch_size() > 1 ? "batch" : "read");
+    std::cout << mode << ": "
+              << frames << " frames, " << bytes << " bytes, " << wakeups << " wakeups in " << wall << " s" << std::endl;
+    std::cout << "  " << frames / wall << " frames/s, "
+              << (wakeups ? (double)frames / wakeups : 0.0) << " frames/wakeup, "
+              << 100.0 * cpu / wall << " % CPU, "
+              << (frames ? 1e6 * cpu / frames : 0.0) << " us CPU/frame" << std::endl;
+
+    if (!netif->rx_ring_enabled() && netif->rx_batch_size() > 1)
+    {
+        struct avdecc_lib::frame_batch_stats stats;
+        netif->get_rx_batch_stats(stats);
+        std::cout << "  " << stats.batches << " batches, max " << stats.max << " frames/batch" << std::endl;
+        for (int i = 0; i < avdecc_lib::frame_batch_stats::HISTOGRAM_BINS; i++)
+        {
+            if (stats.histogram[i])
+                std::cout << "    " << (1 << i) << "-" << (2 << i) - 1 << " frames: " << stats.histogram[i] << std::endl;
+        }
+    }
+
+    close(epollfd);
+    netif->destroy();
+    return 0;
+}
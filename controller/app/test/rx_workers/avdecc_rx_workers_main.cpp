@@ -0,0 +1,380 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_rx_workers_main.cpp
+ *
+ * Measures how fast many End Stations enumerating together are read, through the controller and
+ * system_layer2_multithreaded_callback on the loopback interface, with the received frames
+ * processed by the system thread alone against a number of RX workers. Responder threads with
+ * raw sockets of their own on the interface stand for the End Stations, announcing them by ADP and
+ * answering their READ_DESCRIPTOR commands at once. Every End Station has one CONFIGURATION holding
+ * STREAM_INPUT, STREAM_OUTPUT and AUDIO_CLUSTER descriptors. The controller captures frames from its
+ * receive ring, and a run fails unless every End Station completes its enumeration. Each worker
+ * count is run in a process of its own, so that it starts with no End Stations.
+ *
+ * Needs the privileges to open a raw socket.
+ *
+ * Usage: bench_rx_workers [end stations] [descriptors per type] [max workers] [responder threads]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include "system.h"
+#include "end_station.h"
+#include "test_fixture.h"
+
+static const uint64_t base_entity_id = UINT64_C(0x001b92fffe000000);
+static const uint64_t entity_model_id = UINT64_C(0x001b92fffe000100);
+static const uint16_t stream_formats = 4;
+
+static const uint16_t config_desc_types[] = {JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                                             JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT,
+                                             JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER};
+
+static void entity_mac(uint32_t entity, uint8_t * mac)
+{
+    static const uint8_t oui[3] = {0x00, 0x1b, 0x92};
+    memcpy(mac, oui, sizeof(oui));
+    mac[3] = (uint8_t)(entity >> 16);
+    mac[4] = (uint8_t)(entity >> 8);
+    mac[5] = (uint8_t)entity;
+}
+
+// Append the descriptor a READ_DESCRIPTOR command asks for to its response, or return false if the End Station has none
+static bool append_desc(std::vector<uint8_t> & frame, uint64_t entity_id, uint16_t desc_type, uint16_t desc_index, uint16_t per_type)
+{
+    size_t desc_len;
+    switch (desc_type)
+    {
+    case JDKSAVDECC_DESCRIPTOR_ENTITY:
+        desc_len = JDKSAVDECC_DESCRIPTOR_ENTITY_LEN;
+        break;
+    case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
+        desc_len = JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN + sizeof(config_desc_types) * 2;
+        break;
+    case JDKSAVDECC_DESCRIPTOR_STREAM_INPUT:
+    case JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT:
+        desc_len = JDKSAVDECC_DESCRIPTOR_STREAM_LEN + stream_formats * 8;
+        break;
+    case JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER:
+        desc_len = JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_LEN;
+        break;
+    default:
+        return false;
+    }
+    if (desc_index >= ((desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY || desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION) ? 1 : per_type))
+        return false;
+
+    frame.resize(read_desc_pos);
+    frame.resize(read_desc_pos + desc_len, 0);
+    uint8_t * desc = &frame[read_desc_pos];
+    jdksavdecc_uint16_set(desc_type, desc, 0);
+    jdksavdecc_uint16_set(desc_index, desc, 2);
+    if (desc_type != JDKSAVDECC_DESCRIPTOR_ENTITY)
+        snprintf((char *)desc + 4, 64, "Descriptor %u.%u", desc_type, desc_index); // The object name
+
+    switch (desc_type)
+    {
+    case JDKSAVDECC_DESCRIPTOR_ENTITY:
+        jdksavdecc_uint64_set(entity_id, desc, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_ID);
+        jdksavdecc_uint64_set(entity_model_id, desc, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_MODEL_ID);
+        jdksavdecc_uint16_set(1, desc, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_CONFIGURATIONS_COUNT);
+        break;
+    case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
+        jdksavdecc_uint16_set(sizeof(config_desc_types) / sizeof(config_desc_types[0]), desc, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_DESCRIPTOR_COUNTS_COUNT);
+        jdksavdecc_uint16_set(JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN, desc, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_DESCRIPTOR_COUNTS_OFFSET);
+        for (size_t i = 0; i < sizeof(config_desc_types) / sizeof(config_desc_types[0]); i++)
+        {
+            jdksavdecc_uint16_set(config_desc_types[i], desc, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN + i * 4);
+            jdksavdecc_uint16_set(per_type, desc, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN + i * 4 + 2);
+        }
+        break;
+    case JDKSAVDECC_DESCRIPTOR_STREAM_INPUT:
+    case JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT:
+        jdksavdecc_uint16_set(JDKSAVDECC_DESCRIPTOR_STREAM_LEN, desc, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_FORMATS_OFFSET);
+        jdksavdecc_uint16_set(stream_formats, desc, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_NUMBER_OF_FORMATS);
+        for (uint16_t i = 0; i < stream_formats; i++)
+            jdksavdecc_uint64_set(UINT64_C(0x00a0020840000800) + i, desc, JDKSAVDECC_DESCRIPTOR_STREAM_LEN + i * 8);
+        break;
+    case JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER:
+        jdksavdecc_uint16_set(2, desc, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_CHANNEL_COUNT);
+        break;
+    }
+    return true;
+}
+
+// Announces a share of the End Stations and answers their READ_DESCRIPTOR commands at once
+class responder
+{
+private:
+    int sock;
+    int ifindex;
+    uint32_t entities;
+    uint32_t share;
+    uint32_t shares;
+    uint16_t per_type;
+    std::atomic<bool> stop;
+    std::thread thread;
+
+    void send(const std::vector<uint8_t> & frame)
+    {
+        struct sockaddr_ll addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sll_family = AF_PACKET;
+        addr.sll_ifindex = ifindex;
+        addr.sll_halen = ETH_ALEN;
+        memcpy(addr.sll_addr, &frame[0], ETH_ALEN);
+        sendto(sock, frame.data(), frame.size(), 0, (struct sockaddr *)&addr, sizeof(addr));
+    }
+
+    void rx(const uint8_t * frame, size_t len, std::vector<uint8_t> & resp)
+    {
+        const uint8_t * pdu = frame + avdecc_lib::ETHER_HDR_SIZE;
+        if (len < avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_LEN ||
+            jdksavdecc_uint16_get(frame, 12) != JDKSAVDECC_AVTP_ETHERTYPE ||
+            pdu[0] != (0x80 | JDKSAVDECC_SUBTYPE_AECP) ||
+            (pdu[1] & 0x0f) != JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND ||
+            jdksavdecc_aecpdu_aem_get_command_type(frame, avdecc_lib::ETHER_HDR_SIZE) != JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR)
+            return;
+
+        uint64_t entity_id = jdksavdecc_uint64_get(pdu, 4);
+        uint64_t entity = entity_id - base_entity_id;
+        if (entity_id <= base_entity_id || entity > entities || entity % shares != share)
+            return;
+
+        resp.assign(frame, frame + read_desc_pos);
+        if (!append_desc(resp, entity_id,
+                         jdksavdecc_uint16_get(pdu, JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_TYPE),
+                         jdksavdecc_uint16_get(pdu, JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_COMMAND_OFFSET_DESCRIPTOR_INDEX),
+                         per_type))
+            return;
+
+        memcpy(&resp[0], frame + 6, 6);
+        entity_mac((uint32_t)entity, &resp[6]);
+        uint8_t * resp_pdu = &resp[avdecc_lib::ETHER_HDR_SIZE];
+        resp_pdu[1] = (pdu[1] & 0xf0) | JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE;
+        jdksavdecc_uint16_set((uint16_t)(resp.size() - avdecc_lib::ETHER_HDR_SIZE - JDKSAVDECC_COMMON_CONTROL_HEADER_LEN), resp_pdu, 2); // SUCCESS
+        send(resp);
+    }
+
+    void run()
+    {
+        std::vector<std::vector<uint8_t>> adp;
+        for (uint32_t entity = 1; entity <= entities; entity++)
+        {
+            if (entity % shares == share)
+            {
+                uint8_t mac[6];
+                entity_mac(entity, mac);
+                adp.push_back(make_adp_frame(base_entity_id + entity, entity_model_id, mac));
+            }
+        }
+
+        bench_clock::time_point next_adp = bench_clock::now();
+        size_t next_adp_entity = 0;
+        std::vector<uint8_t> resp;
+        uint8_t buf[1600];
+
+        while (!stop.load())
+        {
+            // A few End Stations are announced at a time, as a burst of every announcement would
+            // overflow the receive buffer of the controller socket
+            if (bench_clock::now() >= next_adp)
+            {
+                for (size_t i = 0; i < 16 && next_adp_entity < adp.size(); i++)
+                    send(adp[next_adp_entity++]);
+                if (next_adp_entity < adp.size())
+                {
+                    next_adp = bench_clock::now() + std::chrono::milliseconds(1);
+                }
+                else
+                {
+                    next_adp_entity = 0;
+                    next_adp = bench_clock::now() + std::chrono::seconds(2);
+                }
+            }
+
+            struct pollfd pfd = {sock, POLLIN, 0};
+            if (poll(&pfd, 1, 1) <= 0)
+                continue;
+
+            struct sockaddr_ll from;
+            socklen_t from_len = sizeof(from);
+            ssize_t len;
+            while ((len = recvfrom(sock, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len)) > 0)
+            {
+                // The interface passes every frame sent on it to the raw sockets twice
+                if (from.sll_pkttype != PACKET_OUTGOING)
+                    rx(buf, (size_t)len, resp);
+                from_len = sizeof(from);
+            }
+        }
+    }
+
+public:
+    responder(const char * ifname, uint32_t entities, uint32_t share, uint32_t shares, uint16_t per_type)
+        : sock(-1), entities(entities), share(share), shares(shares), per_type(per_type), stop(false)
+    {
+        ifindex = if_nametoindex(ifname);
+        sock = socket(AF_PACKET, SOCK_RAW, htons(JDKSAVDECC_AVTP_ETHERTYPE));
+        if (sock < 0 || !ifindex)
+            return;
+
+        int rcvbuf = 4 << 20;
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        struct sockaddr_ll addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sll_family = AF_PACKET;
+        addr.sll_ifindex = ifindex;
+        addr.sll_protocol = htons(JDKSAVDECC_AVTP_ETHERTYPE);
+        bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+        thread = std::thread(&responder::run, this);
+    }
+
+    ~responder()
+    {
+        stop.store(true);
+        if (thread.joinable())
+            thread.join();
+        if (sock >= 0)
+            close(sock);
+    }
+
+    bool is_open() const
+    {
+        return sock >= 0 && ifindex;
+    }
+};
+
+// Enumerate every End Station with the given number of RX workers, and print the rate the descriptors were read at
+static int run(uint32_t workers, uint32_t entities, uint16_t per_type, uint32_t responders)
+{
+    avdecc_lib::net_interface * netif = avdecc_lib::create_net_interface();
+    uint32_t interface_num = loopback_interface_num(netif);
+    if (!interface_num)
+    {
+        std::cerr << "No loopback interface" << std::endl;
+        return 1;
+    }
+
+    // The receive ring holds bursts of responses that the default socket receive buffer would drop
+    netif->set_rx_ring_enabled(true);
+    netif->select_interface_by_num(interface_num);
+    avdecc_lib::controller * controller = avdecc_lib::create_controller(netif, notification_callback, acmp_notification_callback,
+                                                                        log_callback, avdecc_lib::LOGGING_LEVEL_ERROR);
+    // Every End Station keeps its AECP window of reads inflight, so that the rate is set by how fast the frames are processed
+    controller->set_enumeration_max_inflight(entities * avdecc_lib::AECP_DEFAULT_WINDOW);
+    avdecc_lib::system * sys = avdecc_lib::create_system(avdecc_lib::system::LAYER2_MULTITHREADED_CALLBACK, netif, controller);
+    if (workers && sys->set_rx_worker_count(workers) != 0)
+    {
+        std::cerr << "RX workers are not supported" << std::endl;
+        return 1;
+    }
+    sys->process_start();
+
+    bench_clock::time_point start = bench_clock::now();
+    std::vector<responder *> r;
+    for (uint32_t i = 0; i < responders; i++)
+        r.push_back(new responder("lo", entities, i, responders, per_type));
+
+    bool open = r[0]->is_open();
+    uint32_t enumerated = 0;
+    uint64_t descriptors = 0;
+    while (open && enumerated < entities && bench_clock::now() - start < std::chrono::seconds(60))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        enumerated = 0;
+        descriptors = 0;
+        for (uint32_t i = 0; i < controller->get_end_station_count(); i++)
+        {
+            avdecc_lib::end_station * es = controller->get_end_station_by_index(i);
+            if (es->get_enumeration_time_ms())
+            {
+                enumerated++;
+                descriptors += es->get_background_reads_completed();
+            }
+        }
+    }
+    double s = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+    for (uint32_t i = 0; i < responders; i++)
+        delete r[i];
+    sys->process_close();
+    sys->destroy();
+    controller->destroy();
+    netif->destroy();
+
+    if (!open)
+    {
+        std::cerr << "Cannot open a raw socket on the loopback interface" << std::endl;
+        return 1;
+    }
+
+    std::string name = workers ? std::to_string(workers) + " RX workers" : "system thread";
+    std::cout << name << ": " << (uint64_t)(descriptors / s) << " descriptors/s, "
+              << enumerated << " of " << entities << " End Stations enumerated in " << (uint64_t)(s * 1000) << " ms" << std::endl;
+    return enumerated == entities ? 0 : 1;
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t entities = (argc > 1) ? (uint32_t)atol(argv[1]) : 256;
+    uint16_t per_type = (argc > 2) ? (uint16_t)atol(argv[2]) : 32;
+    uint32_t max_workers = (argc > 3) ? (uint32_t)atol(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    uint32_t responders = (argc > 4) ? std::max(1L, atol(argv[4])) : 2;
+    int result = 0;
+
+    std::cout << entities << " End Stations, " << per_type << " descriptors per type, "
+              << std::thread::hardware_concurrency() << " cores" << std::endl;
+
+    for (uint32_t workers = 0; workers <= max_workers; workers = workers ? workers * 2 : 1)
+    {
+        // A process per run, as the system and its End Stations are created once per process
+        pid_t pid = fork();
+        if (pid == 0)
+            return run(workers, entities, per_type, responders);
+
+        int status = 1;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            result = 1;
+    }
+    return result;
+}
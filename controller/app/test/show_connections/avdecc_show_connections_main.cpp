@@ -0,0 +1,295 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_show_connections_main.cpp
+ *
+ * Measures the show connections walk over the GET_RX_STATE and GET_TX_STATE responses of every
+ * End Station. The walk through heap allocated response classes, one pair allocated and deleted
+ * for every stream input and stream output compared, is measured against the same walk through
+ * response views, and against the views with the stream outputs indexed by stream id.
+ *
+ * Usage: bench_show_connections [end_stations]
+ */
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include "stream_input_get_rx_state_response.h"
+#include "stream_output_get_tx_state_response.h"
+#include "response_views.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const size_t ether_hdr_len = 14;
+static const size_t acmpdu_len = 56;
+static const uint32_t streams_per_station = 2;
+
+static uint64_t get_u64(const uint8_t * p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+static uint16_t get_u16(const uint8_t * p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void set_u64(uint8_t * p, uint64_t v)
+{
+    for (int i = 7; i >= 0; i--, v >>= 8)
+        p[i] = (uint8_t)v;
+}
+
+static void set_u16(uint8_t * p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+///
+/// The response classes as returned before the views, holding a heap copy of the frame.
+///
+class heap_rx_state_response : public avdecc_lib::stream_input_get_rx_state_response
+{
+private:
+    uint8_t * m_frame;
+    size_t m_position;
+
+public:
+    heap_rx_state_response(const uint8_t * frame, size_t frame_len, size_t pos) : m_position(pos)
+    {
+        m_frame = (uint8_t *)malloc(frame_len);
+        memcpy(m_frame, frame, frame_len);
+    }
+    virtual ~heap_rx_state_response() { free(m_frame); }
+
+    uint64_t STDCALL get_rx_state_stream_id() { return get_u64(&m_frame[m_position + 4]); }
+    uint64_t STDCALL get_rx_state_talker_entity_id() { return get_u64(&m_frame[m_position + 20]); }
+    uint16_t STDCALL get_rx_state_talker_unique_id() { return get_u16(&m_frame[m_position + 36]); }
+    uint64_t STDCALL get_rx_state_listener_entity_id() { return get_u64(&m_frame[m_position + 28]); }
+    uint16_t STDCALL get_rx_state_listener_unique_id() { return get_u16(&m_frame[m_position + 38]); }
+    uint64_t STDCALL get_rx_state_stream_dest_mac() { return get_u64(&m_frame[m_position + 40]) >> 16; }
+    uint16_t STDCALL get_rx_state_connection_count() { return get_u16(&m_frame[m_position + 46]); }
+    uint16_t STDCALL get_rx_state_flags() { return get_u16(&m_frame[m_position + 50]); }
+    uint16_t STDCALL get_rx_state_stream_vlan_id() { return get_u16(&m_frame[m_position + 52]); }
+};
+
+class heap_tx_state_response : public avdecc_lib::stream_output_get_tx_state_response
+{
+private:
+    uint8_t * m_frame;
+    size_t m_position;
+
+public:
+    heap_tx_state_response(const uint8_t * frame, size_t frame_len, size_t pos) : m_position(pos)
+    {
+        m_frame = (uint8_t *)malloc(frame_len);
+        memcpy(m_frame, frame, frame_len);
+    }
+    virtual ~heap_tx_state_response() { free(m_frame); }
+
+    uint64_t STDCALL get_tx_state_stream_id() { return get_u64(&m_frame[m_position + 4]); }
+    uint64_t STDCALL get_tx_state_stream_dest_mac() { return get_u64(&m_frame[m_position + 40]) >> 16; }
+    uint16_t STDCALL get_tx_state_connection_count() { return get_u16(&m_frame[m_position + 46]); }
+    uint16_t STDCALL get_tx_state_stream_vlan_id() { return get_u16(&m_frame[m_position + 52]); }
+};
+
+///
+/// The stored responses of one End Station.
+///
+struct station
+{
+    uint64_t entity_id;
+    std::vector<std::vector<uint8_t>> rx_state; // One GET_RX_STATE response per stream input
+    std::vector<std::vector<uint8_t>> tx_state; // One GET_TX_STATE response per stream output
+};
+
+static std::vector<uint8_t> make_state_frame(uint64_t stream_id, uint16_t connection_count)
+{
+    std::vector<uint8_t> frame(ether_hdr_len + acmpdu_len, 0);
+    uint8_t * pdu = &frame[ether_hdr_len];
+
+    pdu[0] = 0xfc; // ACMP subtype
+    set_u16(&pdu[2], acmpdu_len - 12);
+    set_u64(&pdu[4], stream_id);
+    set_u16(&pdu[46], connection_count);
+    return frame;
+}
+
+///
+/// Every End Station talks on all its stream outputs, and every other End Station listens to the
+/// stream outputs of the End Station that follows it.
+///
+static std::vector<station> make_stations(uint32_t count)
+{
+    std::vector<station> stations(count);
+
+    for (uint32_t i = 0; i < count; i++)
+        stations[i].entity_id = 0x001b920000000000ULL + i;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t s = 0; s < streams_per_station; s++)
+        {
+            uint64_t own_stream_id = (stations[i].entity_id << 16) | s;
+            uint64_t talker_stream_id = ((stations[(i + 1) % count].entity_id) << 16) | s;
+            bool listening = (i % 2) == 0;
+
+            stations[i].tx_state.push_back(make_state_frame(own_stream_id, 1));
+            stations[i].rx_state.push_back(make_state_frame(listening ? talker_stream_id : 0, listening ? 1 : 0));
+        }
+    }
+    return stations;
+}
+
+static uint32_t walk_heap(const std::vector<station> & stations)
+{
+    uint32_t found = 0;
+
+    for (size_t in_index = 0; in_index < stations.size(); in_index++)
+    {
+        for (size_t in_stream_index = 0; in_stream_index < stations[in_index].rx_state.size(); in_stream_index++)
+        {
+            const std::vector<uint8_t> & rx = stations[in_index].rx_state[in_stream_index];
+            avdecc_lib::stream_input_get_rx_state_response * rx_resp = new heap_rx_state_response(rx.data(), rx.size(), ether_hdr_len);
+            if (!rx_resp->get_rx_state_connection_count())
+            {
+                delete rx_resp;
+                continue;
+            }
+            delete rx_resp;
+
+            for (size_t out_index = 0; out_index < stations.size(); out_index++)
+            {
+                for (size_t out_stream_index = 0; out_stream_index < stations[out_index].tx_state.size(); out_stream_index++)
+                {
+                    const std::vector<uint8_t> & tx = stations[out_index].tx_state[out_stream_index];
+                    rx_resp = new heap_rx_state_response(rx.data(), rx.size(), ether_hdr_len);
+                    avdecc_lib::stream_output_get_tx_state_response * tx_resp = new heap_tx_state_response(tx.data(), tx.size(), ether_hdr_len);
+                    if (tx_resp->get_tx_state_connection_count() &&
+                        (rx_resp->get_rx_state_stream_id() == tx_resp->get_tx_state_stream_id()))
+                        found++;
+
+                    delete rx_resp;
+                    delete tx_resp;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+static uint32_t walk_views(const std::vector<station> & stations)
+{
+    uint32_t found = 0;
+    avdecc_lib::stream_input_get_rx_state_view rx_state;
+    avdecc_lib::stream_output_get_tx_state_view tx_state;
+
+    for (size_t in_index = 0; in_index < stations.size(); in_index++)
+    {
+        for (size_t in_stream_index = 0; in_stream_index < stations[in_index].rx_state.size(); in_stream_index++)
+        {
+            const std::vector<uint8_t> & rx = stations[in_index].rx_state[in_stream_index];
+            rx_state.assign(rx.data(), rx.size(), ether_hdr_len);
+            if (!rx_state.get_rx_state_connection_count())
+                continue;
+
+            for (size_t out_index = 0; out_index < stations.size(); out_index++)
+            {
+                for (size_t out_stream_index = 0; out_stream_index < stations[out_index].tx_state.size(); out_stream_index++)
+                {
+                    const std::vector<uint8_t> & tx = stations[out_index].tx_state[out_stream_index];
+                    tx_state.assign(tx.data(), tx.size(), ether_hdr_len);
+                    if (tx_state.get_tx_state_connection_count() &&
+                        (rx_state.get_rx_state_stream_id() == tx_state.get_tx_state_stream_id()))
+                        found++;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+static uint32_t walk_indexed_views(const std::vector<station> & stations)
+{
+    uint32_t found = 0;
+    avdecc_lib::stream_input_get_rx_state_view rx_state;
+    avdecc_lib::stream_output_get_tx_state_view tx_state;
+    std::unordered_map<uint64_t, std::vector<uint64_t>> outputs_by_stream_id;
+
+    for (size_t out_index = 0; out_index < stations.size(); out_index++)
+    {
+        for (size_t out_stream_index = 0; out_stream_index < stations[out_index].tx_state.size(); out_stream_index++)
+        {
+            const std::vector<uint8_t> & tx = stations[out_index].tx_state[out_stream_index];
+            tx_state.assign(tx.data(), tx.size(), ether_hdr_len);
+            if (tx_state.get_tx_state_connection_count())
+                outputs_by_stream_id[tx_state.get_tx_state_stream_id()].push_back(stations[out_index].entity_id);
+        }
+    }
+
+    for (size_t in_index = 0; in_index < stations.size(); in_index++)
+    {
+        for (size_t in_stream_index = 0; in_stream_index < stations[in_index].rx_state.size(); in_stream_index++)
+        {
+            const std::vector<uint8_t> & rx = stations[in_index].rx_state[in_stream_index];
+            rx_state.assign(rx.data(), rx.size(), ether_hdr_len);
+            if (!rx_state.get_rx_state_connection_count())
+                continue;
+
+            std::unordered_map<uint64_t, std::vector<uint64_t>>::const_iterator outputs = outputs_by_stream_id.find(rx_state.get_rx_state_stream_id());
+            if (outputs != outputs_by_stream_id.end())
+                found += (uint32_t)outputs->second.size();
+        }
+    }
+    return found;
+}
+
+static void report(const char * name, uint32_t (*walk)(const std::vector<station> &), const std::vector<station> & stations)
+{
+    bench_clock::time_point start = bench_clock::now();
+    uint32_t found = walk(stations);
+    double ms = std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+
+    printf("%-22s %8u connections %10.2f ms\n", name, found, ms);
+}
+
+int main(int argc, char * argv[])
+{
+    uint32_t count = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1000;
+    std::vector<station> stations = make_stations(count);
+
+    std::cout << count << " End Stations, " << streams_per_station << " stream inputs and outputs each" << std::endl;
+    report("heap responses", walk_heap, stations);
+    report("views", walk_views, stations);
+    report("views, indexed", walk_indexed_views, stations);
+    return 0;
+}
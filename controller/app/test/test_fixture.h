@@ -0,0 +1,228 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * test_fixture.h
+ *
+ * The frames, entity model and controller callbacks shared by the benchmarks and tests. An End
+ * Station is announced by an ADP frame, and populated from a descriptor cache file of its entity
+ * model written to a cache directory, so that its descriptors are stored by the library as when
+ * read from the network.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "jdksavdecc_adp.h"
+#include "jdksavdecc_aem_command.h"
+#include "jdksavdecc_aem_descriptor.h"
+#include "enumeration.h"
+#include "net_interface.h"
+#include "controller_imp.h"
+#include "descriptor_cache.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const size_t read_desc_pos = avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
+
+struct model_desc
+{
+    uint16_t type;
+    uint16_t count;
+    uint16_t len;
+};
+
+// A 32 channel stage box
+static const model_desc stage_box[] = {
+    {avdecc_lib::AEM_DESC_AUDIO_UNIT, 1, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_LEN},
+    {avdecc_lib::AEM_DESC_STREAM_INPUT, 2, JDKSAVDECC_DESCRIPTOR_STREAM_LEN},
+    {avdecc_lib::AEM_DESC_STREAM_OUTPUT, 2, JDKSAVDECC_DESCRIPTOR_STREAM_LEN},
+    {avdecc_lib::AEM_DESC_JACK_INPUT, 32, JDKSAVDECC_DESCRIPTOR_JACK_LEN},
+    {avdecc_lib::AEM_DESC_JACK_OUTPUT, 32, JDKSAVDECC_DESCRIPTOR_JACK_LEN},
+    {avdecc_lib::AEM_DESC_AVB_INTERFACE, 2, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_LEN},
+    {avdecc_lib::AEM_DESC_CLOCK_SOURCE, 3, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_LEN},
+    {avdecc_lib::AEM_DESC_LOCALE, 1, JDKSAVDECC_DESCRIPTOR_LOCALE_LEN},
+    {avdecc_lib::AEM_DESC_STRINGS, 2, JDKSAVDECC_DESCRIPTOR_STRINGS_LEN},
+    {avdecc_lib::AEM_DESC_STREAM_PORT_INPUT, 2, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_LEN},
+    {avdecc_lib::AEM_DESC_STREAM_PORT_OUTPUT, 2, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_LEN},
+    {avdecc_lib::AEM_DESC_EXTERNAL_PORT_INPUT, 32, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_LEN},
+    {avdecc_lib::AEM_DESC_EXTERNAL_PORT_OUTPUT, 32, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_LEN},
+    {avdecc_lib::AEM_DESC_AUDIO_CLUSTER, 64, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_LEN},
+    {avdecc_lib::AEM_DESC_AUDIO_MAP, 4, JDKSAVDECC_DESCRIPTOR_AUDIO_MAP_LEN},
+    {avdecc_lib::AEM_DESC_CONTROL, 16, JDKSAVDECC_DESCRIPTOR_CONTROL_LEN},
+    {avdecc_lib::AEM_DESC_CLOCK_DOMAIN, 1, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_LEN},
+};
+
+static const size_t stage_box_types = sizeof(stage_box) / sizeof(stage_box[0]);
+
+///
+/// An ENTITY_AVAILABLE announcement of an End Station, valid for 20 s. The source address is left
+/// zero if mac is NULL.
+///
+inline std::vector<uint8_t> make_adp_frame(uint64_t entity_id, uint64_t entity_model_id, const uint8_t * mac)
+{
+    static const uint8_t adp_multicast[6] = {0x91, 0xe0, 0xf0, 0x01, 0x00, 0x00};
+    std::vector<uint8_t> frame(avdecc_lib::ETHER_HDR_SIZE + JDKSAVDECC_ADPDU_LEN, 0);
+    uint8_t * pdu = &frame[avdecc_lib::ETHER_HDR_SIZE];
+
+    memcpy(&frame[0], adp_multicast, sizeof(adp_multicast));
+    if (mac)
+        memcpy(&frame[6], mac, 6);
+    jdksavdecc_uint16_set(JDKSAVDECC_AVTP_ETHERTYPE, frame.data(), 12);
+    pdu[0] = 0x80 | JDKSAVDECC_SUBTYPE_ADP;
+    pdu[1] = JDKSAVDECC_ADP_MESSAGE_TYPE_ENTITY_AVAILABLE;
+    jdksavdecc_uint16_set((10 << 11) | (JDKSAVDECC_ADPDU_LEN - JDKSAVDECC_COMMON_CONTROL_HEADER_LEN), pdu, 2);
+    jdksavdecc_uint64_set(entity_id, pdu, 4);
+    jdksavdecc_uint64_set(entity_model_id, pdu, JDKSAVDECC_ADPDU_OFFSET_ENTITY_MODEL_ID);
+    return frame;
+}
+
+///
+/// An AEM response of the End Station with a zeroed payload.
+///
+inline std::vector<uint8_t> make_aem_resp(uint64_t entity_id, uint16_t cmd_type, size_t aecpdu_len)
+{
+    std::vector<uint8_t> frame(avdecc_lib::ETHER_HDR_SIZE + aecpdu_len, 0);
+    uint8_t * pdu = &frame[avdecc_lib::ETHER_HDR_SIZE];
+
+    jdksavdecc_uint16_set(JDKSAVDECC_AVTP_ETHERTYPE, frame.data(), 12);
+    pdu[0] = 0x80 | JDKSAVDECC_SUBTYPE_AECP;
+    pdu[1] = JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE;
+    jdksavdecc_uint16_set((uint16_t)(aecpdu_len - JDKSAVDECC_COMMON_CONTROL_HEADER_LEN), pdu, 2);
+    jdksavdecc_uint64_set(entity_id, pdu, 4);
+    jdksavdecc_aecpdu_aem_set_command_type(cmd_type, frame.data(), avdecc_lib::ETHER_HDR_SIZE);
+    return frame;
+}
+
+inline std::vector<uint8_t> make_read_desc_resp(uint64_t entity_id, uint16_t desc_type, uint16_t desc_index, size_t desc_len)
+{
+    std::vector<uint8_t> frame = make_aem_resp(entity_id, JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR,
+                                               JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN + desc_len);
+
+    jdksavdecc_uint16_set(desc_type, frame.data(), read_desc_pos);
+    jdksavdecc_uint16_set(desc_index, frame.data(), read_desc_pos + 2);
+    return frame;
+}
+
+///
+/// The READ_DESCRIPTOR responses of an entity model with one CONFIGURATION holding the given
+/// descriptors, in the order of a descriptor cache file.
+///
+inline std::vector<std::vector<uint8_t>> make_model_frames(uint64_t entity_id, uint64_t entity_model_id,
+                                                           const model_desc * descs, size_t desc_types)
+{
+    std::vector<std::vector<uint8_t>> frames;
+
+    std::vector<uint8_t> entity = make_read_desc_resp(entity_id, avdecc_lib::AEM_DESC_ENTITY, 0, JDKSAVDECC_DESCRIPTOR_ENTITY_LEN);
+    jdksavdecc_uint64_set(entity_id, entity.data(), read_desc_pos + JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_ID);
+    jdksavdecc_uint64_set(entity_model_id, entity.data(), read_desc_pos + JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_MODEL_ID);
+    jdksavdecc_uint16_set(1, entity.data(), read_desc_pos + JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_CONFIGURATIONS_COUNT);
+    frames.push_back(entity);
+
+    std::vector<uint8_t> config = make_read_desc_resp(entity_id, avdecc_lib::AEM_DESC_CONFIGURATION, 0,
+                                                      JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN + 4 * desc_types);
+    jdksavdecc_uint16_set((uint16_t)desc_types, config.data(), read_desc_pos + JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_DESCRIPTOR_COUNTS_COUNT);
+    jdksavdecc_uint16_set(JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN, config.data(), read_desc_pos + JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_DESCRIPTOR_COUNTS_OFFSET);
+    for (size_t t = 0; t < desc_types; t++)
+    {
+        jdksavdecc_uint16_set(descs[t].type, config.data(), read_desc_pos + JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN + 4 * t);
+        jdksavdecc_uint16_set(descs[t].count, config.data(), read_desc_pos + JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN + 4 * t + 2);
+    }
+    frames.push_back(config);
+
+    for (size_t t = 0; t < desc_types; t++)
+    {
+        for (uint16_t i = 0; i < descs[t].count; i++)
+            frames.push_back(make_read_desc_resp(entity_id, descs[t].type, i, descs[t].len));
+    }
+
+    return frames;
+}
+
+///
+/// Write the descriptor cache file of an entity model to cache_dir, the descriptor cache directory
+/// of the controller from then on.
+///
+inline bool write_model_cache(avdecc_lib::controller * controller, const char * cache_dir, uint64_t entity_model_id,
+                              const std::vector<std::vector<uint8_t>> & frames)
+{
+    controller->set_descriptor_cache_dir(cache_dir);
+    if (!avdecc_lib::descriptor_cache_ref->save(entity_model_id, frames))
+    {
+        std::cerr << "Cannot write the descriptor cache file to " << cache_dir << std::endl;
+        return false;
+    }
+    return true;
+}
+
+///
+/// Remove the descriptor cache file of an entity model. The controller keeps the models it has loaded.
+///
+inline void remove_model_cache(const char * cache_dir, uint64_t entity_model_id)
+{
+    char cache_file[32];
+    snprintf(cache_file, sizeof(cache_file), "/%016llx.avdc", (unsigned long long)entity_model_id);
+    remove((std::string(cache_dir) + cache_file).c_str());
+}
+
+///
+/// Pass a received frame to the controller, as the system thread does.
+///
+inline void rx_frame(const std::vector<uint8_t> & frame)
+{
+    void * notification_id = NULL;
+    bool is_notification_id_valid = false;
+    int status = 0;
+    uint16_t operation_id = 0;
+    bool is_operation_id_valid = false;
+
+    avdecc_lib::controller_imp_ref->rx_packet_event(notification_id, is_notification_id_valid, frame.data(), frame.size(),
+                                                    status, operation_id, is_operation_id_valid);
+}
+
+///
+/// \return The number to select the loopback interface by, or 0 if there is none.
+///
+inline uint32_t loopback_interface_num(avdecc_lib::net_interface * netif)
+{
+    for (uint32_t i = 0; i < netif->devs_count(); i++)
+    {
+        if (strncmp(netif->get_dev_name_by_index(i), "lo,", 3) == 0)
+            return i + 1;
+    }
+    return 0;
+}
+
+inline void notification_callback(void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *) {}
+
+inline void acmp_notification_callback(void *, int32_t, uint16_t, uint64_t, uint16_t, uint64_t, uint16_t, uint32_t, void *) {}
+
+inline void log_callback(void *, int32_t, const char * msg, int32_t)
+{
+    std::cerr << msg << std::endl;
+}
@@ -0,0 +1,255 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * avdecc_tx_queue_main.cpp
+ *
+ * Multi-producer stress test of the transmit queue. Measures enqueue latency of the
+ * eventfd signalled mpsc_ring against the previous pipe + heap allocation scheme.
+ *
+ * Usage: bench_tx_queue [producers] [frames per producer]
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "mpsc_ring.h"
+
+enum
+{
+    FRAME_SIZE = 2048,
+    FRAME_LEN = 64,
+    QUEUE_SLOTS = 1024
+};
+
+struct ring_entry
+{
+    size_t mem_buf_len;
+    void * notification_id;
+    uint32_t notification_flag;
+    uint8_t frame[FRAME_SIZE];
+};
+
+struct pipe_entry
+{
+    uint8_t * frame;
+    size_t mem_buf_len;
+    void * notification_id;
+    uint32_t notification_flag;
+};
+
+typedef std::chrono::steady_clock bench_clock;
+
+class ring_queue
+{
+private:
+    avdecc_lib::mpsc_ring<ring_entry> ring;
+    int event_fd;
+    std::atomic<bool> event_pending;
+
+public:
+    ring_queue() : ring(QUEUE_SLOTS), event_pending(false)
+    {
+        event_fd = eventfd(0, EFD_NONBLOCK);
+    }
+
+    ~ring_queue()
+    {
+        close(event_fd);
+    }
+
+    int fd()
+    {
+        return event_fd;
+    }
+
+    void push(void * id, const uint8_t * frame, size_t len)
+    {
+        size_t ticket;
+        while (!ring.try_acquire(ticket))
+            sched_yield();
+
+        ring_entry & e = ring.slot(ticket);
+        e.mem_buf_len = len;
+        memcpy(e.frame, frame, len);
+        e.notification_id = id;
+        e.notification_flag = 1;
+        ring.publish(ticket);
+
+        if (!event_pending.exchange(true))
+        {
+            uint64_t one = 1;
+            write(event_fd, &one, sizeof(one));
+        }
+    }
+
+    size_t drain()
+    {
+        uint64_t count;
+        size_t frames = 0;
+        read(event_fd, &count, sizeof(count));
+        event_pending.store(false);
+
+        while (ring.front())
+        {
+            ring.pop();
+            frames++;
+        }
+        return frames;
+    }
+};
+
+class pipe_queue
+{
+private:
+    int p[2];
+
+public:
+    pipe_queue()
+    {
+        pipe(p);
+    }
+
+    ~pipe_queue()
+    {
+        close(p[0]);
+        close(p[1]);
+    }
+
+    int fd()
+    {
+        return p[0];
+    }
+
+    void push(void * id, const uint8_t * frame, size_t len)
+    {
+        pipe_entry t;
+        t.frame = new uint8_t[FRAME_SIZE];
+        t.mem_buf_len = len;
+        memcpy(t.frame, frame, len);
+        t.notification_id = id;
+        t.notification_flag = 1;
+        write(p[1], &t, sizeof(t));
+    }
+
+    size_t drain()
+    {
+        pipe_entry t;
+        if (read(p[0], &t, sizeof(t)) > 0)
+        {
+            delete[] t.frame;
+            return 1;
+        }
+        return 0;
+    }
+};
+
+template <typename Q>
+static void run(const char * name, int producers, int frames_per_producer)
+{
+    Q q;
+    std::vector<std::vector<uint32_t> > latencies(producers);
+    size_t total = (size_t)producers * frames_per_producer;
+
+    std::thread consumer([&]() {
+        int epollfd = epoll_create(1);
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        epoll_ctl(epollfd, EPOLL_CTL_ADD, q.fd(), &ev);
+
+        size_t received = 0;
+        while (received < total)
+        {
+            struct epoll_event events[1];
+            if (epoll_wait(epollfd, events, 1, 100) > 0)
+                received += q.drain();
+        }
+        close(epollfd);
+    });
+
+    bench_clock::time_point start = bench_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.push_back(std::thread([&, p]() {
+            uint8_t frame[FRAME_LEN];
+            memset(frame, p, sizeof(frame));
+            latencies[p].reserve(frames_per_producer);
+
+            for (int i = 0; i < frames_per_producer; i++)
+            {
+                bench_clock::time_point t0 = bench_clock::now();
+                q.push((void *)(intptr_t)i, frame, sizeof(frame));
+                bench_clock::time_point t1 = bench_clock::now();
+                latencies[p].push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    consumer.join();
+
+    double elapsed = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+    std::vector<uint32_t> all;
+    all.reserve(total);
+    for (int p = 0; p < producers; p++)
+        all.insert(all.end(), latencies[p].begin(), latencies[p].end());
+    std::sort(all.begin(), all.end());
+
+    std::cout << name << ": " << total / elapsed << " frames/s, enqueue latency ns"
+              << " p50 " << all[all.size() / 2]
+              << " p99 " << all[all.size() * 99 / 100]
+              << " p99.9 " << all[all.size() * 999 / 1000]
+              << " max " << all.back() << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+    int producers = argc > 1 ? atoi(argv[1]) : 4;
+    int frames_per_producer = argc > 2 ? atoi(argv[2]) : 100000;
+
+    if (producers < 1 || frames_per_producer < 1)
+    {
+        std::cout << "Usage: " << argv[0] << " [producers] [frames per producer]" << std::endl;
+        return 1;
+    }
+
+    std::cout << producers << " producers, " << frames_per_producer << " frames each" << std::endl;
+    run<pipe_queue>("pipe", producers, frames_per_producer);
+    run<ring_queue>("ring", producers, frames_per_producer);
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_batch.h
+ *
+ * Public command batch interface class
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "avdecc-lib_build.h"
+
+namespace avdecc_lib
+{
+///
+/// A command of a batch. cmd_type is an AEM command type, or an ACMP command message type plus
+/// CMD_LOOKUP, as passed to the notification callbacks.
+///
+/// The supported commands are the AEM commands whose only arguments are the descriptor type and
+/// index (GET_STREAM_FORMAT, GET_STREAM_INFO, GET_SAMPLING_RATE, GET_CLOCK_SOURCE, GET_COUNTERS
+/// and GET_AVB_INFO), and the ACMP GET_RX_STATE_COMMAND and GET_TX_STATE_COMMAND, which apply to
+/// a STREAM_INPUT and a STREAM_OUTPUT descriptor respectively.
+///
+struct cmd_batch_item
+{
+    uint64_t entity_id; ///< The Entity ID of the End Station the command is sent to
+    uint16_t cmd_type;
+    uint16_t desc_type;
+    uint16_t desc_index; ///< The index of the descriptor in the current configuration of the End Station
+};
+
+///
+/// A batch of commands sent together, which completes once when every command of the batch has
+/// completed. The result of every command is kept by its position in the batch.
+///
+/// Commands to one End Station are subject to the window of the End Station, so a large batch
+/// is queued inside the library rather than sent to any End Station at once.
+///
+class cmd_batch
+{
+public:
+    ///
+    /// Destroy the batch. Once destroyed, the responses of its commands are ignored. This can be
+    /// called from the completion callback of the batch.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL destroy() = 0;
+
+    ///
+    /// \return The number of commands in the batch.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual size_t STDCALL item_count() = 0;
+
+    ///
+    /// \return The number of commands of the batch that were sent. If none was, the batch is complete
+    ///         and its completion callback is never called.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual size_t STDCALL sent_count() = 0;
+
+    ///
+    /// \return True if every command of the batch has completed.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL is_complete() = 0;
+
+    ///
+    /// Block until every command of the batch has completed, or for at most timeout_ms.
+    ///
+    /// \return 0 if the batch is complete, -1 on timeout.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL wait(uint32_t timeout_ms) = 0;
+
+    ///
+    /// \return The status of the response to the command at item_index, AVDECC_LIB_STATUS_TICK_TIMEOUT
+    ///         if the command timed out, or AVDECC_LIB_STATUS_INVALID if it could not be sent or has
+    ///         not completed.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL item_status(size_t item_index) = 0;
+
+    ///
+    /// \return The response frame to the command at item_index, or NULL if there is none. The frame
+    ///         is valid until the batch is destroyed.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual const uint8_t * STDCALL item_resp_frame(size_t item_index) = 0;
+
+    ///
+    /// \return The length of the response frame to the command at item_index.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual size_t STDCALL item_resp_frame_len(size_t item_index) = 0;
+};
+}
@@ -0,0 +1,90 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_completion.h
+ *
+ * Public command completion interface class
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "avdecc-lib_build.h"
+
+namespace avdecc_lib
+{
+///
+/// A completion handle for commands sent without blocking.
+///
+/// Pass the notification id of the handle to any send_*_cmd function. The handle completes when
+/// the last command sent with it has completed, with the status and the frame of its response,
+/// or AVDECC_LIB_STATUS_TICK_TIMEOUT if it timed out. Any number of handles can be outstanding
+/// from any number of threads.
+///
+/// A complete handle can be used for a new command, which clears the status and the frame.
+///
+class cmd_completion
+{
+public:
+    ///
+    /// Destroy the handle. Once destroyed, the responses of the commands sent with it are ignored.
+    /// This can be called from the completion callback of the handle.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL destroy() = 0;
+
+    ///
+    /// \return The notification id to send commands with.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void * STDCALL notification_id() = 0;
+
+    ///
+    /// \return True if the commands sent with the handle have completed.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL is_complete() = 0;
+
+    ///
+    /// Block until the commands sent with the handle have completed, or for at most timeout_ms.
+    ///
+    /// \return 0 if the handle is complete, -1 on timeout.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL wait(uint32_t timeout_ms) = 0;
+
+    ///
+    /// \return The status of the response, or AVDECC_LIB_STATUS_TICK_TIMEOUT if the command timed out.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL status() = 0;
+
+    ///
+    /// \return The response frame, or NULL if the command timed out. The frame is valid until the
+    ///         handle is destroyed or used for a new command.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual const uint8_t * STDCALL resp_frame() = 0;
+
+    ///
+    /// \return The length of the response frame.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual size_t STDCALL resp_frame_len() = 0;
+};
+}
@@ -0,0 +1,540 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_coroutine.h
+ *
+ * C++20 coroutine layer over command completion handles and batches
+ *
+ * This header is only usable from applications compiled with C++20 coroutine
+ * support. The library itself does not depend on it.
+ *
+ * A multi-step procedure is written as a cmd_task coroutine that co_awaits each
+ * command. While it waits for a response, the coroutine is suspended and holds no
+ * thread. The library thread hands completed commands to a cmd_executor, which
+ * resumes the coroutines on the application threads that run it:
+ *
+ *     avdecc_lib::cmd_task<int> identify(avdecc_lib::controller & c, avdecc_lib::cmd_executor & exec,
+ *                                        avdecc_lib::stream_input_descriptor * stream)
+ *     {
+ *         avdecc_lib::cmd_result r = co_await avdecc_lib::send_cmd_async(c, exec, [stream](void * id) {
+ *             return stream->send_get_stream_info_cmd(id);
+ *         });
+ *         co_return r.status;
+ *     }
+ *
+ *     exec.spawn(procedure(...)); // Any number of procedures
+ *     exec.run();                 // On one or more application threads
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <coroutine>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "controller.h"
+#include "cmd_completion.h"
+#include "cmd_batch.h"
+
+namespace avdecc_lib
+{
+template <typename T = void>
+class cmd_task;
+
+namespace cmd_task_detail
+{
+struct final_awaiter
+{
+    bool await_ready() noexcept
+    {
+        return false;
+    }
+
+    // Resume the coroutine awaiting the task, if any, without growing the stack
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+    {
+        std::coroutine_handle<> continuation = h.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() noexcept {}
+};
+
+struct promise_base
+{
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    final_awaiter final_suspend() noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        exception = std::current_exception();
+    }
+};
+
+template <typename T>
+struct promise : promise_base
+{
+    std::optional<T> value;
+
+    template <typename U>
+    void return_value(U && v)
+    {
+        value.emplace(std::forward<U>(v));
+    }
+
+    T result()
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct promise<void> : promise_base
+{
+    void return_void() noexcept {}
+
+    void result()
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+};
+
+struct detached
+{
+    struct promise_type
+    {
+        detached get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept {}
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+}
+
+///
+/// A coroutine producing a T. It starts when it is awaited, and resumes its awaiter when it
+/// returns. An exception leaving the coroutine is rethrown to the awaiter.
+///
+template <typename T>
+class cmd_task
+{
+public:
+    struct promise_type : cmd_task_detail::promise<T>
+    {
+        cmd_task get_return_object() noexcept
+        {
+            return cmd_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+    };
+
+    cmd_task(cmd_task && other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    cmd_task & operator=(cmd_task && other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    cmd_task(const cmd_task &) = delete;
+    cmd_task & operator=(const cmd_task &) = delete;
+
+    ~cmd_task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+
+    T await_resume()
+    {
+        return m_handle.promise().result();
+    }
+
+private:
+    explicit cmd_task(std::coroutine_handle<promise_type> h) noexcept : m_handle(h) {}
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+///
+/// Resumes coroutines on the application threads that call run() or poll().
+///
+/// Completed commands are posted to the executor by the library thread, which therefore never
+/// runs application code, and a small number of threads can drive any number of suspended
+/// procedures.
+///
+class cmd_executor
+{
+private:
+    std::mutex m_lock;
+    std::condition_variable m_ready;
+    std::deque<std::coroutine_handle<>> m_queue;
+    size_t m_tasks; // Spawned tasks that have not returned
+
+    static cmd_task_detail::detached run_detached(cmd_executor * exec, cmd_task<void> task)
+    {
+        co_await exec->schedule();
+        co_await task;
+        exec->task_done();
+    }
+
+    void task_done()
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (--m_tasks == 0)
+            m_ready.notify_all();
+    }
+
+public:
+    struct schedule_awaiter
+    {
+        cmd_executor & exec;
+
+        bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h)
+        {
+            exec.post(h);
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    cmd_executor() : m_tasks(0) {}
+
+    cmd_executor(const cmd_executor &) = delete;
+    cmd_executor & operator=(const cmd_executor &) = delete;
+
+    ///
+    /// Queue a coroutine to be resumed by run() or poll(). This can be called from any thread.
+    ///
+    void post(std::coroutine_handle<> h)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_queue.push_back(h);
+        m_ready.notify_one();
+    }
+
+    ///
+    /// Start a task on the executor. The task is owned by the executor until it returns. An
+    /// exception leaving the task terminates the program.
+    ///
+    void spawn(cmd_task<void> task)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_tasks++;
+        }
+        run_detached(this, std::move(task));
+    }
+
+    ///
+    /// \return An awaitable that suspends the calling coroutine and resumes it on the executor.
+    ///
+    schedule_awaiter schedule()
+    {
+        return schedule_awaiter{*this};
+    }
+
+    ///
+    /// Resume the queued coroutines without waiting for further completions.
+    ///
+    /// \return The number of coroutines resumed.
+    ///
+    size_t poll()
+    {
+        size_t resumed = 0;
+
+        for (;;)
+        {
+            std::coroutine_handle<> h;
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                if (m_queue.empty())
+                    return resumed;
+                h = m_queue.front();
+                m_queue.pop_front();
+            }
+            h.resume();
+            resumed++;
+        }
+    }
+
+    ///
+    /// Resume coroutines as their commands complete, until every spawned task has returned. Any
+    /// number of threads can run the executor together.
+    ///
+    void run()
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+
+        for (;;)
+        {
+            if (!m_queue.empty())
+            {
+                std::coroutine_handle<> h = m_queue.front();
+                m_queue.pop_front();
+                guard.unlock();
+                h.resume();
+                guard.lock();
+            }
+            else if (m_tasks == 0)
+            {
+                return;
+            }
+            else
+            {
+                m_ready.wait(guard);
+            }
+        }
+    }
+};
+
+///
+/// The result of a command awaited with send_cmd_async().
+///
+struct cmd_result
+{
+    int status;                      ///< As cmd_completion::status(), AVDECC_LIB_STATUS_INVALID if the command was not sent
+    std::vector<uint8_t> resp_frame; ///< The response frame, empty if the command timed out or was not sent
+};
+
+///
+/// Awaitable that sends one command with a completion handle and suspends until the handle completes.
+///
+/// The awaiting coroutine is resumed by whichever of await_suspend() and the completion callback
+/// comes last, so a response that arrives before the coroutine has suspended is not missed. The
+/// handle completes as soon as it has no command outstanding, which the response to a first command
+/// can cause before a second is queued, so only one command is sent per awaiter and a completion
+/// after the first never resumes the coroutine again. Use send_cmd_batch_async() for several commands.
+///
+template <typename Send>
+class cmd_awaiter
+{
+public:
+    cmd_awaiter(controller & ctrl, cmd_executor & exec, Send send)
+        : m_controller(ctrl), m_executor(exec), m_send(std::move(send)), m_completion(NULL), m_events(0)
+    {
+    }
+
+    cmd_awaiter(const cmd_awaiter &) = delete;
+    cmd_awaiter & operator=(const cmd_awaiter &) = delete;
+
+    ~cmd_awaiter()
+    {
+        if (m_completion)
+            m_completion->destroy();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        m_awaiting = awaiting;
+        m_completion = m_controller.create_cmd_completion(completed, this);
+
+        // A send function that fails has queued nothing, so the handle will not complete
+        if (m_send(m_completion->notification_id()) < 0)
+            return false;
+
+        return m_events.fetch_add(1) == 0;
+    }
+
+    cmd_result await_resume()
+    {
+        cmd_result result;
+
+        result.status = m_completion->status();
+        const uint8_t * frame = m_completion->resp_frame();
+        if (frame)
+            result.resp_frame.assign(frame, frame + m_completion->resp_frame_len());
+
+        return result;
+    }
+
+private:
+    controller & m_controller;
+    cmd_executor & m_executor;
+    Send m_send;
+    cmd_completion * m_completion;
+    std::coroutine_handle<> m_awaiting;
+    std::atomic<uint32_t> m_events; // await_suspend() and the completions of the handle, in the order they happen
+
+    static void completed(void * awaiter, cmd_completion *)
+    {
+        cmd_awaiter * a = static_cast<cmd_awaiter *>(awaiter);
+
+        // Only the first completion after the coroutine has suspended resumes it
+        if (a->m_events.fetch_add(1) == 1)
+            a->m_executor.post(a->m_awaiting);
+    }
+};
+
+///
+/// Send a command and suspend the calling coroutine until it has completed.
+///
+/// \param send Called with the notification id to send the command with, for example
+///        [stream](void * id) { return stream->send_get_stream_info_cmd(id); }. Every send_*_cmd
+///        function can be used, but only one command can be sent with the id; several commands
+///        are awaited with send_cmd_batch_async().
+///
+/// \return An awaitable producing a cmd_result.
+///
+template <typename Send>
+cmd_awaiter<Send> send_cmd_async(controller & ctrl, cmd_executor & exec, Send send)
+{
+    return cmd_awaiter<Send>(ctrl, exec, std::move(send));
+}
+
+///
+/// Awaitable that sends a batch of commands and suspends until the batch completes.
+///
+class cmd_batch_awaiter
+{
+public:
+    cmd_batch_awaiter(controller & ctrl, cmd_executor & exec, const struct cmd_batch_item * items, size_t item_count)
+        : m_controller(ctrl), m_executor(exec), m_items(items), m_item_count(item_count), m_batch(NULL), m_arrived(false)
+    {
+    }
+
+    cmd_batch_awaiter(const cmd_batch_awaiter &) = delete;
+    cmd_batch_awaiter & operator=(const cmd_batch_awaiter &) = delete;
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> awaiting)
+    {
+        m_awaiting = awaiting;
+        m_batch = m_controller.send_cmd_batch(m_items, m_item_count, completed, this);
+
+        // The completion callback of a batch with no command sent is never called
+        if (m_batch->sent_count() == 0)
+            return false;
+
+        return !m_arrived.exchange(true);
+    }
+
+    ///
+    /// \return The complete batch, to be destroyed by the caller.
+    ///
+    cmd_batch * await_resume() noexcept
+    {
+        return m_batch;
+    }
+
+private:
+    controller & m_controller;
+    cmd_executor & m_executor;
+    const struct cmd_batch_item * m_items;
+    size_t m_item_count;
+    cmd_batch * m_batch;
+    std::coroutine_handle<> m_awaiting;
+    std::atomic<bool> m_arrived;
+
+    static void completed(void * awaiter, cmd_batch *)
+    {
+        cmd_batch_awaiter * a = static_cast<cmd_batch_awaiter *>(awaiter);
+        if (a->m_arrived.exchange(true))
+            a->m_executor.post(a->m_awaiting);
+    }
+};
+
+///
+/// Send a batch of commands and suspend the calling coroutine until every command has completed.
+/// The items are copied when the batch is sent, at the start of the co_await expression.
+///
+/// \return An awaitable producing the complete cmd_batch, to be destroyed by the caller.
+///
+inline cmd_batch_awaiter send_cmd_batch_async(controller & ctrl, cmd_executor & exec,
+                                              const struct cmd_batch_item * items, size_t item_count)
+{
+    return cmd_batch_awaiter(ctrl, exec, items, item_count);
+}
+}
+
+#endif
@@ -40,6 +40,9 @@ namespace avdecc_lib
 {
 class end_station;
 class configuration_descriptor;
+class cmd_completion;
+class cmd_batch;
+struct cmd_batch_item;
 
 class controller
 {
@@ -133,6 +136,74 @@ public:
     /// Send a CONTROLLER_AVAILABLE command to verify that the AVDECC Controller is still there.
     ///
     AVDECC_CONTROLLER_LIB32_API virtual int STDCALL send_controller_avail_cmd(void * notification_id, uint32_t end_station_index) = 0;
+
+    ///
+    /// Set the maximum number of AECP commands outstanding to each End Station that has no window
+    /// of its own. The default is AECP_DEFAULT_WINDOW.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_aecp_default_window(uint32_t window) = 0;
+
+    ///
+    /// Set the maximum number of background descriptor reads inflight across all End Stations.
+    /// The default is ENUMERATION_DEFAULT_MAX_INFLIGHT.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_enumeration_max_inflight(uint32_t max) = 0;
+
+    ///
+    /// \return The number of background descriptor reads inflight across all End Stations.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_enumeration_inflight() = 0;
+
+    ///
+    /// \return The number of End Stations waiting for their turn to read a descriptor.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_enumeration_queue_depth() = 0;
+
+    ///
+    /// Set the directory of the descriptor cache. The descriptors read from an End Station are saved
+    /// there by entity model id, and End Stations of a cached entity model are populated from the
+    /// cache, reading again only the descriptors that have a name or a current value. The directory
+    /// must exist. The cache is disabled by default, and by passing NULL.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_descriptor_cache_dir(const char * dir) = 0;
+
+    ///
+    /// Get the memory used by descriptor frames. referenced_bytes is the size of the descriptor frames
+    /// held by every End Station, and stored_bytes the memory they take, identical frames being shared.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL get_descriptor_frame_bytes(uint64_t & referenced_bytes, uint64_t & stored_bytes) = 0;
+
+    ///
+    /// Create a completion handle to send commands with, without blocking. Unlike set_wait_for_next_cmd(),
+    /// any number of handles can be outstanding from any number of threads.
+    ///
+    /// \param completion_callback If not NULL, called by the library thread with user_obj when the handle
+    ///        completes. It must not block, but can send commands and destroy the handle.
+    /// \param user_obj A void pointer used to store any helpful C++ class object.
+    ///
+    /// \see cmd_completion
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual cmd_completion * STDCALL create_cmd_completion(void (*completion_callback)(void *, cmd_completion *), void * user_obj) = 0;
+
+    ///
+    /// Send a batch of commands, queued for transmission in one operation. The batch completes once,
+    /// when every command has completed, and keeps the result of every command by its position.
+    ///
+    /// \param items The commands to send, which are copied.
+    /// \param item_count The number of commands.
+    /// \param completion_callback If not NULL, called by the library thread with user_obj when the batch
+    ///        completes. It must not block, but can send commands and destroy the batch. It is not
+    ///        called if no command of the batch can be sent, as the batch is then complete on return.
+    /// \param user_obj A void pointer used to store any helpful C++ class object.
+    ///
+    /// \return The batch, to be destroyed by the application. A command to an unknown End Station
+    ///         or descriptor, or a command that is not supported in a batch, is not sent and has the
+    ///         status AVDECC_LIB_STATUS_INVALID.
+    ///
+    /// \see cmd_batch
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual cmd_batch * STDCALL send_cmd_batch(const struct cmd_batch_item * items, size_t item_count,
+                                                                           void (*completion_callback)(void *, cmd_batch *), void * user_obj) = 0;
 };
 
 ///
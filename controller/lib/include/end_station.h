@@ -139,5 +139,75 @@ public:
     /// \param notification_id A void pointer to the unique identifier associated with the command.
     ///
     AVDECC_CONTROLLER_LIB32_API virtual int STDCALL send_deregister_unsolicited_cmd(void * notification_id) = 0;
+
+    ///
+    /// Set the maximum number of AECP commands outstanding to the End Station. Further commands
+    /// are queued and sent as responses arrive.
+    ///
+    /// \param window The number of outstanding commands allowed, or 0 to use the controller default.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_aecp_window(uint32_t window) = 0;
+
+    ///
+    /// \return The maximum number of AECP commands outstanding to the End Station.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_aecp_window() = 0;
+
+    ///
+    /// \return The number of AECP commands currently outstanding to the End Station.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_aecp_window_occupancy() = 0;
+
+    ///
+    /// \return The number of AECP commands queued because the window of the End Station is full.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_aecp_queue_depth() = 0;
+
+    ///
+    /// \return The average time in milliseconds AECP commands have been queued before being sent.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_aecp_avg_queue_wait_ms() = 0;
+
+    ///
+    /// \return The longest time in milliseconds an AECP command has been queued before being sent.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_aecp_max_queue_wait_ms() = 0;
+
+    ///
+    /// \return The current AECP command timeout in milliseconds of the End Station, derived from
+    ///         the round trip times measured for its commands. It is never shorter than the 250
+    ///         milliseconds AECP command timeout of IEEE 1722.1.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_aecp_rto_ms() = 0;
+
+    ///
+    /// Set the maximum number of READ_DESCRIPTOR commands the background enumeration of the End
+    /// Station keeps inflight, across all descriptor types.
+    ///
+    /// \param window The number of reads inflight, or 0 to use the AECP window of the End Station.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_background_read_window(uint32_t window) = 0;
+
+    ///
+    /// \return The time in milliseconds from the start of the enumeration of the End Station to
+    ///         END_STATION_READ_COMPLETED, or 0 if the enumeration has not completed.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_enumeration_time_ms() = 0;
+
+    ///
+    /// Mark the End Station as of interest to the application, so that the controller enumeration
+    /// scheduler lets it read its descriptors before End Stations that are not marked.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL set_enumeration_priority(bool high) = 0;
+
+    ///
+    /// \return The number of descriptors read by the background enumeration of the End Station.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_background_reads_completed() = 0;
+
+    ///
+    /// \return The number of descriptors the background enumeration of the End Station has still to read.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual uint32_t STDCALL get_background_reads_pending() = 0;
 };
 }
@@ -38,6 +38,7 @@
 #include "entity_descriptor_response.h"
 #include "entity_counters_response.h"
 #include "entity_descriptor_get_config_response.h"
+#include "response_views.h"
 
 namespace avdecc_lib
 {
@@ -50,6 +51,13 @@ public:
     /// \return the entity descriptor response class.
     ///
     AVDECC_CONTROLLER_LIB32_API virtual entity_descriptor_response * STDCALL get_entity_response() = 0;
+
+    ///
+    /// Fill view with the ENTITY descriptor without allocating a response class.
+    ///
+    /// \return False if the descriptor is not available.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL get_entity_view(entity_descriptor_view & view) = 0;
     
     ///
     /// \return the entity descriptor get_configuration response class.
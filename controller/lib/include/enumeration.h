@@ -254,10 +254,29 @@ enum aem_max_maps
     AEM_MAX_MAPS = 63 ///< 1722.1 max maps allowed per cmd frame for ADD/REMOVE audio mappings cmd
 };
 
+enum aecp_windows
+{
+    AECP_DEFAULT_WINDOW = 8 ///< Default maximum number of AECP commands outstanding to one End Station
+};
+
+enum enumeration_limits
+{
+    ENUMERATION_DEFAULT_MAX_INFLIGHT = 64 ///< Default maximum number of background descriptor reads inflight across all End Stations
+};
+
+enum aecp_sends
+{
+    AECP_MIN_SENDS = 2, ///< An AECP command is sent at least twice before it times out
+    AECP_MAX_SENDS = 4  ///< An AECP command is sent at most four times before it times out
+};
+
 enum timeouts
 {
     NETIF_READ_TIMEOUT_MS = 100, ///< The network interface has a 100 milliseconds timeout in capturing ADP packets
     AVDECC_MSG_TIMEOUT_MS = 250, ///< AVDECC messages have a 250 milliseconds timeout
+    AECP_RTO_MIN_MS = 250,       ///< Lower bound of the adaptive AECP command timeout, the IEEE 1722.1 AECP command timeout
+    AECP_RTO_MAX_MS = 2000,      ///< Upper bound of the adaptive AECP command timeout
+    AECP_RETRY_BUDGET_MS = 4000, ///< Time over which the sends of an AECP command are spread: four up to a 285 ms timeout, three up to 666 ms, else two
     ACMP_CONNECT_TX_COMMAND_TIMEOUT_MS = 2000,
     ACMP_DISCONNECT_TX_COMMAND_TIMEOUT_MS = 200,
     ACMP_GET_TX_STATE_COMMAND_TIMEOUT_MS = 200,
@@ -31,11 +31,12 @@
 
 #include <stdint.h>
 #include "avdecc-lib_build.h"
+#include "descriptor_base.h"
 #include "descriptor_response_base.h"
 
 namespace avdecc_lib
 {
-class external_port_output_descriptor_response : public virtual descriptor_response_base
+class external_port_output_descriptor_response : public virtual descriptor_base, public virtual descriptor_response_base
 {
 public:
     virtual ~external_port_output_descriptor_response(){};
@@ -35,6 +35,23 @@
 
 namespace avdecc_lib
 {
+///
+/// Frame batch counters of a network interface.
+///
+struct frame_batch_stats
+{
+    enum
+    {
+        HISTOGRAM_BINS = 11 ///< Bin n counts batches of 2^n to 2^(n+1) - 1 frames
+    };
+
+    uint64_t batches;                   ///< Number of batches that carried at least one frame
+    uint64_t frames;                    ///< Number of frames carried by all batches
+    uint32_t last;                      ///< Number of frames carried by the most recent batch
+    uint32_t max;                       ///< Largest number of frames carried by one batch
+    uint64_t histogram[HISTOGRAM_BINS]; ///< Batch size distribution
+};
+
 class net_interface
 {
 public:
@@ -99,6 +116,60 @@ public:
     /// Capture a network packet.
     ///
     AVDECC_CONTROLLER_LIB32_API virtual int STDCALL capture_frame(const uint8_t ** frame, uint16_t * frame_len) = 0;
+
+    ///
+    /// Capture frames from a memory mapped receive ring instead of copying each frame with a
+    /// system call. Must be called before select_interface_by_num().
+    ///
+    /// \return 0 on success, or -1 if the receive ring is not supported on this platform.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL set_rx_ring_enabled(bool enabled) = 0;
+
+    ///
+    /// \return True if frames are captured from the memory mapped receive ring.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL rx_ring_enabled() = 0;
+
+    ///
+    /// Set the maximum number of frames received by one system call. A size of 1 receives one
+    /// frame per call. Must be called before system::process_start().
+    ///
+    /// \return 0 on success, or -1 if batched receive is not supported on this platform.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL set_rx_batch_size(uint32_t frames) = 0;
+
+    ///
+    /// Copy the receive batch counters. They can be read while frames are being received.
+    ///
+    /// \return 0 on success, or -1 if batched receive is not supported on this platform.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_rx_batch_stats(struct frame_batch_stats & stats) = 0;
+
+    ///
+    /// Clear the receive batch counters.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL reset_rx_batch_stats() = 0;
+
+    ///
+    /// Set the maximum number of frames held back and sent together by one system call once the
+    /// frames produced by an event have been handled. A size of 1 sends every frame immediately.
+    /// Must be called before system::process_start().
+    ///
+    /// \return 0 on success, or -1 if batched transmit is not supported on this platform.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL set_tx_batch_size(uint32_t frames) = 0;
+
+    ///
+    /// Copy the transmit batch counters. They can be read while frames are being sent.
+    ///
+    /// \return 0 on success, or -1 if batched transmit is not supported on this platform.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL get_tx_batch_stats(struct frame_batch_stats & stats) = 0;
+
+    ///
+    /// Clear the transmit batch counters.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual void STDCALL reset_tx_batch_stats() = 0;
 };
 
 /**
@@ -34,9 +34,13 @@
 #include <cstring>
 #include <assert.h>
 #include <map>
+#include <memory>
 
 namespace avdecc_lib
 {
+struct shared_frame;
+class descriptor_arena;
+
 struct cmd_resp_frame_info
 {
     uint8_t * buffer;
@@ -50,25 +54,37 @@ struct cmd_resp_frame_info
 class response_frame
 {
 public:
-    response_frame(const uint8_t * frame, size_t size, size_t pos);
+    response_frame(descriptor_arena * arena, const uint8_t * frame, size_t size, size_t pos);
     virtual ~response_frame();
+
+    ///
+    /// Response frames and the command responses they store are allocated from the descriptor
+    /// arena of their End Station, or from the heap without an arena.
+    ///
+    static void * operator new(size_t size, descriptor_arena & arena);
+    static void * operator new(size_t size);
+    static void operator delete(void * p, descriptor_arena & arena);
+    static void operator delete(void * p);
+
 private:
+    descriptor_arena * m_arena;
+
+
     // <key, value> : <command type, command response frame info>
     std::map<uint16_t, struct cmd_resp_frame_info * > cmd_resp_buffers;
 
     //
-    // Buffer to store descriptor response frames.  Will be updated by
-    // update_desc_database() method in configuration descriptor.
+    // Descriptor response frame, shared with the End Stations holding the same
+    // descriptor.  Will be replaced by update_desc_database() method in
+    // configuration descriptor.
     //
-    uint8_t * desc_buffer;
-    size_t desc_frame_size;
-    size_t desc_position;
+    std::shared_ptr<const shared_frame> desc_frame;
 
 public:
     struct cmd_resp_frame_info * get_cmd_resp_frame_info(uint16_t cmd_type);
     int store_cmd_resp_frame(uint16_t cmd_type, const uint8_t * frame, size_t pos, size_t size);
     int replace_desc_frame(const uint8_t * frame, size_t pos, size_t size);
-    uint8_t * get_desc_buffer();
+    uint8_t * get_desc_buffer(); // The buffer is shared and must not be written, use replace_desc_frame()
     size_t get_desc_pos();
     size_t get_desc_size();
 };
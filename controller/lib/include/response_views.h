@@ -0,0 +1,176 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * response_views.h
+ *
+ * Value types holding the fields of a stored response. A view is filled by
+ * the matching descriptor without any allocation, is trivially copyable and
+ * remains valid after the End Station receives a newer response.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "avdecc-lib_build.h"
+
+namespace avdecc_lib
+{
+///
+/// The GET_RX_STATE response of a STREAM_INPUT descriptor.
+///
+class stream_input_get_rx_state_view
+{
+public:
+    stream_input_get_rx_state_view() : m_valid(false) {}
+
+    ///
+    /// Copy the ACMPDU starting at pos of a GET_RX_STATE response frame.
+    ///
+    AVDECC_CONTROLLER_LIB32_API void STDCALL assign(const uint8_t * frame, size_t frame_len, size_t pos);
+
+    ///
+    /// \return True if a response has been assigned to the view.
+    ///
+    bool valid() const { return m_valid; }
+
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL get_rx_state_stream_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL get_rx_state_talker_entity_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL get_rx_state_talker_unique_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL get_rx_state_listener_entity_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL get_rx_state_listener_unique_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL get_rx_state_stream_dest_mac() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL get_rx_state_connection_count() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL get_rx_state_flags() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL get_rx_state_stream_vlan_id() const;
+
+private:
+    uint8_t m_pdu[56]; // JDKSAVDECC_ACMPDU_LEN
+    bool m_valid;
+};
+
+///
+/// The GET_TX_STATE response of a STREAM_OUTPUT descriptor.
+///
+class stream_output_get_tx_state_view
+{
+public:
+    stream_output_get_tx_state_view() : m_valid(false) {}
+
+    ///
+    /// Copy the ACMPDU starting at pos of a GET_TX_STATE response frame.
+    ///
+    AVDECC_CONTROLLER_LIB32_API void STDCALL assign(const uint8_t * frame, size_t frame_len, size_t pos);
+
+    ///
+    /// \return True if a response has been assigned to the view.
+    ///
+    bool valid() const { return m_valid; }
+
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL get_tx_state_stream_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL get_tx_state_stream_dest_mac() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL get_tx_state_connection_count() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL get_tx_state_stream_vlan_id() const;
+
+private:
+    uint8_t m_pdu[56]; // JDKSAVDECC_ACMPDU_LEN
+    bool m_valid;
+};
+
+///
+/// The GET_COUNTERS response of a STREAM_INPUT descriptor.
+///
+class stream_input_counters_view
+{
+public:
+    stream_input_counters_view() : m_valid(false), m_counters_valid(0) {}
+
+    ///
+    /// Decode the counters of a GET_COUNTERS response frame.
+    ///
+    AVDECC_CONTROLLER_LIB32_API void STDCALL assign(const uint8_t * frame, size_t frame_len, size_t pos);
+
+    ///
+    /// \return True if a response has been assigned to the view.
+    ///
+    bool valid() const { return m_valid; }
+
+    ///
+    /// \param name avdecc_lib::counter_labels
+    ///
+    AVDECC_CONTROLLER_LIB32_API uint32_t STDCALL get_counter_valid(int name) const;
+
+    ///
+    /// \param name avdecc_lib::counter_labels
+    ///
+    AVDECC_CONTROLLER_LIB32_API uint32_t STDCALL get_counter_by_name(int name) const;
+
+private:
+    bool m_valid;
+    uint32_t m_counters_valid;
+    uint32_t m_counters_block[32];
+};
+
+///
+/// The ENTITY descriptor of an End Station.
+///
+class entity_descriptor_view
+{
+public:
+    entity_descriptor_view() : m_valid(false) {}
+
+    ///
+    /// Copy the ENTITY descriptor starting at pos of a READ_DESCRIPTOR response frame.
+    ///
+    AVDECC_CONTROLLER_LIB32_API void STDCALL assign(const uint8_t * frame, size_t frame_len, size_t pos);
+
+    ///
+    /// \return True if a descriptor has been assigned to the view.
+    ///
+    bool valid() const { return m_valid; }
+
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL entity_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL entity_model_id() const;
+    AVDECC_CONTROLLER_LIB32_API uint32_t STDCALL entity_capabilities() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL talker_stream_sources() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL talker_capabilities() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL listener_stream_sinks() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL listener_capabilities() const;
+    AVDECC_CONTROLLER_LIB32_API uint32_t STDCALL controller_capabilities() const;
+    AVDECC_CONTROLLER_LIB32_API uint32_t STDCALL available_index() const;
+    AVDECC_CONTROLLER_LIB32_API uint64_t STDCALL association_id() const;
+    AVDECC_CONTROLLER_LIB32_API const uint8_t * STDCALL entity_name() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL vendor_name_string() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL model_name_string() const;
+    AVDECC_CONTROLLER_LIB32_API const uint8_t * STDCALL firmware_version() const;
+    AVDECC_CONTROLLER_LIB32_API const uint8_t * STDCALL group_name() const;
+    AVDECC_CONTROLLER_LIB32_API const uint8_t * STDCALL serial_number() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL configurations_count() const;
+    AVDECC_CONTROLLER_LIB32_API uint16_t STDCALL current_configuration() const;
+
+private:
+    uint8_t m_desc[312]; // JDKSAVDECC_DESCRIPTOR_ENTITY_LEN
+    bool m_valid;
+};
+}
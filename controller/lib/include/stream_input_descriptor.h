@@ -38,6 +38,7 @@
 #include "stream_input_get_stream_format_response.h"
 #include "stream_input_get_stream_info_response.h"
 #include "stream_input_get_rx_state_response.h"
+#include "response_views.h"
 
 namespace avdecc_lib
 {
@@ -69,6 +70,20 @@ public:
     ///
     AVDECC_CONTROLLER_LIB32_API virtual stream_input_get_rx_state_response * STDCALL get_stream_input_get_rx_state_response() = 0;
 
+    ///
+    /// Fill view with the last GET_RX_STATE response without allocating a response class.
+    ///
+    /// \return False if no GET_RX_STATE response has been received.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL get_rx_state_view(stream_input_get_rx_state_view & view) = 0;
+
+    ///
+    /// Fill view with the last GET_COUNTERS response without allocating a response class.
+    ///
+    /// \return False if no GET_COUNTERS response has been received.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL get_counters_view(stream_input_counters_view & view) = 0;
+
     ///
     /// Send a SET_STREAM_FORMAT command with a notification id to change the format of a stream.
     ///
@@ -37,6 +37,7 @@
 #include "stream_output_get_stream_format_response.h"
 #include "stream_output_get_stream_info_response.h"
 #include "stream_output_get_tx_state_response.h"
+#include "response_views.h"
 #include "stream_output_get_tx_connection_response.h"
 
 namespace avdecc_lib
@@ -64,6 +65,13 @@ public:
     ///
     AVDECC_CONTROLLER_LIB32_API virtual stream_output_get_tx_state_response * STDCALL get_stream_output_get_tx_state_response() = 0;
 
+    ///
+    /// Fill view with the last GET_TX_STATE response without allocating a response class.
+    ///
+    /// \return False if no GET_TX_STATE response has been received.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual bool STDCALL get_tx_state_view(stream_output_get_tx_state_view & view) = 0;
+
     ///
     /// \return the stream_output get_tx_connection response class.
     ///
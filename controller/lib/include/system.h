@@ -70,6 +70,17 @@ public:
     /// End point of the system process, which terminates the threads.
     ///
     AVDECC_CONTROLLER_LIB32_API virtual int STDCALL process_close() = 0;
+
+    ///
+    /// Process received frames on worker threads rather than on the system thread. The End Stations are
+    /// shared between the workers by entity id, and the frames of one End Station are processed in the
+    /// order they were received by the same worker. Must be called before process_start().
+    ///
+    /// \param worker_count The number of worker threads. With 0, every frame is processed by the system thread.
+    ///
+    /// \return 0 on success, or -1 if RX workers are not supported on this platform.
+    ///
+    AVDECC_CONTROLLER_LIB32_API virtual int STDCALL set_rx_worker_count(uint32_t worker_count) = 0;
 };
 
 //
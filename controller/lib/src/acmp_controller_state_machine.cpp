@@ -38,6 +38,7 @@
 #include "log_imp.h"
 #include "inflight.h"
 #include "adp.h"
+#include "cmd_completion_imp.h"
 #include "acmp_controller_state_machine.h"
 
 namespace avdecc_lib
@@ -111,10 +112,28 @@ int acmp_controller_state_machine::state_resp(void *& notification_id, struct jd
     return proc_resp(notification_id, cmd_frame);
 }
 
-void acmp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
+void acmp_controller_state_machine::state_timeout(uint16_t seq_id, std::vector<void *> & timed_out)
 {
-    struct jdksavdecc_frame frame = inflight_cmds.at(inflight_cmd_index).frame();
-    bool is_retried = inflight_cmds.at(inflight_cmd_index).retried();
+    struct jdksavdecc_frame frame;
+    bool is_retried;
+    uint32_t notification_flag;
+    void * notification_id;
+
+    {
+        std::lock_guard<std::mutex> guard(inflight_lock);
+        inflight * cmd = inflight_cmds.find(seq_id);
+        if (!cmd)
+            return;
+
+        frame = cmd->frame();
+        is_retried = cmd->retried();
+        notification_flag = cmd->notification_flag();
+        notification_id = cmd->cmd_notification_id;
+
+        // A response received from now on is not matched to the command
+        if (is_retried)
+            inflight_cmds.erase(seq_id);
+    }
 
     if (is_retried)
     {
@@ -137,7 +156,7 @@ void acmp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
                                                               listener_entity_id,
                                                               0,
                                                               UINT_MAX,
-                                                              inflight_cmds.at(inflight_cmd_index).cmd_notification_id);
+                                                              notification_id);
 
         log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR,
                                   "Command Timeout, 0x%llx, %s, %s, %s, %d",
@@ -145,18 +164,19 @@ void acmp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
                                   utility::acmp_cmd_value_to_name(msg_type),
                                   "NULL",
                                   "NULL",
-                                  inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                  seq_id);
 
-        inflight_cmds.erase(inflight_cmds.begin() + inflight_cmd_index);
+        cmd_completions_ref->cmd_timed_out(notification_id);
+        timed_out.push_back(notification_id);
     }
     else
     {
         log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG,
                                   "Resend the command with sequence id = %d",
-                                  inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                  seq_id);
 
-        tx_cmd(inflight_cmds.at(inflight_cmd_index).cmd_notification_id,
-               inflight_cmds.at(inflight_cmd_index).notification_flag(),
+        tx_cmd(notification_id,
+               notification_flag,
                &frame,
                true);
     }
@@ -165,6 +185,7 @@ void acmp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
 int acmp_controller_state_machine::tx_cmd(void * notification_id, uint32_t notification_flag, struct jdksavdecc_frame * cmd_frame, bool resend)
 {
     int send_frame_returned;
+    std::unique_lock<std::mutex> guard(inflight_lock);
 
     if (!resend)
     {
@@ -180,20 +201,24 @@ int acmp_controller_state_machine::tx_cmd(void * notification_id, uint32_t notif
                                       timeout_ms);
 
         in_flight.start_timer();
-        inflight_cmds.push_back(in_flight);
+        inflight_deadlines.schedule(this_seq_id, in_flight.deadline());
+        inflight_cmds.insert(in_flight);
     }
     else
     {
         uint16_t resend_with_seq_id = jdksavdecc_acmpdu_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
-        std::vector<inflight>::iterator j =
-            std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(resend_with_seq_id));
+        inflight * j = inflight_cmds.find(resend_with_seq_id);
 
-        if (j != inflight_cmds.end()) // found?
+        if (j) // found?
         {
-            (*j).start_timer();
+            j->start_timer();
+            inflight_deadlines.schedule(resend_with_seq_id, j->deadline());
         }
     }
 
+    // A response can only be matched once the command is inflight, so it is sent after the table is updated
+    guard.unlock();
+
     send_frame_returned = net_interface_ref->send_frame(cmd_frame->payload, cmd_frame->length);
     if (send_frame_returned < 0)
     {
@@ -210,16 +235,25 @@ int acmp_controller_state_machine::proc_resp(void *& notification_id, struct jdk
 {
     uint16_t seq_id = jdksavdecc_acmpdu_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
     uint32_t notification_flag = 0;
+    bool found = false;
 
-    std::vector<inflight>::iterator j =
-        std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(seq_id));
+    {
+        std::lock_guard<std::mutex> guard(inflight_lock);
+        inflight * j = inflight_cmds.find(seq_id);
+
+        if (j) // found?
+        {
+            notification_id = j->cmd_notification_id;
+            notification_flag = j->notification_flag();
+            inflight_deadlines.cancel(seq_id);
+            inflight_cmds.erase(seq_id);
+            found = true;
+        }
+    }
 
-    if (j != inflight_cmds.end()) // found?
+    if (found)
     {
-        notification_id = (*j).cmd_notification_id;
-        notification_flag = (*j).notification_flag();
         callback(notification_id, notification_flag, cmd_frame->payload);
-        inflight_cmds.erase(j);
         return 1;
     }
     else
@@ -232,28 +266,31 @@ int acmp_controller_state_machine::proc_resp(void *& notification_id, struct jdk
     return -1;
 }
 
-void acmp_controller_state_machine::tick()
+void acmp_controller_state_machine::tick(uint64_t now_ms, std::vector<void *> & timed_out)
 {
-    for (uint32_t i = 0; i < inflight_cmds.size(); i++)
+    uint16_t seq_id;
+
+    for (;;)
     {
-        if (inflight_cmds.at(i).timeout())
         {
-            state_timeout(i);
+            std::lock_guard<std::mutex> guard(inflight_lock);
+            if (!inflight_deadlines.pop_expired(now_ms, seq_id))
+                break;
         }
+
+        state_timeout(seq_id, timed_out);
     }
 }
 
-bool acmp_controller_state_machine::is_inflight_cmd_with_notification_id(void * notification_id)
+bool acmp_controller_state_machine::next_deadline(uint64_t & deadline_ms)
 {
-    std::vector<inflight>::iterator j =
-        std::find_if(inflight_cmds.begin(), inflight_cmds.end(), NotificationComp(notification_id));
-
-    if (j != inflight_cmds.end()) // found?
-    {
-        return true;
-    }
+    std::lock_guard<std::mutex> guard(inflight_lock);
+    return inflight_deadlines.next_deadline(deadline_ms);
+}
 
-    return false;
+bool acmp_controller_state_machine::is_inflight_cmd_with_notification_id(void * notification_id)
+{
+    return inflight_cmds.has_notification_id(notification_id);
 }
 
 int acmp_controller_state_machine::callback(void * notification_id, uint32_t notification_flag, uint8_t * frame)
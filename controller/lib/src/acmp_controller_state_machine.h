@@ -29,6 +29,11 @@
 
 #pragma once
 
+#include <vector>
+#include <mutex>
+#include "inflight.h"
+#include "deadline_queue.h"
+
 namespace avdecc_lib
 {
 class inflight;
@@ -37,7 +42,9 @@ class acmp_controller_state_machine
 {
 private:
     uint16_t acmp_seq_id; // The sequence id used for identifying the ACMP command that a response is for
-    std::vector<inflight> inflight_cmds;
+    inflight_table inflight_cmds;
+    deadline_queue<uint16_t> inflight_deadlines; // Timeout of every inflight command, keyed by sequence id
+    std::mutex inflight_lock;                    // Protects the sequence id, the inflight commands and their timeouts
 
 public:
     acmp_controller_state_machine();
@@ -64,9 +71,15 @@ public:
     int state_resp(void *& notification_id, struct jdksavdecc_frame * cmd_frame);
 
     ///
-    /// Check timeout for the inflight commands.
+    /// Process the inflight commands whose timeout has expired. The notification id of every
+    /// command removed after its last retry is added to timed_out.
+    ///
+    void tick(uint64_t now_ms, std::vector<void *> & timed_out);
+
+    ///
+    /// \return False if no command is inflight, otherwise the earliest command timeout is stored in deadline_ms.
     ///
-    void tick();
+    bool next_deadline(uint64_t & deadline_ms);
 
     ///
     /// Check if the command with the corresponding notification id is already in the inflight command vector.
@@ -77,7 +90,7 @@ private:
     ///
     /// Process the Timeout state of the ACMP Controller State Machine.
     ///
-    void state_timeout(uint32_t inflight_cmd_index);
+    void state_timeout(uint16_t seq_id, std::vector<void *> & timed_out);
 
     ///
     /// Transmit an ACMP Command.
@@ -114,35 +114,27 @@ int adp_discovery_state_machine::tx_discover(struct jdksavdecc_frame * cmd_frame
     return 0;
 }
 
-bool adp_discovery_state_machine::have_entity(uint64_t entity_id, uint32_t * entity_index)
+bool adp_discovery_state_machine::have_entity(uint64_t entity_id)
 {
-    for (uint32_t i = 0; i < entities_vec.size(); i++)
-    {
-        if (entities_vec.at(i).entity_id == entity_id)
-        {
-            *entity_index = i;
-            return true;
-        }
-    }
-
-    return false;
+    return entities.find(entity_id) != entities.end();
 }
 
-int adp_discovery_state_machine::update_entity_timeout(uint32_t entity_index, uint32_t timeout_ms)
+int adp_discovery_state_machine::update_entity_timeout(uint64_t entity_id, uint32_t timeout_ms)
 {
-    entities_vec.at(entity_index).inflight_timer.start(timeout_ms);
+    entity_deadlines.schedule(entity_id, timer::clk_monotonic_ms() + timeout_ms);
     return 0;
 }
 
-int adp_discovery_state_machine::add_entity(struct entities new_entity)
+int adp_discovery_state_machine::add_entity(uint64_t entity_id)
 {
-    entities_vec.push_back(new_entity);
+    entities.insert(entity_id);
     return 0;
 }
 
-int adp_discovery_state_machine::remove_entity(uint32_t entity_index)
+int adp_discovery_state_machine::remove_entity(uint64_t entity_id)
 {
-    entities_vec.erase(entities_vec.begin() + entity_index);
+    entity_deadlines.cancel(entity_id);
+    entities.erase(entity_id);
     return 0;
 }
 
@@ -159,21 +151,19 @@ int adp_discovery_state_machine::state_avail(const uint8_t * frame, size_t frame
 {
     struct jdksavdecc_adpdu_common_control_header adp_hdr;
     uint64_t entity_entity_id;
-    uint32_t entity_index;
 
     entity_entity_id = jdksavdecc_uint64_get(frame, ETHER_HDR_SIZE + PROTOCOL_HDR_SIZE);
     jdksavdecc_adpdu_common_control_header_read(&adp_hdr, frame, ETHER_HDR_SIZE, frame_len);
 
-    if (have_entity(entity_entity_id, &entity_index))
+    std::lock_guard<std::mutex> guard(entity_lock);
+    if (have_entity(entity_entity_id))
     {
-        update_entity_timeout(entity_index, adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
+        update_entity_timeout(entity_entity_id, adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
     }
     else
     {
-        struct entities entity;
-        entity.entity_id = entity_entity_id;
-        entity.inflight_timer.start(adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
-        add_entity(entity);
+        add_entity(entity_entity_id);
+        update_entity_timeout(entity_entity_id, adp_hdr.valid_time * 2 * 1000); // Valid time period is between 2 and 62 seconds
         notification_imp_ref->post_notification_msg(END_STATION_CONNECTED, entity_entity_id, 0, 0, 0, 0, 0);
     }
 
@@ -186,31 +176,51 @@ int adp_discovery_state_machine::state_departing()
     return 0;
 }
 
-int adp_discovery_state_machine::state_timeout(uint32_t entity_index)
+int adp_discovery_state_machine::state_timeout(uint64_t entity_id)
 {
-    remove_entity(entity_index);
+    remove_entity(entity_id);
     return 0;
 }
 
-bool adp_discovery_state_machine::tick(uint64_t & end_station_entity_id)
+const std::vector<uint64_t> & adp_discovery_state_machine::tick(uint64_t now_ms)
 {
-    if (first_tick)
+    uint64_t end_station_entity_id;
+    bool discover;
+
+    departed_entities.clear();
+
     {
-        state_discover(0);
+        std::lock_guard<std::mutex> guard(entity_lock);
+        discover = first_tick;
         first_tick = false;
-    }
 
-    for (uint32_t i = 0; i < entities_vec.size(); i++)
-    {
-        if (entities_vec.at(i).inflight_timer.timeout())
+        while (entity_deadlines.pop_expired(now_ms, end_station_entity_id))
         {
-            end_station_entity_id = entities_vec.at(i).entity_id;
-            state_timeout(i);
-            notification_imp_ref->post_notification_msg(END_STATION_DISCONNECTED, end_station_entity_id, 0, 0, 0, 0, 0);
-            return true;
+            if (have_entity(end_station_entity_id))
+            {
+                state_timeout(end_station_entity_id);
+                departed_entities.push_back(end_station_entity_id);
+            }
         }
     }
 
-    return false;
+    if (discover)
+        state_discover(0);
+
+    notification_imp_ref->post_notification_msgs(END_STATION_DISCONNECTED, departed_entities);
+
+    return departed_entities;
+}
+
+bool adp_discovery_state_machine::next_deadline(uint64_t & deadline_ms)
+{
+    std::lock_guard<std::mutex> guard(entity_lock);
+    if (first_tick)
+    {
+        deadline_ms = 0; // Discover as soon as the first tick runs
+        return true;
+    }
+
+    return entity_deadlines.next_deadline(deadline_ms);
 }
 }
@@ -29,21 +29,22 @@
 
 #pragma once
 
+#include <vector>
+#include <mutex>
+#include <unordered_set>
 #include "timer.h"
+#include "deadline_queue.h"
 
 namespace avdecc_lib
 {
 class adp_discovery_state_machine
 {
 private:
-    struct entities
-    {
-        uint64_t entity_id;
-        timer inflight_timer;
-    };
-
     bool first_tick;
-    std::vector<struct entities> entities_vec;
+    std::unordered_set<uint64_t> entities;     // Entity id of every AVDECC Entity currently available
+    deadline_queue<uint64_t> entity_deadlines; // Expiry of every entity's advertised valid time, keyed by entity id
+    std::vector<uint64_t> departed_entities;   // Entities that timed out in the current tick
+    std::mutex entity_lock;                    // Protects the first tick flag, the entities and their expiry, updated by every RX thread
 
 public:
     adp_discovery_state_machine();
@@ -75,9 +76,17 @@ public:
     int state_departing();
 
     ///
-    /// Check timeout for the end stations.
+    /// Check timeout for the end stations. Every end station whose valid time has expired is removed
+    /// and END_STATION_DISCONNECTED is posted for all of them together.
+    ///
+    /// \return The entity ids of the end stations that have timed out, valid until the next tick().
+    ///
+    const std::vector<uint64_t> & tick(uint64_t now_ms);
+
+    ///
+    /// \return False if nothing is scheduled, otherwise the time of the next tick() that has work is stored in deadline_ms.
     ///
-    bool tick(uint64_t & end_station_entity_id);
+    bool next_deadline(uint64_t & deadline_ms);
 
 private:
     ///
@@ -94,27 +103,27 @@ private:
     ///
     /// Check if an AVDECC Entity is present in the entities variable.
     ///
-    bool have_entity(uint64_t entity_id, uint32_t * entity_index);
+    bool have_entity(uint64_t entity_id);
 
     ///
     /// Update the AVDECC Entity record timeout information.
     ///
-    int update_entity_timeout(uint32_t entity_index, uint32_t timeout_ms);
+    int update_entity_timeout(uint64_t entity_id, uint32_t timeout_ms);
 
     ///
     /// Add a new Entity record to the entities variable.
     ///
-    int add_entity(struct entities new_entity);
+    int add_entity(uint64_t entity_id);
 
     ///
     /// Remove an Entity record form the entities variable.
     ///
-    int remove_entity(uint32_t entity_index);
+    int remove_entity(uint64_t entity_id);
 
     ///
     /// Process the Timeout state of the ADP Discovery State Machine.
     ///
-    int state_timeout(uint32_t entity_index);
+    int state_timeout(uint64_t entity_id);
 };
 
 extern adp_discovery_state_machine * adp_discovery_state_machine_ref;
@@ -29,6 +29,7 @@
 
 #include <algorithm>
 #include <vector>
+#include <mutex>
 #include "jdksavdecc_aem_command.h"
 #include "net_interface_imp.h"
 #include "util.h"
@@ -37,15 +38,24 @@
 #include "log_imp.h"
 #include "inflight.h"
 #include "operation.h"
+#include "aem_resp_dispatch.h"
+#include "cmd_completion_imp.h"
 #include "aecp_controller_state_machine.h"
 
 namespace avdecc_lib
 {
 aecp_controller_state_machine * aecp_controller_state_machine_ref = new aecp_controller_state_machine(); // To have one Controller State Machine for all end stations
 
+static uint64_t target_entity_id(const uint8_t * frame)
+{
+    jdksavdecc_eui64 id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
+    return jdksavdecc_uint64_get(&id, 0);
+}
+
 aecp_controller_state_machine::aecp_controller_state_machine()
 {
     aecp_seq_id = 0;
+    default_window = AECP_DEFAULT_WINDOW;
 }
 
 aecp_controller_state_machine::~aecp_controller_state_machine() {}
@@ -99,6 +109,8 @@ void aecp_controller_state_machine::common_hdr_init(int message_type, struct jdk
 int aecp_controller_state_machine::tx_cmd(void * notification_id, uint32_t notification_flag, struct jdksavdecc_frame * cmd_frame, bool resend)
 {
     int send_frame_returned;
+    uint32_t rto_ms = resend ? 0 : get_rto_ms(target_entity_id(cmd_frame->payload));
+    std::unique_lock<std::mutex> guard(inflight_lock);
 
     if (!resend)
     {
@@ -109,22 +121,28 @@ int aecp_controller_state_machine::tx_cmd(void * notification_id, uint32_t notif
                                       current_seq_id,
                                       notification_id,
                                       notification_flag,
-                                      AVDECC_MSG_TIMEOUT_MS);
+                                      rto_ms);
+        in_flight.set_retry_policy(rto_ms, sends_for_rto(rto_ms));
         in_flight.start_timer();
-        inflight_cmds.push_back(in_flight);
+        inflight_deadlines.schedule(current_seq_id, in_flight.deadline());
+        inflight_cmds.insert(in_flight);
     }
     else
     {
         uint16_t resend_with_seq_id = jdksavdecc_aecpdu_common_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
-        std::vector<inflight>::iterator j =
-            std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(resend_with_seq_id));
+        inflight * j = inflight_cmds.find(resend_with_seq_id);
 
-        if (j != inflight_cmds.end()) // found?
+        if (j) // found?
         {
+            j->backoff(AECP_RTO_MAX_MS);
             j->start_timer();
+            inflight_deadlines.schedule(resend_with_seq_id, j->deadline());
         }
     }
 
+    // A response can only be matched once the command is inflight, so it is sent after the table is updated
+    guard.unlock();
+
     send_frame_returned = net_interface_ref->send_frame(cmd_frame->payload, cmd_frame->length);
     if (send_frame_returned < 0)
     {
@@ -152,37 +170,119 @@ int aecp_controller_state_machine::proc_resp(void *& notification_id, struct jdk
     uint16_t seq_id = jdksavdecc_aecpdu_common_get_sequence_id(cmd_frame->payload, ETHER_HDR_SIZE);
     uint32_t status = jdksavdecc_common_control_header_get_status(cmd_frame->payload, ETHER_HDR_SIZE);
     uint32_t notification_flag = 0;
+    uint32_t rtt_ms;
+    bool has_rtt_sample;
 
-    std::vector<inflight>::iterator j =
-        std::find_if(inflight_cmds.begin(), inflight_cmds.end(), SeqIdComp(seq_id));
-
-    if (j != inflight_cmds.end()) // found?
     {
+        std::lock_guard<std::mutex> guard(inflight_lock);
+        inflight * j = inflight_cmds.find(seq_id);
+
+        if (!j) // not found?
+            return -1;
+
+        has_rtt_sample = j->rtt_sample(timer::clk_monotonic_ms(), rtt_ms);
         notification_id = j->cmd_notification_id;
         notification_flag = j->notification_flag();
-        callback(notification_id, notification_flag, cmd_frame->payload);
 
         // Restart the timer if response is indicating the operation is still in progress so that it won't be timed out
         if (status == AEM_STATUS_IN_PROGRESS)
         {
             j->restart_timer();
+            inflight_deadlines.schedule(seq_id, j->deadline());
         }
         else
         {
-            inflight_cmds.erase(j);
+            inflight_deadlines.cancel(seq_id);
+            inflight_cmds.erase(seq_id);
         }
+    }
 
-        return 1;
+    if (has_rtt_sample)
+    {
+        std::lock_guard<std::mutex> guard(window_lock);
+        rtt_update(entity_states[target_entity_id(cmd_frame->payload)], rtt_ms);
     }
 
-    return -1;
+    callback(notification_id, notification_flag, cmd_frame->payload);
+
+    if (status != AEM_STATUS_IN_PROGRESS)
+        release_window_slot(target_entity_id(cmd_frame->payload));
+
+    return 1;
 }
 
 int aecp_controller_state_machine::state_send_cmd(void * notification_id, uint32_t notification_flag, struct jdksavdecc_frame * cmd_frame)
 {
+    {
+        std::lock_guard<std::mutex> guard(window_lock);
+        entity_state & w = entity_states[target_entity_id(cmd_frame->payload)];
+
+        if (w.outstanding >= window_size(w))
+        {
+            queued_cmd q;
+            q.frame = *cmd_frame;
+            q.notification_id = notification_id;
+            q.notification_flag = notification_flag;
+            q.queued_ms = timer::clk_monotonic_ms();
+            w.queue.push_back(q);
+            queued_notification_counts[notification_id]++;
+            return 0;
+        }
+
+        w.outstanding++;
+    }
+
     return tx_cmd(notification_id, notification_flag, cmd_frame, false);
 }
 
+void aecp_controller_state_machine::release_window_slot(uint64_t entity_id)
+{
+    std::vector<queued_cmd> ready;
+
+    {
+        std::lock_guard<std::mutex> guard(window_lock);
+        std::unordered_map<uint64_t, entity_state>::iterator i = entity_states.find(entity_id);
+        if (i == entity_states.end())
+            return;
+
+        entity_state & w = i->second;
+        if (w.outstanding)
+            w.outstanding--;
+
+        if (w.queue.empty())
+            return;
+
+        uint64_t now_ms = timer::clk_monotonic_ms();
+        while (!w.queue.empty() && w.outstanding < window_size(w))
+        {
+            uint32_t wait_ms = (uint32_t)(now_ms - w.queue.front().queued_ms);
+            w.queue_wait_total_ms += wait_ms;
+            w.queue_wait_count++;
+            if (wait_ms > w.queue_wait_max_ms)
+                w.queue_wait_max_ms = wait_ms;
+
+            ready.push_back(w.queue.front());
+            w.queue.pop_front();
+            w.outstanding++;
+        }
+    }
+
+    for (size_t i = 0; i < ready.size(); i++)
+    {
+        tx_cmd(ready[i].notification_id, ready[i].notification_flag, &ready[i].frame, false);
+    }
+
+    // The released commands are only dropped from the queued counts once they are inflight, so
+    // that a waiter never sees them as neither queued nor inflight
+    std::lock_guard<std::mutex> guard(window_lock);
+    for (size_t i = 0; i < ready.size(); i++)
+    {
+        std::unordered_map<void *, uint32_t>::iterator n = queued_notification_counts.find(ready[i].notification_id);
+        if (n != queued_notification_counts.end() && --n->second == 0)
+            queued_notification_counts.erase(n);
+    }
+}
+
 int aecp_controller_state_machine::state_rcvd_unsolicited(struct jdksavdecc_frame * cmd_frame)
 {
     return proc_unsolicited(cmd_frame);
@@ -193,11 +293,28 @@ int aecp_controller_state_machine::state_rcvd_resp(void *& notification_id, stru
     return proc_resp(notification_id, cmd_frame);
 }
 
-void aecp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
+void aecp_controller_state_machine::state_timeout(uint16_t seq_id, std::vector<void *> & timed_out)
 {
-    struct jdksavdecc_frame frame = inflight_cmds.at(inflight_cmd_index).frame();
-    bool is_retried = inflight_cmds.at(inflight_cmd_index).retried();
-    uint32_t notification_flag = inflight_cmds.at(inflight_cmd_index).notification_flag();
+    struct jdksavdecc_frame frame;
+    bool is_retried;
+    uint32_t notification_flag;
+    void * notification_id;
+
+    {
+        std::lock_guard<std::mutex> guard(inflight_lock);
+        inflight * cmd = inflight_cmds.find(seq_id);
+        if (!cmd)
+            return;
+
+        frame = cmd->frame();
+        is_retried = cmd->retried();
+        notification_flag = cmd->notification_flag();
+        notification_id = cmd->cmd_notification_id;
+
+        // A response received from now on is not matched to the command
+        if (is_retried)
+            inflight_cmds.erase(seq_id);
+    }
 
     if (is_retried)
     {
@@ -213,7 +330,7 @@ void aecp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
                                                     desc_type,
                                                     desc_index,
                                                     UINT_MAX,
-                                                    inflight_cmds.at(inflight_cmd_index).cmd_notification_id);
+                                                    notification_id);
 
         log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR,
                                   "Command Timeout, 0x%llx, %s, %s, %d, %d",
@@ -221,34 +338,54 @@ void aecp_controller_state_machine::state_timeout(uint32_t inflight_cmd_index)
                                   utility::aem_cmd_value_to_name(cmd_type),
                                   utility::aem_desc_value_to_name(desc_type),
                                   desc_index,
-                                  inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                  seq_id);
 
-        inflight_cmds.erase(inflight_cmds.begin() + inflight_cmd_index);
+        release_window_slot(jdksavdecc_uint64_get(&id, 0));
+        cmd_completions_ref->cmd_timed_out(notification_id);
+        timed_out.push_back(notification_id);
     }
     else
     {
         log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG,
                                   "Resend the command with sequence id = %d",
-                                  inflight_cmds.at(inflight_cmd_index).cmd_seq_id);
+                                  seq_id);
 
-        tx_cmd(inflight_cmds.at(inflight_cmd_index).cmd_notification_id,
+        // Back off the timeout of the entity until a response to a command sent once gives a new sample
+        {
+            std::lock_guard<std::mutex> guard(window_lock);
+            entity_state & e = entity_states[target_entity_id(frame.payload)];
+            e.rto_ms = (e.rto_ms * 2 < AECP_RTO_MAX_MS) ? e.rto_ms * 2 : AECP_RTO_MAX_MS;
+        }
+
+        tx_cmd(notification_id,
                notification_flag,
                &frame,
                true);
     }
 }
 
-void aecp_controller_state_machine::tick()
+void aecp_controller_state_machine::tick(uint64_t now_ms, std::vector<void *> & timed_out)
 {
-    for (uint32_t i = 0; i < inflight_cmds.size(); i++)
+    uint16_t seq_id;
+
+    for (;;)
     {
-        if (inflight_cmds.at(i).timeout())
         {
-            state_timeout(i);
+            std::lock_guard<std::mutex> guard(inflight_lock);
+            if (!inflight_deadlines.pop_expired(now_ms, seq_id))
+                break;
         }
+
+        state_timeout(seq_id, timed_out);
     }
 }
 
+bool aecp_controller_state_machine::next_deadline(uint64_t & deadline_ms)
+{
+    std::lock_guard<std::mutex> guard(inflight_lock);
+    return inflight_deadlines.next_deadline(deadline_ms);
+}
+
 int aecp_controller_state_machine::update_inflight_for_rcvd_resp(void *& notification_id, uint32_t msg_type, bool u_field, struct jdksavdecc_frame * cmd_frame)
 {
     switch (msg_type)
@@ -282,7 +419,10 @@ int aecp_controller_state_machine::start_operation(void *& notification_id, uint
                                operation_type,
                                notification_id,
                                CMD_WITH_NOTIFICATION);
-    active_operations.push_back(oper);
+    {
+        std::lock_guard<std::mutex> guard(window_lock);
+        active_operations.push_back(oper);
+    }
 
     log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Added new operation with type %x and id %d", operation_type, operation_id);
 
@@ -292,6 +432,7 @@ int aecp_controller_state_machine::start_operation(void *& notification_id, uint
 int aecp_controller_state_machine::update_operation_for_rcvd_resp(void *& notification_id, uint16_t operation_id, uint16_t percent_complete, struct jdksavdecc_frame * cmd_frame)
 {
     uint32_t notification_flag = 0;
+    std::unique_lock<std::mutex> guard(window_lock);
 
     std::vector<operation>::iterator j =
         std::find_if(active_operations.begin(), active_operations.end(), operation_id_comp(operation_id));
@@ -300,12 +441,14 @@ int aecp_controller_state_machine::update_operation_for_rcvd_resp(void *& notifi
     {
         notification_id = j->cmd_notification_id;
         notification_flag = j->notification_flag();
-        callback(notification_id, notification_flag, cmd_frame->payload);
         if (percent_complete == 0 || percent_complete == 1000)
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Removed operation with id %d, percent_complete: %d", operation_id, percent_complete);
             active_operations.erase(j);
         }
+        guard.unlock();
+
+        callback(notification_id, notification_flag, cmd_frame->payload);
         return 1;
     }
 
@@ -314,6 +457,7 @@ int aecp_controller_state_machine::update_operation_for_rcvd_resp(void *& notifi
 
 bool aecp_controller_state_machine::is_active_operation_with_notification_id(void * notification_id)
 {
+    std::lock_guard<std::mutex> guard(window_lock);
     std::vector<operation>::iterator j =
         std::find_if(active_operations.begin(), active_operations.end(), notification_comp(notification_id));
 
@@ -336,129 +480,9 @@ int aecp_controller_state_machine::callback(void * notification_id, uint32_t not
     bool is_unsolicited = cmd_type >> 15 & 0x01;
     cmd_type &= 0x7FFF;
 
-    switch (cmd_type)
+    if (!aem_resp_dispatch_ref->get_desc(cmd_type, frame, desc_type, desc_index))
     {
-    case JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY:
-        desc_type = jdksavdecc_aem_command_acquire_entity_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_acquire_entity_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_LOCK_ENTITY:
-        desc_type = jdksavdecc_aem_command_lock_entity_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_lock_entity_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE:
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_CONTROLLER_AVAILABLE:
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR:
-        desc_type = jdksavdecc_aem_command_read_descriptor_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_read_descriptor_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP:
-        desc_type = jdksavdecc_aem_command_get_audio_map_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_audio_map_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_ADD_AUDIO_MAPPINGS:
-        desc_type = jdksavdecc_aem_command_add_audio_mappings_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_add_audio_mappings_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_REMOVE_AUDIO_MAPPINGS:
-        desc_type = jdksavdecc_aem_command_remove_audio_mappings_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_remove_audio_mappings_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_STREAM_FORMAT:
-        desc_type = jdksavdecc_aem_command_set_stream_format_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_stream_format_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT:
-        desc_type = jdksavdecc_aem_command_get_stream_format_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_stream_format_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_STREAM_INFO:
-        desc_type = jdksavdecc_aem_command_set_stream_info_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_stream_info_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO:
-        desc_type = jdksavdecc_aem_command_get_stream_info_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_stream_info_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_NAME:
-        desc_type = jdksavdecc_aem_command_set_name_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_name_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_NAME:
-        desc_type = jdksavdecc_aem_command_get_name_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_name_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_SAMPLING_RATE:
-        desc_type = jdksavdecc_aem_command_set_sampling_rate_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_sampling_rate_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_SAMPLING_RATE:
-        desc_type = jdksavdecc_aem_command_get_sampling_rate_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_sampling_rate_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_CLOCK_SOURCE:
-        desc_type = jdksavdecc_aem_command_set_clock_source_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_clock_source_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_CLOCK_SOURCE:
-        desc_type = jdksavdecc_aem_command_get_clock_source_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_clock_source_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_START_STREAMING:
-        desc_type = jdksavdecc_aem_command_start_streaming_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_start_streaming_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_STOP_STREAMING:
-        desc_type = jdksavdecc_aem_command_stop_streaming_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_stop_streaming_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_COUNTERS:
-        desc_type = jdksavdecc_aem_command_get_counters_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_counters_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_AVB_INFO:
-        desc_type = jdksavdecc_aem_command_get_avb_info_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_avb_info_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_REGISTER_UNSOLICITED_NOTIFICATION:
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_DEREGISTER_UNSOLICITED_NOTIFICATION:
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_CONFIGURATION:
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_CONFIGURATION:
-        break;
-
-    default:
         log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "NO_MATCH_FOUND for %s", utility::aem_cmd_value_to_name(cmd_type));
-        break;
     }
 
     jdksavdecc_eui64 id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
@@ -543,14 +567,117 @@ int aecp_controller_state_machine::callback(void * notification_id, uint32_t not
 
 bool aecp_controller_state_machine::is_inflight_cmd_with_notification_id(void * notification_id)
 {
-    std::vector<inflight>::iterator j =
-        std::find_if(inflight_cmds.begin(), inflight_cmds.end(), NotificationComp(notification_id));
+    if (inflight_cmds.has_notification_id(notification_id))
+        return true;
+
+    std::lock_guard<std::mutex> guard(window_lock);
+    return queued_notification_counts.find(notification_id) != queued_notification_counts.end();
+}
+
+void aecp_controller_state_machine::set_default_window(uint32_t window)
+{
+    std::lock_guard<std::mutex> guard(window_lock);
+    default_window = window ? window : 1;
+}
 
-    if (j != inflight_cmds.end()) // found?
+void aecp_controller_state_machine::set_window(uint64_t entity_id, uint32_t window)
+{
+    std::lock_guard<std::mutex> guard(window_lock);
+    entity_states[entity_id].window = window;
+}
+
+uint32_t aecp_controller_state_machine::get_window(uint64_t entity_id)
+{
+    std::lock_guard<std::mutex> guard(window_lock);
+    std::unordered_map<uint64_t, entity_state>::iterator i = entity_states.find(entity_id);
+    return i == entity_states.end() ? default_window : window_size(i->second);
+}
+
+uint32_t aecp_controller_state_machine::get_window_occupancy(uint64_t entity_id)
+{
+    std::lock_guard<std::mutex> guard(window_lock);
+    std::unordered_map<uint64_t, entity_state>::iterator i = entity_states.find(entity_id);
+    return i == entity_states.end() ? 0 : i->second.outstanding;
+}
+
+uint32_t aecp_controller_state_machine::get_queue_depth(uint64_t entity_id)
+{
+    std::lock_guard<std::mutex> guard(window_lock);
+    std::unordered_map<uint64_t, entity_state>::iterator i = entity_states.find(entity_id);
+    return i == entity_states.end() ? 0 : (uint32_t)i->second.queue.size();
+}
+
+uint32_t aecp_controller_state_machine::get_rto_ms(uint64_t entity_id)
+{
+    std::lock_guard<std::mutex> guard(window_lock);
+    std::unordered_map<uint64_t, entity_state>::iterator i = entity_states.find(entity_id);
+    return i == entity_states.end() ? AVDECC_MSG_TIMEOUT_MS : i->second.rto_ms;
+}
+
+uint32_t aecp_controller_state_machine::command_lifetime_ms(uint64_t entity_id)
+{
+    uint32_t rto_ms = get_rto_ms(entity_id);
+    uint32_t lifetime_ms = 0;
+    uint32_t sends = sends_for_rto(rto_ms);
+
+    for (uint32_t i = 0; i < sends; i++)
     {
-        return true;
+        lifetime_ms += rto_ms;
+        rto_ms = (rto_ms * 2 < AECP_RTO_MAX_MS) ? rto_ms * 2 : AECP_RTO_MAX_MS;
     }
 
-    return false;
+    return lifetime_ms;
+}
+
+void aecp_controller_state_machine::rtt_update(entity_state & e, uint32_t rtt_ms)
+{
+    if (!e.has_rtt)
+    {
+        e.srtt_ms = rtt_ms;
+        e.rttvar_ms = rtt_ms / 2;
+        e.has_rtt = true;
+    }
+    else
+    {
+        uint32_t delta_ms = (e.srtt_ms > rtt_ms) ? e.srtt_ms - rtt_ms : rtt_ms - e.srtt_ms;
+        e.rttvar_ms = (3 * e.rttvar_ms + delta_ms) / 4;
+        e.srtt_ms = (7 * e.srtt_ms + rtt_ms) / 8;
+    }
+
+    uint32_t rto_ms = e.srtt_ms + std::max<uint32_t>(1, 4 * e.rttvar_ms); // The clock granularity is 1 ms
+    e.rto_ms = std::min<uint32_t>(std::max<uint32_t>(rto_ms, AECP_RTO_MIN_MS), AECP_RTO_MAX_MS);
+}
+
+uint32_t aecp_controller_state_machine::sends_for_rto(uint32_t rto_ms)
+{
+    uint32_t sends = 0;
+    uint32_t total_ms = 0;
+
+    // Every command is sent AECP_MIN_SENDS times, and an entity answering quickly is given more
+    // retries within the same budget, as its timeouts are short
+    while (sends < AECP_MAX_SENDS)
+    {
+        if (sends >= AECP_MIN_SENDS && total_ms + rto_ms > AECP_RETRY_BUDGET_MS)
+            break;
+        total_ms += rto_ms;
+        rto_ms = (rto_ms * 2 < AECP_RTO_MAX_MS) ? rto_ms * 2 : AECP_RTO_MAX_MS;
+        sends++;
+    }
+
+    return sends;
+}
+
+void aecp_controller_state_machine::get_queue_wait_ms(uint64_t entity_id, uint32_t & avg_ms, uint32_t & max_ms)
+{
+    std::lock_guard<std::mutex> guard(window_lock);
+    std::unordered_map<uint64_t, entity_state>::iterator i = entity_states.find(entity_id);
+
+    avg_ms = 0;
+    max_ms = 0;
+    if (i != entity_states.end() && i->second.queue_wait_count)
+    {
+        avg_ms = (uint32_t)(i->second.queue_wait_total_ms / i->second.queue_wait_count);
+        max_ms = i->second.queue_wait_max_ms;
+    }
 }
 }
@@ -30,8 +30,13 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "enumeration.h"
 #include "inflight.h"
 #include "operation.h"
+#include "deadline_queue.h"
 
 namespace avdecc_lib
 {
@@ -40,10 +45,42 @@ class inflight;
 class aecp_controller_state_machine
 {
 private:
+    struct queued_cmd
+    {
+        struct jdksavdecc_frame frame;
+        void * notification_id;
+        uint32_t notification_flag;
+        uint64_t queued_ms; // Time the command was queued, from timer::clk_monotonic_ms()
+    };
+
+    struct entity_state
+    {
+        uint32_t window;      // Maximum number of outstanding commands, 0 if the default window applies
+        uint32_t outstanding; // Number of commands sent and not yet completed or timed out
+        std::deque<queued_cmd> queue;
+        uint64_t queue_wait_total_ms;
+        uint32_t queue_wait_count;
+        uint32_t queue_wait_max_ms;
+        uint32_t srtt_ms;   // Smoothed round trip time, valid once has_rtt is set
+        uint32_t rttvar_ms; // Round trip time variation
+        uint32_t rto_ms;    // Timeout of the first transmission of the next command
+        bool has_rtt;
+
+        entity_state() : window(0), outstanding(0), queue_wait_total_ms(0), queue_wait_count(0), queue_wait_max_ms(0),
+                         srtt_ms(0), rttvar_ms(0), rto_ms(AVDECC_MSG_TIMEOUT_MS), has_rtt(false) {}
+    };
+
     uint16_t aecp_seq_id; // The sequence id used for identifying the AECP command that a response is for
-    std::vector<inflight> inflight_cmds;
+    inflight_table inflight_cmds;
+    deadline_queue<uint16_t> inflight_deadlines; // Timeout of every inflight command, keyed by sequence id
+    std::mutex inflight_lock;                    // Protects the sequence id, the inflight commands and their timeouts
     std::vector<operation> active_operations;
 
+    uint32_t default_window;
+    std::unordered_map<uint64_t, entity_state> entity_states; // Command window and round trip time of every target entity
+    std::unordered_map<void *, uint32_t> queued_notification_counts;
+    std::mutex window_lock; // Protects the entity state and the active operations read from other threads
+
 public:
     aecp_controller_state_machine();
 
@@ -74,9 +111,15 @@ public:
     int state_rcvd_resp(void *& notification_id, struct jdksavdecc_frame * cmd_frame);
 
     ///
-    /// Check timeout for the inflight commands.
+    /// Process the inflight commands whose timeout has expired. The notification id of every
+    /// command removed after its last retry is added to timed_out.
+    ///
+    void tick(uint64_t now_ms, std::vector<void *> & timed_out);
+
+    ///
+    /// \return False if no command is inflight, otherwise the earliest command timeout is stored in deadline_ms.
     ///
-    void tick();
+    bool next_deadline(uint64_t & deadline_ms);
 
     ///
     /// Update inflight command for the response received.
@@ -93,6 +136,49 @@ public:
     ///
     bool is_inflight_cmd_with_notification_id(void * notification_id);
 
+    ///
+    /// Set the window used by every entity without its own window. The window is the maximum number of
+    /// commands outstanding to one entity; further commands are queued until a command completes.
+    ///
+    void set_default_window(uint32_t window);
+
+    ///
+    /// Set the window of the entity with entity_id. A window of 0 restores the default window.
+    ///
+    void set_window(uint64_t entity_id, uint32_t window);
+
+    ///
+    /// \return The window applied to the entity with entity_id.
+    ///
+    uint32_t get_window(uint64_t entity_id);
+
+    ///
+    /// \return The number of commands outstanding to the entity with entity_id.
+    ///
+    uint32_t get_window_occupancy(uint64_t entity_id);
+
+    ///
+    /// \return The number of commands to the entity with entity_id queued behind a full window.
+    ///
+    uint32_t get_queue_depth(uint64_t entity_id);
+
+    ///
+    /// \return The average and maximum time in milliseconds commands to the entity with entity_id
+    ///         have spent queued behind a full window.
+    ///
+    void get_queue_wait_ms(uint64_t entity_id, uint32_t & avg_ms, uint32_t & max_ms);
+
+    ///
+    /// \return The timeout of the first transmission of the next command to the entity with entity_id.
+    ///
+    uint32_t get_rto_ms(uint64_t entity_id);
+
+    ///
+    /// \return The time in milliseconds after which a command sent now to the entity with entity_id
+    ///         has used all its retries.
+    ///
+    uint32_t command_lifetime_ms(uint64_t entity_id);
+
 private:
     ///
     /// Transmit an AEM Command.
@@ -113,7 +199,30 @@ private:
     /// Notify the application that a command has timed out and the retry has timed out and the
     /// inflight command is removed from the inflight list.
     ///
-    void state_timeout(uint32_t inflight_cmd_index);
+    void state_timeout(uint16_t seq_id, std::vector<void *> & timed_out);
+
+    ///
+    /// Release the window slot of a command to the entity with entity_id that has completed or timed out,
+    /// and transmit the queued commands that now fit in the window.
+    ///
+    void release_window_slot(uint64_t entity_id);
+
+    inline uint32_t window_size(const entity_state & w) const
+    {
+        return w.window ? w.window : default_window;
+    }
+
+    ///
+    /// Update the smoothed round trip time and timeout of an entity with a new sample, as for
+    /// the TCP retransmission timer in RFC 6298.
+    ///
+    void rtt_update(entity_state & e, uint32_t rtt_ms);
+
+    ///
+    /// \return The number of transmissions of a command with a timeout of rto_ms, doubling on every
+    ///         retry, that fit in AECP_RETRY_BUDGET_MS, from AECP_MIN_SENDS to AECP_MAX_SENDS.
+    ///
+    static uint32_t sends_for_rto(uint32_t rto_ms);
 
     ///
     /// Call notification or post_log_msg callback function for the command sent or response received.
@@ -0,0 +1,318 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * aem_resp_dispatch.cpp
+ *
+ * AEM response dispatch table implementation
+ */
+
+#include <cstring>
+#include <assert.h>
+#include "jdksavdecc_aem_command.h"
+#include "enumeration.h"
+#include "aecp_controller_state_machine.h"
+#include "entity_descriptor_imp.h"
+#include "aem_resp_dispatch.h"
+
+namespace avdecc_lib
+{
+aem_resp_dispatch * aem_resp_dispatch_ref = new aem_resp_dispatch(); // To have one AEM response dispatch table for all end stations
+
+///
+/// Call a response handler of the descriptor implementation IMP, whose public descriptor class is IFACE.
+///
+template <typename IFACE, typename IMP, int (IMP::*PROC)(void *&, const uint8_t *, size_t, int &)>
+static int proc_typed_resp(descriptor_base_imp * desc,
+                           void * typed_desc,
+                           void *& notification_id,
+                           const uint8_t * frame,
+                           size_t frame_len,
+                           int & status,
+                           uint16_t & operation_id,
+                           bool & is_operation_id_valid)
+{
+    IMP * imp = static_cast<IMP *>(static_cast<IFACE *>(typed_desc));
+    return (imp->*PROC)(notification_id, frame, frame_len, status);
+}
+
+///
+/// Call a response handler common to every descriptor implementation.
+///
+template <int (descriptor_base_imp::*PROC)(void *&, const uint8_t *, size_t, int &)>
+static int proc_base_resp(descriptor_base_imp * desc,
+                          void * typed_desc,
+                          void *& notification_id,
+                          const uint8_t * frame,
+                          size_t frame_len,
+                          int & status,
+                          uint16_t & operation_id,
+                          bool & is_operation_id_valid)
+{
+    return (desc->*PROC)(notification_id, frame, frame_len, status);
+}
+
+static int proc_start_operation_resp(descriptor_base_imp * desc,
+                                     void * typed_desc,
+                                     void *& notification_id,
+                                     const uint8_t * frame,
+                                     size_t frame_len,
+                                     int & status,
+                                     uint16_t & operation_id,
+                                     bool & is_operation_id_valid)
+{
+    memory_object_descriptor_imp * imp = static_cast<memory_object_descriptor_imp *>(static_cast<memory_object_descriptor *>(typed_desc));
+    uint16_t operation_type;
+
+    int rc = imp->proc_start_operation_resp(notification_id, frame, frame_len, status, operation_id, operation_type);
+    if (status == AEM_STATUS_SUCCESS && operation_id)
+    {
+        aecp_controller_state_machine_ref->start_operation(notification_id, operation_id, operation_type, frame, frame_len);
+        is_operation_id_valid = true;
+    }
+
+    return rc;
+}
+
+static int proc_operation_status_resp(descriptor_base_imp * desc,
+                                      void * typed_desc,
+                                      void *& notification_id,
+                                      const uint8_t * frame,
+                                      size_t frame_len,
+                                      int & status,
+                                      uint16_t & operation_id,
+                                      bool & is_operation_id_valid)
+{
+    memory_object_descriptor_imp * imp = static_cast<memory_object_descriptor_imp *>(static_cast<memory_object_descriptor *>(typed_desc));
+    return imp->proc_operation_status_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
+}
+
+aem_resp_dispatch::aem_resp_dispatch()
+{
+    memset(cmds, 0, sizeof(cmds));
+
+    // Commands without descriptor fields
+    add_cmd(JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE, NULL, NULL);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_CONTROLLER_AVAILABLE, NULL, NULL);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_REGISTER_UNSOLICITED_NOTIFICATION, NULL, NULL);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_DEREGISTER_UNSOLICITED_NOTIFICATION, NULL, NULL);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_CONFIGURATION, NULL, NULL);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_SET_CONFIGURATION, NULL, NULL);
+
+    // The descriptor fields of these commands are at the same offset in the command and the response
+    add_cmd(JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY,
+            jdksavdecc_aem_command_acquire_entity_response_get_descriptor_type,
+            jdksavdecc_aem_command_acquire_entity_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_LOCK_ENTITY,
+            jdksavdecc_aem_command_lock_entity_get_descriptor_type,
+            jdksavdecc_aem_command_lock_entity_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR,
+            jdksavdecc_aem_command_read_descriptor_get_descriptor_type,
+            jdksavdecc_aem_command_read_descriptor_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_SET_STREAM_FORMAT,
+            jdksavdecc_aem_command_set_stream_format_response_get_descriptor_type,
+            jdksavdecc_aem_command_set_stream_format_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT,
+            jdksavdecc_aem_command_get_stream_format_response_get_descriptor_type,
+            jdksavdecc_aem_command_get_stream_format_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_SET_STREAM_INFO,
+            jdksavdecc_aem_command_set_stream_info_response_get_descriptor_type,
+            jdksavdecc_aem_command_set_stream_info_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO,
+            jdksavdecc_aem_command_get_stream_info_response_get_descriptor_type,
+            jdksavdecc_aem_command_get_stream_info_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_SET_NAME,
+            jdksavdecc_aem_command_set_name_response_get_descriptor_type,
+            jdksavdecc_aem_command_set_name_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_NAME,
+            jdksavdecc_aem_command_get_name_response_get_descriptor_type,
+            jdksavdecc_aem_command_get_name_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_SET_SAMPLING_RATE,
+            jdksavdecc_aem_command_set_sampling_rate_response_get_descriptor_type,
+            jdksavdecc_aem_command_set_sampling_rate_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_SAMPLING_RATE,
+            jdksavdecc_aem_command_get_sampling_rate_response_get_descriptor_type,
+            jdksavdecc_aem_command_get_sampling_rate_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_SET_CLOCK_SOURCE,
+            jdksavdecc_aem_command_set_clock_source_response_get_descriptor_type,
+            jdksavdecc_aem_command_set_clock_source_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_CLOCK_SOURCE,
+            jdksavdecc_aem_command_get_clock_source_response_get_descriptor_type,
+            jdksavdecc_aem_command_get_clock_source_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_SET_CONTROL,
+            jdksavdecc_aem_command_set_control_response_get_descriptor_type,
+            jdksavdecc_aem_command_set_control_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_START_STREAMING,
+            jdksavdecc_aem_command_start_streaming_response_get_descriptor_type,
+            jdksavdecc_aem_command_start_streaming_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_STOP_STREAMING,
+            jdksavdecc_aem_command_stop_streaming_response_get_descriptor_type,
+            jdksavdecc_aem_command_stop_streaming_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_AVB_INFO,
+            jdksavdecc_aem_command_get_avb_info_response_get_descriptor_type,
+            jdksavdecc_aem_command_get_avb_info_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_COUNTERS,
+            jdksavdecc_aem_command_get_counters_response_get_descriptor_type,
+            jdksavdecc_aem_command_get_counters_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_REBOOT,
+            jdksavdecc_aem_command_reboot_get_descriptor_type,
+            jdksavdecc_aem_command_reboot_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP,
+            jdksavdecc_aem_command_get_audio_map_get_descriptor_type,
+            jdksavdecc_aem_command_get_audio_map_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_ADD_AUDIO_MAPPINGS,
+            jdksavdecc_aem_command_add_audio_mappings_get_descriptor_type,
+            jdksavdecc_aem_command_add_audio_mappings_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_REMOVE_AUDIO_MAPPINGS,
+            jdksavdecc_aem_command_remove_audio_mappings_get_descriptor_type,
+            jdksavdecc_aem_command_remove_audio_mappings_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_START_OPERATION,
+            jdksavdecc_aem_command_start_operation_response_get_descriptor_type,
+            jdksavdecc_aem_command_start_operation_response_get_descriptor_index);
+    add_cmd(JDKSAVDECC_AEM_COMMAND_OPERATION_STATUS,
+            jdksavdecc_aem_command_operation_status_response_get_descriptor_type,
+            jdksavdecc_aem_command_operation_status_response_get_descriptor_index);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY, JDKSAVDECC_DESCRIPTOR_ENTITY, proc_base_resp<&descriptor_base_imp::proc_acquire_entity_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT, proc_base_resp<&descriptor_base_imp::proc_acquire_entity_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT, proc_base_resp<&descriptor_base_imp::proc_acquire_entity_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_LOCK_ENTITY, JDKSAVDECC_DESCRIPTOR_ENTITY, proc_base_resp<&descriptor_base_imp::proc_lock_entity_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_LOCK_ENTITY, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT, proc_base_resp<&descriptor_base_imp::proc_lock_entity_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_LOCK_ENTITY, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT, proc_base_resp<&descriptor_base_imp::proc_lock_entity_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_REBOOT, JDKSAVDECC_DESCRIPTOR_ENTITY, proc_base_resp<&descriptor_base_imp::proc_reboot_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_CONFIGURATION, JDKSAVDECC_DESCRIPTOR_ENTITY,
+                proc_typed_resp<entity_descriptor, entity_descriptor_imp, &entity_descriptor_imp::proc_get_config_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_SET_CONFIGURATION, JDKSAVDECC_DESCRIPTOR_ENTITY,
+                proc_typed_resp<entity_descriptor, entity_descriptor_imp, &entity_descriptor_imp::proc_set_config_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_SET_STREAM_FORMAT, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                proc_typed_resp<stream_input_descriptor, stream_input_descriptor_imp, &stream_input_descriptor_imp::proc_set_stream_format_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_SET_STREAM_FORMAT, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT,
+                proc_typed_resp<stream_output_descriptor, stream_output_descriptor_imp, &stream_output_descriptor_imp::proc_set_stream_format_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                proc_typed_resp<stream_input_descriptor, stream_input_descriptor_imp, &stream_input_descriptor_imp::proc_get_stream_format_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT,
+                proc_typed_resp<stream_output_descriptor, stream_output_descriptor_imp, &stream_output_descriptor_imp::proc_get_stream_format_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_SET_STREAM_INFO, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                proc_typed_resp<stream_input_descriptor, stream_input_descriptor_imp, &stream_input_descriptor_imp::proc_set_stream_info_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_SET_STREAM_INFO, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT,
+                proc_typed_resp<stream_output_descriptor, stream_output_descriptor_imp, &stream_output_descriptor_imp::proc_set_stream_info_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                proc_typed_resp<stream_input_descriptor, stream_input_descriptor_imp, &stream_input_descriptor_imp::proc_get_stream_info_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT,
+                proc_typed_resp<stream_output_descriptor, stream_output_descriptor_imp, &stream_output_descriptor_imp::proc_get_stream_info_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_START_STREAMING, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                proc_typed_resp<stream_input_descriptor, stream_input_descriptor_imp, &stream_input_descriptor_imp::proc_start_streaming_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_START_STREAMING, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT,
+                proc_typed_resp<stream_output_descriptor, stream_output_descriptor_imp, &stream_output_descriptor_imp::proc_start_streaming_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_STOP_STREAMING, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                proc_typed_resp<stream_input_descriptor, stream_input_descriptor_imp, &stream_input_descriptor_imp::proc_stop_streaming_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_STOP_STREAMING, JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT,
+                proc_typed_resp<stream_output_descriptor, stream_output_descriptor_imp, &stream_output_descriptor_imp::proc_stop_streaming_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT,
+                proc_typed_resp<stream_port_input_descriptor, stream_port_input_descriptor_imp, &stream_port_input_descriptor_imp::proc_get_audio_map_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT,
+                proc_typed_resp<stream_port_output_descriptor, stream_port_output_descriptor_imp, &stream_port_output_descriptor_imp::proc_get_audio_map_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_ADD_AUDIO_MAPPINGS, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT,
+                proc_typed_resp<stream_port_input_descriptor, stream_port_input_descriptor_imp, &stream_port_input_descriptor_imp::proc_add_audio_mappings_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_ADD_AUDIO_MAPPINGS, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT,
+                proc_typed_resp<stream_port_output_descriptor, stream_port_output_descriptor_imp, &stream_port_output_descriptor_imp::proc_add_audio_mappings_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_REMOVE_AUDIO_MAPPINGS, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT,
+                proc_typed_resp<stream_port_input_descriptor, stream_port_input_descriptor_imp, &stream_port_input_descriptor_imp::proc_remove_audio_mappings_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_REMOVE_AUDIO_MAPPINGS, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT,
+                proc_typed_resp<stream_port_output_descriptor, stream_port_output_descriptor_imp, &stream_port_output_descriptor_imp::proc_remove_audio_mappings_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_SET_SAMPLING_RATE, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT,
+                proc_typed_resp<audio_unit_descriptor, audio_unit_descriptor_imp, &audio_unit_descriptor_imp::proc_set_sampling_rate_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_SAMPLING_RATE, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT,
+                proc_typed_resp<audio_unit_descriptor, audio_unit_descriptor_imp, &audio_unit_descriptor_imp::proc_get_sampling_rate_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_COUNTERS, JDKSAVDECC_DESCRIPTOR_ENTITY,
+                proc_typed_resp<entity_descriptor, entity_descriptor_imp, &entity_descriptor_imp::proc_get_counters_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_COUNTERS, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE,
+                proc_typed_resp<avb_interface_descriptor, avb_interface_descriptor_imp, &avb_interface_descriptor_imp::proc_get_counters_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_COUNTERS, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN,
+                proc_typed_resp<clock_domain_descriptor, clock_domain_descriptor_imp, &clock_domain_descriptor_imp::proc_get_counters_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_COUNTERS, JDKSAVDECC_DESCRIPTOR_STREAM_INPUT,
+                proc_typed_resp<stream_input_descriptor, stream_input_descriptor_imp, &stream_input_descriptor_imp::proc_get_counters_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_SET_CLOCK_SOURCE, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN,
+                proc_typed_resp<clock_domain_descriptor, clock_domain_descriptor_imp, &clock_domain_descriptor_imp::proc_set_clock_source_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_CLOCK_SOURCE, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN,
+                proc_typed_resp<clock_domain_descriptor, clock_domain_descriptor_imp, &clock_domain_descriptor_imp::proc_get_clock_source_resp>);
+    add_handler(JDKSAVDECC_AEM_COMMAND_GET_AVB_INFO, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE,
+                proc_typed_resp<avb_interface_descriptor, avb_interface_descriptor_imp, &avb_interface_descriptor_imp::proc_get_avb_info_resp>);
+
+    add_handler(JDKSAVDECC_AEM_COMMAND_START_OPERATION, JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT, proc_start_operation_resp);
+    add_handler(JDKSAVDECC_AEM_COMMAND_OPERATION_STATUS, JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT, proc_operation_status_resp);
+
+    // SET_NAME and GET_NAME apply to every descriptor
+    cmds[JDKSAVDECC_AEM_COMMAND_SET_NAME].dispatched = true;
+    cmds[JDKSAVDECC_AEM_COMMAND_SET_NAME].any_desc_handler = proc_base_resp<&descriptor_base_imp::proc_set_name_resp>;
+    cmds[JDKSAVDECC_AEM_COMMAND_GET_NAME].dispatched = true;
+    cmds[JDKSAVDECC_AEM_COMMAND_GET_NAME].any_desc_handler = proc_base_resp<&descriptor_base_imp::proc_get_name_resp>;
+}
+
+aem_resp_dispatch::~aem_resp_dispatch() {}
+
+void aem_resp_dispatch::add_cmd(uint16_t cmd_type, aem_field_getter get_desc_type, aem_field_getter get_desc_index)
+{
+    assert(cmd_type < TOTAL_NUM_OF_AEM_CMDS);
+
+    cmds[cmd_type].known = true;
+    cmds[cmd_type].get_desc_type = get_desc_type;
+    cmds[cmd_type].get_desc_index = get_desc_index;
+}
+
+void aem_resp_dispatch::add_handler(uint16_t cmd_type, uint16_t desc_type, aem_resp_handler handler)
+{
+    assert(cmds[cmd_type].known && desc_type < desc_type_count);
+
+    cmds[cmd_type].dispatched = true;
+    cmds[cmd_type].handlers[desc_type] = handler;
+}
+
+bool aem_resp_dispatch::get_desc(uint16_t cmd_type, const uint8_t * frame, uint16_t & desc_type, uint16_t & desc_index) const
+{
+    if (!is_known(cmd_type))
+        return false;
+
+    const cmd_entry & cmd = cmds[cmd_type];
+    if (cmd.get_desc_type)
+    {
+        desc_type = cmd.get_desc_type(frame, ETHER_HDR_SIZE);
+        desc_index = cmd.get_desc_index(frame, ETHER_HDR_SIZE);
+    }
+    else
+    {
+        desc_type = JDKSAVDECC_DESCRIPTOR_ENTITY;
+        desc_index = 0;
+    }
+
+    return true;
+}
+}
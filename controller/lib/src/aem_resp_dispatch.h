@@ -0,0 +1,134 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * aem_resp_dispatch.h
+ *
+ * AEM response dispatch table
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+#include "enumeration.h"
+
+namespace avdecc_lib
+{
+class descriptor_base_imp;
+
+///
+/// Read a 16 bit field of an AEM command or response, at pos the offset of the AECPDU in the frame.
+///
+typedef uint16_t (*aem_field_getter)(void const * base, ssize_t pos);
+
+///
+/// Process an AEM response for the descriptor it addresses. desc is the descriptor and typed_desc the same
+/// descriptor converted to the public descriptor class of its type, so that the handler can reach the
+/// descriptor implementation with static_cast only.
+///
+typedef int (*aem_resp_handler)(descriptor_base_imp * desc,
+                                void * typed_desc,
+                                void *& notification_id,
+                                const uint8_t * frame,
+                                size_t frame_len,
+                                int & status,
+                                uint16_t & operation_id,
+                                bool & is_operation_id_valid);
+
+///
+/// Table of AEM responses indexed by command type and descriptor type.
+///
+/// Each command type records how to read the descriptor type and index of the command, and each
+/// (command type, descriptor type) pair the handler of the descriptor implementation, so that
+/// responses are dispatched with two array lookups instead of a switch and a dynamic_cast per
+/// descriptor type.
+///
+class aem_resp_dispatch
+{
+public:
+    static const uint16_t desc_type_count = AEM_DESC_CONTROL_BLOCK + 1;
+
+private:
+    struct cmd_entry
+    {
+        bool known;                                 // The command is supported by the AEM Controller State Machine
+        bool dispatched;                            // At least one descriptor handles the response
+        aem_field_getter get_desc_type;             // NULL if the command has no descriptor fields
+        aem_field_getter get_desc_index;            // NULL if the command has no descriptor fields
+        aem_resp_handler any_desc_handler;          // Handler for every descriptor type, if the command applies to any descriptor
+        aem_resp_handler handlers[desc_type_count]; // Handler per descriptor type
+    };
+
+    cmd_entry cmds[TOTAL_NUM_OF_AEM_CMDS];
+
+    void add_cmd(uint16_t cmd_type, aem_field_getter get_desc_type, aem_field_getter get_desc_index);
+    void add_handler(uint16_t cmd_type, uint16_t desc_type, aem_resp_handler handler);
+
+public:
+    aem_resp_dispatch();
+
+    ~aem_resp_dispatch();
+
+    ///
+    /// \return True if the command type is supported by the AEM Controller State Machine.
+    ///
+    inline bool is_known(uint16_t cmd_type) const
+    {
+        return cmd_type < TOTAL_NUM_OF_AEM_CMDS && cmds[cmd_type].known;
+    }
+
+    ///
+    /// \return True if the response to cmd_type is handled by a descriptor rather than by the End Station.
+    ///
+    inline bool has_handlers(uint16_t cmd_type) const
+    {
+        return cmd_type < TOTAL_NUM_OF_AEM_CMDS && cmds[cmd_type].dispatched;
+    }
+
+    ///
+    /// Read the descriptor type and index of the AEM command or response in frame. Commands without
+    /// descriptor fields, such as GET_CONFIGURATION, address the ENTITY descriptor 0.
+    ///
+    /// \return False if the command type is not supported.
+    ///
+    bool get_desc(uint16_t cmd_type, const uint8_t * frame, uint16_t & desc_type, uint16_t & desc_index) const;
+
+    ///
+    /// \return The handler of the response to cmd_type for a descriptor of desc_type, or NULL if there is none.
+    ///
+    inline aem_resp_handler handler(uint16_t cmd_type, uint16_t desc_type) const
+    {
+        if (cmd_type >= TOTAL_NUM_OF_AEM_CMDS)
+            return NULL;
+
+        const cmd_entry & cmd = cmds[cmd_type];
+        if (cmd.any_desc_handler)
+            return cmd.any_desc_handler;
+
+        return desc_type < desc_type_count ? cmd.handlers[desc_type] : NULL;
+    }
+};
+
+extern aem_resp_dispatch * aem_resp_dispatch_ref;
+}
@@ -0,0 +1,311 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_batch_imp.cpp
+ *
+ * Command batch implementation
+ */
+
+#include <chrono>
+#include "enumeration.h"
+#include "log_imp.h"
+#include "util.h"
+#include "adp.h"
+#include "end_station_imp.h"
+#include "configuration_descriptor_imp.h"
+#include "controller_imp.h"
+#include "aem_resp_dispatch.h"
+#include "acmp_controller_state_machine.h"
+#include "aecp_controller_state_machine.h"
+#include "system_tx_queue.h"
+#include "cmd_completion_imp.h"
+#include "cmd_batch_imp.h"
+
+namespace avdecc_lib
+{
+///
+/// \return True if the only arguments of the AEM command are the descriptor type and index.
+///
+static bool is_desc_only_aem_cmd(uint16_t cmd_type)
+{
+    switch (cmd_type)
+    {
+    case JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT:
+    case JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO:
+    case JDKSAVDECC_AEM_COMMAND_GET_SAMPLING_RATE:
+    case JDKSAVDECC_AEM_COMMAND_GET_CLOCK_SOURCE:
+    case JDKSAVDECC_AEM_COMMAND_GET_COUNTERS:
+    case JDKSAVDECC_AEM_COMMAND_GET_AVB_INFO:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+static bool build_aem_cmd(end_station_imp * end_station, const struct cmd_batch_item & item, struct jdksavdecc_frame & cmd_frame)
+{
+    struct jdksavdecc_aem_command_get_stream_info aem_cmd;
+    ssize_t aem_cmd_returned;
+    memset(&aem_cmd, 0, sizeof(aem_cmd));
+
+    // The commands share the layout of GET_STREAM_INFO: the AEM header followed by the descriptor type and index
+    aem_cmd.aem_header.aecpdu_header.controller_entity_id = adp::get_controller_entity_id();
+    aem_cmd.aem_header.command_type = item.cmd_type;
+    aem_cmd.descriptor_type = item.desc_type;
+    aem_cmd.descriptor_index = item.desc_index;
+
+    aecp_controller_state_machine_ref->ether_frame_init(end_station->mac(), &cmd_frame,
+                                                        ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_COMMAND_LEN);
+    aem_cmd_returned = jdksavdecc_aem_command_get_stream_info_write(&aem_cmd,
+                                                                   cmd_frame.payload,
+                                                                   ETHER_HDR_SIZE,
+                                                                   sizeof(cmd_frame.payload));
+    if (aem_cmd_returned < 0)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "cmd_batch aem_cmd_write error");
+        return false;
+    }
+
+    aecp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_COMMAND,
+                                                       &cmd_frame,
+                                                       end_station->entity_id(),
+                                                       JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO_COMMAND_LEN -
+                                                           JDKSAVDECC_COMMON_CONTROL_HEADER_LEN);
+    return true;
+}
+
+static bool build_acmp_cmd(end_station_imp * end_station, const struct cmd_batch_item & item, struct jdksavdecc_frame & cmd_frame)
+{
+    struct jdksavdecc_acmpdu acmp_cmd;
+    ssize_t acmp_cmd_returned;
+    uint32_t msg_type = item.cmd_type - CMD_LOOKUP;
+    memset(&acmp_cmd, 0, sizeof(acmp_cmd));
+
+    acmp_cmd.controller_entity_id = adp::get_controller_entity_id();
+    jdksavdecc_eui64_init(&acmp_cmd.talker_entity_id);
+    jdksavdecc_eui64_init(&acmp_cmd.listener_entity_id);
+    jdksavdecc_eui48_init(&acmp_cmd.stream_dest_mac);
+    // Fill acmp_cmd.sequence_id in ACMP Controller State Machine
+
+    if (msg_type == JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_RX_STATE_COMMAND)
+    {
+        jdksavdecc_uint64_write(end_station->entity_id(), &acmp_cmd.listener_entity_id, 0, sizeof(uint64_t));
+        acmp_cmd.listener_unique_id = item.desc_index;
+    }
+    else
+    {
+        jdksavdecc_uint64_write(end_station->entity_id(), &acmp_cmd.talker_entity_id, 0, sizeof(uint64_t));
+        acmp_cmd.talker_unique_id = item.desc_index;
+    }
+
+    acmp_controller_state_machine_ref->ether_frame_init(&cmd_frame);
+    acmp_cmd_returned = jdksavdecc_acmpdu_write(&acmp_cmd,
+                                                cmd_frame.payload,
+                                                ETHER_HDR_SIZE,
+                                                sizeof(cmd_frame.payload));
+    if (acmp_cmd_returned < 0)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "cmd_batch acmp_cmd_write error");
+        return false;
+    }
+
+    acmp_controller_state_machine_ref->common_hdr_init(msg_type, &cmd_frame);
+    return true;
+}
+
+///
+/// Build the command of an item in cmd_frame.
+///
+/// \return False if the End Station, the descriptor or the command of the item is not supported.
+///
+static bool build_cmd(const struct cmd_batch_item & item, struct jdksavdecc_frame & cmd_frame)
+{
+    uint32_t end_station_index;
+    end_station_imp * end_station = NULL;
+    configuration_descriptor_imp * config = NULL;
+
+    if (controller_imp_ref->is_end_station_found_by_entity_id(item.entity_id, end_station_index))
+    {
+        end_station = dynamic_cast<end_station_imp *>(controller_imp_ref->get_end_station_by_index(end_station_index));
+        config = dynamic_cast<configuration_descriptor_imp *>(controller_imp_ref->get_current_config_desc(end_station_index, false));
+    }
+
+    if (!end_station || !config)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "cmd_batch: no End Station 0x%llx", item.entity_id);
+        return false;
+    }
+
+    if (!config->lookup_desc_imp(item.desc_type, item.desc_index))
+        return false;
+
+    if (is_desc_only_aem_cmd(item.cmd_type) && aem_resp_dispatch_ref->handler(item.cmd_type, item.desc_type))
+        return build_aem_cmd(end_station, item, cmd_frame);
+
+    if ((item.cmd_type == CMD_LOOKUP + JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_RX_STATE_COMMAND && item.desc_type == AEM_DESC_STREAM_INPUT) ||
+        (item.cmd_type == CMD_LOOKUP + JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_COMMAND && item.desc_type == AEM_DESC_STREAM_OUTPUT))
+        return build_acmp_cmd(end_station, item, cmd_frame);
+
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "cmd_batch: command 0x%x is not supported for %s",
+                              item.cmd_type, utility::aem_desc_value_to_name(item.desc_type));
+    return false;
+}
+
+cmd_batch_imp::cmd_batch_imp(void (*completion_callback)(void *, cmd_batch *), void * user_obj)
+    : m_callback(completion_callback), m_user_obj(user_obj), m_sent(0), m_remaining(0)
+{
+}
+
+cmd_batch_imp::~cmd_batch_imp() {}
+
+void cmd_batch_imp::send(const struct cmd_batch_item * items, size_t item_count)
+{
+    std::vector<struct jdksavdecc_frame> cmd_frames(item_count);
+    std::vector<struct system_tx_entry> entries;
+    entries.reserve(item_count);
+    m_handles.assign(item_count, NULL);
+
+    for (size_t i = 0; i < item_count; i++)
+    {
+        if (!build_cmd(items[i], cmd_frames[i]))
+            continue;
+
+        m_handles[i] = cmd_completions_ref->create(item_complete, this);
+
+        struct system_tx_entry entry = {m_handles[i], CMD_WITH_NOTIFICATION, cmd_frames[i].payload, cmd_frames[i].length};
+        entries.push_back(entry);
+    }
+
+    // Set before queueing, as the lib thread may complete the first commands before the last are queued
+    m_remaining = entries.size();
+    m_sent = entries.size();
+    if (entries.empty())
+        return;
+
+    size_t queued = system_queue_tx_batch(&entries[0], entries.size());
+    if (queued < entries.size())
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_sent = queued;
+        }
+
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "cmd_batch: %d of %d commands queued", (int)queued, (int)entries.size());
+
+        // The queued commands may all have completed already, and then the batch completes here
+        items_done(entries.size() - queued);
+    }
+}
+
+void STDCALL cmd_batch_imp::destroy()
+{
+    // Once the handles are destroyed, no completion callback can be running or start for the batch
+    for (size_t i = 0; i < m_handles.size(); i++)
+    {
+        if (m_handles[i])
+            m_handles[i]->destroy();
+    }
+
+    delete this;
+}
+
+size_t STDCALL cmd_batch_imp::item_count()
+{
+    return m_handles.size();
+}
+
+size_t STDCALL cmd_batch_imp::sent_count()
+{
+    return m_sent;
+}
+
+bool STDCALL cmd_batch_imp::is_complete()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_remaining == 0;
+}
+
+int STDCALL cmd_batch_imp::wait(uint32_t timeout_ms)
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (m_remaining)
+    {
+        if (m_done.wait_for(guard, std::chrono::milliseconds(timeout_ms)) == std::cv_status::timeout && m_remaining)
+            return -1;
+    }
+    return 0;
+}
+
+int STDCALL cmd_batch_imp::item_status(size_t item_index)
+{
+    if (item_index >= m_handles.size() || !m_handles[item_index])
+        return AVDECC_LIB_STATUS_INVALID;
+
+    return m_handles[item_index]->status();
+}
+
+const uint8_t * STDCALL cmd_batch_imp::item_resp_frame(size_t item_index)
+{
+    if (item_index >= m_handles.size() || !m_handles[item_index])
+        return NULL;
+
+    return m_handles[item_index]->resp_frame();
+}
+
+size_t STDCALL cmd_batch_imp::item_resp_frame_len(size_t item_index)
+{
+    if (item_index >= m_handles.size() || !m_handles[item_index])
+        return 0;
+
+    return m_handles[item_index]->resp_frame_len();
+}
+
+void cmd_batch_imp::item_complete(void * batch, cmd_completion *)
+{
+    static_cast<cmd_batch_imp *>(batch)->items_done(1);
+}
+
+void cmd_batch_imp::items_done(size_t count)
+{
+    bool batch_complete;
+    bool notify;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_remaining -= count;
+        batch_complete = (m_remaining == 0);
+        notify = batch_complete && m_sent > 0;
+    }
+
+    if (!batch_complete)
+        return;
+
+    m_done.notify_all();
+
+    // The callback may destroy the batch, so it is not used afterwards
+    if (notify && m_callback)
+        m_callback(m_user_obj, this);
+}
+}
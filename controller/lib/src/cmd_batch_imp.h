@@ -0,0 +1,90 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_batch_imp.h
+ *
+ * Command batch implementation class
+ *
+ * Every command of a batch is sent with a completion handle of its own, so that
+ * its response is matched to its position in the batch. The batch completes when
+ * the last of these handles completes.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include "cmd_batch.h"
+
+namespace avdecc_lib
+{
+class cmd_completion;
+class cmd_completion_imp;
+
+class cmd_batch_imp : public cmd_batch
+{
+public:
+    cmd_batch_imp(void (*completion_callback)(void *, cmd_batch *), void * user_obj);
+    virtual ~cmd_batch_imp();
+
+    ///
+    /// Build the command of every item and queue the commands for transmission in one operation.
+    /// Items that cannot be sent complete at once with AVDECC_LIB_STATUS_INVALID.
+    ///
+    void send(const struct cmd_batch_item * items, size_t item_count);
+
+    void STDCALL destroy();
+    size_t STDCALL item_count();
+    size_t STDCALL sent_count();
+    bool STDCALL is_complete();
+    int STDCALL wait(uint32_t timeout_ms);
+    int STDCALL item_status(size_t item_index);
+    const uint8_t * STDCALL item_resp_frame(size_t item_index);
+    size_t STDCALL item_resp_frame_len(size_t item_index);
+
+private:
+    void (*m_callback)(void *, cmd_batch *);
+    void * m_user_obj;
+
+    std::vector<cmd_completion_imp *> m_handles; // Completion handle of every item, NULL if the item was not sent
+    size_t m_sent;                               // Items queued for transmission
+
+    std::mutex m_lock;
+    std::condition_variable m_done;
+    size_t m_remaining; // Items sent and not yet complete
+
+    ///
+    /// Completion callback of the handle of every item, called by the lib thread.
+    ///
+    static void item_complete(void * batch, cmd_completion * handle);
+
+    ///
+    /// Count items as complete, and call the completion callback of the batch once the last of
+    /// them does if any command of the batch was sent.
+    ///
+    void items_done(size_t count);
+};
+}
@@ -0,0 +1,232 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_completion_imp.cpp
+ *
+ * Command completion implementation
+ */
+
+#include <chrono>
+#include <algorithm>
+#include "enumeration.h"
+#include "controller_imp.h"
+#include "cmd_completion_imp.h"
+
+namespace avdecc_lib
+{
+cmd_completions * cmd_completions_ref = new cmd_completions(); // To have one set of completion handles for all end stations
+
+cmd_completion_imp::cmd_completion_imp(void (*completion_callback)(void *, cmd_completion *), void * user_obj)
+    : m_callback(completion_callback), m_user_obj(user_obj), m_complete(false), m_status(AVDECC_LIB_STATUS_INVALID), m_queued(0)
+{
+}
+
+cmd_completion_imp::~cmd_completion_imp() {}
+
+void STDCALL cmd_completion_imp::destroy()
+{
+    cmd_completions_ref->destroy(this);
+}
+
+void * STDCALL cmd_completion_imp::notification_id()
+{
+    return this;
+}
+
+bool STDCALL cmd_completion_imp::is_complete()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_complete;
+}
+
+int STDCALL cmd_completion_imp::wait(uint32_t timeout_ms)
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (!m_complete)
+    {
+        if (m_done.wait_for(guard, std::chrono::milliseconds(timeout_ms)) == std::cv_status::timeout && !m_complete)
+            return -1;
+    }
+    return 0;
+}
+
+int STDCALL cmd_completion_imp::status()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_status;
+}
+
+const uint8_t * STDCALL cmd_completion_imp::resp_frame()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_frame.empty() ? NULL : &m_frame[0];
+}
+
+size_t STDCALL cmd_completion_imp::resp_frame_len()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_frame.size();
+}
+
+cmd_completions::cmd_completions() : handle_count(0), calling(NULL) {}
+
+cmd_completions::~cmd_completions() {}
+
+cmd_completion_imp * cmd_completions::create(void (*completion_callback)(void *, cmd_completion *), void * user_obj)
+{
+    cmd_completion_imp * c = new cmd_completion_imp(completion_callback, user_obj);
+
+    std::lock_guard<std::mutex> guard(lock);
+    handles[c] = c;
+    handle_count.store(handles.size());
+    return c;
+}
+
+void cmd_completions::destroy(cmd_completion_imp * c)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    handles.erase(c);
+    handle_count.store(handles.size());
+    sent.erase(std::remove(sent.begin(), sent.end(), (void *)c), sent.end());
+
+    // The completion callback may still be using the handle, unless it is the caller
+    while (calling == c && calling_thread != std::this_thread::get_id())
+        callback_done.wait(guard);
+
+    delete c;
+}
+
+void cmd_completions::cmd_queued(void * notification_id, uint32_t notification_flag)
+{
+    if (handle_count.load() == 0 || notification_flag != CMD_WITH_NOTIFICATION)
+        return;
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::unordered_map<void *, cmd_completion_imp *>::iterator i = handles.find(notification_id);
+    if (i == handles.end())
+        return;
+
+    cmd_completion_imp * c = i->second;
+    if (c->m_queued++ == 0)
+    {
+        // A new command for a complete handle starts a new completion
+        std::lock_guard<std::mutex> c_guard(c->m_lock);
+        if (c->m_complete)
+        {
+            c->m_complete = false;
+            c->m_status = AVDECC_LIB_STATUS_INVALID;
+            c->m_frame.clear();
+        }
+    }
+}
+
+void cmd_completions::cmd_sent(void * notification_id, uint32_t notification_flag)
+{
+    if (handle_count.load() == 0 || notification_flag != CMD_WITH_NOTIFICATION)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::unordered_map<void *, cmd_completion_imp *>::iterator i = handles.find(notification_id);
+        if (i == handles.end())
+            return;
+
+        if (i->second->m_queued > 0)
+            i->second->m_queued--;
+
+        sent.push_back(notification_id);
+    }
+}
+
+void cmd_completions::complete_sent()
+{
+    std::vector<void *> ids;
+
+    if (handle_count.load() == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ids.swap(sent);
+    }
+
+    // A command that is neither inflight nor queued once handed to the state machines was not sent
+    for (size_t i = 0; i < ids.size(); i++)
+        complete(ids[i], AVDECC_LIB_STATUS_INVALID, NULL, 0);
+}
+
+void cmd_completions::resp_received(void * notification_id, int status, const uint8_t * frame, size_t frame_len)
+{
+    if (handle_count.load() == 0)
+        return;
+
+    complete(notification_id, status, frame, frame_len);
+}
+
+void cmd_completions::cmd_timed_out(void * notification_id)
+{
+    if (handle_count.load() == 0)
+        return;
+
+    complete(notification_id, AVDECC_LIB_STATUS_TICK_TIMEOUT, NULL, 0);
+}
+
+bool cmd_completions::is_idle(cmd_completion_imp * c)
+{
+    return c->m_queued == 0 &&
+           !controller_imp_ref->is_inflight_cmd_with_notification_id(c) &&
+           !controller_imp_ref->is_active_operation_with_notification_id(c);
+}
+
+void cmd_completions::complete(void * notification_id, int status, const uint8_t * frame, size_t frame_len)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    std::unordered_map<void *, cmd_completion_imp *>::iterator i = handles.find(notification_id);
+    if (i == handles.end() || !is_idle(i->second))
+        return;
+
+    cmd_completion_imp * c = i->second;
+    {
+        std::lock_guard<std::mutex> c_guard(c->m_lock);
+        if (c->m_complete)
+            return;
+
+        c->m_complete = true;
+        c->m_status = status;
+        c->m_frame.assign(frame, frame + frame_len);
+    }
+
+    calling = c;
+    calling_thread = std::this_thread::get_id();
+    guard.unlock();
+
+    c->m_done.notify_all();
+    if (c->m_callback)
+        c->m_callback(c->m_user_obj, c);
+
+    guard.lock();
+    calling = NULL;
+    callback_done.notify_all();
+}
+}
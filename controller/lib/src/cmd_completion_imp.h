@@ -0,0 +1,135 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * cmd_completion_imp.h
+ *
+ * Command completion implementation class
+ *
+ * Completion handles are created by app threads and completed by the avdecc-lib
+ * "lib" thread. The notification id of a handle is the handle itself, so that the
+ * commands sent with it are matched to it through the notification id they carry
+ * through the state machines.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include "cmd_completion.h"
+
+namespace avdecc_lib
+{
+class cmd_completion_imp : public cmd_completion
+{
+public:
+    cmd_completion_imp(void (*completion_callback)(void *, cmd_completion *), void * user_obj);
+    virtual ~cmd_completion_imp();
+
+    void STDCALL destroy();
+    void * STDCALL notification_id();
+    bool STDCALL is_complete();
+    int STDCALL wait(uint32_t timeout_ms);
+    int STDCALL status();
+    const uint8_t * STDCALL resp_frame();
+    size_t STDCALL resp_frame_len();
+
+private:
+    friend class cmd_completions;
+
+    void (*m_callback)(void *, cmd_completion *);
+    void * m_user_obj;
+
+    std::mutex m_lock;
+    std::condition_variable m_done;
+    bool m_complete;
+    int m_status;
+    std::vector<uint8_t> m_frame;
+    uint32_t m_queued; // Commands queued for transmission and not yet handed to the state machines
+};
+
+///
+/// The live completion handles, indexed by notification id.
+///
+class cmd_completions
+{
+private:
+    std::mutex lock;
+    std::condition_variable callback_done;
+    std::unordered_map<void *, cmd_completion_imp *> handles;
+    std::vector<void *> sent;          // Handles of commands handed to the state machines since complete_sent()
+    std::atomic<size_t> handle_count;  // Checked without the lock so that there is no cost without handles
+    cmd_completion_imp * calling;      // The handle whose completion callback is running
+    std::thread::id calling_thread;
+
+    ///
+    /// \return True if no command with notification_id is queued, inflight or in an active operation.
+    ///
+    bool is_idle(cmd_completion_imp * c);
+
+    ///
+    /// Complete the handle with notification_id if it has no command left, and call its completion callback.
+    ///
+    void complete(void * notification_id, int status, const uint8_t * frame, size_t frame_len);
+
+public:
+    cmd_completions();
+    ~cmd_completions();
+
+    cmd_completion_imp * create(void (*completion_callback)(void *, cmd_completion *), void * user_obj);
+    void destroy(cmd_completion_imp * c);
+
+    ///
+    /// A command with notification_id is queued for transmission, called by the sending thread.
+    ///
+    void cmd_queued(void * notification_id, uint32_t notification_flag);
+
+    ///
+    /// A command with notification_id has been handed to the state machines, which may have dropped it.
+    ///
+    void cmd_sent(void * notification_id, uint32_t notification_flag);
+
+    ///
+    /// Complete the handles of the commands dropped by the state machines since the last call. Called
+    /// once the TX queue has been drained, so that their callbacks do not run while a command is sent.
+    ///
+    void complete_sent();
+
+    ///
+    /// A response for a command with notification_id has been processed.
+    ///
+    void resp_received(void * notification_id, int status, const uint8_t * frame, size_t frame_len);
+
+    ///
+    /// A command with notification_id has timed out and has been removed from the inflight commands.
+    ///
+    void cmd_timed_out(void * notification_id);
+};
+
+extern cmd_completions * cmd_completions_ref;
+}
@@ -24,85 +24,126 @@
 /**
  * cmd_wait_mgr.cpp
  *
- * Notification base class implementation, which is called by AVDECC LIB modules to generate notification messages.
+ * Command wait manager implementation
  */
 
+#include "enumeration.h"
+#include "controller_imp.h"
 #include "cmd_wait_mgr.h"
 
 namespace avdecc_lib
 {
 
-cmd_wait_mgr::cmd_wait_mgr()
-{
-    state = wait_idle;
-}
+cmd_wait_mgr::cmd_wait_mgr(controller_imp * controller) : m_controller(controller) {}
 
 cmd_wait_mgr::~cmd_wait_mgr() {}
 
 int cmd_wait_mgr::set_primed_state(void * id)
 {
-    if (state != wait_idle)
-        return -1;
-    else
-    {
-        notify_id = id;
-        state = wait_primed;
-        return 0;
-    }
+    std::lock_guard<std::mutex> guard(lock);
+    primed[std::this_thread::get_id()] = id;
+    return 0;
 }
-int cmd_wait_mgr::set_active_state(void)
+
+bool cmd_wait_mgr::set_active_state(void * id)
 {
-    if (state != wait_primed)
-        return -1;
-    else
-    {
-        state = wait_active;
-        return 0;
-    }
+    std::thread::id self = std::this_thread::get_id();
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::unordered_map<std::thread::id, void *>::iterator p = primed.find(self);
+    if (p == primed.end() || p->second != id)
+        return false;
+
+    primed.erase(p);
+    waiter * w = new waiter();
+    active[self] = w;
+    waiters.insert(std::make_pair(id, w));
+    return true;
 }
-int cmd_wait_mgr::set_idle_state(void)
+
+int cmd_wait_mgr::wait_for_completion(void)
 {
-    if (state != wait_active)
-        return -1;
-    else
-    {
-        state = wait_idle;
-        return 0;
-    }
+    std::thread::id self = std::this_thread::get_id();
+
+    std::unique_lock<std::mutex> guard(lock);
+    std::unordered_map<std::thread::id, waiter *>::iterator a = active.find(self);
+    if (a == active.end())
+        return AVDECC_LIB_STATUS_INVALID;
+
+    waiter * w = a->second;
+    active.erase(a);
+    while (!w->done)
+        w->released.wait(guard);
+
+    int status = w->status;
+    completion_status[self] = status;
+    delete w;
+    return status;
 }
 
-bool cmd_wait_mgr::match_id(void * id)
+int cmd_wait_mgr::get_completion_status(void)
 {
-    return id == notify_id;
+    std::lock_guard<std::mutex> guard(lock);
+    std::unordered_map<std::thread::id, int>::iterator s = completion_status.find(std::this_thread::get_id());
+    return (s != completion_status.end()) ? s->second : AVDECC_LIB_STATUS_INVALID;
 }
 
-void * cmd_wait_mgr::get_notify_id(void)
+bool cmd_wait_mgr::is_incomplete(void * id)
 {
-    return notify_id;
+    return m_controller->is_inflight_cmd_with_notification_id(id) ||
+           m_controller->is_active_operation_with_notification_id(id);
 }
 
-bool cmd_wait_mgr::active_state(void)
+void cmd_wait_mgr::release(void * id, int status)
 {
-    return state == wait_active;
+    std::pair<std::unordered_multimap<void *, waiter *>::iterator,
+              std::unordered_multimap<void *, waiter *>::iterator>
+        range = waiters.equal_range(id);
+
+    for (std::unordered_multimap<void *, waiter *>::iterator i = range.first; i != range.second; ++i)
+    {
+        i->second->done = true;
+        i->second->status = status;
+        i->second->released.notify_one();
+    }
+    waiters.erase(range.first, range.second);
 }
 
-bool cmd_wait_mgr::primed_state(void)
+void cmd_wait_mgr::resp_received(void * notification_id, int status)
 {
-    return state == wait_primed;
+    std::lock_guard<std::mutex> guard(lock);
+    if (waiters.find(notification_id) != waiters.end() && !is_incomplete(notification_id))
+        release(notification_id, status);
 }
 
-int cmd_wait_mgr::set_completion_status(int status)
+void cmd_wait_mgr::cmd_timed_out(void * notification_id)
 {
-    if (state != wait_active)
-        return -1;
-    else
+    std::lock_guard<std::mutex> guard(lock);
+    if (waiters.find(notification_id) != waiters.end() && !is_incomplete(notification_id))
+        release(notification_id, AVDECC_LIB_STATUS_TICK_TIMEOUT);
+}
+
+void cmd_wait_mgr::tick_begin(void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    tick_ids.clear();
+    for (std::unordered_multimap<void *, waiter *>::iterator i = waiters.begin(); i != waiters.end(); ++i)
     {
-        completion_status = status;
-        return 0;
+        if (is_incomplete(i->first))
+            tick_ids.push_back(i->first);
     }
 }
-int cmd_wait_mgr::get_completion_status(void)
+
+void cmd_wait_mgr::tick_end(void)
 {
-    return completion_status;
+    // If a command was inflight before the timer tick and is no longer inflight after it,
+    // timeout processing has removed it, so release its waiters.
+    std::lock_guard<std::mutex> guard(lock);
+    for (size_t i = 0; i < tick_ids.size(); i++)
+    {
+        if (!is_incomplete(tick_ids[i]))
+            release(tick_ids[i], AVDECC_LIB_STATUS_TICK_TIMEOUT);
+    }
+    tick_ids.clear();
 }
 }
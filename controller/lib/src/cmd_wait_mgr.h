@@ -27,58 +27,108 @@
  * A helper class for managing commands that are sent from an application that
  * wait for the commands to complete.
  *
- * There are 2 threads that operate on this class. The avdecc-lib "lib" thread
- * that is responsible for all 1722.1 operations happening in a single context and
- * the "app" thread that is responsible for issuing commands to the 1722.1 lib
- * thread and potentially waiting for the completion of those commands.
- * This class clarifies the "contract" between the two threads.
+ * Several threads operate on this class. The avdecc-lib "lib" thread is
+ * responsible for all 1722.1 operations happening in a single context, and any
+ * number of "app" threads issue commands to the 1722.1 lib thread and potentially
+ * wait for the completion of those commands. This class clarifies the "contract"
+ * between the threads.
  *
- * An internal state is maintained that is written to by the app thread and read
- * by the lib thread.
+ * Each app thread primes a wait for the next command it sends with a notification
+ * ID, and becomes a waiter for that ID when the command is queued. Waiters are
+ * kept per notification ID, each with its own condition variable.
  *
- * The only communication from the lib thread to the main thread occurs when
- * a semaphore is posted to release the waiting operation in the app thread.
- * Either a successful command completion or a timeout can cause the lib
- * thread to post to the waiting semaphore in the app thread.
+ * The only communication from the lib thread to the app threads occurs when the
+ * waiters for a notification ID are released. Either a successful command
+ * completion or a timeout can cause the lib thread to release them.
  */
 
 #pragma once
 
 #include <stdint.h>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
 #include "avdecc-lib_build.h"
 
 namespace avdecc_lib
 {
+class controller_imp;
+
 class cmd_wait_mgr
 {
 public:
-    cmd_wait_mgr();
+    cmd_wait_mgr(controller_imp * controller);
     virtual ~cmd_wait_mgr();
 
+    ///
+    /// Prime the calling thread to wait for the next command it sends with id.
+    ///
     int set_primed_state(void * id);
-    int set_active_state(void);
-    int set_idle_state(void);
 
-    bool match_id(void * id);
-    bool active_state(void);
-    bool primed_state(void);
-    int set_completion_status(int status);
+    ///
+    /// Make the calling thread a waiter for id if it is primed for id. Called before the command
+    /// is queued, so that its completion cannot be missed.
+    ///
+    /// \return True if the calling thread has to wait with wait_for_completion().
+    ///
+    bool set_active_state(void * id);
+
+    ///
+    /// Block the calling thread until the command it is waiting for completes.
+    ///
+    /// \return The completion status, also returned by get_completion_status() afterwards.
+    ///
+    int wait_for_completion(void);
+
+    ///
+    /// \return The completion status of the last command the calling thread waited for.
+    ///
     int get_completion_status(void);
-    void * get_notify_id(void);
 
-private:
     ///
-    /// Wait states.
+    /// Release the waiters for notification_id if no command with it is inflight or in an active
+    /// operation. Called by the lib thread for a response carrying notification_id.
     ///
-    enum wait_states
+    void resp_received(void * notification_id, int status);
+
+    ///
+    /// Release with AVDECC_LIB_STATUS_TICK_TIMEOUT the waiters for notification_id if no other command
+    /// with it is inflight or in an active operation. Called for a command removed by timeout processing.
+    ///
+    void cmd_timed_out(void * notification_id);
+
+    ///
+    /// Record the waited for notification IDs with commands inflight before a timer tick.
+    ///
+    void tick_begin(void);
+
+    ///
+    /// Release with AVDECC_LIB_STATUS_TICK_TIMEOUT the waiters recorded by tick_begin() whose
+    /// commands were removed by the timer tick.
+    ///
+    void tick_end(void);
+
+private:
+    struct waiter
     {
-        wait_idle,   /// idle state
-        wait_primed, /// primed means a call to set_wait_for_next_cmd() has been made
-        wait_active  /// active means a command matching the "primed" notify ID has been sent
+        std::condition_variable released;
+        bool done;
+        int status;
+
+        waiter() : done(false), status(0) {}
     };
 
-    void * notify_id;
-    int completion_status;
-    enum wait_states state;
+    controller_imp * m_controller;
+    std::mutex lock;
+    std::unordered_map<std::thread::id, void *> primed;           // Notification ID each primed thread waits for
+    std::unordered_map<std::thread::id, waiter *> active;         // Waiter of each thread between set_active_state() and wait_for_completion()
+    std::unordered_map<std::thread::id, int> completion_status;   // Last completion status of each thread
+    std::unordered_multimap<void *, waiter *> waiters;            // Active waiters by notification ID
+    std::vector<void *> tick_ids;                                 // Notification IDs recorded by tick_begin()
+
+    bool is_incomplete(void * id);
+    void release(void * id, int status);
 };
 }
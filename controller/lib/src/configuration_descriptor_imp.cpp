@@ -53,28 +53,17 @@ configuration_descriptor_imp::configuration_descriptor_imp(end_station_imp * end
     desc_count_vec_init(frame, pos);
 }
 
-template <typename T>
-void delete_pointed_to(T * const ptr)
-{
-    delete ptr;
-}
-
 configuration_descriptor_imp::~configuration_descriptor_imp()
 {
-    std::map<uint16_t, DITEM>::iterator it;
-    for (it = m_all_desc.begin(); it != m_all_desc.end(); ++it)
-        std::for_each(it->second.begin(), it->second.end(), delete_pointed_to<descriptor_base_imp>);
-    m_all_desc.clear();
+    for (uint16_t desc_type = 0; desc_type < desc_type_count; desc_type++)
+    {
+        for (size_t i = 0; i < m_all_desc[desc_type].size(); i++)
+            delete m_all_desc[desc_type][i].desc;
+        m_all_desc[desc_type].clear();
+    }
 }
 
-size_t configuration_descriptor_imp::desc_count(uint16_t desc_type)
-{
-    if (m_all_desc.find(desc_type) == m_all_desc.end())
-        return 0;
-    else
-        return m_all_desc[desc_type].size();
-}
-descriptor_base_imp * configuration_descriptor_imp::lookup_desc_imp(uint16_t desc_type, size_t index)
+const configuration_descriptor_imp::desc_slot * configuration_descriptor_imp::lookup_slot(uint16_t desc_type, size_t index)
 {
     if (desc_count(desc_type) <= index)
     {
@@ -86,16 +75,35 @@ descriptor_base_imp * configuration_descriptor_imp::lookup_desc_imp(uint16_t des
     }
     else
     {
-        return m_all_desc[desc_type].at(index);
+        return &m_all_desc[desc_type][index];
     }
 }
 
+descriptor_base_imp * configuration_descriptor_imp::lookup_desc_imp(uint16_t desc_type, size_t index)
+{
+    const desc_slot * slot = lookup_slot(desc_type, index);
+    return slot ? slot->desc : NULL;
+}
+
 descriptor_base * configuration_descriptor_imp::lookup_desc(uint16_t desc_type, size_t index)
 {
     descriptor_base_imp * imp = lookup_desc_imp(desc_type, index);
     return imp;
 }
 
+void STDCALL configuration_descriptor_imp::replace_desc_frame(const uint8_t * frame, ssize_t pos, size_t size)
+{
+    descriptor_base_imp::replace_desc_frame(frame, pos, size);
+
+    // The descriptor counts belong to the entity model, so only the name and description can change
+    struct jdksavdecc_descriptor_configuration replaced;
+    if (jdksavdecc_descriptor_configuration_read(&replaced, frame, pos, size) >= 0)
+    {
+        config_desc.object_name = replaced.object_name;
+        config_desc.localized_description = replaced.localized_description;
+    }
+}
+
 uint16_t STDCALL configuration_descriptor_imp::descriptor_type() const
 {
     assert(config_desc.descriptor_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION);
@@ -218,119 +226,148 @@ static void add_or_replace_descriptor_and_sort(T *d, std::vector<T *> &desc_vec)
 }
 */
 
-void configuration_descriptor_imp::update_desc_database(descriptor_base_imp * desc, const uint8_t * frame, ssize_t pos, size_t frame_len)
+void configuration_descriptor_imp::update_desc_database(descriptor_base_imp * desc, void * typed_desc, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
     uint16_t desc_type = desc->descriptor_type();
     uint16_t desc_index = desc->descriptor_index();
 
-    if (m_all_desc[desc_type].size() <= desc_index)
-        m_all_desc[desc_type].resize(desc_index + 1);
-    if (m_all_desc[desc_type][desc_index])
+    if (desc_type >= desc_type_count)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, descriptor type 0x%x not stored",
+                                  base_end_station_imp_ref->entity_id(), desc_type);
+        delete desc;
+        return;
+    }
+
+    DITEM & descs = m_all_desc[desc_type];
+    if (descs.size() <= desc_index)
+        descs.resize(desc_index + 1);
+    if (descs[desc_index].desc)
     {
-        // exists
-        desc->replace_desc_frame(frame, pos, frame_len);
+        // exists, so a re-read updates the stored descriptor
+        descs[desc_index].desc->replace_desc_frame(frame, pos, frame_len);
         delete desc;
     }
     else
     {
         // does not exist
-        m_all_desc[desc_type][desc_index] = desc;
+        descs[desc_index].desc = desc;
+        descs[desc_index].typed_desc = typed_desc;
     }
 }
 
 void configuration_descriptor_imp::store_entity_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new entity_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    entity_descriptor_imp * desc = new (end_station_obj->desc_arena()) entity_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<entity_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_audio_unit_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new audio_unit_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    audio_unit_descriptor_imp * desc = new (end_station_obj->desc_arena()) audio_unit_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<audio_unit_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_stream_input_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new stream_input_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    stream_input_descriptor_imp * desc = new (end_station_obj->desc_arena()) stream_input_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<stream_input_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_stream_output_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new stream_output_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    stream_output_descriptor_imp * desc = new (end_station_obj->desc_arena()) stream_output_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<stream_output_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_jack_input_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new jack_input_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    jack_input_descriptor_imp * desc = new (end_station_obj->desc_arena()) jack_input_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<jack_input_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_jack_output_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new jack_output_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    jack_output_descriptor_imp * desc = new (end_station_obj->desc_arena()) jack_output_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<jack_output_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_avb_interface_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new avb_interface_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    avb_interface_descriptor_imp * desc = new (end_station_obj->desc_arena()) avb_interface_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<avb_interface_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_clock_source_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new clock_source_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    clock_source_descriptor_imp * desc = new (end_station_obj->desc_arena()) clock_source_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<clock_source_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_memory_object_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new memory_object_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    memory_object_descriptor_imp * desc = new (end_station_obj->desc_arena()) memory_object_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<memory_object_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_locale_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new locale_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    locale_descriptor_imp * desc = new (end_station_obj->desc_arena()) locale_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<locale_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_strings_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new strings_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    strings_descriptor_imp * desc = new (end_station_obj->desc_arena()) strings_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<strings_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_stream_port_input_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new stream_port_input_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    stream_port_input_descriptor_imp * desc = new (end_station_obj->desc_arena()) stream_port_input_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<stream_port_input_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_stream_port_output_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new stream_port_output_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    stream_port_output_descriptor_imp * desc = new (end_station_obj->desc_arena()) stream_port_output_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<stream_port_output_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_audio_cluster_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new audio_cluster_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    audio_cluster_descriptor_imp * desc = new (end_station_obj->desc_arena()) audio_cluster_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<audio_cluster_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_audio_map_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new audio_map_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    audio_map_descriptor_imp * desc = new (end_station_obj->desc_arena()) audio_map_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<audio_map_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_clock_domain_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new clock_domain_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    clock_domain_descriptor_imp * desc = new (end_station_obj->desc_arena()) clock_domain_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<clock_domain_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_control_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new control_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    control_descriptor_imp * desc = new (end_station_obj->desc_arena()) control_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<control_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_external_port_input_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new external_port_input_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    external_port_input_descriptor_imp * desc = new (end_station_obj->desc_arena()) external_port_input_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<external_port_input_descriptor *>(desc), frame, pos, frame_len);
 }
 
 void configuration_descriptor_imp::store_external_port_output_desc(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len)
 {
-    update_desc_database(new external_port_output_descriptor_imp(end_station_obj, frame, pos, frame_len), frame, pos, frame_len);
+    external_port_output_descriptor_imp * desc = new (end_station_obj->desc_arena()) external_port_output_descriptor_imp(end_station_obj, frame, pos, frame_len);
+    update_desc_database(desc, static_cast<external_port_output_descriptor *>(desc), frame, pos, frame_len);
 }
 
 size_t STDCALL configuration_descriptor_imp::entity_desc_count()
@@ -430,57 +467,57 @@ size_t STDCALL configuration_descriptor_imp::external_port_output_desc_count()
 
 entity_descriptor * STDCALL configuration_descriptor_imp::get_entity_descriptor_by_index(size_t entity_desc_index)
 {
-    return dynamic_cast<entity_descriptor *>(lookup_desc(AEM_DESC_ENTITY, entity_desc_index));
+    return lookup_typed_desc<entity_descriptor>(AEM_DESC_ENTITY, entity_desc_index);
 }
 
 audio_unit_descriptor * STDCALL configuration_descriptor_imp::get_audio_unit_desc_by_index(size_t audio_unit_desc_index)
 {
-    return dynamic_cast<audio_unit_descriptor *>(lookup_desc(AEM_DESC_AUDIO_UNIT, audio_unit_desc_index));
+    return lookup_typed_desc<audio_unit_descriptor>(AEM_DESC_AUDIO_UNIT, audio_unit_desc_index);
 }
 
 stream_input_descriptor * STDCALL configuration_descriptor_imp::get_stream_input_desc_by_index(size_t stream_input_desc_index)
 {
-    return dynamic_cast<stream_input_descriptor *>(lookup_desc(AEM_DESC_STREAM_INPUT, stream_input_desc_index));
+    return lookup_typed_desc<stream_input_descriptor>(AEM_DESC_STREAM_INPUT, stream_input_desc_index);
 }
 
 stream_output_descriptor * STDCALL configuration_descriptor_imp::get_stream_output_desc_by_index(size_t stream_output_desc_index)
 {
-    return dynamic_cast<stream_output_descriptor *>(lookup_desc(AEM_DESC_STREAM_OUTPUT, stream_output_desc_index));
+    return lookup_typed_desc<stream_output_descriptor>(AEM_DESC_STREAM_OUTPUT, stream_output_desc_index);
 }
 
 jack_input_descriptor * STDCALL configuration_descriptor_imp::get_jack_input_desc_by_index(size_t jack_input_desc_index)
 {
-    return dynamic_cast<jack_input_descriptor *>(lookup_desc(AEM_DESC_JACK_INPUT, jack_input_desc_index));
+    return lookup_typed_desc<jack_input_descriptor>(AEM_DESC_JACK_INPUT, jack_input_desc_index);
 }
 
 jack_output_descriptor * STDCALL configuration_descriptor_imp::get_jack_output_desc_by_index(size_t jack_output_desc_index)
 {
-    return dynamic_cast<jack_output_descriptor *>(lookup_desc(AEM_DESC_JACK_OUTPUT, jack_output_desc_index));
+    return lookup_typed_desc<jack_output_descriptor>(AEM_DESC_JACK_OUTPUT, jack_output_desc_index);
 }
 
 avb_interface_descriptor * STDCALL configuration_descriptor_imp::get_avb_interface_desc_by_index(size_t avb_interface_desc_index)
 {
-    return dynamic_cast<avb_interface_descriptor *>(lookup_desc(AEM_DESC_AVB_INTERFACE, avb_interface_desc_index));
+    return lookup_typed_desc<avb_interface_descriptor>(AEM_DESC_AVB_INTERFACE, avb_interface_desc_index);
 }
 
 clock_source_descriptor * STDCALL configuration_descriptor_imp::get_clock_source_desc_by_index(size_t clock_source_desc_index)
 {
-    return dynamic_cast<clock_source_descriptor *>(lookup_desc(AEM_DESC_CLOCK_SOURCE, clock_source_desc_index));
+    return lookup_typed_desc<clock_source_descriptor>(AEM_DESC_CLOCK_SOURCE, clock_source_desc_index);
 }
 
 memory_object_descriptor * STDCALL configuration_descriptor_imp::get_memory_object_desc_by_index(size_t memory_object_desc_index)
 {
-    return dynamic_cast<memory_object_descriptor *>(lookup_desc(AEM_DESC_MEMORY_OBJECT, memory_object_desc_index));
+    return lookup_typed_desc<memory_object_descriptor>(AEM_DESC_MEMORY_OBJECT, memory_object_desc_index);
 }
 
 locale_descriptor * STDCALL configuration_descriptor_imp::get_locale_desc_by_index(size_t locale_desc_index)
 {
-    return dynamic_cast<locale_descriptor *>(lookup_desc(AEM_DESC_LOCALE, locale_desc_index));
+    return lookup_typed_desc<locale_descriptor>(AEM_DESC_LOCALE, locale_desc_index);
 }
 
 strings_descriptor * STDCALL configuration_descriptor_imp::get_strings_desc_by_index(size_t strings_desc_index)
 {
-    return dynamic_cast<strings_descriptor *>(lookup_desc(AEM_DESC_STRINGS, strings_desc_index));
+    return lookup_typed_desc<strings_descriptor>(AEM_DESC_STRINGS, strings_desc_index);
 }
 
 int STDCALL configuration_descriptor_imp::get_strings_desc_string_by_reference(size_t reference, size_t & string_desc_index, size_t & string_index)
@@ -498,41 +535,41 @@ int STDCALL configuration_descriptor_imp::get_strings_desc_string_by_reference(s
 
 stream_port_input_descriptor * STDCALL configuration_descriptor_imp::get_stream_port_input_desc_by_index(size_t stream_port_input_desc_index)
 {
-    return dynamic_cast<stream_port_input_descriptor *>(lookup_desc(AEM_DESC_STREAM_PORT_INPUT, stream_port_input_desc_index));
+    return lookup_typed_desc<stream_port_input_descriptor>(AEM_DESC_STREAM_PORT_INPUT, stream_port_input_desc_index);
 }
 
 stream_port_output_descriptor * STDCALL configuration_descriptor_imp::get_stream_port_output_desc_by_index(size_t stream_port_output_desc_index)
 {
-    return dynamic_cast<stream_port_output_descriptor *>(lookup_desc(AEM_DESC_STREAM_PORT_OUTPUT, stream_port_output_desc_index));
+    return lookup_typed_desc<stream_port_output_descriptor>(AEM_DESC_STREAM_PORT_OUTPUT, stream_port_output_desc_index);
 }
 
 audio_cluster_descriptor * STDCALL configuration_descriptor_imp::get_audio_cluster_desc_by_index(size_t audio_cluster_desc_index)
 {
-    return dynamic_cast<audio_cluster_descriptor *>(lookup_desc(AEM_DESC_AUDIO_CLUSTER, audio_cluster_desc_index));
+    return lookup_typed_desc<audio_cluster_descriptor>(AEM_DESC_AUDIO_CLUSTER, audio_cluster_desc_index);
 }
 
 audio_map_descriptor * STDCALL configuration_descriptor_imp::get_audio_map_desc_by_index(size_t audio_map_desc_index)
 {
-    return dynamic_cast<audio_map_descriptor *>(lookup_desc(AEM_DESC_AUDIO_MAP, audio_map_desc_index));
+    return lookup_typed_desc<audio_map_descriptor>(AEM_DESC_AUDIO_MAP, audio_map_desc_index);
 }
 
 clock_domain_descriptor * STDCALL configuration_descriptor_imp::get_clock_domain_desc_by_index(size_t clock_domain_desc_index)
 {
-    return dynamic_cast<clock_domain_descriptor *>(lookup_desc(AEM_DESC_CLOCK_DOMAIN, clock_domain_desc_index));
+    return lookup_typed_desc<clock_domain_descriptor>(AEM_DESC_CLOCK_DOMAIN, clock_domain_desc_index);
 }
 
 control_descriptor * STDCALL configuration_descriptor_imp::get_control_desc_by_index(size_t control_desc_index)
 {
-    return dynamic_cast<control_descriptor *>(lookup_desc(AEM_DESC_CONTROL, control_desc_index));
+    return lookup_typed_desc<control_descriptor>(AEM_DESC_CONTROL, control_desc_index);
 }
 
 external_port_input_descriptor * STDCALL configuration_descriptor_imp::get_external_port_input_desc_by_index(size_t index)
 {
-    return dynamic_cast<external_port_input_descriptor *>(lookup_desc(AEM_DESC_EXTERNAL_PORT_INPUT, index));
+    return lookup_typed_desc<external_port_input_descriptor>(AEM_DESC_EXTERNAL_PORT_INPUT, index);
 }
 
 external_port_output_descriptor * STDCALL configuration_descriptor_imp::get_external_port_output_desc_by_index(size_t index)
 {
-    return dynamic_cast<external_port_output_descriptor *>(lookup_desc(AEM_DESC_EXTERNAL_PORT_OUTPUT, index));
+    return lookup_typed_desc<external_port_output_descriptor>(AEM_DESC_EXTERNAL_PORT_OUTPUT, index);
 }
 }
@@ -55,21 +55,52 @@ namespace avdecc_lib
 {
 class configuration_descriptor_imp : public configuration_descriptor, public virtual descriptor_base_imp
 {
+public:
+    struct desc_slot
+    {
+        descriptor_base_imp * desc;
+        void * typed_desc; // desc converted to the public descriptor class of its type
+    };
+
 private:
-    typedef std::vector<descriptor_base_imp *> DITEM;
+    typedef std::vector<desc_slot> DITEM;
+    static const uint16_t desc_type_count = AEM_DESC_CONTROL_BLOCK + 1;
+
     struct jdksavdecc_descriptor_configuration config_desc; // Structure containing the config_desc fields
 
     std::vector<uint16_t> desc_type_vec;  // Store descriptor types present in the CONFIGURATION descriptor
     std::vector<uint16_t> desc_count_vec; // Store descriptor counts present in the CONFIGURATION descriptor
-    std::map<uint16_t, DITEM> m_all_desc; // Store all descriptors in a map of vectors
+    DITEM m_all_desc[desc_type_count];    // Store all descriptors, indexed by descriptor type and descriptor index
+
+    ///
+    /// \return The descriptor as T, the public descriptor class of desc_type.
+    ///
+    template <typename T>
+    inline T * lookup_typed_desc(uint16_t desc_type, size_t index)
+    {
+        const desc_slot * slot = lookup_slot(desc_type, index);
+        return slot ? static_cast<T *>(slot->typed_desc) : NULL;
+    }
 
-    size_t desc_count(uint16_t type);
-    void update_desc_database(descriptor_base_imp * desc, const uint8_t * frame, ssize_t pos, size_t frame_len);
+    void update_desc_database(descriptor_base_imp * desc, void * typed_desc, const uint8_t * frame, ssize_t pos, size_t frame_len);
 
 public:
     configuration_descriptor_imp(end_station_imp * end_station_obj, const uint8_t * frame, ssize_t pos, size_t frame_len);
     virtual ~configuration_descriptor_imp();
 
+    ///
+    /// \return The number of descriptors of desc_type stored, as read or from the descriptor cache.
+    ///
+    inline size_t desc_count(uint16_t desc_type) const
+    {
+        return (desc_type < desc_type_count) ? m_all_desc[desc_type].size() : 0;
+    }
+
+    ///
+    /// Replace the frame of a re-read CONFIGURATION descriptor, with its name and description.
+    ///
+    void STDCALL replace_desc_frame(const uint8_t * frame, ssize_t pos, size_t size);
+
     uint16_t STDCALL descriptor_type() const;
     uint16_t STDCALL descriptor_index() const;
     uint8_t * STDCALL object_name();
@@ -126,6 +157,11 @@ public:
     uint16_t STDCALL get_desc_count_from_config_by_index(int desc_index);
     bool STDCALL are_desc_type_and_index_in_config(int desc_type, int desc_count_index);
 
+    ///
+    /// \return The slot of the descriptor, or NULL if there is no such descriptor.
+    ///
+    const desc_slot * lookup_slot(uint16_t desc_type, size_t index);
+
     descriptor_base_imp * lookup_desc_imp(uint16_t desc_type, size_t index);
     descriptor_base * STDCALL lookup_desc(uint16_t desc_type, size_t index);
 
@@ -42,9 +42,15 @@
 #include "adp.h"
 #include "system_tx_queue.h"
 #include "end_station_imp.h"
+#include "end_stations.h"
+#include "enumeration_scheduler.h"
+#include "descriptor_cache.h"
+#include "frame_pool.h"
 #include "adp_discovery_state_machine.h"
 #include "acmp_controller_state_machine.h"
 #include "aecp_controller_state_machine.h"
+#include "cmd_completion_imp.h"
+#include "cmd_batch_imp.h"
 #include "controller_imp.h"
 
 namespace avdecc_lib
@@ -52,49 +58,6 @@ namespace avdecc_lib
 net_interface_imp * net_interface_ref;
 controller_imp * controller_imp_ref;
 
-/*
-* The end_stations class is added here so that in the rare case that an endpoint is added by the background discovery
-* thread, causing the vector of end_stations to be re-allocated, a foreground process can still obtain a handle
-* to an end-station and send commands. Note that end_stations are never deleted by this library, even if they go
-* off-line, so end_station classes and their pointers will remain valid.
-*/
-class end_stations
-{
-private:
-    size_t m_count;
-    std::mutex locker;
-    std::vector<end_station_imp *> end_station_vec; // Store a list of End Station objects
-public:
-    end_stations()
-    {
-        m_count = 0;
-    };
-    ~end_stations()
-    {
-        for (uint32_t i = 0; i < end_station_vec.size(); i++)
-            delete end_station_vec.at(i);
-    };
-    /* use local m_count to avoid mutex operations */
-    const size_t size(void)
-    {
-        return m_count;
-    };
-    end_station_imp * at(size_t i)
-    {
-        end_station_imp * ep;
-        std::lock_guard<std::mutex> guard(locker);
-        ep = end_station_vec.at(i);
-        return ep;
-    };
-    void push_back(end_station_imp * ep)
-    {
-        locker.lock();
-        end_station_vec.push_back(ep);
-        m_count++;
-        locker.unlock();
-    };
-};
-
 controller * STDCALL create_controller(net_interface * netif,
                                        void (*notification_callback)(void *, int32_t, uint64_t,
                                                                      uint16_t, uint16_t, uint16_t,
@@ -190,38 +153,12 @@ end_station * STDCALL controller_imp::get_end_station_by_index(size_t end_statio
 
 bool STDCALL controller_imp::is_end_station_found_by_entity_id(uint64_t entity_entity_id, uint32_t & end_station_index)
 {
-    uint64_t end_station_entity_id;
-
-    for (uint32_t i = 0; i < end_station_array->size(); i++)
-    {
-        end_station_entity_id = end_station_array->at(i)->entity_id();
-
-        if (end_station_entity_id == entity_entity_id)
-        {
-            end_station_index = i;
-            return true;
-        }
-    }
-
-    return false;
+    return end_station_array->find_by_entity_id(entity_entity_id, end_station_index) != NULL;
 }
 
 bool STDCALL controller_imp::is_end_station_found_by_mac_addr(uint64_t mac_addr, uint32_t & end_station_index)
 {
-    uint64_t end_station_mac_addr;
-
-    for (uint32_t i = 0; i < end_station_array->size(); i++)
-    {
-        end_station_mac_addr = end_station_array->at(i)->mac();
-
-        if (end_station_mac_addr == mac_addr)
-        {
-            end_station_index = i;
-            return true;
-        }
-    }
-
-    return false;
+    return end_station_array->find_by_mac(mac_addr, end_station_index) != NULL;
 }
 
 configuration_descriptor * STDCALL controller_imp::get_current_config_desc(size_t end_station_index, bool report_error)
@@ -259,12 +196,13 @@ configuration_descriptor * controller_imp::get_config_desc_by_entity_id(uint64_t
 {
     for (uint32_t i = 0; i < end_station_array->size(); i++)
     {
-        entity_descriptor_response * entity_resp_ref = end_station_array->at(i)->get_entity_desc_by_index(entity_index)->get_entity_response();
         uint64_t end_station_entity_id = end_station_array->at(i)->entity_id();
         if (end_station_entity_id == entity_entity_id)
         {
+            entity_descriptor_view entity_view;
             bool is_valid = ((entity_index < end_station_array->at(i)->entity_desc_count()) &&
-                             (config_index < entity_resp_ref->configurations_count()));
+                             end_station_array->at(i)->get_entity_desc_by_index(entity_index)->get_entity_view(entity_view) &&
+                             (config_index < entity_view.configurations_count()));
             if (is_valid)
             {
                 configuration_descriptor * configuration;
@@ -277,7 +215,6 @@ configuration_descriptor * controller_imp::get_config_desc_by_entity_id(uint64_t
                 log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "get_config_desc_by_entity_id error");
             }
         }
-        delete entity_resp_ref;
     }
     return NULL;
 }
@@ -319,71 +256,186 @@ uint32_t STDCALL controller_imp::missed_log_count()
     return log_imp_ref->missed_log_event_count();
 }
 
+void STDCALL controller_imp::set_aecp_default_window(uint32_t window)
+{
+    aecp_controller_state_machine_ref->set_default_window(window);
+}
+
+void STDCALL controller_imp::set_enumeration_max_inflight(uint32_t max)
+{
+    enumeration_scheduler_ref->set_max_inflight(max);
+}
+
+uint32_t STDCALL controller_imp::get_enumeration_inflight()
+{
+    return enumeration_scheduler_ref->get_inflight();
+}
+
+uint32_t STDCALL controller_imp::get_enumeration_queue_depth()
+{
+    return enumeration_scheduler_ref->get_queue_depth();
+}
+
+void STDCALL controller_imp::set_descriptor_cache_dir(const char * dir)
+{
+    descriptor_cache_ref->set_dir(dir);
+}
+
+void STDCALL controller_imp::get_descriptor_frame_bytes(uint64_t & referenced_bytes, uint64_t & stored_bytes)
+{
+    referenced_bytes = frame_pool_ref->get_referenced_bytes();
+    stored_bytes = frame_pool_ref->get_stored_bytes();
+}
+
+cmd_completion * STDCALL controller_imp::create_cmd_completion(void (*completion_callback)(void *, cmd_completion *), void * user_obj)
+{
+    return cmd_completions_ref->create(completion_callback, user_obj);
+}
+
+cmd_batch * STDCALL controller_imp::send_cmd_batch(const struct cmd_batch_item * items, size_t item_count,
+                                                   void (*completion_callback)(void *, cmd_batch *), void * user_obj)
+{
+    cmd_batch_imp * batch = new cmd_batch_imp(completion_callback, user_obj);
+    batch->send(items, item_count);
+    return batch;
+}
+
 void controller_imp::time_tick_event()
 {
-    uint64_t end_station_entity_id;
+    time_tick_event(timer::clk_monotonic_ms());
+}
+
+void controller_imp::time_tick_event(uint64_t now_ms)
+{
+    std::vector<void *> timed_out;
+    time_tick_event(now_ms, timed_out);
+}
+
+void controller_imp::time_tick_event(uint64_t now_ms, std::vector<void *> & timed_out)
+{
     uint32_t disconnected_end_station_index;
     if (aecp_controller_state_machine_ref)
-        aecp_controller_state_machine_ref->tick();
+        aecp_controller_state_machine_ref->tick(now_ms, timed_out);
     if (acmp_controller_state_machine_ref)
-        acmp_controller_state_machine_ref->tick();
+        acmp_controller_state_machine_ref->tick(now_ms, timed_out);
 
     if (adp_discovery_state_machine_ref)
     {
-        if (adp_discovery_state_machine_ref->tick(end_station_entity_id) &&
-            is_end_station_found_by_entity_id(end_station_entity_id, disconnected_end_station_index))
+        const std::vector<uint64_t> & departed = adp_discovery_state_machine_ref->tick(now_ms);
+
+        for (size_t i = 0; i < departed.size(); i++)
         {
-            end_station_array->at(disconnected_end_station_index)->set_disconnected();
+            end_station_imp * end_station = end_station_array->find_by_entity_id(departed[i], disconnected_end_station_index);
+            if (end_station)
+            {
+                std::lock_guard<std::mutex> guard(end_station->state_locker);
+                end_station->set_disconnected();
+            }
         }
     }
 
     /* tick updates to background read of descriptors */
-    for (uint32_t i = 0; i < end_station_array->size(); i++)
+    end_station_imp::background_read_tick(now_ms);
+    enumeration_scheduler_ref->dispatch();
+}
+
+bool controller_imp::next_tick_deadline(uint64_t & deadline_ms)
+{
+    uint64_t next_ms;
+    bool found = false;
+
+    if (aecp_controller_state_machine_ref && aecp_controller_state_machine_ref->next_deadline(next_ms))
     {
-        end_station_array->at(i)->background_read_update_timeouts();
-        end_station_array->at(i)->background_read_submit_pending();
+        deadline_ms = next_ms;
+        found = true;
     }
+    if (acmp_controller_state_machine_ref && acmp_controller_state_machine_ref->next_deadline(next_ms) &&
+        (!found || next_ms < deadline_ms))
+    {
+        deadline_ms = next_ms;
+        found = true;
+    }
+    if (adp_discovery_state_machine_ref && adp_discovery_state_machine_ref->next_deadline(next_ms) &&
+        (!found || next_ms < deadline_ms))
+    {
+        deadline_ms = next_ms;
+        found = true;
+    }
+    if (end_station_imp::background_read_next_deadline(next_ms) && (!found || next_ms < deadline_ms))
+    {
+        deadline_ms = next_ms;
+        found = true;
+    }
+
+    return found;
 }
 
 int controller_imp::find_in_end_station(struct jdksavdecc_eui64 & other_entity_id, bool isUnsolicited, const uint8_t * frame)
 {
     struct jdksavdecc_eui64 other_controller_id = jdksavdecc_acmpdu_get_controller_entity_id(frame, ETHER_HDR_SIZE);
+    uint32_t i;
 
-    for (uint32_t i = 0; i < end_station_array->size(); i++)
+    end_station_imp * end_station = end_station_array->find_by_entity_id(jdksavdecc_uint64_get(&other_entity_id, 0), i);
+    if (!end_station)
     {
-        struct jdksavdecc_eui64 end_entity_id = end_station_array->at(i)->get_adp()->get_entity_entity_id();
-        struct jdksavdecc_eui64 this_controller_id = end_station_array->at(i)->get_adp()->get_controller_entity_id();
-        bool entity_id_match = false;
-        bool controller_id_match = false;
+        return -1;
+    }
 
-        if (jdksavdecc_eui64_compare(&end_entity_id, &other_entity_id) == 0)
-        {
-            entity_id_match = true;
-        }
+    //Do not try to find the controller_id if it is an unsolicited response
+    if (isUnsolicited)
+    {
+        return i;
+    }
 
-        //Do not try to find the controller_id if it is an unsolicited response
-        if (isUnsolicited && entity_id_match)
-        {
-            return i;
-        }
-        else
-        {
-            if (jdksavdecc_eui64_compare(&other_controller_id, &this_controller_id) == 0 ||
-                jdksavdecc_eui64_compare(&other_controller_id, &end_entity_id) == 0)
-            {
-                controller_id_match = true;
-            }
+    struct jdksavdecc_eui64 end_entity_id = end_station->get_adp()->get_entity_entity_id();
+    struct jdksavdecc_eui64 this_controller_id = end_station->get_adp()->get_controller_entity_id();
 
-            if (entity_id_match && controller_id_match)
-            {
-                return i;
-            }
-        }
+    if (jdksavdecc_eui64_compare(&other_controller_id, &this_controller_id) == 0 ||
+        jdksavdecc_eui64_compare(&other_controller_id, &end_entity_id) == 0)
+    {
+        return i;
     }
 
     return -1;
 }
 
+uint64_t controller_imp::rx_frame_entity_id(const uint8_t * frame, size_t frame_len)
+{
+    struct jdksavdecc_eui64 entity_id;
+
+    if (frame_len < ETHER_HDR_SIZE + JDKSAVDECC_COMMON_CONTROL_HEADER_LEN)
+        return 0;
+
+    switch (jdksavdecc_common_control_header_get_subtype(frame, ETHER_HDR_SIZE))
+    {
+    case JDKSAVDECC_SUBTYPE_ADP:
+    case JDKSAVDECC_SUBTYPE_AECP:
+        // The entity id of an ADPDU and the target entity id of an AECPDU are both in the stream id field
+        entity_id = jdksavdecc_common_control_header_get_stream_id(frame, ETHER_HDR_SIZE);
+        return jdksavdecc_uint64_get(&entity_id, 0);
+
+    case JDKSAVDECC_SUBTYPE_ACMP:
+        // As in rx_packet_event(), a response is processed by the End Station of the talker or of the listener
+        switch (jdksavdecc_common_control_header_get_control_data(frame, ETHER_HDR_SIZE))
+        {
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_RESPONSE:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_CONNECTION_RESPONSE:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_TX_RESPONSE:
+            entity_id = jdksavdecc_acmpdu_get_talker_entity_id(frame, ETHER_HDR_SIZE);
+            return jdksavdecc_uint64_get(&entity_id, 0);
+
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_RX_RESPONSE:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_RX_RESPONSE:
+        case JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_RX_STATE_RESPONSE:
+            entity_id = jdksavdecc_acmpdu_get_listener_entity_id(frame, ETHER_HDR_SIZE);
+            return jdksavdecc_uint64_get(&entity_id, 0);
+        }
+        break;
+    }
+
+    return 0;
+}
+
 void controller_imp::rx_packet_event(void *& notification_id,
                                      bool & is_notification_id_valid,
                                      const uint8_t * frame,
@@ -406,6 +458,7 @@ void controller_imp::rx_packet_event(void *& notification_id,
         {
             end_station_imp * end_station = NULL;
             bool found_adp_in_end_station = false;
+            uint32_t end_station_index;
 
             jdksavdecc_adpdu adpdu;
             memset(&adpdu, 0, sizeof(adpdu));
@@ -433,15 +486,8 @@ void controller_imp::rx_packet_event(void *& notification_id,
              * Check if an ADP object is already in the system. If not, create a new End Station object storing the ADPDU information
              * and add the End Station object to the system.
              */
-            for (uint32_t i = 0; i < end_station_array->size(); i++)
-            {
-                struct jdksavdecc_eui64 end_entity_id = end_station_array->at(i)->get_adp()->get_entity_entity_id();
-                if (jdksavdecc_eui64_compare(&end_entity_id, &adpdu.header.entity_id) == 0)
-                {
-                    found_adp_in_end_station = true;
-                    end_station = end_station_array->at(i);
-                }
-            }
+            end_station = end_station_array->find_by_entity_id(jdksavdecc_uint64_get(&adpdu.header.entity_id, 0), end_station_index);
+            found_adp_in_end_station = (end_station != NULL);
 
             if (jdksavdecc_eui64_convert_to_uint64(&adpdu.header.entity_id) != 0)
             {
@@ -449,20 +495,29 @@ void controller_imp::rx_packet_event(void *& notification_id,
                 {
                     if (adp_discovery_state_machine_ref)
                         adp_discovery_state_machine_ref->state_avail(frame, frame_len);
-                    end_station_array->push_back(new end_station_imp(frame, frame_len));
-                    end_station_array->at(end_station_array->size() - 1)->set_connected();
+                    // Another thread can add an End Station meanwhile, so the new one is not looked up by position
+                    end_station = new end_station_imp(frame, frame_len);
+                    std::lock_guard<std::mutex> guard(end_station->state_locker);
+                    end_station_array->push_back(end_station);
+                    end_station->set_connected();
                 }
                 else
                 {
-                    if ((adpdu.available_index < end_station->get_adp()->get_available_index()) ||
-                        (jdksavdecc_eui64_convert_to_uint64(&adpdu.entity_model_id) != end_station->get_adp()->get_entity_model_id()))
+                    // Frames of one End Station are processed in order by one thread, and its lock keeps
+                    // them apart from its background read timeouts and the enumeration scheduler
+                    std::lock_guard<std::mutex> guard(end_station->state_locker);
+                    bool reenumerate = (adpdu.available_index < end_station->get_adp()->get_available_index()) ||
+                                       (jdksavdecc_eui64_convert_to_uint64(&adpdu.entity_model_id) != end_station->get_adp()->get_entity_model_id());
+
+                    // Update the ADP information first, so that the End Station is re-enumerated with its new entity model
+                    end_station->get_adp()->proc_adpdu(frame, frame_len);
+
+                    if (reenumerate)
                     {
                         log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Re-enumerating end station with entity_id %ull", end_station->entity_id());
                         end_station->end_station_reenumerate();
                     }
 
-                    end_station->get_adp()->proc_adpdu(frame, frame_len);
-
                     if (end_station->get_connection_status() == 'D')
                     {
                         end_station->set_connected();
@@ -507,19 +562,22 @@ void controller_imp::rx_packet_event(void *& notification_id,
                     found_end_station_index = find_in_end_station(entity_entity_id, isUnsolicited, frame);
                     if (found_end_station_index >= 0)
                     {
+                        end_station_imp * end_station = end_station_array->at(found_end_station_index);
+                        std::lock_guard<std::mutex> guard(end_station->state_locker);
+
                         switch (msg_type)
                         {
 
                         case JDKSAVDECC_AECP_MESSAGE_TYPE_AEM_RESPONSE:
                         {
-                            end_station_array->at(found_end_station_index)->proc_rcvd_aem_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
+                            end_station->proc_rcvd_aem_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
 
                             is_notification_id_valid = true;
                             break;
                         }
                         case JDKSAVDECC_AECP_MESSAGE_TYPE_ADDRESS_ACCESS_RESPONSE:
                         {
-                            end_station_array->at(found_end_station_index)->proc_rcvd_aecp_aa_resp(notification_id, frame, frame_len, status);
+                            end_station->proc_rcvd_aecp_aa_resp(notification_id, frame, frame_len, status);
 
                             is_notification_id_valid = true;
                             break;
@@ -571,7 +629,9 @@ void controller_imp::rx_packet_event(void *& notification_id,
 
             if (found_acmp_in_end_station)
             {
-                end_station_array->at(found_end_station_index)->proc_rcvd_acmp_resp(msg_type, notification_id, frame, frame_len, status);
+                end_station_imp * end_station = end_station_array->at(found_end_station_index);
+                std::lock_guard<std::mutex> guard(end_station->state_locker);
+                end_station->proc_rcvd_acmp_resp(msg_type, notification_id, frame, frame_len, status);
                 is_notification_id_valid = true;
             }
             else
@@ -586,6 +646,12 @@ void controller_imp::rx_packet_event(void *& notification_id,
             break;
         }
     }
+
+    // The End Station lock is released, so the reads it queued can be sent
+    enumeration_scheduler_ref->dispatch();
+
+    if (is_notification_id_valid)
+        cmd_completions_ref->resp_received(notification_id, status, frame, frame_len);
 }
 
 void controller_imp::tx_packet_event(void * notification_id, uint32_t notification_flag, uint8_t * frame, size_t frame_len)
@@ -617,6 +683,8 @@ void controller_imp::tx_packet_event(void * notification_id, uint32_t notificati
     {
         log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Invalid Subtype: %x", subtype);
     }
+
+    cmd_completions_ref->cmd_sent(notification_id, notification_flag);
 }
 
 int STDCALL controller_imp::send_controller_avail_cmd(void * notification_id, uint32_t end_station_index)
@@ -29,11 +29,12 @@
 
 #pragma once
 
+#include <vector>
 #include "controller.h"
+#include "end_stations.h"
 
 namespace avdecc_lib
 {
-class end_stations;
 
 class controller_imp : public virtual controller
 {
@@ -106,16 +107,49 @@ public:
     uint32_t STDCALL missed_notification_count();
     uint32_t STDCALL missed_log_count();
 
+    void STDCALL set_aecp_default_window(uint32_t window);
+    void STDCALL set_enumeration_max_inflight(uint32_t max);
+    uint32_t STDCALL get_enumeration_inflight();
+    uint32_t STDCALL get_enumeration_queue_depth();
+    void STDCALL set_descriptor_cache_dir(const char * dir);
+    void STDCALL get_descriptor_frame_bytes(uint64_t & referenced_bytes, uint64_t & stored_bytes);
+    cmd_completion * STDCALL create_cmd_completion(void (*completion_callback)(void *, cmd_completion *), void * user_obj);
+    cmd_batch * STDCALL send_cmd_batch(const struct cmd_batch_item * items, size_t item_count,
+                                       void (*completion_callback)(void *, cmd_batch *), void * user_obj);
+
     ///
     /// Check for End Station connection, command packet, and response packet timeouts.
     ///
     void time_tick_event();
 
+    ///
+    /// Process every state machine timeout that has expired at now_ms, a timer::clk_monotonic_ms() time.
+    ///
+    void time_tick_event(uint64_t now_ms);
+
+    ///
+    /// As time_tick_event(now_ms), adding the notification id of every command removed after its
+    /// last retry to timed_out.
+    ///
+    void time_tick_event(uint64_t now_ms, std::vector<void *> & timed_out);
+
+    ///
+    /// \return False if no timeout is pending, otherwise the earliest timeout of any state machine is
+    ///         stored in deadline_ms as a timer::clk_monotonic_ms() time.
+    ///
+    bool next_tick_deadline(uint64_t & deadline_ms);
+
     ///
     /// Lookup and process packet received.
     ///
     void rx_packet_event(void *& notification_id, bool & is_notification_id_valid, const uint8_t * frame, size_t frame_len, int & status, uint16_t & operation_id, bool & is_operation_id_valid);
 
+    ///
+    /// \return The entity id of the End Station a received frame is processed for, or 0 if there is none.
+    ///         Frames with the same entity id must be processed in the order they were received.
+    ///
+    uint64_t rx_frame_entity_id(const uint8_t * frame, size_t frame_len);
+
     ///
     /// Send queued packet to the AEM Controller State Machine.
     ///
@@ -0,0 +1,191 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * deadline_queue.h
+ *
+ * Min-heap of absolute deadlines used to drive state machine timeouts.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+namespace avdecc_lib
+{
+///
+/// Keeps at most one pending deadline per key and hands back the keys whose deadline has
+/// passed in deadline order.
+///
+/// Rescheduling or cancelling a key does not search the heap. The old heap entry is left in
+/// place and skipped when it reaches the top, and the heap is rebuilt once stale entries
+/// outnumber live ones.
+///
+template <typename Key, typename Hash = std::hash<Key>>
+class deadline_queue
+{
+private:
+    struct entry
+    {
+        uint64_t deadline;
+        Key key;
+    };
+
+    struct later
+    {
+        bool operator()(const entry & a, const entry & b) const
+        {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    std::vector<entry> heap;
+    std::unordered_map<Key, uint64_t, Hash> scheduled; // The live deadline of every key
+
+    bool is_live(const entry & e) const
+    {
+        typename std::unordered_map<Key, uint64_t, Hash>::const_iterator i = scheduled.find(e.key);
+        return i != scheduled.end() && i->second == e.deadline;
+    }
+
+    void discard_stale()
+    {
+        while (!heap.empty() && !is_live(heap.front()))
+        {
+            std::pop_heap(heap.begin(), heap.end(), later());
+            heap.pop_back();
+        }
+    }
+
+    void compact()
+    {
+        heap.clear();
+        for (typename std::unordered_map<Key, uint64_t, Hash>::const_iterator i = scheduled.begin(); i != scheduled.end(); ++i)
+        {
+            entry e = {i->second, i->first};
+            heap.push_back(e);
+        }
+        std::make_heap(heap.begin(), heap.end(), later());
+    }
+
+public:
+    ///
+    /// Set the deadline for key, replacing any deadline already pending for it.
+    ///
+    void schedule(const Key & key, uint64_t deadline)
+    {
+        std::pair<typename std::unordered_map<Key, uint64_t, Hash>::iterator, bool> r =
+            scheduled.insert(std::make_pair(key, deadline));
+
+        if (!r.second)
+        {
+            if (r.first->second == deadline)
+                return;
+            r.first->second = deadline;
+        }
+
+        entry e = {deadline, key};
+        heap.push_back(e);
+        std::push_heap(heap.begin(), heap.end(), later());
+
+        if (heap.size() > 2 * scheduled.size() + 32)
+            compact();
+    }
+
+    ///
+    /// Drop the pending deadline for key, if any.
+    ///
+    void cancel(const Key & key)
+    {
+        scheduled.erase(key);
+    }
+
+    ///
+    /// \return True if a deadline is pending for key.
+    ///
+    bool is_scheduled(const Key & key) const
+    {
+        return scheduled.find(key) != scheduled.end();
+    }
+
+    ///
+    /// Remove the earliest key whose deadline is at or before now.
+    ///
+    /// \return False if no deadline has expired.
+    ///
+    bool pop_expired(uint64_t now, Key & key)
+    {
+        discard_stale();
+
+        if (heap.empty() || heap.front().deadline > now)
+            return false;
+
+        key = heap.front().key;
+        scheduled.erase(key);
+        std::pop_heap(heap.begin(), heap.end(), later());
+        heap.pop_back();
+
+        return true;
+    }
+
+    ///
+    /// \return False if no deadline is pending, otherwise the earliest deadline is stored in deadline.
+    ///
+    bool next_deadline(uint64_t & deadline)
+    {
+        discard_stale();
+
+        if (heap.empty())
+            return false;
+
+        deadline = heap.front().deadline;
+        return true;
+    }
+
+    ///
+    /// \return The number of keys with a pending deadline.
+    ///
+    size_t size() const
+    {
+        return scheduled.size();
+    }
+
+    ///
+    /// \return The number of heap entries, including the stale entries not yet discarded.
+    ///
+    size_t heap_entries() const
+    {
+        return heap.size();
+    }
+
+    void clear()
+    {
+        heap.clear();
+        scheduled.clear();
+    }
+};
+}
@@ -0,0 +1,229 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_arena.h
+ *
+ * Per End Station allocator for descriptor objects and command response frames
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+#include <mutex>
+
+namespace avdecc_lib
+{
+///
+/// Carves the descriptor objects and stored command responses of one End Station out of large
+/// chunks, so that the descriptor tree is a few contiguous blocks rather than thousands of small
+/// heap blocks, and is laid out in the order it was read.
+///
+/// Blocks are rounded up to 16 bytes and freed blocks are kept on a free list per size, so that a
+/// descriptor read again reuses the storage of the one it replaces. Every block starts with a
+/// header naming its arena, so release() needs no arena argument and a class can route its
+/// operator delete to it. Blocks larger than the largest size class come from the heap, as do
+/// blocks of objects without an End Station from allocate_unowned().
+///
+class descriptor_arena
+{
+private:
+    enum
+    {
+        ALIGN = 16,
+        CHUNK_SIZE = 64 * 1024,
+        SIZE_CLASSES = 128 // Blocks of up to (SIZE_CLASSES - 1) * ALIGN bytes are carved from chunks
+    };
+
+    struct alignas(16) block_header
+    {
+        descriptor_arena * arena; // NULL for a block from allocate_unowned()
+        uint32_t size_class; // SIZE_CLASSES for a block allocated from the heap
+    };
+
+    struct free_block
+    {
+        free_block * next;
+    };
+
+    std::mutex locker;
+    std::vector<uint8_t *> chunks;
+    size_t chunk_used; // Bytes used in the last chunk
+    free_block * free_lists[SIZE_CLASSES];
+    uint32_t allocation_count; // Blocks allocated since the arena was created
+    uint32_t live_count;       // Blocks allocated and not yet released
+
+    void * carve(uint32_t size_class)
+    {
+        size_t block_size = sizeof(block_header) + (size_t)size_class * ALIGN;
+
+        if (chunks.empty() || chunk_used + block_size > CHUNK_SIZE)
+        {
+            uint8_t * chunk = (uint8_t *)malloc(CHUNK_SIZE);
+            if (!chunk)
+                return NULL;
+            chunks.push_back(chunk);
+            chunk_used = 0;
+        }
+
+        void * p = chunks.back() + chunk_used;
+        chunk_used += block_size;
+        return p;
+    }
+
+public:
+    descriptor_arena() : chunk_used(0), allocation_count(0), live_count(0)
+    {
+        for (int i = 0; i < SIZE_CLASSES; i++)
+            free_lists[i] = NULL;
+    }
+
+    ~descriptor_arena()
+    {
+        for (size_t i = 0; i < chunks.size(); i++)
+            free(chunks[i]);
+    }
+
+    ///
+    /// \return A block of at least size bytes aligned to 16 bytes, or NULL if out of memory.
+    ///
+    void * allocate(size_t size)
+    {
+        uint32_t size_class = (uint32_t)((size + ALIGN - 1) / ALIGN);
+        block_header * h;
+
+        std::lock_guard<std::mutex> guard(locker);
+
+        if (size_class >= SIZE_CLASSES)
+        {
+            h = (block_header *)malloc(sizeof(block_header) + size);
+            size_class = SIZE_CLASSES;
+        }
+        else if (free_lists[size_class])
+        {
+            h = (block_header *)free_lists[size_class];
+            free_lists[size_class] = free_lists[size_class]->next;
+        }
+        else
+        {
+            h = (block_header *)carve(size_class);
+        }
+
+        if (!h)
+            return NULL;
+
+        h->arena = this;
+        h->size_class = size_class;
+        allocation_count++;
+        live_count++;
+        return h + 1;
+    }
+
+    ///
+    /// \return A heap block of at least size bytes that release() frees, or NULL if out of memory.
+    ///
+    static void * allocate_unowned(size_t size)
+    {
+        block_header * h = (block_header *)malloc(sizeof(block_header) + size);
+        if (!h)
+            return NULL;
+
+        h->arena = NULL;
+        h->size_class = SIZE_CLASSES;
+        return h + 1;
+    }
+
+    ///
+    /// Release a block returned by allocate() of any arena or by allocate_unowned().
+    ///
+    static void release(void * p)
+    {
+        if (!p)
+            return;
+
+        block_header * h = (block_header *)p - 1;
+        descriptor_arena * arena = h->arena;
+        if (!arena)
+        {
+            free(h);
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(arena->locker);
+        arena->live_count--;
+
+        if (h->size_class == SIZE_CLASSES)
+        {
+            free(h);
+        }
+        else
+        {
+            free_block * b = (free_block *)h;
+            b->next = arena->free_lists[h->size_class];
+            arena->free_lists[h->size_class] = b;
+        }
+    }
+
+    ///
+    /// Free every chunk at once, once every block has been released, as when an End Station
+    /// drops its descriptors to be enumerated again.
+    ///
+    /// \return False if blocks are still allocated, in which case the chunks are kept.
+    ///
+    bool reset()
+    {
+        std::lock_guard<std::mutex> guard(locker);
+
+        if (live_count)
+            return false;
+
+        for (size_t i = 0; i < chunks.size(); i++)
+            free(chunks[i]);
+        chunks.clear();
+        chunk_used = 0;
+        for (int i = 0; i < SIZE_CLASSES; i++)
+            free_lists[i] = NULL;
+        return true;
+    }
+
+    inline uint32_t get_allocation_count() const
+    {
+        return allocation_count;
+    }
+
+    inline uint32_t get_live_count() const
+    {
+        return live_count;
+    }
+
+    ///
+    /// \return The number of heap blocks backing the arena, excluding blocks larger than the largest size class.
+    ///
+    inline size_t get_chunk_count() const
+    {
+        return chunks.size();
+    }
+};
+}
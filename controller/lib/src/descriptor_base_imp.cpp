@@ -48,7 +48,10 @@ static void delete_field(descriptor_field_imp * f)
 descriptor_base_imp::descriptor_base_imp(end_station_imp * base, const uint8_t * frame, size_t size, ssize_t pos)
 {
     base_end_station_imp_ref = base;
-    resp_ref = new response_frame(frame, size, pos);
+    if (base)
+        resp_ref = new (base->desc_arena()) response_frame(&base->desc_arena(), frame, size, pos);
+    else
+        resp_ref = new response_frame(NULL, frame, size, pos); // A descriptor response without an End Station
     desc_type = jdksavdecc_uint16_get(frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR);
     desc_index = jdksavdecc_uint16_get(frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR + 2);
 }
@@ -60,6 +63,28 @@ descriptor_base_imp::~descriptor_base_imp()
     delete resp_ref;
 }
 
+size_t STDCALL descriptor_base_imp::field_count() const
+{
+    const descriptor_layout * layout = descriptor_layout_for(desc_type);
+    return layout ? layout->field_count : 0;
+}
+
+descriptor_field * STDCALL descriptor_base_imp::field(size_t index) const
+{
+    const descriptor_layout * layout = descriptor_layout_for(desc_type);
+    if (!layout || index >= layout->field_count)
+        return nullptr;
+
+    if (m_fields.empty())
+    {
+        m_fields.reserve(layout->field_count);
+        for (uint16_t i = 0; i < layout->field_count; i++)
+            m_fields.push_back(new descriptor_field_imp(layout->fields[i], resp_ref));
+    }
+
+    return m_fields[index];
+}
+
 descriptor_response_base * STDCALL descriptor_base_imp::get_descriptor_response()
 {
     std::lock_guard<std::mutex> guard(base_end_station_imp_ref->locker); //mutex lock end station
@@ -33,6 +33,7 @@
 #endif
 
 #include <vector>
+#include <new>
 #include "jdksavdecc_util.h"
 #include "jdksavdecc_aem_command.h"
 #include "jdksavdecc_aem_descriptor.h"
@@ -40,6 +41,7 @@
 #include "descriptor_field_imp.h"
 #include "descriptor_response_base_imp.h"
 #include "descriptor_base_get_name_response_imp.h"
+#include "descriptor_arena.h"
 
 namespace avdecc_lib
 {
@@ -52,7 +54,7 @@ protected:
     descriptor_response_base_imp * resp_base;
     descriptor_base_get_name_response_imp * get_name_resp;
     end_station_imp * base_end_station_imp_ref;
-    std::vector<descriptor_field_imp *> m_fields;
+    mutable std::vector<descriptor_field_imp *> m_fields; // Field views, created by the first field() call
     response_frame * resp_ref;
     uint16_t desc_type;
     uint16_t desc_index;
@@ -84,24 +86,49 @@ public:
     descriptor_base_imp(end_station_imp * base, const uint8_t * frame, size_t size, ssize_t pos);
     virtual ~descriptor_base_imp();
 
+    ///
+    /// Descriptors are allocated from the descriptor arena of their End Station. Descriptor
+    /// responses, which have no End Station, are allocated from the heap.
+    ///
+    static void * operator new(size_t size, descriptor_arena & arena)
+    {
+        void * p = arena.allocate(size);
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+
+    static void * operator new(size_t size)
+    {
+        void * p = descriptor_arena::allocate_unowned(size);
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+
+    static void operator delete(void * p, descriptor_arena &)
+    {
+        descriptor_arena::release(p);
+    }
+
+    static void operator delete(void * p)
+    {
+        descriptor_arena::release(p);
+    }
+
     uint16_t STDCALL descriptor_type() const;
     uint16_t STDCALL descriptor_index() const;
     virtual uint16_t STDCALL localized_description();
     bool STDCALL get_permission(int flag);
     uint64_t STDCALL get_owning_guid();
 
-    size_t STDCALL field_count() const
-    {
-        return m_fields.size();
-    };
+    ///
+    /// The fields are described by the layout table of the descriptor type and decoded from the
+    /// stored descriptor frame when read. Nothing is allocated until field() is first called.
+    ///
+    size_t STDCALL field_count() const;
+    descriptor_field * STDCALL field(size_t index) const;
 
-    descriptor_field * STDCALL field(size_t index) const
-    {
-        if (index < m_fields.size())
-            return m_fields.at(index);
-        else
-            return nullptr;
-    };
     ///
     /// Replace the frame for counters/commands.
     ///
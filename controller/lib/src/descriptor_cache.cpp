@@ -0,0 +1,247 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_cache.cpp
+ *
+ * Persistent cache of the descriptors read from End Stations implementation
+ */
+
+#include <cstdio>
+#include <cstring>
+#ifdef WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "jdksavdecc.h"
+#include "enumeration.h"
+#include "log_imp.h"
+#include "descriptor_cache.h"
+
+namespace avdecc_lib
+{
+descriptor_cache * descriptor_cache_ref = new descriptor_cache(); // To have one descriptor cache for all end stations
+
+static const uint8_t cache_magic[4] = {'A', 'V', 'D', 'C'};
+
+cached_entity_model::~cached_entity_model()
+{
+#ifndef WIN32
+    if (map_addr)
+        munmap(map_addr, map_len);
+#endif
+}
+
+bool cached_entity_model::load(const std::string & path, uint64_t model_id)
+{
+    const uint8_t * base;
+    size_t len;
+
+#ifdef WIN32
+    std::ifstream f(path.c_str(), std::ios::binary);
+    if (!f)
+        return false;
+    file_buf.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    base = file_buf.data();
+    len = file_buf.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < descriptor_cache::HEADER_LEN)
+    {
+        close(fd);
+        return false;
+    }
+
+    void * addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        return false;
+
+    map_addr = addr;
+    map_len = (size_t)st.st_size;
+    base = (const uint8_t *)addr;
+    len = map_len;
+#endif
+
+    if (len < descriptor_cache::HEADER_LEN ||
+        memcmp(base, cache_magic, sizeof(cache_magic)) != 0 ||
+        jdksavdecc_uint16_get(base, 4) != descriptor_cache::FILE_VERSION ||
+        jdksavdecc_uint64_get(base, 8) != model_id)
+    {
+        return false;
+    }
+
+    uint32_t count = jdksavdecc_uint32_get(base, 16);
+    size_t pos = descriptor_cache::HEADER_LEN;
+
+    // Every frame takes at least its length field, so a count the file cannot hold is corrupt
+    if (count > (len - descriptor_cache::HEADER_LEN) / 2)
+        return false;
+
+    frames.reserve(count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (pos + 2 > len)
+            return false;
+
+        cached_frame f;
+        f.frame_len = jdksavdecc_uint16_get(base, (ssize_t)pos);
+        f.frame = base + pos + 2;
+        pos += 2 + f.frame_len;
+
+        if (pos > len || f.frame_len > sizeof(((struct jdksavdecc_frame *)0)->payload))
+            return false;
+
+        frames.push_back(f);
+    }
+
+    entity_model_id = model_id;
+    return !frames.empty();
+}
+
+descriptor_cache::descriptor_cache() {}
+
+descriptor_cache::~descriptor_cache() {}
+
+std::string descriptor_cache::path(uint64_t entity_model_id) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.avdc", (unsigned long long)entity_model_id);
+
+    return cache_dir + "/" + name;
+}
+
+void descriptor_cache::set_dir(const char * dir)
+{
+    std::lock_guard<std::mutex> guard(locker);
+
+    cache_dir = dir ? dir : "";
+    models.clear();
+    missing_models.clear();
+}
+
+bool descriptor_cache::enabled()
+{
+    std::lock_guard<std::mutex> guard(locker);
+
+    return !cache_dir.empty();
+}
+
+std::shared_ptr<cached_entity_model> descriptor_cache::find(uint64_t entity_model_id)
+{
+    std::lock_guard<std::mutex> guard(locker);
+
+    if (cache_dir.empty() || entity_model_id == 0)
+        return std::shared_ptr<cached_entity_model>();
+
+    std::unordered_map<uint64_t, std::shared_ptr<cached_entity_model>>::iterator it = models.find(entity_model_id);
+    if (it != models.end())
+        return it->second;
+
+    if (missing_models.count(entity_model_id))
+        return std::shared_ptr<cached_entity_model>();
+
+    std::shared_ptr<cached_entity_model> model(new cached_entity_model());
+    if (!model->load(path(entity_model_id), entity_model_id))
+    {
+        missing_models[entity_model_id] = true;
+        return std::shared_ptr<cached_entity_model>();
+    }
+
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Loaded %d cached descriptors of entity model 0x%llx",
+                              (int)model->frames.size(), entity_model_id);
+    models[entity_model_id] = model;
+    return model;
+}
+
+bool descriptor_cache::save(uint64_t entity_model_id, const std::vector<std::vector<uint8_t>> & frames)
+{
+    std::lock_guard<std::mutex> guard(locker);
+
+    if (cache_dir.empty() || entity_model_id == 0 || frames.empty())
+        return false;
+
+    std::vector<uint8_t> buf(HEADER_LEN);
+    memcpy(buf.data(), cache_magic, sizeof(cache_magic));
+    jdksavdecc_uint16_set(FILE_VERSION, buf.data(), 4);
+    jdksavdecc_uint16_set(0, buf.data(), 6);
+    jdksavdecc_uint64_set(entity_model_id, buf.data(), 8);
+    jdksavdecc_uint32_set((uint32_t)frames.size(), buf.data(), 16);
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        size_t pos = buf.size();
+        buf.resize(pos + 2 + frames[i].size());
+        jdksavdecc_uint16_set((uint16_t)frames[i].size(), buf.data(), (ssize_t)pos);
+        memcpy(buf.data() + pos + 2, frames[i].data(), frames[i].size());
+    }
+
+    std::string file_path = path(entity_model_id);
+    std::string tmp_path = file_path + ".tmp";
+
+    FILE * f = fopen(tmp_path.c_str(), "wb");
+    if (!f)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Cannot create descriptor cache file %s", tmp_path.c_str());
+        return false;
+    }
+
+    bool written = (fwrite(buf.data(), 1, buf.size(), f) == buf.size());
+    written = (fclose(f) == 0) && written;
+
+#ifdef WIN32
+    remove(file_path.c_str()); // rename() does not replace an existing file
+#endif
+    if (!written || rename(tmp_path.c_str(), file_path.c_str()) != 0)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Cannot write descriptor cache file %s", file_path.c_str());
+        remove(tmp_path.c_str());
+        return false;
+    }
+
+    missing_models.erase(entity_model_id);
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Saved %d descriptors of entity model 0x%llx to the descriptor cache",
+                              (int)frames.size(), entity_model_id);
+    return true;
+}
+
+void descriptor_cache::invalidate(uint64_t entity_model_id)
+{
+    std::lock_guard<std::mutex> guard(locker);
+
+    models.erase(entity_model_id);
+    missing_models[entity_model_id] = true;
+    if (!cache_dir.empty())
+        remove(path(entity_model_id).c_str());
+}
+}
@@ -0,0 +1,133 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_cache.h
+ *
+ * Persistent cache of the descriptors read from End Stations, keyed by entity model id
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace avdecc_lib
+{
+///
+/// The READ_DESCRIPTOR response frames of a fully enumerated entity model. The frames point into
+/// a read only mapping of the cache file, which is released with the last reference to the model.
+///
+class cached_entity_model
+{
+private:
+    void * map_addr;
+    size_t map_len;
+    std::vector<uint8_t> file_buf; // File contents where the file is read rather than mapped
+
+public:
+    struct cached_frame
+    {
+        const uint8_t * frame;
+        uint16_t frame_len;
+    };
+
+    uint64_t entity_model_id;
+    std::vector<cached_frame> frames;
+
+    cached_entity_model() : map_addr(NULL), map_len(0), entity_model_id(0) {}
+
+    ~cached_entity_model();
+
+    ///
+    /// Map the cache file at path and index its frames.
+    ///
+    /// \return False if the file does not exist, or is not a valid cache file of the current version
+    ///         for entity_model_id.
+    ///
+    bool load(const std::string & path, uint64_t entity_model_id);
+};
+
+///
+/// The descriptors of an entity model are static, so once one End Station of a model has been
+/// enumerated its READ_DESCRIPTOR responses are saved to <dir>/<entity model id>.avdc. End Stations
+/// of the same model discovered later, in this or a following run, are populated from the cache
+/// and only the descriptors with a name or a current value are read again from the network.
+///
+/// A cache file starts with a 20 byte header: the "AVDC" magic, a 16-bit format version, 16 reserved
+/// bits, the 64-bit entity model id and the 32-bit number of frames. Each frame follows as a 16-bit
+/// length and the frame as received. All fields are big endian.
+///
+class descriptor_cache
+{
+private:
+    std::mutex locker; // Protects the directory set from application threads
+    std::string cache_dir;
+    std::unordered_map<uint64_t, std::shared_ptr<cached_entity_model>> models; // Models loaded or saved in this run
+    std::unordered_map<uint64_t, bool> missing_models;                          // Models without a valid cache file
+
+    std::string path(uint64_t entity_model_id) const;
+
+public:
+    enum
+    {
+        FILE_VERSION = 1,
+        HEADER_LEN = 20
+    };
+
+    descriptor_cache();
+
+    ~descriptor_cache();
+
+    ///
+    /// Set the directory holding the cache files. The directory must exist. The cache is disabled
+    /// while no directory is set, which is the default, and by setting NULL or an empty string.
+    ///
+    void set_dir(const char * dir);
+
+    bool enabled();
+
+    ///
+    /// \return The cached frames of entity_model_id, or an empty pointer if the model is not cached.
+    ///
+    std::shared_ptr<cached_entity_model> find(uint64_t entity_model_id);
+
+    ///
+    /// Save the READ_DESCRIPTOR response frames of an enumeration of entity_model_id, replacing any
+    /// cache file of the model. The file is written under a temporary name and then renamed, so a
+    /// reader never sees a partial file.
+    ///
+    bool save(uint64_t entity_model_id, const std::vector<std::vector<uint8_t>> & frames);
+
+    ///
+    /// Remove entity_model_id from the cache, for a model found not to match its cache file.
+    ///
+    void invalidate(uint64_t entity_model_id);
+};
+
+extern descriptor_cache * descriptor_cache_ref;
+}
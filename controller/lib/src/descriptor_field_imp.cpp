@@ -33,6 +33,8 @@
 #include <stdint.h>
 #include "avdecc-lib_build.h"
 
+#include "response_frame.h"
+#include "descriptor_response_base.h"
 #include "descriptor_field_flags_imp.h"
 #include "descriptor_field_imp.h"
 
@@ -44,8 +46,10 @@ static void delete_bitfield(avdecc_lib::descriptor_field_flags_imp * f)
 namespace avdecc_lib
 {
 
-descriptor_field_imp::descriptor_field_imp(const char * name, enum aem_desc_field_types the_type, void * v) : m_name(name), m_value(v), m_type(the_type)
+descriptor_field_imp::descriptor_field_imp(const descriptor_field_layout & layout, response_frame * frame) : m_layout(layout), m_frame(frame)
 {
+    for (uint16_t i = 0; i < m_layout.flags_count; i++)
+        m_fields.push_back(new descriptor_field_flags_imp(m_layout.flags[i].name, m_layout.flags[i].mask));
 }
 
 descriptor_field_imp::~descriptor_field_imp()
@@ -54,63 +58,56 @@ descriptor_field_imp::~descriptor_field_imp()
     m_fields.clear();
 }
 
-enum descriptor_field::aem_desc_field_types STDCALL descriptor_field_imp::get_type() const
+uint32_t descriptor_field_imp::value() const
 {
-    return m_type;
+    return descriptor_field_value(m_layout, m_frame->get_desc_buffer(), m_frame->get_desc_pos());
 }
 
-void descriptor_field_imp::append_field(descriptor_field_flags_imp * bit_field)
+enum descriptor_field::aem_desc_field_types STDCALL descriptor_field_imp::get_type() const
 {
-    m_fields.push_back(bit_field);
+    return m_layout.type;
 }
 
 const char * STDCALL descriptor_field_imp::get_name() const
 {
-    return m_name;
+    return m_layout.name;
 }
 
 char * STDCALL descriptor_field_imp::get_char() const
 {
-    assert(m_type == TYPE_CHAR);
-    return (char *)m_value;
+    assert(m_layout.type == TYPE_CHAR);
+    const char * s = (const char *)m_frame->get_desc_buffer() + m_frame->get_desc_pos() + m_layout.offset;
+    m_char.assign(s, std::find(s, s + sizeof(struct avdecc_lib_name_string64), '\0'));
+    return &m_char[0];
 }
 
 uint16_t STDCALL descriptor_field_imp::get_uint16() const
 {
-    assert(m_type == TYPE_UINT16);
-    return *(uint16_t *)m_value;
+    assert(m_layout.type == TYPE_UINT16);
+    return (uint16_t)value();
 }
 
 uint32_t STDCALL descriptor_field_imp::get_uint32() const
 {
-    assert(m_type == TYPE_UINT32);
-    return *(uint32_t *)m_value;
+    assert(m_layout.type == TYPE_UINT32);
+    return value();
 }
 
 uint32_t STDCALL descriptor_field_imp::get_flags() const
 {
-    uint32_t flag;
-    assert((m_type == TYPE_FLAGS16) || (m_type == TYPE_FLAGS16));
-    if (m_type == TYPE_FLAGS16)
-    {
-        flag = (uint32_t) * (uint16_t *)m_value;
-    }
-    else
-    {
-        flag = *(uint32_t *)m_value;
-    }
-    return flag;
+    assert((m_layout.type == TYPE_FLAGS16) || (m_layout.type == TYPE_FLAGS32));
+    return value();
 }
 
 uint32_t STDCALL descriptor_field_imp::get_flags_count() const
 {
-    assert((m_type == TYPE_FLAGS16) || (m_type == TYPE_FLAGS16));
-    return m_fields.size();
+    assert((m_layout.type == TYPE_FLAGS16) || (m_layout.type == TYPE_FLAGS32));
+    return (uint32_t)m_fields.size();
 }
 
 descriptor_field_flags * STDCALL descriptor_field_imp::get_flag_by_index(uint32_t index) const
 {
-    assert((m_type == TYPE_FLAGS16) || (m_type == TYPE_FLAGS16));
+    assert((m_layout.type == TYPE_FLAGS16) || (m_layout.type == TYPE_FLAGS32));
     return m_fields[index];
 }
 }
@@ -30,22 +30,28 @@
 #pragma once
 
 #include <vector>
+#include <string>
 #include <stdint.h>
 #include "avdecc-lib_build.h"
 
 #include "descriptor_field_flags_imp.h"
 #include "descriptor_field.h"
+#include "descriptor_field_layout.h"
 
 namespace avdecc_lib
 {
+class response_frame;
+
+///
+/// A view of a descriptor field. The value is decoded from the descriptor frame of the
+/// response_frame each time it is read, so a view stays valid when the frame is replaced.
+///
 class descriptor_field_imp : public descriptor_field
 {
 public:
-    descriptor_field_imp(const char * name, enum aem_desc_field_types the_type, void * v);
+    descriptor_field_imp(const descriptor_field_layout & layout, response_frame * frame);
     virtual ~descriptor_field_imp();
 
-    void append_field(descriptor_field_flags_imp * bit_field);
-
     const char * STDCALL get_name() const;
     enum descriptor_field::aem_desc_field_types STDCALL get_type() const;
     char * STDCALL get_char() const;
@@ -56,9 +62,11 @@ public:
     descriptor_field_flags * STDCALL get_flag_by_index(uint32_t index) const;
 
 private:
-    const char * m_name;
-    void * m_value;
-    enum aem_desc_field_types m_type;
+    const descriptor_field_layout & m_layout;
+    response_frame * m_frame;
+    mutable std::string m_char; // Null terminated copy of a TYPE_CHAR field
     std::vector<descriptor_field_flags_imp *> m_fields;
+
+    uint32_t value() const;
 };
 }
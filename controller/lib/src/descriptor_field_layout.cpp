@@ -0,0 +1,362 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_field_layout.cpp
+ *
+ * Field layout tables of the AEM descriptors
+ */
+
+#include <assert.h>
+#include "jdksavdecc_util.h"
+#include "jdksavdecc_adp.h"
+#include "jdksavdecc_aem_descriptor.h"
+#include "enumeration.h"
+#include "cassert.h"
+#include "descriptor_field_layout.h"
+
+namespace avdecc_lib
+{
+static const descriptor_flag_layout port_flags[] = {
+    {"CLOCK_SYNC_SOURCE", 1 << 15},
+    {"ASYNC_SAMPLE_RATE_CONVERTER", 1 << 14},
+    {"SYNC_SAMPLE_RATE_CONVERTER", 1 << 13},
+};
+
+static const descriptor_flag_layout stream_flags[] = {
+    {"CLOCK_SYNC_SOURCE", 1 << 0},
+    {"CLASS_A", 1 << 1},
+    {"CLASS_B", 1 << 2},
+    {"SUPPORTS_ENCRYPTED", 1 << 3},
+    {"PRIMARY_BACKUP_SUPPORTED", 1 << 4},
+    {"PRIMARY_BACKUP_VALID", 1 << 5},
+    {"SECONDARY_BACKUP_SUPPORTED", 1 << 6},
+    {"SECONDARY_BACKUP_VALID", 1 << 7},
+    {"TERTIARY_BACKUP_SUPPORTED", 1 << 8},
+    {"TERTIARY_BACKUP_VALID", 1 << 9},
+};
+
+static const descriptor_flag_layout jack_flags[] = {
+    {"CLOCK_SYNC_SOURCE", 1 << 1},
+    {"CAPTIVE", 1 << 2},
+};
+
+static const descriptor_flag_layout entity_capabilities_flags[] = {
+    {"EFU_MODE", JDKSAVDECC_ADP_ENTITY_CAPABILITY_EFU_MODE},
+    {"ADDRESS_ACCESS_SUPPORTED", JDKSAVDECC_ADP_ENTITY_CAPABILITY_ADDRESS_ACCESS_SUPPORTED},
+    {"GATEWAY_ENTITY", JDKSAVDECC_ADP_ENTITY_CAPABILITY_GATEWAY_ENTITY},
+    {"AEM_SUPPORTED", JDKSAVDECC_ADP_ENTITY_CAPABILITY_AEM_SUPPORTED},
+    {"LEGACY_AVC", JDKSAVDECC_ADP_ENTITY_CAPABILITY_LEGACY_AVC},
+    {"ASSOCIATION_ID_SUPPORTED", JDKSAVDECC_ADP_ENTITY_CAPABILITY_ASSOCIATION_ID_SUPPORTED},
+    {"ASSOCIATION_ID_VALID", JDKSAVDECC_ADP_ENTITY_CAPABILITY_ASSOCIATION_ID_VALID},
+    {"VENDOR_UNIQUE_SUPPORTED", JDKSAVDECC_ADP_ENTITY_CAPABILITY_VENDOR_UNIQUE_SUPPORTED},
+    {"CLASS_A_SUPPORTED", JDKSAVDECC_ADP_ENTITY_CAPABILITY_CLASS_A_SUPPORTED},
+    {"CLASS_B_SUPPORTED", JDKSAVDECC_ADP_ENTITY_CAPABILITY_CLASS_B_SUPPORTED},
+    {"GPTP_SUPPORTED", JDKSAVDECC_ADP_ENTITY_CAPABILITY_GPTP_SUPPORTED},
+};
+
+static const descriptor_flag_layout talker_capabilities_flags[] = {
+    {"IMPLEMENTED", JDKSAVDECC_ADP_TALKER_CAPABILITY_IMPLEMENTED},
+    {"OTHER_SOURCE", JDKSAVDECC_ADP_TALKER_CAPABILITY_OTHER_SOURCE},
+    {"CONTROL_SOURCE", JDKSAVDECC_ADP_TALKER_CAPABILITY_CONTROL_SOURCE},
+    {"MEDIA_CLOCK_SOURCE", JDKSAVDECC_ADP_TALKER_CAPABILITY_MEDIA_CLOCK_SOURCE},
+    {"SMPTE_SOURCE", JDKSAVDECC_ADP_TALKER_CAPABILITY_SMPTE_SOURCE},
+    {"MIDI_SOURCE", JDKSAVDECC_ADP_TALKER_CAPABILITY_MIDI_SOURCE},
+    {"AUDIO_SOURCE", JDKSAVDECC_ADP_TALKER_CAPABILITY_AUDIO_SOURCE},
+    {"VIDEO_SOURCE", JDKSAVDECC_ADP_TALKER_CAPABILITY_VIDEO_SOURCE},
+};
+
+static const descriptor_flag_layout listener_capabilities_flags[] = {
+    {"IMPLEMENTED", JDKSAVDECC_ADP_LISTENER_CAPABILITY_IMPLEMENTED},
+    {"OTHER_SINK", JDKSAVDECC_ADP_LISTENER_CAPABILITY_OTHER_SINK},
+    {"CONTROL_SINK", JDKSAVDECC_ADP_LISTENER_CAPABILITY_CONTROL_SINK},
+    {"MEDIA_CLOCK_SINK", JDKSAVDECC_ADP_LISTENER_CAPABILITY_MEDIA_CLOCK_SINK},
+    {"SMPTE_SINK", JDKSAVDECC_ADP_LISTENER_CAPABILITY_SMPTE_SINK},
+    {"MIDI_SINK", JDKSAVDECC_ADP_LISTENER_CAPABILITY_MIDI_SINK},
+    {"AUDIO_SINK", JDKSAVDECC_ADP_LISTENER_CAPABILITY_AUDIO_SINK},
+    {"VIDEO_SINK", JDKSAVDECC_ADP_LISTENER_CAPABILITY_VIDEO_SINK},
+};
+
+static const descriptor_field_layout entity_fields[] = {
+    {"entity_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_NAME, NULL, 0},
+    {"entity_capabilities", descriptor_field::TYPE_FLAGS32, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_CAPABILITIES, entity_capabilities_flags, ARRAY_SIZE(entity_capabilities_flags)},
+    {"talker_stream_sources", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_TALKER_STREAM_SOURCES, NULL, 0},
+    {"talker_capabilities", descriptor_field::TYPE_FLAGS16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_TALKER_CAPABILITIES, talker_capabilities_flags, ARRAY_SIZE(talker_capabilities_flags)},
+    {"listener_stream_sinks", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_LISTENER_STREAM_SINKS, NULL, 0},
+    {"listener_capabilities", descriptor_field::TYPE_FLAGS16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_LISTENER_CAPABILITIES, listener_capabilities_flags, ARRAY_SIZE(listener_capabilities_flags)},
+    {"controller_capabilities", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_CONTROLLER_CAPABILITIES, NULL, 0},
+    {"available_index", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_AVAILABLE_INDEX, NULL, 0},
+    {"vendor_name_string", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_VENDOR_NAME_STRING, NULL, 0},
+    {"model_name_string", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_MODEL_NAME_STRING, NULL, 0},
+    {"firmware_version", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_FIRMWARE_VERSION, NULL, 0},
+    {"group_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_GROUP_NAME, NULL, 0},
+    {"serial_number", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_SERIAL_NUMBER, NULL, 0},
+    {"configurations_count", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_CONFIGURATIONS_COUNT, NULL, 0},
+    {"current_configuration", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_CURRENT_CONFIGURATION, NULL, 0},
+};
+
+static const descriptor_field_layout configuration_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"descriptor_counts_count", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_DESCRIPTOR_COUNTS_COUNT, NULL, 0},
+    {"descriptor_counts_offset", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONFIGURATION_OFFSET_DESCRIPTOR_COUNTS_OFFSET, NULL, 0},
+};
+
+static const descriptor_field_layout audio_unit_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"clock_domain_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_CLOCK_DOMAIN_INDEX, NULL, 0},
+    {"number_of_stream_input_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_STREAM_INPUT_PORTS, NULL, 0},
+    {"base_stream_input_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_STREAM_INPUT_PORTS, NULL, 0},
+    {"number_of_stream_output_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_STREAM_OUTPUT_PORTS, NULL, 0},
+    {"base_stream_output_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_STREAM_OUTPUT_PORTS, NULL, 0},
+    {"number_of_external_input_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_EXTERNAL_INPUT_PORTS, NULL, 0},
+    {"base_external_input_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_EXTERNAL_INPUT_PORTS, NULL, 0},
+    {"number_of_external_output_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_EXTERNAL_OUTPUT_PORTS, NULL, 0},
+    {"base_external_output_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_EXTERNAL_OUTPUT_PORTS, NULL, 0},
+    {"number_of_internal_input_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_INTERNAL_INPUT_PORTS, NULL, 0},
+    {"base_internal_input_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_INTERNAL_INPUT_PORTS, NULL, 0},
+    {"number_of_internal_output_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_INTERNAL_OUTPUT_PORTS, NULL, 0},
+    {"base_internal_output_ports", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_INTERNAL_OUTPUT_PORTS, NULL, 0},
+    {"number_of_controls", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_CONTROLS, NULL, 0},
+    {"base_controls", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_CONTROLS, NULL, 0},
+    {"number_of_signal_selectors", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_SIGNAL_SELECTORS, NULL, 0},
+    {"base_signal_selectors", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_SIGNAL_SELECTORS, NULL, 0},
+    {"number_of_mixers", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_MIXERS, NULL, 0},
+    {"base_mixers", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_MIXERS, NULL, 0},
+    {"number_of_matrices", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_MATRICES, NULL, 0},
+    {"base_matrices", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_MATRICES, NULL, 0},
+    {"number_of_splitters", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_SPLITTERS, NULL, 0},
+    {"base_splitters", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_SPLITTERS, NULL, 0},
+    {"number_of_combiners", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_COMBINERS, NULL, 0},
+    {"base_combiners", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_COMBINERS, NULL, 0},
+    {"number_of_demultiplexers", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_DEMULTIPLEXERS, NULL, 0},
+    {"base_demultiplexers", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_DEMULTIPLEXERS, NULL, 0},
+    {"number_of_multiplexers", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_MULTIPLEXERS, NULL, 0},
+    {"base_multiplexers", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_MULTIPLEXERS, NULL, 0},
+    {"number_of_transcoders", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_TRANSCODERS, NULL, 0},
+    {"base_transcoders", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_TRANSCODERS, NULL, 0},
+    {"number_of_control_blocks", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_NUMBER_OF_CONTROL_BLOCKS, NULL, 0},
+    {"base_control_blocks", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_BASE_CONTROL_BLOCKS, NULL, 0},
+    {"current_sampling_rate", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_CURRENT_SAMPLING_RATE, NULL, 0},
+    {"sampling_rates_offset", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_SAMPLING_RATES_OFFSET, NULL, 0},
+    {"sampling_rates_count", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_OFFSET_SAMPLING_RATES_COUNT, NULL, 0},
+};
+
+static const descriptor_field_layout stream_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"clock_domain_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_CLOCK_DOMAIN_INDEX, NULL, 0},
+    {"stream_flags", descriptor_field::TYPE_FLAGS16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_STREAM_FLAGS, stream_flags, ARRAY_SIZE(stream_flags)},
+    {"formats_offset", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_FORMATS_OFFSET, NULL, 0},
+    {"number_of_formats", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_NUMBER_OF_FORMATS, NULL, 0},
+    {"backup_talker_unique_id_0", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_BACKUP_TALKER_UNIQUE_ID_0, NULL, 0},
+    {"backup_talker_unique_id_1", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_BACKUP_TALKER_UNIQUE_ID_1, NULL, 0},
+    {"backup_talker_unique_id_2", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_BACKUP_TALKER_UNIQUE_ID_2, NULL, 0},
+    {"backedup_talker_unique", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_BACKEDUP_TALKER_UNIQUE, NULL, 0},
+    {"avb_interface_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_AVB_INTERFACE_INDEX, NULL, 0},
+    {"buffer_length", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_STREAM_OFFSET_BUFFER_LENGTH, NULL, 0},
+};
+
+static const descriptor_field_layout jack_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_JACK_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_JACK_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"jack_flags", descriptor_field::TYPE_FLAGS16, JDKSAVDECC_DESCRIPTOR_JACK_OFFSET_JACK_FLAGS, jack_flags, ARRAY_SIZE(jack_flags)},
+    {"jack_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_JACK_OFFSET_JACK_TYPE, NULL, 0},
+    {"number_of_controls", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_JACK_OFFSET_NUMBER_OF_CONTROLS, NULL, 0},
+    {"base_control", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_JACK_OFFSET_BASE_CONTROL, NULL, 0},
+};
+
+static const descriptor_field_layout avb_interface_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"interface_flags", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_OFFSET_INTERFACE_FLAGS, NULL, 0},
+    {"offset_scaled_log_variance", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_OFFSET_OFFSET_SCALED_LOG_VARIANCE, NULL, 0},
+    {"port_number", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_OFFSET_PORT_NUMBER, NULL, 0},
+};
+
+static const descriptor_field_layout clock_source_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"clock_source_flags", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_OFFSET_CLOCK_SOURCE_FLAGS, NULL, 0},
+    {"clock_source_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_OFFSET_CLOCK_SOURCE_TYPE, NULL, 0},
+    {"clock_source_location_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_OFFSET_CLOCK_SOURCE_LOCATION_TYPE, NULL, 0},
+    {"clock_source_location_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_OFFSET_CLOCK_SOURCE_LOCATION_INDEX, NULL, 0},
+};
+
+static const descriptor_field_layout memory_object_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"memory_object_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT_OFFSET_MEMORY_OBJECT_TYPE, NULL, 0},
+    {"target_descriptor_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT_OFFSET_TARGET_DESCRIPTOR_TYPE, NULL, 0},
+    {"target_descriptor_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT_OFFSET_TARGET_DESCRIPTOR_INDEX, NULL, 0},
+};
+
+static const descriptor_field_layout locale_fields[] = {
+    {"locale_identifier", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_LOCALE_OFFSET_LOCALE_IDENTIFIER, NULL, 0},
+    {"number_of_strings", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_LOCALE_OFFSET_NUMBER_OF_STRINGS, NULL, 0},
+    {"base_strings", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_LOCALE_OFFSET_BASE_STRINGS, NULL, 0},
+};
+
+static const descriptor_field_layout strings_fields[] = {
+    {"string_0", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STRINGS_OFFSET_STRING_0, NULL, 0},
+    {"string_1", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STRINGS_OFFSET_STRING_1, NULL, 0},
+    {"string_2", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STRINGS_OFFSET_STRING_2, NULL, 0},
+    {"string_3", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STRINGS_OFFSET_STRING_3, NULL, 0},
+    {"string_4", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STRINGS_OFFSET_STRING_4, NULL, 0},
+    {"string_5", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STRINGS_OFFSET_STRING_5, NULL, 0},
+    {"string_6", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_STRINGS_OFFSET_STRING_6, NULL, 0},
+};
+
+static const descriptor_field_layout stream_port_fields[] = {
+    {"clock_domain_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_CLOCK_DOMAIN_INDEX, NULL, 0},
+    {"port_flags", descriptor_field::TYPE_FLAGS16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_PORT_FLAGS, port_flags, ARRAY_SIZE(port_flags)},
+    {"number_of_controls", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_NUMBER_OF_CONTROLS, NULL, 0},
+    {"base_control", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_BASE_CONTROL, NULL, 0},
+    {"number_of_clusters", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_NUMBER_OF_CLUSTERS, NULL, 0},
+    {"base_cluster", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_BASE_CLUSTER, NULL, 0},
+    {"number_of_maps", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_NUMBER_OF_MAPS, NULL, 0},
+    {"base_map", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OFFSET_BASE_MAP, NULL, 0},
+};
+
+static const descriptor_field_layout external_port_fields[] = {
+    {"clock_domain_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_CLOCK_DOMAIN_INDEX, NULL, 0},
+    {"port_flags", descriptor_field::TYPE_FLAGS16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_PORT_FLAGS, port_flags, ARRAY_SIZE(port_flags)},
+    {"number_of_controls", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_NUMBER_OF_CONTROLS, NULL, 0},
+    {"base_control", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_BASE_CONTROL, NULL, 0},
+    {"signal_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_SIGNAL_TYPE, NULL, 0},
+    {"signal_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_SIGNAL_INDEX, NULL, 0},
+    {"signal_output", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_SIGNAL_OUTPUT, NULL, 0},
+    {"block_latency", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_BLOCK_LATENCY, NULL, 0},
+    {"jack_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OFFSET_JACK_INDEX, NULL, 0},
+};
+
+static const descriptor_field_layout audio_cluster_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"signal_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_SIGNAL_TYPE, NULL, 0},
+    {"signal_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_SIGNAL_INDEX, NULL, 0},
+    {"signal_output", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_SIGNAL_OUTPUT, NULL, 0},
+    {"path_latency", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_PATH_LATENCY, NULL, 0},
+    {"block_latency", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_BLOCK_LATENCY, NULL, 0},
+    {"channel_count", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_OFFSET_CHANNEL_COUNT, NULL, 0},
+};
+
+static const descriptor_field_layout control_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"block_latency", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_BLOCK_LATENCY, NULL, 0},
+    {"control_latency", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_CONTROL_LATENCY, NULL, 0},
+    {"control_domain", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_CONTROL_DOMAIN, NULL, 0},
+    {"control_value_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_CONTROL_VALUE_TYPE, NULL, 0},
+    {"reset_time", descriptor_field::TYPE_UINT32, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_RESET_TIME, NULL, 0},
+    {"values_offset", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_VALUES_OFFSET, NULL, 0},
+    {"number_of_values", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_NUMBER_OF_VALUES, NULL, 0},
+    {"signal_type", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_SIGNAL_TYPE, NULL, 0},
+    {"signal_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_SIGNAL_INDEX, NULL, 0},
+    {"signal_output", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CONTROL_OFFSET_SIGNAL_OUTPUT, NULL, 0},
+};
+
+static const descriptor_field_layout clock_domain_fields[] = {
+    {"object_name", descriptor_field::TYPE_CHAR, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_OFFSET_OBJECT_NAME, NULL, 0},
+    {"localized_description", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_OFFSET_LOCALIZED_DESCRIPTION, NULL, 0},
+    {"clock_source_index", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_OFFSET_CLOCK_SOURCE_INDEX, NULL, 0},
+    {"clock_sources_offset", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_OFFSET_CLOCK_SOURCES_OFFSET, NULL, 0},
+    {"clock_sources_count", descriptor_field::TYPE_UINT16, JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_OFFSET_CLOCK_SOURCES_COUNT, NULL, 0},
+};
+
+static const descriptor_layout entity_layout = {entity_fields, ARRAY_SIZE(entity_fields), JDKSAVDECC_DESCRIPTOR_ENTITY_LEN};
+static const descriptor_layout configuration_layout = {configuration_fields, ARRAY_SIZE(configuration_fields), JDKSAVDECC_DESCRIPTOR_CONFIGURATION_LEN};
+static const descriptor_layout audio_unit_layout = {audio_unit_fields, ARRAY_SIZE(audio_unit_fields), JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT_LEN};
+static const descriptor_layout stream_layout = {stream_fields, ARRAY_SIZE(stream_fields), JDKSAVDECC_DESCRIPTOR_STREAM_LEN};
+static const descriptor_layout jack_layout = {jack_fields, ARRAY_SIZE(jack_fields), JDKSAVDECC_DESCRIPTOR_JACK_LEN};
+static const descriptor_layout avb_interface_layout = {avb_interface_fields, ARRAY_SIZE(avb_interface_fields), JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE_LEN};
+static const descriptor_layout clock_source_layout = {clock_source_fields, ARRAY_SIZE(clock_source_fields), JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE_LEN};
+static const descriptor_layout memory_object_layout = {memory_object_fields, ARRAY_SIZE(memory_object_fields), JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT_LEN};
+static const descriptor_layout locale_layout = {locale_fields, ARRAY_SIZE(locale_fields), JDKSAVDECC_DESCRIPTOR_LOCALE_LEN};
+static const descriptor_layout strings_layout = {strings_fields, ARRAY_SIZE(strings_fields), JDKSAVDECC_DESCRIPTOR_STRINGS_LEN};
+static const descriptor_layout stream_port_layout = {stream_port_fields, ARRAY_SIZE(stream_port_fields), JDKSAVDECC_DESCRIPTOR_STREAM_PORT_LEN};
+static const descriptor_layout external_port_layout = {external_port_fields, ARRAY_SIZE(external_port_fields), JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_LEN};
+static const descriptor_layout audio_cluster_layout = {audio_cluster_fields, ARRAY_SIZE(audio_cluster_fields), JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER_LEN};
+static const descriptor_layout control_layout = {control_fields, ARRAY_SIZE(control_fields), JDKSAVDECC_DESCRIPTOR_CONTROL_LEN};
+static const descriptor_layout clock_domain_layout = {clock_domain_fields, ARRAY_SIZE(clock_domain_fields), JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN_LEN};
+
+const descriptor_layout * descriptor_layout_for(uint16_t desc_type)
+{
+    switch (desc_type)
+    {
+    case AEM_DESC_ENTITY:
+        return &entity_layout;
+    case AEM_DESC_CONFIGURATION:
+        return &configuration_layout;
+    case AEM_DESC_AUDIO_UNIT:
+        return &audio_unit_layout;
+    case AEM_DESC_STREAM_INPUT:
+    case AEM_DESC_STREAM_OUTPUT:
+        return &stream_layout;
+    case AEM_DESC_JACK_INPUT:
+    case AEM_DESC_JACK_OUTPUT:
+        return &jack_layout;
+    case AEM_DESC_AVB_INTERFACE:
+        return &avb_interface_layout;
+    case AEM_DESC_CLOCK_SOURCE:
+        return &clock_source_layout;
+    case AEM_DESC_MEMORY_OBJECT:
+        return &memory_object_layout;
+    case AEM_DESC_LOCALE:
+        return &locale_layout;
+    case AEM_DESC_STRINGS:
+        return &strings_layout;
+    case AEM_DESC_STREAM_PORT_INPUT:
+    case AEM_DESC_STREAM_PORT_OUTPUT:
+        return &stream_port_layout;
+    case AEM_DESC_EXTERNAL_PORT_INPUT:
+    case AEM_DESC_EXTERNAL_PORT_OUTPUT:
+        return &external_port_layout;
+    case AEM_DESC_AUDIO_CLUSTER:
+        return &audio_cluster_layout;
+    case AEM_DESC_CONTROL:
+        return &control_layout;
+    case AEM_DESC_CLOCK_DOMAIN:
+        return &clock_domain_layout;
+    default:
+        return NULL;
+    }
+}
+
+uint32_t descriptor_field_value(const descriptor_field_layout & field, const uint8_t * buffer, size_t pos)
+{
+    switch (field.type)
+    {
+    case descriptor_field::TYPE_UINT16:
+    case descriptor_field::TYPE_FLAGS16:
+        return jdksavdecc_uint16_get(buffer, pos + field.offset);
+    case descriptor_field::TYPE_UINT32:
+    case descriptor_field::TYPE_FLAGS32:
+        return jdksavdecc_uint32_get(buffer, pos + field.offset);
+    default:
+        assert(0);
+        return 0;
+    }
+}
+}
@@ -0,0 +1,91 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * descriptor_field_layout.h
+ *
+ * Field layout tables of the AEM descriptors
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "descriptor_field.h"
+
+namespace avdecc_lib
+{
+///
+/// A named bit of a flags field.
+///
+struct descriptor_flag_layout
+{
+    const char * name;
+    uint32_t mask;
+};
+
+///
+/// A field of a descriptor, at offset from the start of the descriptor in the READ_DESCRIPTOR response.
+///
+struct descriptor_field_layout
+{
+    const char * name;
+    enum descriptor_field::aem_desc_field_types type;
+    uint16_t offset;
+    const descriptor_flag_layout * flags; // The named bits of a TYPE_FLAGS16 or TYPE_FLAGS32 field, or NULL
+    uint16_t flags_count;
+};
+
+///
+/// The fields of a descriptor type that the descriptor_field interface can express. 64 bit and
+/// 8 bit fields, and variable length arrays such as the stream formats, are left to the typed
+/// descriptor response getters.
+///
+struct descriptor_layout
+{
+    const descriptor_field_layout * fields;
+    uint16_t field_count;
+    uint16_t length; // The fixed length of the descriptor, up to the variable length arrays
+};
+
+///
+/// The layouts are constant tables, the fields are decoded from the stored descriptor frame
+/// each time they are read.
+///
+/// \return The layout of desc_type, or NULL if the descriptor type has no layout.
+///
+const descriptor_layout * descriptor_layout_for(uint16_t desc_type);
+
+///
+/// \return True if the fixed fields of layout fit in a frame of frame_len with the descriptor at pos.
+///
+inline bool descriptor_layout_fits(const descriptor_layout * layout, size_t frame_len, size_t pos)
+{
+    return pos <= frame_len && frame_len - pos >= layout->length;
+}
+
+///
+/// Decode the field at the descriptor at pos in buffer. TYPE_CHAR fields are returned by descriptor_field_imp.
+///
+uint32_t descriptor_field_value(const descriptor_field_layout & field, const uint8_t * buffer, size_t pos);
+}
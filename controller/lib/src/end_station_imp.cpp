@@ -29,6 +29,8 @@
 
 #include <vector>
 #include <cstring>
+#include <memory>
+#include <utility>
 #include "avdecc_error.h"
 #include "enumeration.h"
 #include "notification_imp.h"
@@ -40,22 +42,39 @@
 #include "system_tx_queue.h"
 #include "jdksavdecc.h"
 #include "end_station_imp.h"
+#include "enumeration_scheduler.h"
+#include "descriptor_cache.h"
+#include "aem_resp_dispatch.h"
 
 namespace avdecc_lib
 {
+deadline_queue<end_station_imp *> end_station_imp::background_read_deadlines;
+std::mutex end_station_imp::background_read_deadlines_locker;
+
 end_station_imp::end_station_imp(const uint8_t * frame, size_t frame_len)
 {
     end_station_connection_status = ' ';
+    m_background_read_window = 0;
+    m_enumeration_priority = false;
+    m_enumeration_queued = false;
+    m_desc_cache_hit = false;
     adp_ref = new adp(frame, frame_len);
     struct jdksavdecc_eui64 entity_id;
     entity_id = adp_ref->get_entity_entity_id();
     end_station_entity_id = jdksavdecc_uint64_get(&entity_id, 0);
     utility::convert_eui48_to_uint64(adp_ref->get_src_addr().value, end_station_mac);
+
+    // The enumeration scheduler can send a read for the End Station as soon as the first one is queued
+    std::lock_guard<std::mutex> guard(state_locker);
     end_station_init();
 }
 
 end_station_imp::~end_station_imp()
 {
+    {
+        std::lock_guard<std::mutex> guard(background_read_deadlines_locker);
+        background_read_deadlines.cancel(this);
+    }
     delete adp_ref;
 
     for (uint32_t entity_vec_index = 0; entity_vec_index < entity_desc_vec.size(); entity_vec_index++)
@@ -68,8 +87,20 @@ int end_station_imp::end_station_init()
 {
     current_entity_desc = 0;
     current_config_desc = 0;
-
-    read_desc_init(JDKSAVDECC_DESCRIPTOR_ENTITY, 0);
+    m_enumeration_start_ms = timer::clk_monotonic_ms();
+    m_enumeration_time_ms = 0;
+    m_background_reads_completed = 0;
+    m_background_read_timeouts = 0;
+    m_desc_cache_frames.clear();
+
+    // An End Station of a cached entity model is populated from the descriptor cache, and the ENTITY
+    // descriptor read below then refreshes the descriptors with a name or a current value.
+    m_desc_cache_hit = desc_cache_replay();
+
+    // The ENTITY descriptor is read in the background like every other descriptor, so that the
+    // enumeration scheduler can hold back End Stations appearing together
+    queue_background_read_request(JDKSAVDECC_DESCRIPTOR_ENTITY, 0, 1, 0);
+    background_read_submit_pending();
 
     return 0;
 }
@@ -82,6 +113,7 @@ void end_station_imp::end_station_reenumerate()
     }
 
     entity_desc_vec.clear();
+    m_desc_arena.reset();
 
     end_station_init();
 }
@@ -191,6 +223,170 @@ int end_station_imp::send_read_desc_cmd_with_flag(void * notification_id, uint32
     return 0;
 }
 
+bool end_station_imp::store_desc(uint16_t desc_type, uint16_t config_index, const uint8_t * frame, size_t frame_len)
+{
+    const int read_desc_offset = ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
+    configuration_descriptor_imp * config_desc_imp_ref = NULL;
+    bool store_descriptor = false;
+
+    switch (desc_type)
+    {
+    case JDKSAVDECC_DESCRIPTOR_ENTITY:
+        store_descriptor = true;
+        break;
+
+    case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
+        if (entity_desc_vec.size() == 1)
+        {
+            store_descriptor = true;
+        }
+        break;
+
+    default:
+        if (entity_desc_vec.size() == 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
+        {
+            store_descriptor = true;
+        }
+        break;
+    }
+
+    if (!store_descriptor)
+        return false;
+
+    if (entity_desc_vec.size() >= 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
+    {
+        config_desc_imp_ref = dynamic_cast<configuration_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(config_index));
+
+        if (!config_desc_imp_ref)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base configuration_descriptor to derived configuration_descriptor_imp error");
+        }
+    }
+
+    try
+    {
+        switch (desc_type)
+        {
+        case JDKSAVDECC_DESCRIPTOR_ENTITY:
+            if (entity_desc_vec.size() == 0)
+            {
+                entity_desc_vec.push_back(new (m_desc_arena) entity_descriptor_imp(this, frame, read_desc_offset, frame_len));
+            }
+            else
+            {
+                // A re-read of the ENTITY descriptor updates its names and current configuration
+                entity_desc_vec.at(current_entity_desc)->replace_desc_frame(frame, read_desc_offset, frame_len);
+            }
+            current_config_desc = entity_desc_vec.at(current_entity_desc)->current_configuration();
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
+            entity_desc_vec.at(current_entity_desc)->store_config_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_audio_unit_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STREAM_INPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_stream_input_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_stream_output_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_JACK_INPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_jack_input_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_JACK_OUTPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_jack_output_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_avb_interface_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_clock_source_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_memory_object_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_LOCALE:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_locale_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STRINGS:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_strings_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_stream_port_input_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_stream_port_output_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_audio_cluster_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_AUDIO_MAP:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_audio_map_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_clock_domain_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_CONTROL:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_control_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_INPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_external_port_input_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OUTPUT:
+            if (config_desc_imp_ref != nullptr)
+                config_desc_imp_ref->store_external_port_output_desc(this, frame, read_desc_offset, frame_len);
+            break;
+
+        default:
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor %s is not yet implemented in avdecc-lib.", utility::aem_desc_value_to_name(desc_type));
+            break;
+        }
+    }
+    catch (const avdecc_read_descriptor_error & ia)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, catch %s", entity_id(), ia.what());
+    }
+
+    return true;
+}
+
 int end_station_imp::proc_read_desc_resp(void *& notification_id, const uint8_t * frame, size_t frame_len, int & status)
 {
     const int read_desc_offset = ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
@@ -202,22 +398,11 @@ int end_station_imp::proc_read_desc_resp(void *& notification_id, const uint8_t
     uint16_t desc_type;
     uint16_t desc_index = 0;
     uint16_t config_index = 0;
-    configuration_descriptor_imp * config_desc_imp_ref = NULL;
     memset(&aem_cmd_read_desc_resp, 0, sizeof(aem_cmd_read_desc_resp));
     desc_type = jdksavdecc_uint16_get(frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR);
     desc_index_from_frame(desc_type, (void *)frame, read_desc_offset, desc_index);
     config_index = jdksavdecc_uint16_get(frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_CONFIGURATION_INDEX);
 
-    if (entity_desc_vec.size() >= 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
-    {
-        config_desc_imp_ref = dynamic_cast<configuration_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(config_index));
-
-        if (!config_desc_imp_ref)
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base configuration_descriptor to derived configuration_descriptor_imp error");
-        }
-    }
-
     memcpy(cmd_frame.payload, frame, frame_len);
     aem_cmd_read_desc_resp_returned = jdksavdecc_aem_command_read_descriptor_response_read(&aem_cmd_read_desc_resp,
                                                                                            frame,
@@ -244,186 +429,181 @@ int end_station_imp::proc_read_desc_resp(void *& notification_id, const uint8_t
         return 0;
     }
 
-    bool store_descriptor = false;
-    if (status == avdecc_lib::AEM_STATUS_SUCCESS)
+    bool stored = (status == avdecc_lib::AEM_STATUS_SUCCESS) && store_desc(desc_type, config_index, frame, frame_len);
+    if (stored && !m_desc_cache_hit)
     {
-        switch (desc_type)
+        if (descriptor_cache_ref->enabled())
         {
-        case JDKSAVDECC_DESCRIPTOR_ENTITY:
-            store_descriptor = true;
-            break;
-
-        case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
-            if (entity_desc_vec.size() == 1)
-            {
-                store_descriptor = true;
-            }
-            break;
-
-        default:
-            if (entity_desc_vec.size() == 1 && entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1)
-            {
-                store_descriptor = true;
-            }
-            break;
+            uint64_t key = ((uint64_t)desc_type << 32) | ((uint64_t)config_index << 16) | desc_index;
+            m_desc_cache_frames[key].assign(frame, frame + frame_len);
         }
+
+        background_read_deduce_next(entity_desc_vec.at(current_entity_desc), desc_type, config_index, (void *)frame, read_desc_offset);
     }
+    background_read_update_inflight(desc_type, (void *)frame, read_desc_offset);
+    if (stored && m_desc_cache_hit && desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
+        desc_cache_refresh();
+    background_read_submit_pending();
 
-    if (store_descriptor)
+    if ((entity_desc_vec.size() >= 1) && (entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1))
     {
-        try
+        if (m_backbround_read_inflight.empty() && m_backbround_read_pending.empty())
         {
-            switch (desc_type)
+            if (m_enumeration_time_ms == 0)
             {
-            case JDKSAVDECC_DESCRIPTOR_ENTITY:
-                if (entity_desc_vec.size() == 0)
-                {
-                    entity_desc_vec.push_back(new entity_descriptor_imp(this, frame, read_desc_offset, frame_len));
-                    current_config_desc = entity_desc_vec.at(current_entity_desc)->current_configuration();
-                }
-                break;
-
-            case JDKSAVDECC_DESCRIPTOR_CONFIGURATION:
-                entity_desc_vec.at(current_entity_desc)->store_config_desc(this, frame, read_desc_offset, frame_len);
-                break;
-
-            case JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_audio_unit_desc(this, frame, read_desc_offset, frame_len);
-                break;
-
-            case JDKSAVDECC_DESCRIPTOR_STREAM_INPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_stream_input_desc(this, frame, read_desc_offset, frame_len);
-                break;
-
-            case JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_stream_output_desc(this, frame, read_desc_offset, frame_len);
-                break;
+                m_enumeration_time_ms = (uint32_t)(timer::clk_monotonic_ms() - m_enumeration_start_ms);
+                if (m_enumeration_time_ms == 0)
+                    m_enumeration_time_ms = 1; // Completed within the clock resolution
+                log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "0x%llx, enumeration completed in %d ms", entity_id(), m_enumeration_time_ms);
+                desc_cache_save();
+            }
+            notification_imp_ref->post_notification_msg(END_STATION_READ_COMPLETED, end_station_entity_id, 0, 0, 0, 0, NULL);
+        }
+    }
 
-            case JDKSAVDECC_DESCRIPTOR_JACK_INPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_jack_input_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    return 0;
+}
 
-            case JDKSAVDECC_DESCRIPTOR_JACK_OUTPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_jack_output_desc(this, frame, read_desc_offset, frame_len);
-                break;
+bool end_station_imp::desc_cache_replay()
+{
+    std::shared_ptr<cached_entity_model> model = descriptor_cache_ref->find(adp_ref->get_entity_model_id());
+    if (!model)
+        return false;
 
-            case JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_avb_interface_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    const int read_desc_offset = ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_LEN;
+    struct jdksavdecc_frame cmd_frame;
 
-            case JDKSAVDECC_DESCRIPTOR_CLOCK_SOURCE:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_clock_source_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    for (size_t i = 0; i < model->frames.size(); i++)
+    {
+        const cached_entity_model::cached_frame & f = model->frames[i];
+        if (f.frame_len < read_desc_offset)
+            continue;
 
-            case JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_memory_object_desc(this, frame, read_desc_offset, frame_len);
-                break;
+        // The frame was read from another End Station of the model
+        memcpy(cmd_frame.payload, f.frame, f.frame_len);
+        jdksavdecc_common_control_header_set_stream_id(adp_ref->get_entity_entity_id(), cmd_frame.payload, ETHER_HDR_SIZE);
 
-            case JDKSAVDECC_DESCRIPTOR_LOCALE:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_locale_desc(this, frame, read_desc_offset, frame_len);
-                break;
+        uint16_t desc_type = jdksavdecc_uint16_get(cmd_frame.payload, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_DESCRIPTOR);
+        uint16_t config_index = jdksavdecc_uint16_get(cmd_frame.payload, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_READ_DESCRIPTOR_RESPONSE_OFFSET_CONFIGURATION_INDEX);
+        store_desc(desc_type, config_index, cmd_frame.payload, f.frame_len);
+    }
 
-            case JDKSAVDECC_DESCRIPTOR_STRINGS:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_strings_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    if (entity_desc_vec.size() != 1 || entity_desc_vec.at(current_entity_desc)->config_desc_count() == 0)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, descriptor cache of entity model 0x%llx is incomplete",
+                                  end_station_entity_id, adp_ref->get_entity_model_id());
+        for (uint32_t entity_vec_index = 0; entity_vec_index < entity_desc_vec.size(); entity_vec_index++)
+        {
+            delete entity_desc_vec.at(entity_vec_index);
+        }
+        entity_desc_vec.clear();
+        descriptor_cache_ref->invalidate(adp_ref->get_entity_model_id());
+        return false;
+    }
 
-            case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_stream_port_input_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "0x%llx, %d descriptors read from the descriptor cache",
+                              end_station_entity_id, (int)model->frames.size());
+    return true;
+}
 
-            case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_stream_port_output_desc(this, frame, read_desc_offset, frame_len);
-                break;
+void end_station_imp::desc_cache_refresh()
+{
+    entity_descriptor_imp * ed = entity_desc_vec.at(current_entity_desc);
+    entity_descriptor_view entity_view;
+    bool valid = ed->get_entity_view(entity_view) &&
+                 (entity_view.entity_model_id() == adp_ref->get_entity_model_id()) &&
+                 (entity_view.configurations_count() == ed->config_desc_count());
 
-            case JDKSAVDECC_DESCRIPTOR_AUDIO_CLUSTER:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_audio_cluster_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    if (!valid)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, ENTITY descriptor does not match the descriptor cache, re-enumerating",
+                                  end_station_entity_id);
+        descriptor_cache_ref->invalidate(adp_ref->get_entity_model_id());
+        end_station_reenumerate();
+        return;
+    }
 
-            case JDKSAVDECC_DESCRIPTOR_AUDIO_MAP:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_audio_map_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    configuration_descriptor_imp * cd = dynamic_cast<configuration_descriptor_imp *>(ed->get_config_desc_by_index(current_config_desc));
+    if (!cd)
+        return;
 
-            case JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_clock_domain_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    // The names of the configurations, and every descriptor of the current one that has a name or
+    // a current value, may have changed since the model was cached
+    queue_background_read_request(JDKSAVDECC_DESCRIPTOR_CONFIGURATION, 0, (uint16_t)ed->config_desc_count(), 0);
+    for (uint16_t desc_type = JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT; desc_type <= JDKSAVDECC_DESCRIPTOR_CONTROL_BLOCK; desc_type++)
+    {
+        if (!desc_cache_is_current(desc_type))
+            queue_background_read_request(desc_type, 0, (uint16_t)cd->desc_count(desc_type), current_config_desc);
+    }
+}
 
-            case JDKSAVDECC_DESCRIPTOR_CONTROL:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_control_desc(this, frame, read_desc_offset, frame_len);
-                break;
+bool end_station_imp::desc_cache_is_current(uint16_t desc_type)
+{
+    switch (desc_type)
+    {
+    case JDKSAVDECC_DESCRIPTOR_LOCALE:
+    case JDKSAVDECC_DESCRIPTOR_STRINGS:
+    case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT:
+    case JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT:
+    case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_INPUT:
+    case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OUTPUT:
+    case JDKSAVDECC_DESCRIPTOR_AUDIO_MAP:
+        return true;
 
-            case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_INPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_external_port_input_desc(this, frame, read_desc_offset, frame_len);
-                break;
+    default:
+        return false;
+    }
+}
 
-            case JDKSAVDECC_DESCRIPTOR_EXTERNAL_PORT_OUTPUT:
-                if (config_desc_imp_ref != nullptr)
-                    config_desc_imp_ref->store_external_port_output_desc(this, frame, read_desc_offset, frame_len);
-                break;
+void end_station_imp::desc_cache_save()
+{
+    uint64_t entity_model_id = adp_ref->get_entity_model_id();
 
-            default:
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor %s is not yet implemented in avdecc-lib.", utility::aem_desc_value_to_name(desc_type));
-                break;
-            }
-        }
-        catch (const avdecc_read_descriptor_error & ia)
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "0x%llx, catch %s", entity_id(), ia.what());
-        }
+    if (!m_desc_cache_hit && m_background_read_timeouts == 0 && !m_desc_cache_frames.empty() &&
+        !descriptor_cache_ref->find(entity_model_id))
+    {
+        std::vector<std::vector<uint8_t>> frames;
+        frames.reserve(m_desc_cache_frames.size());
 
-        background_read_deduce_next(entity_desc_vec.at(current_entity_desc), desc_type, config_index, (void *)frame, read_desc_offset);
-    }
-    background_read_update_inflight(desc_type, (void *)frame, read_desc_offset);
-    background_read_submit_pending();
+        // In key order the ENTITY descriptor comes first and every CONFIGURATION before the descriptors it holds
+        for (std::map<uint64_t, std::vector<uint8_t>>::iterator it = m_desc_cache_frames.begin(); it != m_desc_cache_frames.end(); ++it)
+            frames.push_back(std::move(it->second));
 
-    if ((entity_desc_vec.size() >= 1) && (entity_desc_vec.at(current_entity_desc)->config_desc_count() >= 1))
-    {
-        if (m_backbround_read_inflight.empty() && m_backbround_read_pending.empty())
-        {
-            notification_imp_ref->post_notification_msg(END_STATION_READ_COMPLETED, end_station_entity_id, 0, 0, 0, 0, NULL);
-        }
+        descriptor_cache_ref->save(entity_model_id, frames);
     }
 
-    return 0;
+    m_desc_cache_frames.clear();
 }
 
-void end_station_imp::background_read_update_timeouts(void)
+void end_station_imp::background_read_update_timeouts(uint64_t now_ms)
 {
     std::list<background_read_request *>::iterator ii;
     background_read_request * b;
+    uint32_t timed_out = 0;
 
     ii = m_backbround_read_inflight.begin();
     while (ii != m_backbround_read_inflight.end())
     {
         b = *ii;
         // check inflight timeout
-        if (b->m_timer.timeout())
+        if (b->m_deadline_ms <= now_ms)
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Background read timeout reading descriptor %s index %d\n", utility::aem_desc_value_to_name(b->m_type), b->m_index);
             ii = m_backbround_read_inflight.erase(ii);
             delete b;
+            timed_out++;
+            m_background_read_timeouts++;
         }
         else
         {
             ++ii;
         }
     }
+
+    while (timed_out--)
+        enumeration_scheduler_ref->release();
+
+    background_read_reschedule();
 }
 
 void end_station_imp::background_read_update_inflight(uint16_t desc_type, void * frame, ssize_t read_desc_offset)
@@ -432,6 +612,8 @@ void end_station_imp::background_read_update_inflight(uint16_t desc_type, void *
     background_read_request * b;
     uint16_t desc_index;
 
+    uint32_t completed = 0;
+
     bool have_index = desc_index_from_frame(desc_type, frame, read_desc_offset, desc_index);
 
     ii = m_backbround_read_inflight.begin();
@@ -443,50 +625,105 @@ void end_station_imp::background_read_update_inflight(uint16_t desc_type, void *
         {
             ii = m_backbround_read_inflight.erase(ii);
             delete b;
+            completed++;
         }
         else
         {
             ++ii;
         }
     }
+
+    m_background_reads_completed += completed;
+    while (completed--)
+        enumeration_scheduler_ref->release();
+
+    background_read_reschedule();
 }
 
 void end_station_imp::background_read_submit_pending(void)
 {
-    // if there are no pending inflight, but the background read list is not
-    // empty submit the next set of read operations
-    if (m_backbround_read_inflight.empty() && !m_backbround_read_pending.empty())
+    // Keep the background read window full with the pending reads, whatever their descriptor type,
+    // as the enumeration scheduler gives this End Station its turns. A read that depends on another
+    // descriptor is only queued by background_read_deduce_next() once that descriptor has been read.
+    if (background_read_ready())
+        enumeration_scheduler_ref->request(this);
+
+    background_read_reschedule();
+}
+
+bool end_station_imp::background_read_ready(void)
+{
+    uint32_t window = m_background_read_window ? m_background_read_window : aecp_controller_state_machine_ref->get_window(end_station_entity_id);
+
+    return !m_backbround_read_pending.empty() && (m_backbround_read_inflight.size() < window);
+}
+
+bool end_station_imp::background_read_submit_one(void)
+{
+    if (!background_read_ready())
+        return false;
+
+    // Time out once the READ_DESCRIPTOR command has used all its retries. A read queued behind a
+    // full AECP window is sent one command timeout later per window ahead of it.
+    uint32_t aecp_window = aecp_controller_state_machine_ref->get_window(end_station_entity_id);
+    uint32_t ahead = aecp_controller_state_machine_ref->get_window_occupancy(end_station_entity_id) +
+                     aecp_controller_state_machine_ref->get_queue_depth(end_station_entity_id);
+    uint64_t deadline_ms = timer::clk_monotonic_ms() + aecp_controller_state_machine_ref->command_lifetime_ms(end_station_entity_id) +
+                           (ahead / aecp_window) * aecp_controller_state_machine_ref->get_rto_ms(end_station_entity_id);
+
+    background_read_request * b = m_backbround_read_pending.front();
+    m_backbround_read_pending.pop_front();
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read of %s index %d config %d", utility::aem_desc_value_to_name(b->m_type), b->m_index, b->m_config);
+    read_desc_init(b->m_type, b->m_index, b->m_config);
+    b->m_deadline_ms = deadline_ms;
+    m_backbround_read_inflight.push_back(b);
+
+    background_read_reschedule();
+    return true;
+}
+
+void end_station_imp::background_read_reschedule(void)
+{
+    std::list<background_read_request *>::iterator ii;
+    uint64_t deadline_ms = UINT64_MAX;
+
+    for (ii = m_backbround_read_inflight.begin(); ii != m_backbround_read_inflight.end(); ++ii)
+    {
+        if ((*ii)->m_deadline_ms < deadline_ms)
+            deadline_ms = (*ii)->m_deadline_ms;
+    }
+
+    std::lock_guard<std::mutex> guard(background_read_deadlines_locker);
+    if (m_backbround_read_inflight.empty())
+        background_read_deadlines.cancel(this);
+    else
+        background_read_deadlines.schedule(this, deadline_ms);
+}
+
+void end_station_imp::background_read_tick(uint64_t now_ms)
+{
+    end_station_imp * end_station;
+
+    for (;;)
     {
-        background_read_request * b_first = m_backbround_read_pending.front();
-        m_backbround_read_pending.pop_front();
-        log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read of %s index %d config %d", utility::aem_desc_value_to_name(b_first->m_type), b_first->m_index, b_first->m_config);
-        read_desc_init(b_first->m_type, b_first->m_index, b_first->m_config);
-        b_first->m_timer.start(750); // 750 ms timeout (1722.1 timeout is 250ms)
-        m_backbround_read_inflight.push_back(b_first);
-
-        if (!m_backbround_read_pending.empty())
         {
-            background_read_request * b_next = m_backbround_read_pending.front();
-            while (b_next->m_type == b_first->m_type)
-            {
-                m_backbround_read_pending.pop_front();
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "Background read of %s index %d config %d", utility::aem_desc_value_to_name(b_next->m_type), b_next->m_index, b_next->m_config);
-                read_desc_init(b_next->m_type, b_next->m_index, b_next->m_config);
-                b_next->m_timer.start(750); // 750 ms timeout (1722.1 timeout is 250ms)
-                m_backbround_read_inflight.push_back(b_next);
-                if (m_backbround_read_pending.empty())
-                {
-                    break;
-                }
-                else
-                {
-                    b_next = m_backbround_read_pending.front();
-                }
-            }
+            std::lock_guard<std::mutex> guard(background_read_deadlines_locker);
+            if (!background_read_deadlines.pop_expired(now_ms, end_station))
+                break;
         }
+
+        std::lock_guard<std::mutex> guard(end_station->state_locker);
+        end_station->background_read_update_timeouts(now_ms);
+        end_station->background_read_submit_pending();
     }
 }
 
+bool end_station_imp::background_read_next_deadline(uint64_t & deadline_ms)
+{
+    std::lock_guard<std::mutex> guard(background_read_deadlines_locker);
+    return background_read_deadlines.next_deadline(deadline_ms);
+}
+
 bool end_station_imp::desc_index_from_frame(uint16_t desc_type, void * frame, ssize_t read_desc_offset, uint16_t & desc_index)
 {
     switch (desc_type)
@@ -591,9 +828,9 @@ void end_station_imp::background_read_deduce_next(entity_descriptor * ed, uint16
         return;
     }
     
-    avdecc_lib::entity_descriptor_response * entity_desc_resp = ed->get_entity_response();
-    config_count = entity_desc_resp->configurations_count();
-    delete entity_desc_resp;
+    entity_descriptor_view entity_view;
+    ed->get_entity_view(entity_view);
+    config_count = entity_view.configurations_count();
     
     if (ed->config_desc_count() >= 1)
     {
@@ -797,10 +1034,46 @@ int end_station_imp::proc_entity_avail_resp(void *& notification_id, const uint8
     return 0;
 }
 
-int end_station_imp::proc_rcvd_aem_resp(void *& notification_id,
-                                        const uint8_t * frame,
-                                        size_t frame_len,
-                                        int & status,
+bool end_station_imp::lookup_resp_desc(uint16_t desc_type, uint16_t desc_index, descriptor_base_imp *& desc, void *& typed_desc)
+{
+    // A response can arrive before the ENTITY descriptor has been read, or while the End Station is re-enumerated
+    if (current_entity_desc >= entity_desc_vec.size())
+        return false;
+
+    entity_descriptor_imp * entity_desc_imp_ref = entity_desc_vec[current_entity_desc];
+    configuration_descriptor_imp * config_desc_imp_ref =
+        static_cast<configuration_descriptor_imp *>(entity_desc_imp_ref->get_config_desc_by_index(current_config_desc));
+
+    if (desc_type != JDKSAVDECC_DESCRIPTOR_ENTITY && !config_desc_imp_ref)
+        return false;
+
+    if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
+    {
+        desc = entity_desc_imp_ref;
+        typed_desc = static_cast<entity_descriptor *>(entity_desc_imp_ref);
+    }
+    else if (desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION)
+    {
+        desc = config_desc_imp_ref;
+        typed_desc = static_cast<configuration_descriptor *>(config_desc_imp_ref);
+    }
+    else
+    {
+        const configuration_descriptor_imp::desc_slot * slot = config_desc_imp_ref->lookup_slot(desc_type, desc_index);
+        if (!slot)
+            return false;
+
+        desc = slot->desc;
+        typed_desc = slot->typed_desc;
+    }
+
+    return true;
+}
+
+int end_station_imp::proc_rcvd_aem_resp(void *& notification_id,
+                                        const uint8_t * frame,
+                                        size_t frame_len,
+                                        int & status,
                                         uint16_t & operation_id,
                                         bool & is_operation_id_valid)
 {
@@ -831,116 +1104,6 @@ int end_station_imp::proc_rcvd_aem_resp(void *& notification_id,
 
     switch (cmd_type)
     {
-    case JDKSAVDECC_AEM_COMMAND_ACQUIRE_ENTITY:
-    {
-        desc_type = jdksavdecc_aem_command_acquire_entity_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_acquire_entity_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
-        {
-            entity_descriptor_imp * entity_desc_imp_ref =
-                dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
-
-            if (entity_desc_imp_ref)
-            {
-                entity_desc_imp_ref->proc_acquire_entity_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_acquire_entity_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_acquire_entity_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
-            }
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor type %d is not implemented.", desc_type);
-        }
-    }
-
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_LOCK_ENTITY:
-    {
-        desc_type = jdksavdecc_aem_command_lock_entity_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_lock_entity_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
-        {
-            entity_descriptor_imp * entity_desc_imp_ref =
-                dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
-
-            if (entity_desc_imp_ref)
-            {
-                entity_desc_imp_ref->proc_lock_entity_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_lock_entity_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_lock_entity_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
-            }
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor type %d is not implemented.", desc_type);
-        }
-    }
-
-    break;
-
     case JDKSAVDECC_AEM_COMMAND_ENTITY_AVAILABLE:
         proc_entity_avail_resp(notification_id, frame, frame_len, status);
         break;
@@ -957,681 +1120,41 @@ int end_station_imp::proc_rcvd_aem_resp(void *& notification_id,
         proc_deregister_unsolicited_resp(notification_id, frame, frame_len, status);
         break;
 
-    case JDKSAVDECC_AEM_COMMAND_SET_STREAM_FORMAT:
-    {
-        desc_type = jdksavdecc_aem_command_set_stream_format_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_stream_format_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_set_stream_format_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_set_stream_format_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
-            }
-        }
-    }
-
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_STREAM_FORMAT:
-    {
-        desc_type = jdksavdecc_aem_command_get_stream_format_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_stream_format_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_get_stream_format_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_get_stream_format_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
-            }
-        }
-    }
-
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_STREAM_INFO:
-        desc_type = jdksavdecc_aem_command_set_stream_info_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_stream_info_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_set_stream_info_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_set_stream_info_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_output_descriptor_imp to derived stream_output_descriptor_imp error");
-            }
-        }
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_STREAM_INFO:
-        desc_type = jdksavdecc_aem_command_get_stream_info_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_stream_info_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_get_stream_info_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_get_stream_info_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_output_descriptor_imp to base stream_output_descriptor error");
-            }
-        }
-
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_AUDIO_MAP:
-        desc_type = jdksavdecc_aem_command_get_audio_map_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_audio_map_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT)
-        {
-            stream_port_input_descriptor_imp * stream_port_input_desc_imp_ref =
-                dynamic_cast<stream_port_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_port_input_desc_by_index(desc_index));
-
-            if (stream_port_input_desc_imp_ref)
-            {
-                stream_port_input_desc_imp_ref->proc_get_audio_map_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_port_input_descriptor_imp to base stream_port_input_descriptor error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT)
-        {
-            stream_port_output_descriptor_imp * stream_port_output_desc_imp_ref =
-                dynamic_cast<stream_port_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_port_output_desc_by_index(desc_index));
-
-            if (stream_port_output_desc_imp_ref)
-            {
-                stream_port_output_desc_imp_ref->proc_get_audio_map_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_port_output_descriptor_imp to base stream_port_output_descriptor error");
-            }
-        }
-
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_ADD_AUDIO_MAPPINGS:
-        desc_type = jdksavdecc_aem_command_add_audio_mappings_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_add_audio_mappings_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT)
-        {
-            stream_port_input_descriptor_imp * stream_port_input_desc_imp_ref =
-                dynamic_cast<stream_port_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_port_input_desc_by_index(desc_index));
-
-            if (stream_port_input_desc_imp_ref)
-            {
-                stream_port_input_desc_imp_ref->proc_add_audio_mappings_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_port_input_descriptor_imp to base stream_port_input_descriptor error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT)
-        {
-            stream_port_output_descriptor_imp * stream_port_output_desc_imp_ref =
-                dynamic_cast<stream_port_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_port_output_desc_by_index(desc_index));
-
-            if (stream_port_output_desc_imp_ref)
-            {
-                stream_port_output_desc_imp_ref->proc_add_audio_mappings_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_port_input_descriptor_imp to base stream_port_input_descriptor error");
-            }
-        }
-
-        break;
-
-    case JDKSAVDECC_AEM_COMMAND_REMOVE_AUDIO_MAPPINGS:
-        desc_type = jdksavdecc_aem_command_remove_audio_mappings_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_remove_audio_mappings_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_PORT_INPUT)
-        {
-            stream_port_input_descriptor_imp * stream_port_input_desc_imp_ref =
-                dynamic_cast<stream_port_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_port_input_desc_by_index(desc_index));
-
-            if (stream_port_input_desc_imp_ref)
-            {
-                stream_port_input_desc_imp_ref->proc_remove_audio_mappings_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_port_input_descriptor_imp to base stream_port_input_descriptor error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_PORT_OUTPUT)
-        {
-            stream_port_output_descriptor_imp * stream_port_output_desc_imp_ref =
-                dynamic_cast<stream_port_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_port_output_desc_by_index(desc_index));
-
-            if (stream_port_output_desc_imp_ref)
-            {
-                stream_port_output_desc_imp_ref->proc_remove_audio_mappings_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_port_input_descriptor_imp to base stream_port_input_descriptor error");
-            }
-        }
-
+    case JDKSAVDECC_AEM_COMMAND_SET_CONTROL:
+        proc_set_control_resp(notification_id, frame, frame_len, status);
         break;
 
-    case JDKSAVDECC_AEM_COMMAND_SET_NAME:
-    {
-        desc_type = jdksavdecc_aem_command_set_name_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_name_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        descriptor_base_imp * desc_base_imp_ref = NULL;
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
-        {
-            desc_base_imp_ref = entity_desc_vec.at(current_entity_desc);
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION)
-        {
-            desc_base_imp_ref = dynamic_cast<configuration_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc));
-        }
-        else
-        {
-            configuration_descriptor_imp * cfg_desc_imp = dynamic_cast<configuration_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc));
-            assert(cfg_desc_imp != NULL);
-            desc_base_imp_ref = cfg_desc_imp->lookup_desc_imp(desc_type, desc_index);
-        }
-        if (desc_base_imp_ref)
-        {
-            desc_base_imp_ref->proc_set_name_resp(notification_id, frame, frame_len, status);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Cannot lookup entity descriptor");
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_NAME:
-    {
-        desc_type = jdksavdecc_aem_command_get_name_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_name_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-        descriptor_base_imp * desc_base_imp_ref = NULL;
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
-        {
-            desc_base_imp_ref = entity_desc_vec.at(current_entity_desc);
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_CONFIGURATION)
-        {
-            desc_base_imp_ref = dynamic_cast<configuration_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc));
-        }
-        else
-        {
-            configuration_descriptor_imp * cfg_desc_imp = dynamic_cast<configuration_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc));
-            assert(cfg_desc_imp != NULL);
-            desc_base_imp_ref = cfg_desc_imp->lookup_desc_imp(desc_type, desc_index);
-        }
-        if (desc_base_imp_ref)
-        {
-            desc_base_imp_ref->proc_get_name_resp(notification_id, frame, frame_len, status);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Cannot lookup entity descriptor");
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_SAMPLING_RATE:
-    {
-        desc_type = jdksavdecc_aem_command_set_sampling_rate_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_sampling_rate_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT)
-        {
-            audio_unit_descriptor_imp * audio_unit_desc_imp_ref =
-                dynamic_cast<audio_unit_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_audio_unit_desc_by_index(desc_index));
-
-            if (audio_unit_desc_imp_ref)
-            {
-                audio_unit_desc_imp_ref->proc_set_sampling_rate_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base audio_unit_descriptor to derived audio_unit_descriptor_imp error");
-            }
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_SAMPLING_RATE:
-    {
-        desc_type = jdksavdecc_aem_command_get_sampling_rate_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_sampling_rate_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_AUDIO_UNIT)
-        {
-            audio_unit_descriptor_imp * audio_unit_desc_imp_ref =
-                dynamic_cast<audio_unit_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_audio_unit_desc_by_index(desc_index));
-
-            if (audio_unit_desc_imp_ref)
-            {
-                audio_unit_desc_imp_ref->proc_get_sampling_rate_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base audio_unit_descriptor to derived audio_unit_descriptor_imp error");
-            }
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_COUNTERS:
+    default:
     {
-        desc_type = jdksavdecc_aem_command_get_counters_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_counters_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
+        // Responses addressed to a descriptor are dispatched by command type and descriptor type
+        if (!aem_resp_dispatch_ref->has_handlers(cmd_type) ||
+            !aem_resp_dispatch_ref->get_desc(cmd_type, frame, desc_type, desc_index))
         {
-            entity_descriptor_imp * entity_desc_imp_ref = dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
-            
-            if (entity_desc_imp_ref)
-            {
-                entity_desc_imp_ref->proc_get_counters_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_AVB_INTERFACE)
-        {
-            avb_interface_descriptor_imp * avb_interface_desc_ref =
-                dynamic_cast<avb_interface_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_avb_interface_desc_by_index(desc_index));
-
-            if (avb_interface_desc_ref)
-            {
-                avb_interface_desc_ref->proc_get_counters_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base avb_interface_descriptor to derived avb_interface_descriptor_imp error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_CLOCK_DOMAIN)
-        {
-            clock_domain_descriptor_imp * clock_domain_desc_imp_ref =
-                dynamic_cast<clock_domain_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_clock_domain_desc_by_index(desc_index));
-
-            if (clock_domain_desc_imp_ref)
-            {
-                clock_domain_desc_imp_ref->proc_get_counters_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base clock_domain_descriptor to derived clock_domain_descriptor_imp error");
-            }
+            notification_imp_ref->post_notification_msg(NO_MATCH_FOUND, 0, cmd_type, 0, 0, 0, 0);
+            break;
         }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
 
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_get_counters_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base stream_input_descriptor to derived stream_input_descriptor_imp error");
-            }
-        }
-        else
+        aem_resp_handler handler = aem_resp_dispatch_ref->handler(cmd_type, desc_type);
+        if (!handler)
         {
             log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor type %d is not implemented.", desc_type);
+            break;
         }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_CLOCK_SOURCE:
-    {
-        //desc_type = jdksavdecc_aem_command_set_clock_source_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_set_clock_source_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        clock_domain_descriptor_imp * clock_domain_desc_imp_ref =
-            dynamic_cast<clock_domain_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_clock_domain_desc_by_index(desc_index));
-
-        if (clock_domain_desc_imp_ref)
-        {
-            clock_domain_desc_imp_ref->proc_set_clock_source_resp(notification_id, frame, frame_len, status);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base clock_domain_descriptor to derived clock_domain_descriptor_imp error");
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_CLOCK_SOURCE:
-    {
-        //desc_type = jdksavdecc_aem_command_get_clock_source_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_clock_source_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        clock_domain_descriptor_imp * clock_domain_desc_imp_ref =
-            dynamic_cast<clock_domain_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_clock_domain_desc_by_index(desc_index));
-
-        if (clock_domain_desc_imp_ref)
-        {
-            clock_domain_desc_imp_ref->proc_get_clock_source_resp(notification_id, frame, frame_len, status);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base clock_domain_descriptor to derived clock_domain_descriptor_imp error");
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_AVB_INFO:
-    {
-        //desc_type = jdksavdecc_aem_command_get_avb_info_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_get_avb_info_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        avb_interface_descriptor_imp * avb_interface_desc_imp_ref =
-            dynamic_cast<avb_interface_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_avb_interface_desc_by_index(desc_index));
-
-        if (avb_interface_desc_imp_ref)
-        {
-            avb_interface_desc_imp_ref->proc_get_avb_info_resp(notification_id, frame, frame_len, status);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base avb_interface_descriptor to derived avb_interface_descriptor_imp error");
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_START_STREAMING:
-    {
-        desc_type = jdksavdecc_aem_command_start_streaming_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_start_streaming_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_start_streaming_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_start_streaming_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_output_descriptor_imp to base stream_output_descriptor error");
-            }
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_STOP_STREAMING:
-    {
-        desc_type = jdksavdecc_aem_command_stop_streaming_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_stop_streaming_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_INPUT)
-        {
-            stream_input_descriptor_imp * stream_input_desc_imp_ref =
-                dynamic_cast<stream_input_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_input_desc_by_index(desc_index));
-
-            if (stream_input_desc_imp_ref)
-            {
-                stream_input_desc_imp_ref->proc_stop_streaming_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_input_descriptor_imp to base stream_input_descriptor error");
-            }
-        }
-        else if (desc_type == JDKSAVDECC_DESCRIPTOR_STREAM_OUTPUT)
-        {
-            stream_output_descriptor_imp * stream_output_desc_imp_ref =
-                dynamic_cast<stream_output_descriptor_imp *>(entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_stream_output_desc_by_index(desc_index));
-
-            if (stream_output_desc_imp_ref)
-            {
-                stream_output_desc_imp_ref->proc_stop_streaming_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived stream_output_descriptor_imp to base stream_output_descriptor error");
-            }
-        }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_GET_CONFIGURATION:
-    {
-        entity_descriptor_imp * entity_desc_imp_ref =
-            dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
-        
-        if (entity_desc_imp_ref)
-        {
-            entity_desc_imp_ref->proc_get_config_resp(notification_id, frame, frame_len, status);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
-        }
-    }
-    break;
-            
-    case JDKSAVDECC_AEM_COMMAND_SET_CONFIGURATION:
-    {
-        entity_descriptor_imp * entity_desc_imp_ref =
-            dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
-        
-        if (entity_desc_imp_ref)
-        {
-            entity_desc_imp_ref->proc_set_config_resp(notification_id, frame, frame_len, status);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
-        }
-    }
-    break;
-            
-    case JDKSAVDECC_AEM_COMMAND_REBOOT:
-    {
-        desc_type = jdksavdecc_aem_command_reboot_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        //desc_index = jdksavdecc_aem_command_reboot_get_descriptor_index(frame, ETHER_HDR_SIZE);
 
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_ENTITY)
+        descriptor_base_imp * desc_base_imp_ref;
+        void * typed_desc;
+        if (!lookup_resp_desc(desc_type, desc_index, desc_base_imp_ref, typed_desc))
         {
-            entity_descriptor_imp * entity_desc_imp_ref =
-                dynamic_cast<entity_descriptor_imp *>(entity_desc_vec.at(current_entity_desc));
-
-            if (entity_desc_imp_ref)
-            {
-                entity_desc_imp_ref->proc_reboot_resp(notification_id, frame, frame_len, status);
-            }
-            else
-            {
-                log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base entity_descriptor to derived entity_descriptor_imp error");
-            }
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Descriptor type %d is not valid.", desc_type);
-        }
-    }
-
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_START_OPERATION:
-    {
-        desc_type = jdksavdecc_aem_command_start_operation_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_start_operation_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
-
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT)
-        {
-            memory_object_descriptor * mo = entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_memory_object_desc_by_index(desc_index);
-
-            if (mo)
-            {
-                memory_object_descriptor_imp * memory_object_desc_imp_ref =
-                    dynamic_cast<memory_object_descriptor_imp *>(mo);
-
-                if (memory_object_desc_imp_ref)
-                {
-                    uint16_t operation_type;
-                    memory_object_desc_imp_ref->proc_start_operation_resp(notification_id, frame, frame_len, status, operation_id, operation_type);
-                    if (status == AEM_STATUS_SUCCESS && operation_id)
-                    {
-                        aecp_controller_state_machine_ref->start_operation(notification_id, operation_id, operation_type, frame, frame_len);
-                        is_operation_id_valid = true;
-                    }
-                }
-                else
-                {
-                    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived memory_object_descriptor_imp to base memory_object_descriptor error");
-                }
-            }
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Cannot lookup %s descriptor %d for %s response",
+                                      utility::aem_desc_value_to_name(desc_type),
+                                      desc_index,
+                                      utility::aem_cmd_value_to_name(cmd_type));
+            break;
         }
-    }
-    break;
-
-    case JDKSAVDECC_AEM_COMMAND_OPERATION_STATUS:
-    {
-        desc_type = jdksavdecc_aem_command_operation_status_response_get_descriptor_type(frame, ETHER_HDR_SIZE);
-        desc_index = jdksavdecc_aem_command_operation_status_response_get_descriptor_index(frame, ETHER_HDR_SIZE);
 
-        if (desc_type == JDKSAVDECC_DESCRIPTOR_MEMORY_OBJECT)
-        {
-            memory_object_descriptor * mo = entity_desc_vec.at(current_entity_desc)->get_config_desc_by_index(current_config_desc)->get_memory_object_desc_by_index(desc_index);
-
-            if (mo)
-            {
-                memory_object_descriptor_imp * memory_object_desc_imp_ref =
-                    dynamic_cast<memory_object_descriptor_imp *>(mo);
-
-                if (memory_object_desc_imp_ref)
-                {
-                    memory_object_desc_imp_ref->proc_operation_status_resp(notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
-                }
-                else
-                {
-                    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from derived memory_object_descriptor_imp to base memory_object_descriptor error");
-                }
-            }
-        }
+        handler(desc_base_imp_ref, typed_desc, notification_id, frame, frame_len, status, operation_id, is_operation_id_valid);
     }
     break;
-
-    case JDKSAVDECC_AEM_COMMAND_SET_CONTROL:
-        proc_set_control_resp(notification_id, frame, frame_len, status);
-        break;
-
-    default:
-        notification_imp_ref->post_notification_msg(NO_MATCH_FOUND, 0, cmd_type, 0, 0, 0, 0);
-        break;
     }
 
     return 0;
@@ -2060,4 +1583,77 @@ uint16_t STDCALL end_station_imp::get_current_config_index() const
 {
     return current_config_desc;
 }
+
+void STDCALL end_station_imp::set_aecp_window(uint32_t window)
+{
+    aecp_controller_state_machine_ref->set_window(end_station_entity_id, window);
+}
+
+uint32_t STDCALL end_station_imp::get_aecp_window()
+{
+    return aecp_controller_state_machine_ref->get_window(end_station_entity_id);
+}
+
+uint32_t STDCALL end_station_imp::get_aecp_window_occupancy()
+{
+    return aecp_controller_state_machine_ref->get_window_occupancy(end_station_entity_id);
+}
+
+uint32_t STDCALL end_station_imp::get_aecp_queue_depth()
+{
+    return aecp_controller_state_machine_ref->get_queue_depth(end_station_entity_id);
+}
+
+uint32_t STDCALL end_station_imp::get_aecp_avg_queue_wait_ms()
+{
+    uint32_t avg_ms;
+    uint32_t max_ms;
+
+    aecp_controller_state_machine_ref->get_queue_wait_ms(end_station_entity_id, avg_ms, max_ms);
+    return avg_ms;
+}
+
+uint32_t STDCALL end_station_imp::get_aecp_max_queue_wait_ms()
+{
+    uint32_t avg_ms;
+    uint32_t max_ms;
+
+    aecp_controller_state_machine_ref->get_queue_wait_ms(end_station_entity_id, avg_ms, max_ms);
+    return max_ms;
+}
+
+uint32_t STDCALL end_station_imp::get_aecp_rto_ms()
+{
+    return aecp_controller_state_machine_ref->get_rto_ms(end_station_entity_id);
+}
+
+void STDCALL end_station_imp::set_background_read_window(uint32_t window)
+{
+    std::lock_guard<std::mutex> guard(state_locker);
+    m_background_read_window = window;
+}
+
+uint32_t STDCALL end_station_imp::get_enumeration_time_ms()
+{
+    std::lock_guard<std::mutex> guard(state_locker);
+    return m_enumeration_time_ms;
+}
+
+void STDCALL end_station_imp::set_enumeration_priority(bool high)
+{
+    std::lock_guard<std::mutex> guard(state_locker);
+    m_enumeration_priority = high;
+}
+
+uint32_t STDCALL end_station_imp::get_background_reads_completed()
+{
+    std::lock_guard<std::mutex> guard(state_locker);
+    return m_background_reads_completed;
+}
+
+uint32_t STDCALL end_station_imp::get_background_reads_pending()
+{
+    std::lock_guard<std::mutex> guard(state_locker);
+    return (uint32_t)(m_backbround_read_pending.size() + m_backbround_read_inflight.size());
+}
 }
@@ -30,10 +30,13 @@
 #pragma once
 #include <mutex>
 #include <list>
+#include <map>
+#include <vector>
 
 #include "entity_descriptor_imp.h"
 #include "end_station.h"
 #include "timer.h"
+#include "deadline_queue.h"
 
 namespace avdecc_lib
 {
@@ -46,7 +49,7 @@ public:
     uint16_t m_type;
     uint16_t m_index;
     uint16_t m_config;
-    timer m_timer;
+    uint64_t m_deadline_ms; ///< timer::clk_monotonic_ms() time at which the inflight read times out
 };
 
 class end_station_imp : public virtual end_station
@@ -61,7 +64,23 @@ private:
     std::list<background_read_request *> m_backbround_read_pending;  // Store a list of background reads
     std::list<background_read_request *> m_backbround_read_inflight; // Store a list of background reads that are inflight
 
+    static deadline_queue<end_station_imp *> background_read_deadlines; // Earliest inflight background read timeout of every End Station
+    static std::mutex background_read_deadlines_locker;                 // Protects background_read_deadlines
+
+    uint32_t m_background_read_window; // Maximum number of background reads inflight, 0 to use the AECP window
+    uint64_t m_enumeration_start_ms;   // timer::clk_monotonic_ms() time at which the End Station enumeration started
+    uint32_t m_enumeration_time_ms;    // Time taken to read every descriptor, 0 until END_STATION_READ_COMPLETED
+    uint32_t m_background_reads_completed; // Number of background reads answered since the enumeration started
+    bool m_enumeration_priority;           // Served by the enumeration scheduler before other End Stations
+    bool m_enumeration_queued;             // Waiting in an enumeration scheduler queue
+    bool m_desc_cache_hit;                 // Populated from the descriptor cache, only the descriptors with a name or a current value are read
+    uint32_t m_background_read_timeouts;   // Number of background reads that timed out since the enumeration started
+    std::map<uint64_t, std::vector<uint8_t>> m_desc_cache_frames; // Responses stored since the enumeration started, by descriptor type, configuration and index
+
+    friend class enumeration_scheduler;
+
     adp * adp_ref;                                        // ADP associated with the End Station
+    descriptor_arena m_desc_arena;                        // Storage of the descriptors and their stored command responses
     std::vector<entity_descriptor_imp *> entity_desc_vec; // Store a list of ENTITY descriptor objects
 
     void queue_background_read_request(uint16_t desc_type, uint16_t desc_base_index, uint16_t count, uint16_t config_desc_index);               ///< Generate "count" read requests
@@ -69,12 +88,38 @@ private:
     void background_read_update_inflight(uint16_t desc_type, void * frame, ssize_t read_desc_offset);               ///< Remove rx'd frame from background read inflight list
 
     bool desc_index_from_frame(uint16_t desc_type, void * frame, ssize_t read_desc_offset, uint16_t & desc_index);
+    void background_read_reschedule(); ///< Register the earliest inflight background read timeout
+    bool background_read_ready();      ///< Check for a pending background read that fits in the window
+    bool background_read_submit_one(); ///< Send the next pending background read if it fits in the window
+
+    bool store_desc(uint16_t desc_type, uint16_t config_index, const uint8_t * frame, size_t frame_len); ///< Store a READ_DESCRIPTOR response in the descriptor tree
+    bool desc_cache_replay();  ///< Populate the descriptor tree from the descriptor cache of the entity model
+    void desc_cache_refresh(); ///< Validate the re-read ENTITY descriptor against the cache and queue reads of the descriptors with a name or a current value
+    void desc_cache_save();    ///< Save the responses of a complete enumeration to the descriptor cache
+    static bool desc_cache_is_current(uint16_t desc_type); ///< True for the types without a name or a current value, which are taken from the cache as they are
+
+    ///
+    /// Find the descriptor of the current configuration an AEM response is addressed to.
+    /// typed_desc is set to the descriptor converted to the public descriptor class of desc_type.
+    ///
+    /// \return False if there is no such descriptor.
+    ///
+    bool lookup_resp_desc(uint16_t desc_type, uint16_t desc_index, descriptor_base_imp *& desc, void *& typed_desc);
 
 public:
     end_station_imp(const uint8_t * frame, size_t frame_len);
     virtual ~end_station_imp();
 
     std::mutex locker;
+
+    ///
+    /// Serializes the processing of the received frames of the End Station with its background read
+    /// timeouts, the background reads sent for it by the enumeration scheduler and its connection status.
+    /// Frames of different End Stations are processed in parallel by the RX workers. It is taken before
+    /// the locks of the state machines, the enumeration scheduler and the network interface.
+    ///
+    std::mutex state_locker;
+
     const char STDCALL get_connection_status() const;
 
     ///
@@ -96,6 +141,15 @@ public:
     uint64_t STDCALL mac();
     uint64_t STDCALL get_gptp_grandmaster_id();
     adp * get_adp();
+
+    ///
+    /// \return The arena the descriptors of the End Station are allocated from.
+    ///
+    inline descriptor_arena & desc_arena()
+    {
+        return m_desc_arena;
+    }
+
     size_t STDCALL entity_desc_count();
     entity_descriptor * STDCALL get_entity_desc_by_index(size_t entity_desc_index);
     int STDCALL send_read_desc_cmd(void * notification_id, uint16_t desc_type, uint16_t desc_index);
@@ -112,8 +166,19 @@ public:
     int STDCALL send_identify(void * notification_id, bool turn_on);
     int proc_set_control_resp(void *& notification_id, const uint8_t * frame, size_t frame_len, int & status);
 
-    void background_read_update_timeouts(void); ///< update timeout conditions
-    void background_read_submit_pending(void);  ///< Submit pending background reads
+    void background_read_update_timeouts(uint64_t now_ms); ///< update timeout conditions
+    void background_read_submit_pending(void);             ///< Submit pending background reads
+
+    ///
+    /// Time out the inflight background reads of every End Station whose deadline has passed.
+    /// Takes the lock of each End Station, so the caller must not hold the lock of any End Station.
+    ///
+    static void background_read_tick(uint64_t now_ms);
+
+    ///
+    /// \return False if no background read is inflight, otherwise the earliest timeout is stored in deadline_ms.
+    ///
+    static bool background_read_next_deadline(uint64_t & deadline_ms);
 
     ///
     /// Process response received for the corresponding AECP Address Access command.
@@ -133,6 +198,19 @@ public:
     int STDCALL send_deregister_unsolicited_cmd(void * notification_id);
     int proc_deregister_unsolicited_resp(void *& notification_id, const uint8_t * frame, size_t frame_len, int & status);
 
+    void STDCALL set_aecp_window(uint32_t window);
+    uint32_t STDCALL get_aecp_window();
+    uint32_t STDCALL get_aecp_window_occupancy();
+    uint32_t STDCALL get_aecp_queue_depth();
+    uint32_t STDCALL get_aecp_avg_queue_wait_ms();
+    uint32_t STDCALL get_aecp_max_queue_wait_ms();
+    uint32_t STDCALL get_aecp_rto_ms();
+    void STDCALL set_background_read_window(uint32_t window);
+    uint32_t STDCALL get_enumeration_time_ms();
+    void STDCALL set_enumeration_priority(bool high);
+    uint32_t STDCALL get_background_reads_completed();
+    uint32_t STDCALL get_background_reads_pending();
+
 private:
     ///
     /// Initialize End Station with Entity and Configuration descriptors information.
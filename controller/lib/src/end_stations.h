@@ -0,0 +1,116 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * end_stations.h
+ *
+ * End Station list, indexed by entity id and MAC address
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+#include <unordered_map>
+#include "snapshot_array.h"
+
+namespace avdecc_lib
+{
+/*
+* The end_stations class is added here so that in the rare case that an endpoint is added by the background discovery
+* thread, causing the vector of end_stations to be re-allocated, a foreground process can still obtain a handle
+* to an end-station and send commands. Note that end_stations are never deleted by this library, even if they go
+* off-line, so end_station classes and their pointers will remain valid.
+*
+* As End Stations are never deleted and their entity id and MAC address do not change, the position of every
+* End Station is indexed by both when it is added, so the receive path finds an End Station with one lookup.
+*
+* The End Stations are held in a snapshot_array so that size() and at() never lock: applications polling
+* the list do not contend with the discovery thread adding End Stations. Only the indexes take the mutex.
+*/
+template <class T>
+class end_station_list
+{
+private:
+    std::mutex locker;                                      // Serializes push_back() and protects the indexes
+    snapshot_array<T *> end_station_vec;                    // Store a list of End Station objects
+    std::unordered_map<uint64_t, uint32_t> entity_id_index; // Position of the End Station with each entity id
+    std::unordered_map<uint64_t, uint32_t> mac_index;       // Position of the first End Station with each MAC address
+
+public:
+    end_station_list() {};
+    ~end_station_list()
+    {
+        for (size_t i = 0; i < end_station_vec.size(); i++)
+            delete end_station_vec[i];
+    };
+    const size_t size(void)
+    {
+        return end_station_vec.size();
+    };
+    T * at(size_t i)
+    {
+        return end_station_vec.at(i);
+    };
+    void push_back(T * ep)
+    {
+        locker.lock();
+        uint32_t index = (uint32_t)end_station_vec.size();
+        entity_id_index.insert(std::make_pair(ep->entity_id(), index));
+        mac_index.insert(std::make_pair(ep->mac(), index));
+        end_station_vec.push_back(ep);
+        locker.unlock();
+    };
+
+    ///
+    /// \return The End Station with entity_id and its position in index, or NULL if there is none.
+    ///
+    T * find_by_entity_id(uint64_t entity_id, uint32_t & index)
+    {
+        std::lock_guard<std::mutex> guard(locker);
+        std::unordered_map<uint64_t, uint32_t>::const_iterator i = entity_id_index.find(entity_id);
+        if (i == entity_id_index.end())
+            return NULL;
+
+        index = i->second;
+        return end_station_vec[index];
+    };
+
+    ///
+    /// \return The first End Station added with mac_addr and its position in index, or NULL if there is none.
+    ///
+    T * find_by_mac(uint64_t mac_addr, uint32_t & index)
+    {
+        std::lock_guard<std::mutex> guard(locker);
+        std::unordered_map<uint64_t, uint32_t>::const_iterator i = mac_index.find(mac_addr);
+        if (i == mac_index.end())
+            return NULL;
+
+        index = i->second;
+        return end_station_vec[index];
+    };
+};
+
+class end_station_imp;
+typedef end_station_list<end_station_imp> end_stations;
+}
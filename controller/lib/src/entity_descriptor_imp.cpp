@@ -59,6 +59,13 @@ entity_descriptor_response * STDCALL entity_descriptor_imp::get_entity_response(
     return resp = new entity_descriptor_response_imp(resp_ref->get_desc_buffer(),
                                                      resp_ref->get_desc_size(), resp_ref->get_desc_pos());
 }
+
+bool STDCALL entity_descriptor_imp::get_entity_view(entity_descriptor_view & view)
+{
+    std::lock_guard<std::mutex> guard(base_end_station_imp_ref->locker); //mutex lock end station
+    view.assign(resp_ref->get_desc_buffer(), resp_ref->get_desc_size(), resp_ref->get_desc_pos());
+    return true;
+}
     
 entity_descriptor_get_config_response * STDCALL entity_descriptor_imp::get_entity_get_config_response()
 {
@@ -86,10 +93,12 @@ void entity_descriptor_imp::store_config_desc(end_station_imp * end_station_obj,
 {
     uint16_t config_desc_index = jdksavdecc_descriptor_configuration_get_descriptor_index(frame, pos);
     const auto it = config_desc_map.find(config_desc_index);
+
+    // A re-read CONFIGURATION keeps the descriptors it holds
     if (it != config_desc_map.end())
-        delete it->second;
-    
-    config_desc_map[config_desc_index] = new configuration_descriptor_imp(end_station_obj, frame, pos, frame_len);
+        it->second->replace_desc_frame(frame, pos, frame_len);
+    else
+        config_desc_map[config_desc_index] = new (end_station_obj->desc_arena()) configuration_descriptor_imp(end_station_obj, frame, pos, frame_len);
 }
 
 size_t STDCALL entity_descriptor_imp::config_desc_count()
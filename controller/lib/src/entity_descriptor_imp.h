@@ -59,6 +59,7 @@ public:
     size_t STDCALL config_desc_count();
     configuration_descriptor * STDCALL get_config_desc_by_index(uint16_t config_desc_index);
     entity_descriptor_response * STDCALL get_entity_response();
+    bool STDCALL get_entity_view(entity_descriptor_view & view);
     entity_counters_response * STDCALL get_entity_counters_response();
     entity_descriptor_get_config_response * STDCALL get_entity_get_config_response();
     uint32_t STDCALL acquire_entity_flags();
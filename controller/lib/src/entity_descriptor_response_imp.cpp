@@ -39,110 +39,102 @@
 
 namespace avdecc_lib
 {
-entity_descriptor_response_imp::entity_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos) : descriptor_response_base_imp(frame, frame_len, pos) {}
+entity_descriptor_response_imp::entity_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos) : descriptor_response_base_imp(frame, frame_len, pos)
+{
+    m_view.assign(frame, frame_len, pos);
+}
 
 entity_descriptor_response_imp::~entity_descriptor_response_imp() {}
 
 uint64_t STDCALL entity_descriptor_response_imp::entity_id()
 {
-    uint64_t entity_id;
-    return entity_id = jdksavdecc_uint64_get(&buffer[position +
-                                                     JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_ID],
-                                             0);
+    return m_view.entity_id();
 }
 
 uint64_t STDCALL entity_descriptor_response_imp::entity_model_id()
 {
-    jdksavdecc_eui64 eui = jdksavdecc_descriptor_entity_get_entity_model_id(buffer, position);
-    return jdksavdecc_eui64_convert_to_uint64(&eui);
+    return m_view.entity_model_id();
 }
 
 uint32_t STDCALL entity_descriptor_response_imp::entity_capabilities()
 {
-    return jdksavdecc_descriptor_entity_get_entity_capabilities(buffer, position);
+    return m_view.entity_capabilities();
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::talker_stream_sources()
 {
-    return jdksavdecc_descriptor_entity_get_talker_stream_sources(buffer, position);
+    return m_view.talker_stream_sources();
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::talker_capabilities()
 {
-    return jdksavdecc_descriptor_entity_get_talker_capabilities(buffer, position);
+    return m_view.talker_capabilities();
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::listener_stream_sinks()
 {
-    return jdksavdecc_descriptor_entity_get_listener_stream_sinks(buffer, position);
+    return m_view.listener_stream_sinks();
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::listener_capabilities()
 {
-    return jdksavdecc_descriptor_entity_get_listener_capabilities(buffer, position);
+    return m_view.listener_capabilities();
 }
 
 uint32_t STDCALL entity_descriptor_response_imp::controller_capabilities()
 {
-    return jdksavdecc_descriptor_entity_get_controller_capabilities(buffer, position);
+    return m_view.controller_capabilities();
 }
 
 uint32_t STDCALL entity_descriptor_response_imp::available_index()
 {
-    return jdksavdecc_descriptor_entity_get_available_index(buffer, position);
+    return m_view.available_index();
 }
 
 uint64_t STDCALL entity_descriptor_response_imp::association_id()
 {
-    uint64_t association_id;
-
-    utility::convert_eui48_to_uint64(&buffer[position +
-                                             JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ASSOCIATION_ID],
-                                     association_id);
-    return association_id;
+    return m_view.association_id();
 }
 
 uint8_t * STDCALL entity_descriptor_response_imp::entity_name()
 {
-    return (uint8_t *)&buffer[position + JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_NAME];
+    return (uint8_t *)m_view.entity_name();
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::vendor_name_string()
 {
-    return jdksavdecc_descriptor_entity_get_vendor_name_string(buffer, position);
+    return m_view.vendor_name_string();
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::model_name_string()
 {
-    return jdksavdecc_descriptor_entity_get_model_name_string(buffer, position);
+    return m_view.model_name_string();
 }
 
 uint8_t * STDCALL entity_descriptor_response_imp::firmware_version()
 {
-    return (uint8_t *)&buffer[position + JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_FIRMWARE_VERSION];
+    return (uint8_t *)m_view.firmware_version();
 }
 
 uint8_t * STDCALL entity_descriptor_response_imp::group_name()
 {
-    return (uint8_t *)&buffer[position + JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_GROUP_NAME];
+    return (uint8_t *)m_view.group_name();
 }
 
 uint8_t * STDCALL entity_descriptor_response_imp::serial_number()
 {
-    return (uint8_t *)&buffer[position + JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_SERIAL_NUMBER];
+    return (uint8_t *)m_view.serial_number();
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::configurations_count()
 {
-    uint16_t configurations_count;
-
-    configurations_count = jdksavdecc_descriptor_entity_get_configurations_count(buffer, position);
+    uint16_t configurations_count = m_view.configurations_count();
     assert(configurations_count >= 1);
     return configurations_count;
 }
 
 uint16_t STDCALL entity_descriptor_response_imp::current_configuration()
 {
-    return jdksavdecc_descriptor_entity_get_current_configuration(buffer, position);
+    return m_view.current_configuration();
 }
 }
@@ -33,11 +33,15 @@
 #include "entity_descriptor_response.h"
 #include "jdksavdecc_aem_descriptor.h"
 #include "descriptor_response_base_imp.h"
+#include "response_views.h"
 
 namespace avdecc_lib
 {
 class entity_descriptor_response_imp : public entity_descriptor_response, public virtual descriptor_response_base_imp
 {
+private:
+    entity_descriptor_view m_view;
+
 public:
     entity_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos);
     virtual ~entity_descriptor_response_imp();
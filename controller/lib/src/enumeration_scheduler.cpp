@@ -0,0 +1,113 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * enumeration_scheduler.cpp
+ *
+ * Controller wide scheduler of End Station background reads implementation
+ */
+
+#include "enumeration.h"
+#include "end_station_imp.h"
+#include "enumeration_scheduler.h"
+
+namespace avdecc_lib
+{
+enumeration_scheduler * enumeration_scheduler_ref = new enumeration_scheduler(); // To have one enumeration scheduler for all end stations
+
+enumeration_scheduler::enumeration_scheduler() : max_inflight(ENUMERATION_DEFAULT_MAX_INFLIGHT), inflight(0), queued_count(0) {}
+
+enumeration_scheduler::~enumeration_scheduler() {}
+
+void enumeration_scheduler::enqueue(end_station_imp * end_station)
+{
+    if (!end_station->m_enumeration_queued)
+    {
+        end_station->m_enumeration_queued = true;
+        if (end_station->m_enumeration_priority)
+            priority_queue.push_back(end_station);
+        else
+            normal_queue.push_back(end_station);
+        queued_count++;
+    }
+}
+
+void enumeration_scheduler::request(end_station_imp * end_station)
+{
+    std::lock_guard<std::mutex> guard(locker);
+    enqueue(end_station);
+}
+
+void enumeration_scheduler::release()
+{
+    uint32_t n = inflight.load();
+    while (n > 0 && !inflight.compare_exchange_weak(n, n - 1))
+    {
+    }
+}
+
+void enumeration_scheduler::set_max_inflight(uint32_t max)
+{
+    max_inflight = max ? max : 1;
+}
+
+void enumeration_scheduler::dispatch()
+{
+    // Every thread that queues an End Station or releases a read calls this afterwards, so a
+    // thread that finds nothing to do here leaves nothing behind
+    while (queued_count.load() > 0 && inflight.load() < max_inflight.load())
+    {
+        end_station_imp * end_station;
+
+        {
+            std::lock_guard<std::mutex> guard(locker);
+            if (inflight.load() >= max_inflight.load())
+                break;
+
+            std::deque<end_station_imp *> & q = priority_queue.empty() ? normal_queue : priority_queue;
+            if (q.empty())
+                break;
+
+            end_station = q.front();
+            q.pop_front();
+            end_station->m_enumeration_queued = false;
+            queued_count--;
+            inflight++; // The read is counted before it is sent, so that other threads keep to the cap
+        }
+
+        std::lock_guard<std::mutex> station_guard(end_station->state_locker);
+        if (end_station->background_read_submit_one())
+        {
+            if (end_station->background_read_ready())
+            {
+                std::lock_guard<std::mutex> guard(locker);
+                enqueue(end_station); // Back of the queue until every other End Station has had its turn
+            }
+        }
+        else
+        {
+            release();
+        }
+    }
+}
+}
@@ -0,0 +1,113 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * enumeration_scheduler.h
+ *
+ * Controller wide scheduler of End Station background reads
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <deque>
+#include <mutex>
+#include <atomic>
+
+namespace avdecc_lib
+{
+class end_station_imp;
+
+///
+/// Caps the number of background READ_DESCRIPTOR commands inflight across every End Station, so
+/// that a large number of End Stations appearing together does not flood the network and devices.
+///
+/// End Stations with reads ready to send wait in one of two round-robin queues. Each grant lets
+/// one End Station send one read before it goes to the back of its queue, and End Stations the
+/// application has prioritized are served before all others.
+///
+/// End Stations request and release reads while they hold their own lock, so the reads are only
+/// sent by dispatch(), which is called once the End Station lock is released.
+///
+class enumeration_scheduler
+{
+private:
+    std::deque<end_station_imp *> priority_queue; // End Stations with reads ready, served first
+    std::deque<end_station_imp *> normal_queue;   // Other End Stations with reads ready
+    std::mutex locker;                            // Protects the queues and the queued flag of every End Station
+    std::atomic<uint32_t> max_inflight;
+    std::atomic<uint32_t> inflight;     // Background reads inflight across every End Station
+    std::atomic<uint32_t> queued_count; // End Stations waiting in either queue
+
+    ///
+    /// Add an End Station to the back of its queue, if it is not queued already. The caller holds locker.
+    ///
+    void enqueue(end_station_imp * end_station);
+
+public:
+    enumeration_scheduler();
+
+    ~enumeration_scheduler();
+
+    ///
+    /// Queue an End Station that has background reads ready to send, if it is not queued already.
+    ///
+    void request(end_station_imp * end_station);
+
+    ///
+    /// Account for a background read that has completed or timed out.
+    ///
+    void release();
+
+    ///
+    /// Let the queued End Stations send reads in turn until the cap is reached. Takes the lock of
+    /// each End Station served, so the caller must not hold the lock of any End Station.
+    ///
+    void dispatch();
+
+    ///
+    /// Set the maximum number of background reads inflight across every End Station.
+    ///
+    void set_max_inflight(uint32_t max);
+
+    inline uint32_t get_max_inflight() const
+    {
+        return max_inflight.load();
+    }
+
+    inline uint32_t get_inflight() const
+    {
+        return inflight.load();
+    }
+
+    ///
+    /// \return The number of End Stations waiting for their turn to send a background read.
+    ///
+    inline uint32_t get_queue_depth() const
+    {
+        return queued_count.load();
+    }
+};
+
+extern enumeration_scheduler * enumeration_scheduler_ref;
+}
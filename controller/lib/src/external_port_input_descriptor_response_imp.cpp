@@ -32,39 +32,16 @@
 #include "log_imp.h"
 #include "end_station_imp.h"
 #include "external_port_input_descriptor_response_imp.h"
-#include "descriptor_field_imp.h"
+#include "descriptor_field_layout.h"
 
 namespace avdecc_lib
 {
 external_port_input_descriptor_response_imp::external_port_input_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos) : descriptor_base_imp(nullptr, frame, frame_len, pos), descriptor_response_base_imp(frame, frame_len, pos)
 {
-    ssize_t ret = jdksavdecc_descriptor_external_port_read(&desc, frame, pos, frame_len);
-
-    if (ret < 0)
+    if (!descriptor_layout_fits(descriptor_layout_for(AEM_DESC_EXTERNAL_PORT_INPUT), frame_len, pos))
     {
-        throw avdecc_read_descriptor_error("jdksavdecc_descriptor_external_port_read error");
+        throw avdecc_read_descriptor_error("external_port_input_descriptor_response_imp frame too short");
     }
-
-    // fields
-    descriptor_field_imp * f;
-
-    m_fields.push_back(new descriptor_field_imp("clock_domain_index", descriptor_field::TYPE_UINT16, &desc.clock_domain_index));
-
-    f = new descriptor_field_imp("port_flags", descriptor_field::TYPE_FLAGS16, &desc.port_flags);
-    f->append_field(new descriptor_field_flags_imp("CLOCK_SYNC_SOURCE", 1 << 15));
-    f->append_field(new descriptor_field_flags_imp("ASYNC_SAMPLE_RATE_CONVERTER", 1 << 14));
-    f->append_field(new descriptor_field_flags_imp("SYNC_SAMPLE_RATE_CONVERTER", 1 << 13));
-    m_fields.push_back(f);
-
-    m_fields.push_back(new descriptor_field_imp("number_of_controls", descriptor_field::TYPE_UINT16, &desc.number_of_controls));
-    m_fields.push_back(new descriptor_field_imp("base_control", descriptor_field::TYPE_UINT16, &desc.base_control));
-
-    m_fields.push_back(new descriptor_field_imp("signal_type", descriptor_field::TYPE_UINT16, &desc.signal_type));
-    m_fields.push_back(new descriptor_field_imp("signal_index", descriptor_field::TYPE_UINT16, &desc.signal_index));
-    m_fields.push_back(new descriptor_field_imp("signal_output", descriptor_field::TYPE_UINT16, &desc.signal_output));
-
-    m_fields.push_back(new descriptor_field_imp("block_latency", descriptor_field::TYPE_UINT16, &desc.block_latency));
-    m_fields.push_back(new descriptor_field_imp("jack_index", descriptor_field::TYPE_UINT16, &desc.jack_index));
 }
 
 external_port_input_descriptor_response_imp::~external_port_input_descriptor_response_imp() {}
@@ -40,9 +40,6 @@ namespace avdecc_lib
 {
 class external_port_input_descriptor_response_imp : public external_port_input_descriptor_response, public virtual descriptor_base_imp, public virtual descriptor_response_base_imp
 {
-private:
-    struct jdksavdecc_descriptor_external_port desc;
-
 public:
     external_port_input_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos);
     virtual ~external_port_input_descriptor_response_imp();
@@ -35,7 +35,7 @@
 
 namespace avdecc_lib
 {
-external_port_output_descriptor_response_imp::external_port_output_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos) : descriptor_response_base_imp(frame, frame_len, pos) {}
+external_port_output_descriptor_response_imp::external_port_output_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos) : descriptor_base_imp(nullptr, frame, frame_len, pos), descriptor_response_base_imp(frame, frame_len, pos) {}
 
 external_port_output_descriptor_response_imp::~external_port_output_descriptor_response_imp() {}
 
@@ -31,13 +31,14 @@
 
 #include <stdint.h>
 #include "avdecc-lib_build.h"
+#include "descriptor_base_imp.h"
 #include "external_port_output_descriptor_response.h"
 #include "jdksavdecc_aem_descriptor.h"
 #include "descriptor_response_base_imp.h"
 
 namespace avdecc_lib
 {
-class external_port_output_descriptor_response_imp : public external_port_output_descriptor_response, public virtual descriptor_response_base_imp
+class external_port_output_descriptor_response_imp : public external_port_output_descriptor_response, public virtual descriptor_base_imp, public virtual descriptor_response_base_imp
 {
 public:
     external_port_output_descriptor_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos);
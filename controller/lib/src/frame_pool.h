@@ -0,0 +1,157 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * frame_pool.h
+ *
+ * Pool of immutable descriptor frames shared between End Stations
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+namespace avdecc_lib
+{
+///
+/// An immutable READ_DESCRIPTOR response frame. The Ethernet and AECP headers, which hold the
+/// addresses and sequence id of one exchange, are zeroed so that the same descriptor read from
+/// different End Stations is the same frame.
+///
+struct shared_frame
+{
+    uint64_t hash;
+    size_t position;
+    std::vector<uint8_t> bytes;
+};
+
+///
+/// Interns descriptor frames, so that End Stations of the same entity model hold one copy of each
+/// static descriptor. Frames are immutable: a descriptor that changes, such as a new name or stream
+/// format, is interned again and only then gets storage of its own. A frame is released with its
+/// last reference.
+///
+class frame_pool
+{
+private:
+    std::mutex locker;
+    std::unordered_multimap<uint64_t, std::pair<const shared_frame *, std::weak_ptr<const shared_frame>>> frames;
+    std::atomic<uint64_t> referenced_bytes; // Size of the frames referenced, counted once per reference
+    std::atomic<uint64_t> stored_bytes;     // Size of the frames stored, counted once per frame
+
+    static uint64_t fnv1a(const uint8_t * data, size_t len, uint64_t h)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            h ^= data[i];
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    void release(shared_frame * f)
+    {
+        {
+            std::lock_guard<std::mutex> guard(locker);
+            auto range = frames.equal_range(f->hash);
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second.first == f)
+                {
+                    frames.erase(it);
+                    break;
+                }
+            }
+        }
+        stored_bytes -= f->bytes.size();
+        delete f;
+    }
+
+public:
+    frame_pool() : referenced_bytes(0), stored_bytes(0) {}
+
+    ///
+    /// \return The shared frame with the contents of frame, the descriptor starting at pos.
+    ///
+    std::shared_ptr<const shared_frame> intern(const uint8_t * frame, size_t size, size_t pos)
+    {
+        size_t header_len = (pos < size) ? pos : size;
+        uint64_t h = 0xcbf29ce484222325ULL;
+        h = fnv1a((const uint8_t *)&pos, sizeof(pos), h);
+        h = fnv1a(frame + header_len, size - header_len, h);
+
+        referenced_bytes += size;
+        std::lock_guard<std::mutex> guard(locker);
+
+        auto range = frames.equal_range(h);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const shared_frame * f = it->second.first;
+            if (f->position == pos && f->bytes.size() == size &&
+                memcmp(f->bytes.data() + header_len, frame + header_len, size - header_len) == 0)
+            {
+                std::shared_ptr<const shared_frame> existing = it->second.second.lock();
+                if (existing)
+                    return existing;
+            }
+        }
+
+        shared_frame * f = new shared_frame();
+        f->hash = h;
+        f->position = pos;
+        f->bytes.assign(frame, frame + size);
+        memset(f->bytes.data(), 0, header_len);
+        stored_bytes += size;
+
+        std::shared_ptr<const shared_frame> p(f, [this](shared_frame * released) { release(released); });
+        frames.insert(std::make_pair(h, std::make_pair((const shared_frame *)f, std::weak_ptr<const shared_frame>(p))));
+        return p;
+    }
+
+    ///
+    /// Account for a reference to a frame returned by intern() that is dropped.
+    ///
+    void unreference(const shared_frame & f)
+    {
+        referenced_bytes -= f.bytes.size();
+    }
+
+    inline uint64_t get_referenced_bytes() const
+    {
+        return referenced_bytes.load();
+    }
+
+    inline uint64_t get_stored_bytes() const
+    {
+        return stored_bytes.load();
+    }
+};
+
+extern frame_pool * frame_pool_ref;
+}
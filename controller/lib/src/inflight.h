@@ -29,6 +29,10 @@
 
 #pragma once
 
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include "enumeration.h"
 #include "timer.h"
 
 namespace avdecc_lib
@@ -38,12 +42,15 @@ class inflight
 private:
     struct jdksavdecc_frame cmd_frame;
     uint32_t cmd_notification_flag;
-    timer cmd_timer;
+    uint64_t cmd_deadline_ms;
+    uint64_t cmd_sent_ms; // Time of the first transmission, used for round trip time samples
     uint32_t cmd_timeout_ms;
+    uint32_t cmd_max_sends;
     uint32_t start_timer_cnt;
+    bool rtt_sampled;
 
 public:
-    /* following 2 are public for compare prediate classes */
+    /* following 2 are public for inflight_table indexing */
     uint16_t cmd_seq_id;
     void * cmd_notification_id;
 
@@ -55,21 +62,71 @@ public:
         : cmd_notification_flag(notification_flag), cmd_timeout_ms(timeout_ms), cmd_seq_id(seq_id), cmd_notification_id(notification_id)
     {
         cmd_frame = *frame;
+        cmd_deadline_ms = 0;
+        cmd_sent_ms = 0;
+        cmd_max_sends = 2; // The command can be resent once
         start_timer_cnt = 0;
+        rtt_sampled = false;
     }
 
     ~inflight() {}
 
     inline void start_timer()
     {
-        start_timer_cnt++;
-        cmd_timer.start(cmd_timeout_ms);
+        uint64_t now_ms = timer::clk_monotonic_ms();
+
+        if (start_timer_cnt++ == 0)
+            cmd_sent_ms = now_ms;
+        cmd_deadline_ms = now_ms + cmd_timeout_ms;
+    }
+
+    ///
+    /// Set the timeout of the next transmission and the total number of transmissions allowed.
+    ///
+    inline void set_retry_policy(uint32_t timeout_ms, uint32_t max_sends)
+    {
+        cmd_timeout_ms = timeout_ms;
+        cmd_max_sends = max_sends;
+    }
+
+    ///
+    /// Double the timeout for the next transmission, up to max_timeout_ms.
+    ///
+    inline void backoff(uint32_t max_timeout_ms)
+    {
+        cmd_timeout_ms = (cmd_timeout_ms * 2 < max_timeout_ms) ? cmd_timeout_ms * 2 : max_timeout_ms;
+    }
+
+    ///
+    /// Take a round trip time sample for a response received at now_ms. Following Karn's algorithm
+    /// there is no sample once the command has been resent, as the response cannot be matched to
+    /// one transmission, and only the first response of a command is sampled.
+    ///
+    /// \return True if a sample was stored in rtt_ms.
+    ///
+    inline bool rtt_sample(uint64_t now_ms, uint32_t & rtt_ms)
+    {
+        if (rtt_sampled || start_timer_cnt != 1)
+            return false;
+
+        rtt_sampled = true;
+        rtt_ms = (uint32_t)(now_ms - cmd_sent_ms);
+        return true;
     }
 
     inline void restart_timer()
     {
-        cmd_timer.stop();
-        cmd_timer.start(cmd_timeout_ms);
+        // An IN_PROGRESS response is only repeated within the 1722.1 timeout, however short the adaptive timeout is
+        uint32_t timeout_ms = (cmd_timeout_ms > AVDECC_MSG_TIMEOUT_MS) ? cmd_timeout_ms : (uint32_t)AVDECC_MSG_TIMEOUT_MS;
+        cmd_deadline_ms = timer::clk_monotonic_ms() + timeout_ms;
+    }
+
+    ///
+    /// \return The time returned by timer::clk_monotonic_ms() at which the command times out.
+    ///
+    inline uint64_t deadline() const
+    {
+        return cmd_deadline_ms;
     }
 
     inline struct jdksavdecc_frame frame()
@@ -82,48 +139,93 @@ public:
         return cmd_notification_flag;
     }
 
-    inline bool timeout()
-    {
-        return cmd_timer.timeout();
-    }
-
     inline bool retried()
     {
-        return start_timer_cnt >= 2; // The command can be resent once
+        return start_timer_cnt >= cmd_max_sends;
     }
 };
 
 ///
-/// Class for use in STL find_if() call to find matching sequence ID.
+/// Inflight commands indexed by sequence id and by notification id.
 ///
-class SeqIdComp
+/// Commands are kept in a dense vector. A 65536 entry slot table maps each sequence id to its
+/// position, so lookup and erase by sequence id are O(1). The number of inflight commands per
+/// notification id is counted in a hash map, which can be read by other threads than the one
+/// changing the table.
+///
+class inflight_table
 {
 private:
-    uint16_t v;
+    std::vector<inflight> cmds;
+    std::vector<uint32_t> seq_slots;                          // Position in cmds + 1 for every sequence id, 0 if not inflight
+    std::unordered_map<void *, uint32_t> notification_counts; // Number of inflight commands per notification id
+    mutable std::mutex count_locker;                          // Protects notification_counts
 
 public:
-    SeqIdComp(uint16_t i) : v(i) {}
+    inflight_table() : seq_slots(65536, 0) {}
 
-    inline bool operator()(const inflight & m) const
+    ///
+    /// \return The inflight command with seq_id, or NULL if there is none. The pointer is
+    ///         invalidated by the next insert() or erase().
+    ///
+    inline inflight * find(uint16_t seq_id)
     {
-        return m.cmd_seq_id == v;
+        uint32_t slot = seq_slots[seq_id];
+        return slot ? &cmds[slot - 1] : NULL;
     }
-};
 
-///
-/// Class for use in STL find_if() call to find matching notification ID.
-///
-class NotificationComp
-{
-private:
-    void * v;
+    ///
+    /// Add a command, replacing any command still inflight with the same sequence id.
+    ///
+    inline void insert(const inflight & cmd)
+    {
+        if (seq_slots[cmd.cmd_seq_id])
+            erase(cmd.cmd_seq_id);
 
-public:
-    NotificationComp(void * p) : v(p) {}
+        cmds.push_back(cmd);
+        seq_slots[cmd.cmd_seq_id] = (uint32_t)cmds.size();
+
+        std::lock_guard<std::mutex> guard(count_locker);
+        notification_counts[cmd.cmd_notification_id]++;
+    }
+
+    ///
+    /// Remove the command with seq_id by moving the last command into its place.
+    ///
+    inline void erase(uint16_t seq_id)
+    {
+        uint32_t slot = seq_slots[seq_id];
+        if (!slot)
+            return;
+
+        {
+            std::lock_guard<std::mutex> guard(count_locker);
+            std::unordered_map<void *, uint32_t>::iterator n = notification_counts.find(cmds[slot - 1].cmd_notification_id);
+            if (n != notification_counts.end() && --n->second == 0)
+                notification_counts.erase(n);
+        }
+
+        seq_slots[seq_id] = 0;
+        if (slot != cmds.size())
+        {
+            cmds[slot - 1] = cmds.back();
+            seq_slots[cmds[slot - 1].cmd_seq_id] = slot;
+        }
+        cmds.pop_back();
+    }
+
+    ///
+    /// \return True if a command with notification_id is inflight.
+    ///
+    inline bool has_notification_id(void * notification_id) const
+    {
+        std::lock_guard<std::mutex> guard(count_locker);
+        return notification_counts.find(notification_id) != notification_counts.end();
+    }
 
-    inline bool operator()(const inflight & m) const
+    inline size_t size() const
     {
-        return m.cmd_notification_id == v;
+        return cmds.size();
     }
 };
 }
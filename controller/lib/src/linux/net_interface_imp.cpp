@@ -36,6 +36,7 @@
 
 #include <sys/socket.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <linux/if_packet.h>
 #include <linux/if_ether.h>
 #include <linux/if_arp.h>
@@ -55,6 +56,20 @@
 
 namespace avdecc_lib
 {
+static void update_batch_stats(struct frame_batch_stats & stats, uint32_t count)
+{
+    unsigned int bin = 0;
+    while ((2u << bin) <= count && bin < frame_batch_stats::HISTOGRAM_BINS - 1)
+        bin++;
+
+    stats.batches++;
+    stats.frames += count;
+    stats.last = count;
+    if (count > stats.max)
+        stats.max = count;
+    stats.histogram[bin]++;
+}
+
 
 struct etherII
 {
@@ -92,6 +107,28 @@ net_interface_imp::net_interface_imp()
     char ifname[256];
 
     total_devs = 0;
+    rawsock = -1;
+
+#ifdef AVDECC_USE_PACKET_MMAP
+    use_rx_ring = true;
+#else
+    use_rx_ring = false;
+#endif
+    rx_ring = NULL;
+    rx_ring_size = 0;
+    rx_ring_block = 0;
+    rx_ring_block_owned = false;
+    rx_ring_pkts_left = 0;
+    rx_ring_pkt = NULL;
+
+    rx_batch_len = 0;
+    set_rx_batch_size(RX_BATCH_DEFAULT_SIZE);
+    reset_rx_batch_stats();
+
+    tx_batch_len = 0;
+    tx_batch_count = 0;
+    set_tx_batch_size(TX_BATCH_DEFAULT_SIZE);
+    reset_tx_batch_stats();
 
     ip_hdr_store = new ipheader;
     udp_hdr_store = new udpheader;
@@ -136,6 +173,9 @@ net_interface_imp::net_interface_imp()
 
 net_interface_imp::~net_interface_imp()
 {
+    if (rawsock != -1)
+        flush_tx_frames();
+    teardown_rx_ring();
     close(rawsock);
 }
 
@@ -246,6 +286,11 @@ int STDCALL net_interface_imp::select_interface_by_num(uint32_t interface_num)
 
     setpromiscuous(rawsock, ifindex);
 
+    if (use_rx_ring && setup_rx_ring() < 0)
+    {
+        fprintf(stderr, "NETIF - receive ring not available, using read()\n");
+    }
+
     memset(&sll, 0, sizeof(sll));
     sll.sll_family = AF_PACKET;
     sll.sll_ifindex = ifindex;
@@ -287,10 +332,187 @@ int net_interface_imp::set_capture_ether_type(uint16_t * ether_type, uint32_t co
     return 0;
 }
 
+int STDCALL net_interface_imp::set_rx_ring_enabled(bool enabled)
+{
+    use_rx_ring = enabled;
+    return 0;
+}
+
+bool STDCALL net_interface_imp::rx_ring_enabled()
+{
+    return rx_ring != NULL;
+}
+
+int STDCALL net_interface_imp::set_rx_batch_size(uint32_t frames)
+{
+    if (frames < 1)
+        frames = 1;
+
+    rx_batch_len = frames;
+    rx_batch_bufs.assign((size_t)frames * SIZEOF_BUFFER, 0);
+    rx_batch_iovs.resize(frames);
+    rx_batch_msgs.resize(frames);
+
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        rx_batch_iovs[i].iov_base = &rx_batch_bufs[(size_t)i * SIZEOF_BUFFER];
+        rx_batch_iovs[i].iov_len = SIZEOF_BUFFER;
+
+        memset(&rx_batch_msgs[i], 0, sizeof(rx_batch_msgs[i]));
+        rx_batch_msgs[i].msg_hdr.msg_iov = &rx_batch_iovs[i];
+        rx_batch_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    return 0;
+}
+
+uint32_t net_interface_imp::rx_batch_size()
+{
+    return rx_batch_len;
+}
+
+int net_interface_imp::capture_frame_batch(const uint8_t ** frames, uint16_t * lengths)
+{
+    int count = recvmmsg(rawsock, &rx_batch_msgs[0], rx_batch_len, MSG_DONTWAIT, NULL);
+
+    if (count < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        frames[i] = (const uint8_t *)rx_batch_iovs[i].iov_base;
+        lengths[i] = (uint16_t)rx_batch_msgs[i].msg_len;
+    }
+
+    if (count > 0)
+    {
+        std::lock_guard<std::mutex> guard(rx_stats_locker);
+        update_batch_stats(rx_stats, count);
+    }
+
+    return count;
+}
+
+int STDCALL net_interface_imp::get_rx_batch_stats(struct frame_batch_stats & stats)
+{
+    std::lock_guard<std::mutex> guard(rx_stats_locker);
+    stats = rx_stats;
+    return 0;
+}
+
+void STDCALL net_interface_imp::reset_rx_batch_stats()
+{
+    std::lock_guard<std::mutex> guard(rx_stats_locker);
+    memset(&rx_stats, 0, sizeof(rx_stats));
+}
+
+int net_interface_imp::setup_rx_ring()
+{
+    struct tpacket_req3 req;
+    int version = TPACKET_V3;
+
+    if (setsockopt(rawsock, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0)
+    {
+        fprintf(stderr, "socket PACKET_VERSION failed! %s\n", strerror(errno));
+        return -1;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = RX_RING_BLOCK_SIZE;
+    req.tp_block_nr = RX_RING_BLOCK_COUNT;
+    req.tp_frame_size = RX_RING_FRAME_SIZE;
+    req.tp_frame_nr = (RX_RING_BLOCK_SIZE / RX_RING_FRAME_SIZE) * RX_RING_BLOCK_COUNT;
+    req.tp_retire_blk_tov = RX_RING_BLOCK_TIMEOUT_MS;
+    req.tp_feature_req_word = 0;
+
+    if (setsockopt(rawsock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0)
+    {
+        fprintf(stderr, "socket PACKET_RX_RING failed! %s\n", strerror(errno));
+        return -1;
+    }
+
+    rx_ring_size = (size_t)req.tp_block_size * req.tp_block_nr;
+    void * ring = mmap(NULL, rx_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, rawsock, 0);
+    if (ring == MAP_FAILED)
+    {
+        fprintf(stderr, "receive ring mmap failed! %s\n", strerror(errno));
+        memset(&req, 0, sizeof(req));
+        setsockopt(rawsock, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+        rx_ring_size = 0;
+        return -1;
+    }
+
+    rx_ring = (uint8_t *)ring;
+    rx_ring_block = 0;
+    rx_ring_block_owned = false;
+    rx_ring_pkts_left = 0;
+    rx_ring_pkt = NULL;
+
+    return 0;
+}
+
+void net_interface_imp::teardown_rx_ring()
+{
+    if (rx_ring)
+    {
+        munmap(rx_ring, rx_ring_size);
+        rx_ring = NULL;
+        rx_ring_size = 0;
+    }
+}
+
+int net_interface_imp::capture_frame_from_ring(const uint8_t ** frame, uint16_t * mem_buf_len)
+{
+    struct tpacket_block_desc * bd;
+    struct tpacket3_hdr * ph;
+
+    while (rx_ring_pkts_left == 0)
+    {
+        bd = (struct tpacket_block_desc *)(rx_ring + (size_t)rx_ring_block * RX_RING_BLOCK_SIZE);
+
+        // The previous frame handed out points into this block, so the block is only returned
+        // to the kernel once the caller has come back for the next frame.
+        if (rx_ring_block_owned)
+        {
+            __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            rx_ring_block_owned = false;
+            rx_ring_block = (rx_ring_block + 1) % RX_RING_BLOCK_COUNT;
+            bd = (struct tpacket_block_desc *)(rx_ring + (size_t)rx_ring_block * RX_RING_BLOCK_SIZE);
+        }
+
+        if ((__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0)
+        {
+            *frame = NULL;
+            *mem_buf_len = 0;
+            return 0;
+        }
+
+        rx_ring_block_owned = true;
+        rx_ring_pkts_left = bd->hdr.bh1.num_pkts;
+        rx_ring_pkt = (uint8_t *)bd + bd->hdr.bh1.offset_to_first_pkt;
+    }
+
+    ph = (struct tpacket3_hdr *)rx_ring_pkt;
+    *frame = rx_ring_pkt + ph->tp_mac;
+    *mem_buf_len = (uint16_t)ph->tp_snaplen;
+
+    rx_ring_pkt += ph->tp_next_offset;
+    rx_ring_pkts_left--;
+
+    return ph->tp_snaplen;
+}
+
 int STDCALL net_interface_imp::capture_frame(const uint8_t ** frame, uint16_t * mem_buf_len)
 {
     int len;
 
+    if (rx_ring)
+    {
+        return capture_frame_from_ring(frame, mem_buf_len);
+    }
+
     *frame = &rx_buf[0];
     len = read(rawsock, &rx_buf[0], sizeof(rx_buf));
     if (len < 0)
@@ -304,42 +526,147 @@ int STDCALL net_interface_imp::capture_frame(const uint8_t ** frame, uint16_t *
     return len;
 }
 
-int net_interface_imp::send_frame(uint8_t * frame, uint16_t mem_buf_len)
+void net_interface_imp::prep_tx_address(struct sockaddr_ll * socket_address, const uint8_t * frame)
 {
-    int send_result;
-
-    // target address
-    struct sockaddr_ll socket_address;
-
-    // prepare sockaddr_ll
+    memset(socket_address, 0, sizeof(*socket_address));
 
     // RAW communication
-    socket_address.sll_family = PF_PACKET;
-    socket_address.sll_protocol = htons(ethertype);
+    socket_address->sll_family = PF_PACKET;
+    socket_address->sll_protocol = htons(ethertype);
 
     // index of the network device
-    // see full code later how to retrieve it
-    socket_address.sll_ifindex = ifindex;
+    socket_address->sll_ifindex = ifindex;
 
     // ARP hardware identifier is ethernet
-    socket_address.sll_hatype = ARPHRD_ETHER;
+    socket_address->sll_hatype = ARPHRD_ETHER;
 
     // target is another host
-    socket_address.sll_pkttype = PACKET_OTHERHOST;
+    socket_address->sll_pkttype = PACKET_OTHERHOST;
 
     // address length
-    socket_address.sll_halen = ETH_ALEN;
+    socket_address->sll_halen = ETH_ALEN;
     // MAC - begin
-    memcpy(&socket_address.sll_addr[0], &frame[0], 6);
+    memcpy(&socket_address->sll_addr[0], &frame[0], 6);
     // MAC - end
-    socket_address.sll_addr[6] = 0x00; // not used
-    socket_address.sll_addr[7] = 0x00; // not used
+}
+
+int net_interface_imp::send_frame(uint8_t * frame, uint16_t mem_buf_len)
+{
+    std::lock_guard<std::mutex> guard(tx_batch_locker);
+
+    if (tx_batch_len > 1 && mem_buf_len <= SIZEOF_BUFFER)
+    {
+        uint32_t slot = tx_batch_count++;
+
+        memcpy(tx_batch_iovs[slot].iov_base, frame, mem_buf_len);
+        tx_batch_iovs[slot].iov_len = mem_buf_len;
+        prep_tx_address((struct sockaddr_ll *)&tx_batch_addrs[slot], frame);
+
+        if (tx_batch_count == tx_batch_len && flush_tx_batch() < 0)
+            return -1;
+
+        return mem_buf_len;
+    }
+
+    // Keep frames in order when a frame bypasses the batch
+    if (tx_batch_count && flush_tx_batch() < 0)
+        return -1;
+
+    struct sockaddr_ll socket_address;
+    prep_tx_address(&socket_address, frame);
 
     // send the packet
-    send_result = sendto(rawsock, frame, mem_buf_len, 0,
-                         (struct sockaddr *)&socket_address, sizeof(socket_address));
+    return sendto(rawsock, frame, mem_buf_len, 0,
+                  (struct sockaddr *)&socket_address, sizeof(socket_address));
+}
+
+int net_interface_imp::flush_tx_frames()
+{
+    std::lock_guard<std::mutex> guard(tx_batch_locker);
+    return flush_tx_batch();
+}
+
+int net_interface_imp::flush_tx_batch()
+{
+    uint32_t sent = 0;
+    int status = 0;
+
+    if (tx_batch_count == 0)
+        return 0;
+
+    {
+        std::lock_guard<std::mutex> guard(tx_stats_locker);
+        update_batch_stats(tx_stats, tx_batch_count);
+    }
+
+    while (sent < tx_batch_count)
+    {
+        int count = sendmmsg(rawsock, &tx_batch_msgs[sent], tx_batch_count - sent, 0);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            // Drop the frame that failed and carry on with the rest of the batch
+            fprintf(stderr, "NETIF - sendmmsg failed! %s\n", strerror(errno));
+            status = -1;
+            count = 1;
+        }
+        sent += count;
+    }
 
-    return send_result;
+    tx_batch_count = 0;
+
+    return status < 0 ? -1 : (int)sent;
+}
+
+int STDCALL net_interface_imp::set_tx_batch_size(uint32_t frames)
+{
+    if (frames < 1)
+        frames = 1;
+
+    std::lock_guard<std::mutex> guard(tx_batch_locker);
+    if (tx_batch_count)
+        flush_tx_batch();
+
+    tx_batch_len = frames;
+    tx_batch_bufs.assign((size_t)frames * SIZEOF_BUFFER, 0);
+    tx_batch_iovs.resize(frames);
+    tx_batch_msgs.resize(frames);
+    tx_batch_addrs.resize(frames);
+
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        tx_batch_iovs[i].iov_base = &tx_batch_bufs[(size_t)i * SIZEOF_BUFFER];
+        tx_batch_iovs[i].iov_len = 0;
+
+        memset(&tx_batch_msgs[i], 0, sizeof(tx_batch_msgs[i]));
+        tx_batch_msgs[i].msg_hdr.msg_name = &tx_batch_addrs[i];
+        tx_batch_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_ll);
+        tx_batch_msgs[i].msg_hdr.msg_iov = &tx_batch_iovs[i];
+        tx_batch_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    return 0;
+}
+
+uint32_t net_interface_imp::tx_batch_size()
+{
+    std::lock_guard<std::mutex> guard(tx_batch_locker);
+    return tx_batch_len;
+}
+
+int STDCALL net_interface_imp::get_tx_batch_stats(struct frame_batch_stats & stats)
+{
+    std::lock_guard<std::mutex> guard(tx_stats_locker);
+    stats = tx_stats;
+    return 0;
+}
+
+void STDCALL net_interface_imp::reset_tx_batch_stats()
+{
+    std::lock_guard<std::mutex> guard(tx_stats_locker);
+    memset(&tx_stats, 0, sizeof(tx_stats));
 }
 
 int net_interface_imp::getifindex(int rawsock, const char * iface)
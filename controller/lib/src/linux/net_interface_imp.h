@@ -34,10 +34,15 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <mutex>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "avdecc-lib_build.h"
 #include "net_interface.h"
 
+struct sockaddr_ll;
+
 namespace avdecc_lib
 {
 struct ipheader;
@@ -48,7 +53,13 @@ class net_interface_imp : public net_interface
 private:
     enum econsts
     {
-        SIZEOF_BUFFER = 2048
+        SIZEOF_BUFFER = 2048,
+        RX_RING_BLOCK_SIZE = 1 << 16,    ///< Size of one TPACKET_V3 ring block (a multiple of the page size)
+        RX_RING_BLOCK_COUNT = 64,        ///< Number of blocks in the receive ring
+        RX_RING_FRAME_SIZE = 2048,       ///< Nominal frame slot size used to size the ring
+        RX_RING_BLOCK_TIMEOUT_MS = 2,    ///< Retire a partially filled block after this many milliseconds
+        RX_BATCH_DEFAULT_SIZE = 32,      ///< Default number of frames received by one recvmmsg() call
+        TX_BATCH_DEFAULT_SIZE = 32       ///< Default number of frames sent by one sendmmsg() call
     };
 
     std::vector<std::string> ifnames;
@@ -64,9 +75,59 @@ private:
     uint8_t buf[SIZEOF_BUFFER];
     uint8_t rx_buf[SIZEOF_BUFFER];
 
+    bool use_rx_ring;            // Request a TPACKET_V3 receive ring when the interface is selected
+    uint8_t * rx_ring;           // Memory mapped receive ring, NULL when frames are captured with read()
+    size_t rx_ring_size;         // Size of the mapped receive ring in bytes
+    uint32_t rx_ring_block;      // Index of the ring block currently being walked
+    bool rx_ring_block_owned;    // The current block has been handed to user space and must be released
+    uint32_t rx_ring_pkts_left;  // Number of frames left to walk in the current block
+    uint8_t * rx_ring_pkt;       // Header of the next frame to walk in the current block
+
+    uint32_t rx_batch_len;                  // Maximum number of frames received by one recvmmsg() call
+    std::vector<uint8_t> rx_batch_bufs;     // One SIZEOF_BUFFER slot per batch entry
+    std::vector<struct iovec> rx_batch_iovs;
+    std::vector<struct mmsghdr> rx_batch_msgs;
+    struct frame_batch_stats rx_stats;
+    std::mutex rx_stats_locker;             // Lets the counters be read by other threads
+
+    uint32_t tx_batch_len;                  // Maximum number of frames held back for one sendmmsg() call
+    uint32_t tx_batch_count;                // Number of frames waiting to be flushed
+    std::vector<uint8_t> tx_batch_bufs;     // One SIZEOF_BUFFER slot per batch entry
+    std::vector<struct iovec> tx_batch_iovs;
+    std::vector<struct mmsghdr> tx_batch_msgs;
+    std::vector<struct sockaddr_storage> tx_batch_addrs; // Holds a struct sockaddr_ll per batch entry
+    std::mutex tx_batch_locker;             // Lets frames be sent and flushed by more than one thread
+    struct frame_batch_stats tx_stats;
+    std::mutex tx_stats_locker;             // Lets the counters be read by other threads
+
     int getifindex(int rawsock, const char * iface);
     int setpromiscuous(int rawsock, int ifindex);
 
+    ///
+    /// Map a TPACKET_V3 receive ring onto the raw socket.
+    ///
+    int setup_rx_ring();
+
+    ///
+    /// Release the receive ring and fall back to capturing frames with read().
+    ///
+    void teardown_rx_ring();
+
+    ///
+    /// Return the next frame from the receive ring without copying it.
+    ///
+    int capture_frame_from_ring(const uint8_t ** frame, uint16_t * mem_buf_len);
+
+    ///
+    /// Fill in the link layer address used to send frame.
+    ///
+    void prep_tx_address(struct sockaddr_ll * socket_address, const uint8_t * frame);
+
+    ///
+    /// Send the pending batch. The caller holds tx_batch_locker.
+    ///
+    int flush_tx_batch();
+
 public:
     ///
     /// An empty constructor for net_interface_imp
@@ -148,13 +209,90 @@ public:
     ///
     /// Capture a network packet.
     ///
+    /// With the receive ring enabled the returned frame points into the ring and stays valid
+    /// until the next call. A return value of 0 means that no further frames are ready.
+    ///
     int STDCALL capture_frame(const uint8_t ** frame, uint16_t * mem_buf_len);
 
+    ///
+    /// Request a memory mapped TPACKET_V3 receive ring. Must be called before select_interface_by_num().
+    ///
+    int STDCALL set_rx_ring_enabled(bool enabled);
+
+    ///
+    /// \return True if frames are captured from the memory mapped receive ring.
+    ///
+    bool STDCALL rx_ring_enabled();
+
+    ///
+    /// Set the maximum number of frames received by one capture_frame_batch() call.
+    /// A size of 1 disables batching. Must not be called while frames are being captured.
+    ///
+    int STDCALL set_rx_batch_size(uint32_t frames);
+
+    ///
+    /// \return The maximum number of frames received by one capture_frame_batch() call.
+    ///
+    uint32_t rx_batch_size();
+
+    ///
+    /// Receive up to rx_batch_size() frames with a single non-blocking recvmmsg() call.
+    ///
+    /// The frames stay valid until the next call. Only used when the receive ring is not enabled.
+    ///
+    /// \param frames Array of at least rx_batch_size() entries filled with the received frames.
+    /// \param lengths Array of at least rx_batch_size() entries filled with the frame lengths.
+    ///
+    /// \return The number of frames received, 0 if none are ready, or -1 on error.
+    ///
+    int capture_frame_batch(const uint8_t ** frames, uint16_t * lengths);
+
+    ///
+    /// Copy the receive batch counters.
+    ///
+    int STDCALL get_rx_batch_stats(struct frame_batch_stats & stats);
+
+    ///
+    /// Clear the receive batch counters.
+    ///
+    void STDCALL reset_rx_batch_stats();
+
     ///
     /// Send a network packet.
     ///
+    /// With transmit batching enabled the frame is copied into the pending batch and sent by
+    /// the next flush_tx_frames(), or immediately once the batch is full.
+    ///
     int send_frame(uint8_t * frame, uint16_t mem_buf_len);
 
+    ///
+    /// Send every frame held back by send_frame() with sendmmsg().
+    ///
+    /// \return The number of frames sent, or -1 if any frame could not be sent.
+    ///
+    int flush_tx_frames();
+
+    ///
+    /// Set the maximum number of frames held back for one flush_tx_frames() call.
+    /// A size of 1 sends every frame immediately.
+    ///
+    int STDCALL set_tx_batch_size(uint32_t frames);
+
+    ///
+    /// \return The maximum number of frames held back for one flush_tx_frames() call.
+    ///
+    uint32_t tx_batch_size();
+
+    ///
+    /// Copy the transmit batch counters.
+    ///
+    int STDCALL get_tx_batch_stats(struct frame_batch_stats & stats);
+
+    ///
+    /// Clear the transmit batch counters.
+    ///
+    void STDCALL reset_tx_batch_stats();
+
     int get_fd();
 };
 
@@ -50,8 +50,10 @@
 #include <net/ethernet.h>
 #include <sys/un.h>
 #include <sys/eventfd.h>
+#include <sched.h>
 
 #include <vector>
+#include <mutex>
 
 #include "net_interface_imp.h"
 #include "enumeration.h"
@@ -59,6 +61,7 @@
 #include "log_imp.h"
 #include "end_station_imp.h"
 #include "controller_imp.h"
+#include "cmd_completion_imp.h"
 #include "system_message_queue.h"
 #include "system_tx_queue.h"
 #include "system_layer2_multithreaded_callback.h"
@@ -68,15 +71,29 @@ namespace avdecc_lib
 
 net_interface_imp * netif_obj_in_system;
 controller_imp * controller_ref_in_system;
-system_layer2_multithreaded_callback * local_system = NULL;
+std::atomic<system_layer2_multithreaded_callback *> local_system(NULL); // Cleared by destroy() to stop the poll thread
 
 system_layer2_multithreaded_callback * system_layer2_multithreaded_callback::instance = NULL;
 
 size_t system_queue_tx(void * notification_id, uint32_t notification_flag, uint8_t * frame, size_t mem_buf_len)
 {
-    if (local_system)
+    system_layer2_multithreaded_callback * sys = local_system;
+    if (sys)
     {
-        return local_system->queue_tx_frame(notification_id, notification_flag, frame, mem_buf_len);
+        return sys->queue_tx_frame(notification_id, notification_flag, frame, mem_buf_len);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+size_t system_queue_tx_batch(const struct system_tx_entry * entries, size_t count)
+{
+    system_layer2_multithreaded_callback * sys = local_system;
+    if (sys)
+    {
+        return sys->queue_tx_frames(entries, count);
     }
     else
     {
@@ -93,17 +110,20 @@ system * STDCALL create_system(system::system_type type, net_interface * netif,
 }
 
 system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_interface * netif, controller * controller_obj)
+    : tx_queue(TX_QUEUE_SLOTS), tx_event_pending(false), process_started(false), rx_worker_count(0), rx_workers_stop(false)
 {
     instance = this;
     netif_obj_in_system = dynamic_cast<net_interface_imp *>(netif);
     controller_ref_in_system = dynamic_cast<controller_imp *>(controller_obj);
-    pipe(tx_pipe);
 
-    wait_mgr = new cmd_wait_mgr();
+    tx_event_fd = eventfd(0, EFD_NONBLOCK);
+    if (tx_event_fd == -1)
+    {
+        perror("eventfd");
+        exit(EXIT_FAILURE);
+    }
 
-    waiting_sem = (sem_t *)calloc(1, sizeof(*waiting_sem));
-    if (waiting_sem)
-        sem_init(waiting_sem, 0, 0);
+    wait_mgr = new cmd_wait_mgr(controller_ref_in_system);
 
     shutdown_sem = (sem_t *)calloc(1, sizeof(*shutdown_sem));
     if (shutdown_sem)
@@ -112,7 +132,9 @@ system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_i
 
 system_layer2_multithreaded_callback::~system_layer2_multithreaded_callback()
 {
-    free(waiting_sem);
+    stop_rx_workers();
+    close(tx_event_fd);
+    delete wait_mgr;
     free(shutdown_sem);
 }
 
@@ -122,10 +144,17 @@ void STDCALL system_layer2_multithreaded_callback::destroy()
     {
         local_system = NULL;
 
-        // Wait for controller to have finished
-        if (sem_wait(shutdown_sem) != 0)
+        // The poll thread may be idle with no timeout armed, so it is woken to see the shutdown
+        if (process_started)
         {
-            perror("sem_wait");
+            wake_tx();
+
+            // Wait for controller to have finished
+            if (sem_wait(shutdown_sem) != 0)
+            {
+                perror("sem_wait");
+            }
+            pthread_join(h_thread, NULL);
         }
     }
 
@@ -138,36 +167,86 @@ int system_layer2_multithreaded_callback::queue_tx_frame(
     uint8_t * frame,
     size_t mem_buf_len)
 {
-    struct tx_data t;
+    if (mem_buf_len > TX_FRAME_SIZE)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "queue_tx_frame: frame too large");
+        return -1;
+    }
+
+    cmd_completions_ref->cmd_queued(notification_id, notification_flag);
 
-    t.frame = new uint8_t[2048];
-    if (!t.frame)
+    // A waiting thread becomes a waiter before the command is queued, so that its completion cannot be missed
+    bool wait_for_completion = (notification_flag == CMD_WITH_NOTIFICATION) && wait_mgr->set_active_state(notification_id);
+
+    push_tx_frame(notification_id, notification_flag, frame, mem_buf_len);
+    wake_tx();
+
+    if (wait_for_completion)
+        wait_mgr->wait_for_completion();
+
+    return 0;
+}
+
+size_t system_layer2_multithreaded_callback::queue_tx_frames(const struct system_tx_entry * entries, size_t count)
+{
+    size_t queued = 0;
+
+    for (size_t i = 0; i < count; i++)
     {
-        perror("malloc");
-        exit(EXIT_FAILURE);
+        if (entries[i].frame_len > TX_FRAME_SIZE)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "queue_tx_frames: frame too large");
+            continue;
+        }
+
+        cmd_completions_ref->cmd_queued(entries[i].notification_id, entries[i].notification_flag);
+        push_tx_frame(entries[i].notification_id, entries[i].notification_flag, entries[i].frame, entries[i].frame_len);
+        queued++;
+    }
+
+    if (queued)
+        wake_tx();
+
+    return queued;
+}
+
+void system_layer2_multithreaded_callback::push_tx_frame(void * notification_id, uint32_t notification_flag, const uint8_t * frame, size_t mem_buf_len)
+{
+    size_t ticket;
+
+    while (!tx_queue.try_acquire(ticket))
+    {
+        // The queue is full. The thread draining it can be the one queueing here, and cannot wait
+        // for itself, so any thread that can become the consumer drains the queue here. Other
+        // threads wake the poll thread and give it time to catch up.
+        std::unique_lock<std::recursive_mutex> consumer(tx_consumer, std::try_to_lock);
+        if (consumer.owns_lock())
+        {
+            proc_tx_queue();
+        }
+        else
+        {
+            wake_tx();
+            sched_yield();
+        }
     }
+
+    struct tx_data & t = tx_queue.slot(ticket);
     t.mem_buf_len = mem_buf_len;
     memcpy(t.frame, frame, mem_buf_len);
     t.notification_id = notification_id;
     t.notification_flag = notification_flag;
-    write(tx_pipe[PIPE_WR], &t, sizeof(t));
+    tx_queue.publish(ticket);
+}
 
-    // Check for conditions that cause wait for completion.
-    if (wait_mgr->primed_state() &&
-        wait_mgr->match_id(notification_id) &&
-        (notification_flag == CMD_WITH_NOTIFICATION))
+void system_layer2_multithreaded_callback::wake_tx()
+{
+    // Only the first producer after the poll thread last drained the queue has to wake it
+    if (!tx_event_pending.exchange(true))
     {
-        int status = 0;
-
-        status = wait_mgr->set_active_state();
-        assert(status == 0);
-        sem_wait(waiting_sem);
-        resp_status_for_cmd = wait_mgr->get_completion_status();
-        status = wait_mgr->set_idle_state();
-        assert(status == 0);
+        uint64_t one = 1;
+        write(tx_event_fd, &one, sizeof(one));
     }
-
-    return 0;
 }
 
 int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * id)
@@ -178,24 +257,36 @@ int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * i
 
 int STDCALL system_layer2_multithreaded_callback::get_last_resp_status()
 {
-    return resp_status_for_cmd;
+    return wait_mgr->get_completion_status();
 }
 
-int system_layer2_multithreaded_callback::timer_start_interval(int timerfd)
+int system_layer2_multithreaded_callback::timer_arm_deadline(int timerfd, uint64_t deadline_ms)
 {
     struct itimerspec itimer_new;
-    struct itimerspec itimer_old;
     unsigned long ns_per_ms = 1000000;
-    unsigned long interval_ms = TIME_PERIOD_25_MILLISECONDS;
 
     memset(&itimer_new, 0, sizeof(itimer_new));
-    memset(&itimer_old, 0, sizeof(itimer_old));
 
-    itimer_new.it_interval.tv_sec = interval_ms / 1000;
-    itimer_new.it_interval.tv_nsec = (interval_ms % 1000) * ns_per_ms;
-    itimer_new.it_value = itimer_new.it_interval;
+    // timer::clk_monotonic_ms() reads CLOCK_MONOTONIC, so the deadline can be used as an absolute
+    // timerfd expiry. A deadline of 0 disarms the timer.
+    itimer_new.it_value.tv_sec = deadline_ms / 1000;
+    itimer_new.it_value.tv_nsec = (deadline_ms % 1000) * ns_per_ms;
 
-    return timerfd_settime(timerfd, 0, &itimer_new, &itimer_old);
+    timer_deadline_ms = deadline_ms;
+    return timerfd_settime(timerfd, TFD_TIMER_ABSTIME, &itimer_new, NULL);
+}
+
+void system_layer2_multithreaded_callback::timer_update_deadline(int timerfd)
+{
+    uint64_t deadline_ms;
+
+    if (!controller_ref_in_system->next_tick_deadline(deadline_ms))
+        deadline_ms = 0;
+    else if (deadline_ms == 0)
+        deadline_ms = 1; // Already due, but 0 would disarm the timer
+
+    if (deadline_ms != timer_deadline_ms)
+        timer_arm_deadline(timerfd, deadline_ms);
 }
 
 int system_layer2_multithreaded_callback::fn_timer_cb(struct epoll_priv * priv)
@@ -215,94 +306,255 @@ int system_layer2_multithreaded_callback::fn_timer(struct epoll_priv * priv)
 {
     uint64_t timer_exp_count;
     read(priv->fd, &timer_exp_count, sizeof(timer_exp_count));
+    timer_deadline_ms = 0; // One-shot, so the timer is disarmed once it has fired
 
-    bool notification_id_incomplete = false;
+    // Waiters whose commands are removed by timeout processing are released with a timeout status.
+    // The state machines name the commands they removed, as RX workers complete other commands meanwhile.
+    tick_timed_out.clear();
+    controller_ref_in_system->time_tick_event(timer::clk_monotonic_ms(), tick_timed_out);
+    for (size_t i = 0; i < tick_timed_out.size(); i++)
+        wait_mgr->cmd_timed_out(tick_timed_out[i]);
 
-    if (wait_mgr->active_state())
-    {
-        if (controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) ||
-            controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-            notification_id_incomplete = true;
-    }
+    return 0;
+}
 
-    // If waiting on a command to complete and the command was "inflight" prior to calling the
-    // timer tick update (ie notification_id_incomplete == true) AND after calling the timer tick
-    // update the command is no longer "inflight", timeout processing has removed it, so signal the
-    // waiting app thread.
-    controller_ref_in_system->time_tick_event();
+int system_layer2_multithreaded_callback::fn_tx(struct epoll_priv * priv)
+{
+    uint64_t count;
+    read(tx_event_fd, &count, sizeof(count));
 
-    bool is_timeout_for_waiting_notify_id = wait_mgr->active_state() && notification_id_incomplete &&
-                                            !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                                            !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id());
-    if (is_timeout_for_waiting_notify_id)
-    {
-        int status = wait_mgr->set_completion_status(AVDECC_LIB_STATUS_TICK_TIMEOUT);
-        assert(status == 0);
-        sem_post(waiting_sem);
-    }
+    // Clear the flag before draining so that a frame published while draining either gets
+    // picked up below or raises a fresh wakeup.
+    tx_event_pending.store(false);
+    proc_tx_queue();
 
     return 0;
 }
 
-int system_layer2_multithreaded_callback::fn_tx(struct epoll_priv * priv)
+void system_layer2_multithreaded_callback::proc_tx_queue()
 {
-    struct tx_data t;
-    int result = read(tx_pipe[PIPE_RD], &t, sizeof(t));
+    struct tx_data * t;
+    struct tx_data cmd;
+
+    // Any thread holding the consumer lock can drain the queue, so the lock makes it the only consumer
+    std::unique_lock<std::recursive_mutex> consumer(tx_consumer);
 
-    if (result > 0)
+    while ((t = tx_queue.front()) != NULL)
     {
+        // The entry is taken off the queue before it is sent. The thread can come back here
+        // through push_tx_frame() while sending it, and must then move on to the next entry.
+        cmd.notification_id = t->notification_id;
+        cmd.notification_flag = t->notification_flag;
+        cmd.mem_buf_len = t->mem_buf_len;
+        memcpy(cmd.frame, t->frame, t->mem_buf_len);
+        tx_queue.pop();
+
         log_imp_ref->post_log_msg(LOGGING_LEVEL_DEBUG, "fn_tx");
         controller_ref_in_system->tx_packet_event(
-            t.notification_id,
-            t.notification_flag,
-            t.frame,
-            t.mem_buf_len);
-
-        delete[] t.frame;
+            cmd.notification_id,
+            cmd.notification_flag,
+            cmd.frame,
+            cmd.mem_buf_len);
     }
 
-    return 0;
+    // Completion callbacks can queue further commands, so they run once the queue has been drained
+    consumer.unlock();
+    cmd_completions_ref->complete_sent();
 }
 
 int system_layer2_multithreaded_callback::fn_netif(struct epoll_priv * priv)
 {
     uint16_t length = 0;
     const uint8_t * rx_frame;
-    int status = 0;
 
-    status = netif_obj_in_system->capture_frame(&rx_frame, &length);
+    // With the receive ring every frame in every block retired by the kernel is processed in
+    // place before going back to epoll_wait().
+    if (netif_obj_in_system->rx_ring_enabled())
+    {
+        while (netif_obj_in_system->capture_frame(&rx_frame, &length) > 0)
+            dispatch_rx_frame(rx_frame, length);
+
+        return 0;
+    }
+
+    uint32_t batch_size = netif_obj_in_system->rx_batch_size();
+    if (batch_size <= 1)
+    {
+        if (netif_obj_in_system->capture_frame(&rx_frame, &length) > 0)
+            dispatch_rx_frame(rx_frame, length);
+
+        return 0;
+    }
+
+    // Drain the socket with recvmmsg() until it would block so that a burst of frames costs
+    // one epoll_wait() round trip instead of one per frame.
+    if (rx_batch_frames.size() != batch_size)
+    {
+        rx_batch_frames.resize(batch_size);
+        rx_batch_lengths.resize(batch_size);
+    }
+
+    int count;
+    while ((count = netif_obj_in_system->capture_frame_batch(&rx_batch_frames[0], &rx_batch_lengths[0])) > 0)
+    {
+        for (int i = 0; i < count; i++)
+            dispatch_rx_frame(rx_batch_frames[i], rx_batch_lengths[i]);
+
+        if ((uint32_t)count < batch_size)
+            break;
+    }
+
+    return 0;
+}
+
+void system_layer2_multithreaded_callback::proc_rx_frame(const uint8_t * rx_frame, uint16_t length)
+{
+    bool is_notification_id_valid = false;
+    int rx_status = -1;
+    void * notification_id = NULL;
+    uint16_t operation_id = 0;
+    bool is_operation_id_valid = false;
+
+    controller_ref_in_system->rx_packet_event(notification_id,
+                                              is_notification_id_valid,
+                                              rx_frame,
+                                              length,
+                                              rx_status,
+                                              operation_id,
+                                              is_operation_id_valid);
+
+    if (is_notification_id_valid)
+        wait_mgr->resp_received(notification_id, rx_status);
+}
+
+void system_layer2_multithreaded_callback::dispatch_rx_frame(const uint8_t * rx_frame, uint16_t length)
+{
+    size_t ticket;
+
+    if (rx_workers.empty())
+    {
+        proc_rx_frame(rx_frame, length);
+        return;
+    }
+
+    if (length > RX_FRAME_SIZE)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "dispatch_rx_frame: frame too large");
+        return;
+    }
+
+    // Entity ids of one vendor share their upper bytes, so the bits are mixed before the worker is chosen
+    uint64_t key = controller_ref_in_system->rx_frame_entity_id(rx_frame, length) * UINT64_C(0x9E3779B97F4A7C15);
+    struct rx_worker * w = rx_workers[(size_t)(key >> 32) % rx_workers.size()];
+
+    // A full queue holds back the socket rather than dropping the frame
+    while (!w->queue.try_acquire(ticket))
+    {
+        wake_rx_worker(w);
+        sched_yield();
+    }
+
+    struct rx_data & r = w->queue.slot(ticket);
+    r.length = length;
+    memcpy(r.frame, rx_frame, length);
+    w->queue.publish(ticket);
+
+    wake_rx_worker(w);
+}
+
+void system_layer2_multithreaded_callback::wake_rx_worker(struct rx_worker * w)
+{
+    if (!w->event_pending.exchange(true))
+    {
+        uint64_t one = 1;
+        write(w->event_fd, &one, sizeof(one));
+    }
+}
+
+void system_layer2_multithreaded_callback::proc_rx_worker(struct rx_worker * w)
+{
+    struct rx_data * r;
+    uint64_t count;
+
+    while (!rx_workers_stop.load())
+    {
+        if (read(w->event_fd, &count, sizeof(count)) < 0 && errno != EINTR)
+            break;
+
+        // Clear the flag before draining so that a frame queued while draining either gets
+        // picked up below or raises a fresh wakeup.
+        w->event_pending.store(false);
+
+        if (w->queue.front() == NULL)
+            continue;
+
+        while ((r = w->queue.front()) != NULL)
+        {
+            proc_rx_frame(r->frame, r->length);
+            w->queue.pop();
+        }
+
+        // Commands sent by the state machines while processing the frames go out together
+        if (netif_obj_in_system->flush_tx_frames() < 0)
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "netif_send_frame error");
+
+        // The frames can have brought the earliest timeout forward, so the poll thread re-arms its timer
+        wake_tx();
+    }
+}
+
+void * system_layer2_multithreaded_callback::rx_worker_fn(void * param)
+{
+    struct rx_worker * w = (struct rx_worker *)param;
+    w->system->proc_rx_worker(w);
 
-    if (status > 0)
+    return 0;
+}
+
+int system_layer2_multithreaded_callback::start_rx_workers()
+{
+    for (uint32_t i = 0; i < rx_worker_count; i++)
     {
-        bool is_notification_id_valid = false;
-        int rx_status = -1;
-        void * notification_id = NULL;
-        uint16_t operation_id = 0;
-        bool is_operation_id_valid = false;
-
-        controller_ref_in_system->rx_packet_event(notification_id,
-                                                  is_notification_id_valid,
-                                                  rx_frame,
-                                                  length,
-                                                  rx_status,
-                                                  operation_id,
-                                                  is_operation_id_valid);
-
-        if (
-            wait_mgr->active_state() &&
-            is_notification_id_valid &&
-            wait_mgr->match_id(notification_id) &&
-            !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-            !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
+        struct rx_worker * w = new rx_worker(this);
+
+        w->event_fd = eventfd(0, 0);
+        if (w->event_fd == -1)
         {
-            int status = wait_mgr->set_completion_status(rx_status);
-            assert(status == 0);
-            sem_post(waiting_sem);
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "RX worker eventfd error");
+            delete w;
+            return -1;
         }
+
+        if (pthread_create(&w->thread, NULL, &system_layer2_multithreaded_callback::rx_worker_fn, (void *)w) != 0)
+        {
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "RX worker pthread_create error");
+            close(w->event_fd);
+            delete w;
+            return -1;
+        }
+
+        rx_workers.push_back(w);
     }
+
     return 0;
 }
 
+void system_layer2_multithreaded_callback::stop_rx_workers()
+{
+    uint64_t one = 1;
+
+    rx_workers_stop.store(true);
+    for (size_t i = 0; i < rx_workers.size(); i++)
+    {
+        write(rx_workers[i]->event_fd, &one, sizeof(one));
+        pthread_join(rx_workers[i]->thread, NULL);
+        close(rx_workers[i]->event_fd);
+        delete rx_workers[i];
+    }
+
+    rx_workers.clear();
+}
+
 int system_layer2_multithreaded_callback::prep_evt_desc(
     int fd,
     handler_fn fn,
@@ -331,12 +583,13 @@ int system_layer2_multithreaded_callback::proc_poll_loop()
     prep_evt_desc(netif_obj_in_system->get_fd(), &system_layer2_multithreaded_callback::fn_netif_cb, &fd_fns[1], &ev);
     epoll_ctl(epollfd, EPOLL_CTL_ADD, fd_fns[1].fd, &ev);
 
-    prep_evt_desc(tx_pipe[PIPE_RD], &system_layer2_multithreaded_callback::fn_tx_cb, &fd_fns[2],
+    prep_evt_desc(tx_event_fd, &system_layer2_multithreaded_callback::fn_tx_cb, &fd_fns[2],
                   &ev);
     epoll_ctl(epollfd, EPOLL_CTL_ADD, fd_fns[2].fd, &ev);
 
     fcntl(fd_fns[0].fd, F_SETFL, O_NONBLOCK);
-    timer_start_interval(fd_fns[0].fd);
+    timer_deadline_ms = 0;
+    timer_update_deadline(fd_fns[0].fd);
 
     do
     {
@@ -361,6 +614,14 @@ int system_layer2_multithreaded_callback::proc_poll_loop()
             if (priv->fn(priv) < 0)
                 return -1;
         }
+
+        // Frames produced while handling these events go out together before the loop goes idle
+        if (netif_obj_in_system->flush_tx_frames() < 0)
+            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "netif_send_frame error");
+
+        // Sleep until the earliest timeout registered by the state machines instead of waking
+        // on a fixed period
+        timer_update_deadline(fd_fns[0].fd);
     } while (1);
     return 0;
 }
@@ -376,6 +637,14 @@ int STDCALL system_layer2_multithreaded_callback::process_start()
 {
     int rc;
 
+    // The workers are started first, as the poll thread hands them frames as soon as it runs
+    if (start_rx_workers() < 0)
+    {
+        stop_rx_workers();
+        return -1;
+    }
+
+    process_started = true;
     rc = pthread_create(&h_thread, NULL, &system_layer2_multithreaded_callback::thread_fn, (void *)this);
     if (rc)
     {
@@ -390,4 +659,16 @@ int STDCALL system_layer2_multithreaded_callback::process_close()
 
     return 0;
 }
+
+int STDCALL system_layer2_multithreaded_callback::set_rx_worker_count(uint32_t worker_count)
+{
+    if (process_started)
+    {
+        log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "set_rx_worker_count must be called before process_start");
+        return -1;
+    }
+
+    rx_worker_count = worker_count;
+    return 0;
+}
 }
@@ -30,10 +30,15 @@
 #pragma once
 
 #include <sys/epoll.h>
+#include <vector>
+#include <mutex>
+#include <atomic>
 
 #include "avdecc_lib_os.h"
 #include "system.h"
 #include "cmd_wait_mgr.h"
+#include "mpsc_ring.h"
+#include "system_tx_queue.h"
 
 namespace avdecc_lib
 {
@@ -63,6 +68,13 @@ public:
     ///
     int queue_tx_frame(void * notification_id, uint32_t notification_flag, uint8_t * frame, size_t mem_buf_len);
 
+    ///
+    /// Store the frames to be sent in the queue, waking the poll thread once.
+    ///
+    /// \return The number of frames queued.
+    ///
+    size_t queue_tx_frames(const struct system_tx_entry * entries, size_t count);
+
     ///
     /// Set a waiting flag for the command sent.
     ///
@@ -83,6 +95,8 @@ public:
     ///
     int STDCALL process_close();
 
+    int STDCALL set_rx_worker_count(uint32_t worker_count);
+
 private:
     static system_layer2_multithreaded_callback * instance;
     struct epoll_priv;
@@ -94,29 +108,49 @@ private:
         handler_fn fn;
     };
 
+    enum useful_enums
+    {
+        POLL_COUNT = 3,
+        TX_FRAME_SIZE = 2048,
+        TX_QUEUE_SLOTS = 1024,
+        RX_FRAME_SIZE = 2048,
+        RX_QUEUE_SLOTS = 1024
+    };
+
     struct tx_data
     {
-        uint8_t * frame;
         size_t mem_buf_len;
         void * notification_id;
         uint32_t notification_flag;
+        uint8_t frame[TX_FRAME_SIZE];
     };
 
-    enum useful_enums
+    struct rx_data
     {
-        PIPE_RD = 0,
-        PIPE_WR = 1,
-        POLL_COUNT = 3,
-        TIME_PERIOD_25_MILLISECONDS = 25
+        uint16_t length;
+        uint8_t frame[RX_FRAME_SIZE];
+    };
+
+    struct rx_worker
+    {
+        system_layer2_multithreaded_callback * system;
+        pthread_t thread;
+        mpsc_ring<struct rx_data> queue; // Frames of the End Stations of this worker, queued by the poll thread
+        int event_fd;                    // eventfd that wakes the worker when the queue is filled
+        std::atomic<bool> event_pending; // Set while a wakeup is outstanding to avoid redundant writes
+
+        rx_worker(system_layer2_multithreaded_callback * s) : system(s), queue(RX_QUEUE_SLOTS), event_fd(-1), event_pending(false) {}
     };
 
     pthread_t h_thread;
 
     //int network_fd;
-    int tx_pipe[2];
+    mpsc_ring<struct tx_data> tx_queue; // Frames queued by any thread, transmitted by the poll thread
+    std::recursive_mutex tx_consumer;   // Held by the one thread draining tx_queue, which can queue a frame meanwhile
+    int tx_event_fd;                    // eventfd that wakes the poll thread when tx_queue is filled
+    std::atomic<bool> tx_event_pending; // Set while a wakeup is outstanding to avoid redundant writes
     //int tick_timer;
 
-    sem_t * waiting_sem;
     sem_t * shutdown_sem;
 
     // Events to process:
@@ -125,7 +159,17 @@ private:
     // Timer tick - from timer
 
     cmd_wait_mgr * wait_mgr;
-    int resp_status_for_cmd;
+
+    uint64_t timer_deadline_ms; // Deadline the tick timerfd is armed for, 0 when disarmed
+    std::vector<void *> tick_timed_out; // Notification ids of the commands removed by the last timer tick
+
+    std::vector<const uint8_t *> rx_batch_frames; // Frames returned by the last recvmmsg() batch
+    std::vector<uint16_t> rx_batch_lengths;
+
+    bool process_started;
+    uint32_t rx_worker_count;
+    std::vector<struct rx_worker *> rx_workers; // Empty when every frame is processed by the poll thread
+    std::atomic<bool> rx_workers_stop;
     int prep_evt_desc(int fd, handler_fn fn, struct epoll_priv * priv, struct epoll_event * ev);
     static int fn_timer_cb(struct epoll_priv * priv);
     static int fn_netif_cb(struct epoll_priv * priv);
@@ -133,7 +177,30 @@ private:
     int fn_timer(struct epoll_priv * priv);
     int fn_netif(struct epoll_priv * priv);
     int fn_tx(struct epoll_priv * priv);
-    int timer_start_interval(int timerfd);
+    void proc_tx_queue();
+
+    ///
+    /// Copy a frame into the next free slot of the TX queue, waiting for a slot if the queue is full.
+    ///
+    void push_tx_frame(void * notification_id, uint32_t notification_flag, const uint8_t * frame, size_t mem_buf_len);
+
+    ///
+    /// Wake the poll thread to transmit the queued frames.
+    ///
+    void wake_tx();
+    void proc_rx_frame(const uint8_t * rx_frame, uint16_t length);
+
+    ///
+    /// Process a received frame, or queue it to the worker of its End Station if there are RX workers.
+    ///
+    void dispatch_rx_frame(const uint8_t * rx_frame, uint16_t length);
+    void wake_rx_worker(struct rx_worker * w);
+    int start_rx_workers();
+    void stop_rx_workers();
+    void proc_rx_worker(struct rx_worker * w);
+    static void * rx_worker_fn(void * param);
+    int timer_arm_deadline(int timerfd, uint64_t deadline_ms);
+    void timer_update_deadline(int timerfd);
 
     void * proc_poll_thread(void * p);
     int proc_poll_loop();
@@ -65,18 +65,21 @@ void log::post_log_msg(int32_t level, const char * fmt, ...)
     {
         va_list arglist;
         uint32_t index;
+        std::lock_guard<std::mutex> guard(post_locker);
 
-        if ((write_index - read_index) > LOG_BUF_COUNT)
+        // A full buffer drops the message rather than overwrite one not yet dispatched
+        if ((write_index - read_index) >= LOG_BUF_COUNT)
         {
             missed_log_event_cnt++;
             return;
         }
-        index = InterlockedExchangeAdd(&write_index, 1);
+        index = write_index;
         va_start(arglist, fmt);
         vsprintf_s(log_buf[index % LOG_BUF_COUNT].msg, sizeof(log_buf[0].msg), fmt, arglist); // Write to log_buf using write_index
         va_end(arglist);
         log_buf[index % LOG_BUF_COUNT].level = level;
         log_buf[index % LOG_BUF_COUNT].time_stamp_ms = 0;
+        write_index = index + 1; // Published once the entry is complete
 
         post_log_event();
     }
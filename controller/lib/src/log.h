@@ -30,6 +30,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <mutex>
+#include <atomic>
 #include "avdecc-lib_build.h"
 
 namespace avdecc_lib
@@ -38,8 +40,8 @@ class log
 {
 protected:
     int32_t log_level; // The base log level for messages to be logged
-    uint32_t read_index;
-    uint32_t write_index;
+    std::atomic<uint32_t> read_index;
+    std::atomic<uint32_t> write_index;
     void (*callback_func)(void *, int32_t, const char *, int32_t);
     void * user_obj;
     uint32_t missed_log_event_cnt; // The number of missed log that exceeds the log buffer count.
@@ -57,6 +59,7 @@ protected:
     };
 
     struct log_data log_buf[LOG_BUF_COUNT];
+    std::mutex post_locker; // Keeps the messages in buffer order when they are posted by more than one thread
 
 public:
     log();
@@ -0,0 +1,163 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * mpsc_ring.h
+ *
+ * Bounded multi-producer single-consumer ring of preallocated slots.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <vector>
+
+namespace avdecc_lib
+{
+///
+/// A fixed capacity queue that any number of threads can fill and one thread drains.
+///
+/// Each slot carries a sequence number that tells producers when the slot is free and the
+/// consumer when it holds a published entry, so neither side takes a lock or allocates memory.
+///
+template <typename T>
+class mpsc_ring
+{
+private:
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::vector<cell> cells;
+    size_t mask;
+    std::atomic<size_t> enqueue_pos;
+    size_t dequeue_pos; // Only touched by the consumer
+
+    mpsc_ring(const mpsc_ring &);
+    mpsc_ring & operator=(const mpsc_ring &);
+
+public:
+    ///
+    /// Constructor for mpsc_ring. The capacity is rounded up to a power of two.
+    ///
+    explicit mpsc_ring(size_t capacity)
+        : enqueue_pos(0), dequeue_pos(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        std::vector<cell> storage(size);
+        cells.swap(storage);
+        mask = size - 1;
+
+        for (size_t i = 0; i < size; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ///
+    /// \return The number of slots in the ring.
+    ///
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+    ///
+    /// Claim a free slot. Called by producers.
+    ///
+    /// \param ticket Set to the claimed position, which is passed to slot() and publish().
+    ///
+    /// \return False if the ring is full.
+    ///
+    bool try_acquire(size_t & ticket)
+    {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell & c = cells[pos & mask];
+            size_t seq = c.sequence.load(std::memory_order_acquire);
+            ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+
+            if (diff == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    ticket = pos;
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    ///
+    /// \return The slot claimed with try_acquire().
+    ///
+    T & slot(size_t ticket)
+    {
+        return cells[ticket & mask].data;
+    }
+
+    ///
+    /// Hand a filled slot to the consumer. Called by producers.
+    ///
+    void publish(size_t ticket)
+    {
+        cells[ticket & mask].sequence.store(ticket + 1, std::memory_order_release);
+    }
+
+    ///
+    /// \return The oldest published entry, or NULL if the ring is empty. Called by the consumer.
+    ///
+    T * front()
+    {
+        cell & c = cells[dequeue_pos & mask];
+
+        if (c.sequence.load(std::memory_order_acquire) != dequeue_pos + 1)
+            return NULL;
+
+        return &c.data;
+    }
+
+    ///
+    /// Release the entry returned by front() back to the producers. Called by the consumer.
+    ///
+    void pop()
+    {
+        cells[dequeue_pos & mask].sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+        dequeue_pos++;
+    }
+};
+}
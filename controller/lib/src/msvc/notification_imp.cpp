@@ -79,14 +79,7 @@ int notification_imp::proc_notification_thread_callback()
         {
             if ((write_index - read_index) > 0)
             {
-                notification_callback(user_obj,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_type,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].entity_id,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_type,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_type,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_index,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_status,
-                                      notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_id); // Call callback function
+                dispatch_notification(notification_buf[read_index % NOTIFICATION_BUF_COUNT]);
                 read_index++;
             }
         }
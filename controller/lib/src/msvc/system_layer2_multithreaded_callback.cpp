@@ -34,6 +34,7 @@
 #include "log_imp.h"
 #include "end_station_imp.h"
 #include "controller_imp.h"
+#include "cmd_completion_imp.h"
 #include "system_message_queue.h"
 #include "system_tx_queue.h"
 #include "system_layer2_multithreaded_callback.h"
@@ -56,6 +57,18 @@ size_t system_queue_tx(void * notification_id, uint32_t notification_flag, uint8
     }
 }
 
+size_t system_queue_tx_batch(const struct system_tx_entry * entries, size_t count)
+{
+    if (local_system)
+    {
+        return local_system->queue_tx_frames(entries, count);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
 system * STDCALL create_system(system::system_type type, net_interface * netif, controller * controller_obj)
 {
     (void)type; //unused
@@ -66,8 +79,6 @@ system * STDCALL create_system(system::system_type type, net_interface * netif,
 
 system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_interface * netif, controller * controller_obj)
 {
-    wait_mgr = new cmd_wait_mgr();
-
     netif_obj_in_system = netif;
     controller_obj_in_system = dynamic_cast<controller_imp *>(controller_obj);
     if (!controller_obj_in_system)
@@ -75,6 +86,8 @@ system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_i
         log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Dynamic cast from base controller to derived controller_imp error");
     }
 
+    wait_mgr = new cmd_wait_mgr(controller_obj_in_system);
+
     tick_timer.start(NETIF_READ_TIMEOUT_MS);
 }
 
@@ -82,6 +95,7 @@ system_layer2_multithreaded_callback::~system_layer2_multithreaded_callback()
 {
     delete poll_rx.rx_queue;
     delete poll_tx.tx_queue;
+    delete wait_mgr;
 }
 
 void STDCALL system_layer2_multithreaded_callback::destroy()
@@ -107,23 +121,34 @@ int system_layer2_multithreaded_callback::queue_tx_frame(void * notification_id,
     memcpy(thread_data.frame, frame, frame_len);
     thread_data.notification_id = notification_id;
     thread_data.notification_flag = notification_flag;
+    cmd_completions_ref->cmd_queued(notification_id, notification_flag);
+
+    //A waiting thread becomes a waiter before the command is queued, so that its completion cannot be missed
+    bool wait_for_completion = (notification_flag == CMD_WITH_NOTIFICATION) && wait_mgr->set_active_state(notification_id);
     poll_tx.tx_queue->queue_push(&thread_data);
 
-    //Check for conditions that cause wait for completion.
-    if (wait_mgr->primed_state() &&
-        wait_mgr->match_id(notification_id) &&
-        (notification_flag == CMD_WITH_NOTIFICATION))
+    if (wait_for_completion)
+        wait_mgr->wait_for_completion();
+    return 0;
+}
+
+size_t system_layer2_multithreaded_callback::queue_tx_frames(const struct system_tx_entry * entries, size_t count)
+{
+    struct poll_thread_data thread_data;
+
+    for (size_t i = 0; i < count; i++)
     {
-        int status = 0;
-
-        status = wait_mgr->set_active_state();
-        assert(status == 0);
-        WaitForSingleObject(waiting_sem, INFINITE);
-        resp_status_for_cmd = wait_mgr->get_completion_status();
-        status = wait_mgr->set_idle_state();
-        assert(status == 0);
+        assert(entries[i].frame_len < 2048);
+        thread_data.frame = new uint8_t[2048];
+        thread_data.frame_len = entries[i].frame_len;
+        memcpy(thread_data.frame, entries[i].frame, entries[i].frame_len);
+        thread_data.notification_id = entries[i].notification_id;
+        thread_data.notification_flag = entries[i].notification_flag;
+        cmd_completions_ref->cmd_queued(thread_data.notification_id, thread_data.notification_flag);
+        poll_tx.tx_queue->queue_push(&thread_data);
     }
-    return 0;
+
+    return count;
 }
 
 int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * id)
@@ -134,7 +159,7 @@ int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * i
 
 int STDCALL system_layer2_multithreaded_callback::get_last_resp_status()
 {
-    return resp_status_for_cmd;
+    return wait_mgr->get_completion_status();
 }
 
 DWORD WINAPI system_layer2_multithreaded_callback::proc_wpcap_thread(LPVOID lpParam)
@@ -242,8 +267,6 @@ int system_layer2_multithreaded_callback::init_wpcap_thread()
 
     poll_events_array[KILL_ALL] = CreateEvent(NULL, FALSE, FALSE, NULL);
 
-    waiting_sem = CreateSemaphore(NULL, 0, 32767, NULL);
-
     return 0;
 }
 
@@ -300,17 +323,8 @@ int system_layer2_multithreaded_callback::poll_single()
                                                   operation_id,
                                                   is_operation_id_valid);
 
-        if (
-            wait_mgr->active_state() &&
-            is_notification_id_valid &&
-            wait_mgr->match_id(thread_data.notification_id) &&
-            !controller_obj_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-            !controller_obj_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-        {
-            int status = wait_mgr->set_completion_status(rx_status);
-            assert(status == 0);
-            ReleaseSemaphore(waiting_sem, 1, NULL);
-        }
+        if (is_notification_id_valid)
+            wait_mgr->resp_received(thread_data.notification_id, rx_status);
         delete[] thread_data.frame;
     }
     break;
@@ -323,6 +337,7 @@ int system_layer2_multithreaded_callback::poll_single()
                                                   thread_data.frame,
                                                   thread_data.frame_len);
         delete[] thread_data.frame;
+        cmd_completions_ref->complete_sent();
         break;
 
     case WAIT_OBJECT_0 + KILL_ALL: // Exit or kill event
@@ -332,30 +347,10 @@ int system_layer2_multithreaded_callback::poll_single()
 
     if (tick_timer.timeout()) // Check tick timeout
     {
-        bool notification_id_incomplete = false;
-
-        if (wait_mgr->active_state())
-        {
-            if (controller_obj_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) ||
-                controller_obj_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-                notification_id_incomplete = true;
-        }
-
-        // If waiting on a command to complete and the command was "inflight" prior to calling the
-        // timer tick update (ie notification_id_incomplete == true) AND after calling the timer tick
-        // update the command is no longer "inflight", timeout processing has removed it, so signal the
-        // waiting app thread.
+        // Waiters whose commands are removed by timeout processing are released with a timeout status
+        wait_mgr->tick_begin();
         controller_obj_in_system->time_tick_event();
-
-        bool is_timeout_for_waiting_notify_id = wait_mgr->active_state() && notification_id_incomplete &&
-                                                !controller_obj_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                                                !controller_obj_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id());
-        if (is_timeout_for_waiting_notify_id)
-        {
-            int status = wait_mgr->set_completion_status(AVDECC_LIB_STATUS_TICK_TIMEOUT);
-            assert(status == 0);
-            ReleaseSemaphore(waiting_sem, 1, NULL);
-        }
+        wait_mgr->tick_end();
 
         tick_timer.start(NETIF_READ_TIMEOUT_MS);
     }
@@ -385,4 +380,13 @@ int STDCALL system_layer2_multithreaded_callback::process_close()
 
     return 0;
 }
+
+int STDCALL system_layer2_multithreaded_callback::set_rx_worker_count(uint32_t worker_count)
+{
+    if (worker_count == 0)
+        return 0;
+
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "RX workers are not supported on this platform");
+    return -1;
+}
 }
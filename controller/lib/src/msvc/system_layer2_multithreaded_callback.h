@@ -32,6 +32,7 @@
 #include "system.h"
 #include "timer.h"
 #include "cmd_wait_mgr.h"
+#include "system_tx_queue.h"
 
 namespace avdecc_lib
 {
@@ -75,10 +76,8 @@ private:
     struct msg_poll poll_tx;
     struct thread_creation poll_thread;
     HANDLE poll_events_array[NUM_OF_EVENTS];
-    HANDLE waiting_sem;
 
     cmd_wait_mgr * wait_mgr;
-    int resp_status_for_cmd;
     timer tick_timer; // A tick timer that is always running
 
 public:
@@ -100,6 +99,13 @@ public:
     ///
     int queue_tx_frame(void * notification_id, uint32_t notification_flag, uint8_t * frame, size_t frame_len);
 
+    ///
+    /// Store the frames to be sent in the queue.
+    ///
+    /// \return The number of frames queued.
+    ///
+    size_t queue_tx_frames(const struct system_tx_entry * entries, size_t count);
+
     ///
     /// Set a waiting flag for the next command sent.
     ///
@@ -120,6 +126,11 @@ public:
     ///
     int STDCALL process_close();
 
+    ///
+    /// Received frames are always processed by the system thread on this platform.
+    ///
+    int STDCALL set_rx_worker_count(uint32_t worker_count);
+
 private:
     ///
     /// Create and initialize threads, events, and semaphores for wpcap thread.
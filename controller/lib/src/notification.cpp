@@ -61,8 +61,10 @@ notification::~notification() {}
 void notification::post_notification_msg(int32_t notification_type, uint64_t entity_id, uint16_t cmd_type, uint16_t desc_type, uint16_t desc_index, uint32_t cmd_status, void * notification_id)
 {
     uint32_t index;
+    std::lock_guard<std::mutex> guard(post_locker);
 
-    if ((write_index - read_index) > NOTIFICATION_BUF_COUNT)
+    // A full buffer drops the notification rather than overwrite one not yet dispatched
+    if ((write_index - read_index) >= NOTIFICATION_BUF_COUNT)
     {
         missed_notification_event_cnt++;
         return;
@@ -73,7 +75,7 @@ void notification::post_notification_msg(int32_t notification_type, uint64_t ent
         notification_type == RESPONSE_RECEIVED || notification_type == END_STATION_READ_COMPLETED ||
         notification_type == UNSOLICITED_RESPONSE_RECEIVED)
     {
-        index = InterlockedExchangeAdd(&write_index, 1);
+        index = write_index;
         notification_buf[index % NOTIFICATION_BUF_COUNT].notification_type = notification_type;
         notification_buf[index % NOTIFICATION_BUF_COUNT].entity_id = entity_id;
         notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_type = cmd_type;
@@ -81,11 +83,74 @@ void notification::post_notification_msg(int32_t notification_type, uint64_t ent
         notification_buf[index % NOTIFICATION_BUF_COUNT].desc_index = desc_index;
         notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_status = cmd_status;
         notification_buf[index % NOTIFICATION_BUF_COUNT].notification_id = notification_id;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].bulk = false;
+        write_index = index + 1; // Published once the entry is complete
 
         post_notification_event();
     }
 }
 
+void notification::post_notification_msgs(int32_t notification_type, const std::vector<uint64_t> & entity_ids)
+{
+    uint32_t index;
+
+    if (entity_ids.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(post_locker);
+
+        if ((write_index - read_index) >= NOTIFICATION_BUF_COUNT)
+        {
+            missed_notification_event_cnt += (uint32_t)entity_ids.size();
+            return;
+        }
+
+        // One entry of the buffer stands for all the entities, so that they keep their place among the other notifications
+        bulk_entity_ids.push_back(entity_ids);
+
+        index = write_index;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].notification_type = notification_type;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].entity_id = 0;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_type = 0;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].desc_type = 0;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].desc_index = 0;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_status = 0;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].notification_id = NULL;
+        notification_buf[index % NOTIFICATION_BUF_COUNT].bulk = true;
+        write_index = index + 1;
+    }
+
+    post_notification_event();
+}
+
+void notification::dispatch_notification(const struct notification_data & n)
+{
+    std::vector<uint64_t> entity_ids;
+
+    if (!n.bulk)
+    {
+        notification_callback(user_obj,
+                              n.notification_type,
+                              n.entity_id,
+                              n.cmd_type,
+                              n.desc_type,
+                              n.desc_index,
+                              n.cmd_status,
+                              n.notification_id);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(post_locker);
+        entity_ids.swap(bulk_entity_ids.front());
+        bulk_entity_ids.pop_front();
+    }
+
+    for (size_t i = 0; i < entity_ids.size(); i++)
+        notification_callback(user_obj, n.notification_type, entity_ids[i], 0, 0, 0, 0, NULL);
+}
+
 void notification::set_notification_callback(void (*new_notification_callback)(void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *), void * p)
 {
     notification_callback = new_notification_callback;
@@ -30,6 +30,10 @@
 #pragma once
 
 #include <stdint.h>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
 
 namespace avdecc_lib
 {
@@ -45,6 +49,14 @@ public:
     ///
     void post_notification_msg(int32_t notification_type, uint64_t entity_id, uint16_t cmd_type, uint16_t desc_type, uint16_t desc_index, uint32_t cmd_status, void * notification_id);
 
+    ///
+    /// Generate a notification message of notification_type for every entity in entity_ids, such as
+    /// END_STATION_DISCONNECTED when a number of End Stations depart together. The messages take a
+    /// single entry of the notification buffer, so that a burst of them is not missed, and are
+    /// delivered in order with the other notifications.
+    ///
+    void post_notification_msgs(int32_t notification_type, const std::vector<uint64_t> & entity_ids);
+
     ///
     /// Change the notification callback function to a new post_notification_msg callback function.
     ///
@@ -57,8 +69,8 @@ public:
 
 protected:
     int32_t notifications;
-    uint32_t read_index;
-    uint32_t write_index;
+    std::atomic<uint32_t> read_index; // Advanced by the dispatch thread once it has delivered the entry
+    std::atomic<uint32_t> write_index;
     void (*notification_callback)(void *, int32_t, uint64_t, uint16_t, uint16_t, uint16_t, uint32_t, void *);
     void (*acmp_notification_callback)(void *, int32_t, uint16_t, uint64_t, uint16_t, uint64_t, uint16_t, uint32_t, void *);
     void * user_obj;
@@ -78,9 +90,19 @@ protected:
         uint16_t desc_index;
         uint32_t cmd_status;
         void * notification_id;
+        bool bulk; // Posted by post_notification_msgs(), for the entities at the front of bulk_entity_ids
     };
 
     struct notification_data notification_buf[NOTIFICATION_BUF_COUNT];
+    std::mutex post_locker; // Keeps the notifications in buffer order when they are posted by more than one thread
+
+    std::deque<std::vector<uint64_t> > bulk_entity_ids; // Entities of every bulk entry of the buffer, in buffer order
+
+    ///
+    /// Call the notification callback for an entry of the notification buffer, once for every
+    /// entity of a bulk entry. Called by the notification thread.
+    ///
+    void dispatch_notification(const struct notification_data & n);
 
     ///
     /// Release sempahore so that notification callback function is called.
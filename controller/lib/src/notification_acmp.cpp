@@ -65,8 +65,10 @@ void notification_acmp::post_acmp_notification_msg(int32_t notification_type, ui
                                                    uint16_t listener_unique_id, uint32_t cmd_status, void * notification_id)
 {
     uint32_t index;
+    std::lock_guard<std::mutex> guard(post_locker);
 
-    if ((write_index - read_index) > NOTIFICATION_BUF_COUNT)
+    // A full buffer drops the notification rather than overwrite one not yet dispatched
+    if ((write_index - read_index) >= NOTIFICATION_BUF_COUNT)
     {
         missed_notification_event_cnt++;
         return;
@@ -75,7 +77,7 @@ void notification_acmp::post_acmp_notification_msg(int32_t notification_type, ui
     if (notification_type == BROADCAST_ACMP_RESPONSE_RECEIVED ||
         notification_type == ACMP_RESPONSE_RECEIVED)
     {
-        index = InterlockedExchangeAdd(&write_index, 1);
+        index = write_index;
         notification_buf[index % NOTIFICATION_BUF_COUNT].notification_type = notification_type;
         notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_type = cmd_type;
         notification_buf[index % NOTIFICATION_BUF_COUNT].talker_entity_id = talker_entity_id;
@@ -84,6 +86,7 @@ void notification_acmp::post_acmp_notification_msg(int32_t notification_type, ui
         notification_buf[index % NOTIFICATION_BUF_COUNT].listener_unique_id = listener_unique_id;
         notification_buf[index % NOTIFICATION_BUF_COUNT].cmd_status = cmd_status;
         notification_buf[index % NOTIFICATION_BUF_COUNT].notification_id = notification_id;
+        write_index = index + 1; // Published once the entry is complete
 
         post_acmp_notification_event();
     }
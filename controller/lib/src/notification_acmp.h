@@ -30,6 +30,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
+#include <mutex>
 
 namespace avdecc_lib
 {
@@ -63,8 +65,8 @@ public:
 
 protected:
     int32_t notifications;
-    uint32_t read_index;
-    uint32_t write_index;
+    std::atomic<uint32_t> read_index;
+    std::atomic<uint32_t> write_index;
     void (*acmp_notification_callback)(void *, int32_t, uint16_t, uint64_t, uint16_t, uint64_t, uint16_t, uint32_t, void *);
     void * user_obj;
     uint32_t missed_notification_event_cnt;
@@ -87,6 +89,7 @@ protected:
     };
 
     struct acmp_notification_data notification_buf[NOTIFICATION_BUF_COUNT];
+    std::mutex post_locker; // Keeps the notifications in buffer order when they are posted by more than one thread
 
     ///
     /// Release sempahore so that notification callback function is called.
@@ -385,6 +385,46 @@ int STDCALL net_interface_imp::capture_frame(const uint8_t ** frame, uint16_t *
     return error;
 }
 
+int STDCALL net_interface_imp::set_rx_ring_enabled(bool enabled)
+{
+    return enabled ? -1 : 0;
+}
+
+bool STDCALL net_interface_imp::rx_ring_enabled()
+{
+    return false;
+}
+
+int STDCALL net_interface_imp::set_rx_batch_size(uint32_t frames)
+{
+    return (frames <= 1) ? 0 : -1;
+}
+
+int STDCALL net_interface_imp::get_rx_batch_stats(struct frame_batch_stats & stats)
+{
+    stats = frame_batch_stats();
+    return -1;
+}
+
+void STDCALL net_interface_imp::reset_rx_batch_stats()
+{
+}
+
+int STDCALL net_interface_imp::set_tx_batch_size(uint32_t frames)
+{
+    return (frames <= 1) ? 0 : -1;
+}
+
+int STDCALL net_interface_imp::get_tx_batch_stats(struct frame_batch_stats & stats)
+{
+    stats = frame_batch_stats();
+    return -1;
+}
+
+void STDCALL net_interface_imp::reset_tx_batch_stats()
+{
+}
+
 int net_interface_imp::send_frame(uint8_t * frame, uint16_t mem_buf_len)
 {
     if (pcap_sendpacket(pcap_interface, frame, mem_buf_len) != 0)
@@ -141,6 +141,28 @@ public:
     ///
     int STDCALL capture_frame(const uint8_t ** frame, uint16_t * mem_buf_len);
 
+    ///
+    /// The receive ring is only available on Linux.
+    ///
+    int STDCALL set_rx_ring_enabled(bool enabled);
+    bool STDCALL rx_ring_enabled();
+
+    ///
+    /// Frames are received one at a time, so only a batch size of 1 is accepted and no batch
+    /// counters are kept.
+    ///
+    int STDCALL set_rx_batch_size(uint32_t frames);
+    int STDCALL get_rx_batch_stats(struct frame_batch_stats & stats);
+    void STDCALL reset_rx_batch_stats();
+
+    ///
+    /// Frames are sent one at a time, so only a batch size of 1 is accepted and no batch
+    /// counters are kept.
+    ///
+    int STDCALL set_tx_batch_size(uint32_t frames);
+    int STDCALL get_tx_batch_stats(struct frame_batch_stats & stats);
+    void STDCALL reset_tx_batch_stats();
+
     ///
     /// Send a network packet.
     ///
@@ -94,14 +94,7 @@ void * notification_imp::dispatch_callbacks(void)
 
         if ((write_index - read_index) > 0)
         {
-            notification_callback(user_obj,
-                                  notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_type,
-                                  notification_buf[read_index % NOTIFICATION_BUF_COUNT].entity_id,
-                                  notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_type,
-                                  notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_type,
-                                  notification_buf[read_index % NOTIFICATION_BUF_COUNT].desc_index,
-                                  notification_buf[read_index % NOTIFICATION_BUF_COUNT].cmd_status,
-                                  notification_buf[read_index % NOTIFICATION_BUF_COUNT].notification_id);
+            dispatch_notification(notification_buf[read_index % NOTIFICATION_BUF_COUNT]);
             read_index++;
         }
         else
@@ -33,6 +33,7 @@
 #include <stddef.h>
 #include <stdarg.h>
 #include <string.h>
+#include <limits.h>
 #include <syslog.h>
 #include <signal.h>
 #include <errno.h>
@@ -57,6 +58,7 @@
 #include "log_imp.h"
 #include "end_station_imp.h"
 #include "controller_imp.h"
+#include "cmd_completion_imp.h"
 #include "system_message_queue.h"
 #include "system_tx_queue.h"
 #include "system_layer2_multithreaded_callback.h"
@@ -82,6 +84,18 @@ size_t system_queue_tx(void * notification_id, uint32_t notification_flag, uint8
     }
 }
 
+size_t system_queue_tx_batch(const struct system_tx_entry * entries, size_t count)
+{
+    if (local_system)
+    {
+        return local_system->queue_tx_frames(entries, count);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
 system * STDCALL create_system(system::system_type type, net_interface * netif, controller * controller_obj)
 {
     (void)type;
@@ -97,13 +111,11 @@ system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_i
     controller_ref_in_system = dynamic_cast<controller_imp *>(controller_obj);
     pipe(tx_pipe);
 
-    wait_mgr = new cmd_wait_mgr();
+    wait_mgr = new cmd_wait_mgr(controller_ref_in_system);
 
-    sem_unlink("/waiting_sem");
     sem_unlink("/shutdown_sem");
 
-    if (((waiting_sem = sem_open("/waiting_sem", O_CREAT | O_EXCL, 0644, 0)) == SEM_FAILED) ||
-        ((shutdown_sem = sem_open("/shutdown_sem", O_CREAT | O_EXCL, 0644, 0)) == SEM_FAILED))
+    if ((shutdown_sem = sem_open("/shutdown_sem", O_CREAT | O_EXCL, 0644, 0)) == SEM_FAILED)
     {
         perror("sem_open");
         exit(-1);
@@ -112,8 +124,8 @@ system_layer2_multithreaded_callback::system_layer2_multithreaded_callback(net_i
 
 system_layer2_multithreaded_callback::~system_layer2_multithreaded_callback()
 {
-    sem_unlink("/waiting_sem");
     sem_unlink("/shutdown_sem");
+    delete wait_mgr;
 }
 
 void STDCALL system_layer2_multithreaded_callback::destroy()
@@ -150,27 +162,45 @@ int system_layer2_multithreaded_callback::queue_tx_frame(
     memcpy(t.frame, frame, mem_buf_len);
     t.notification_id = notification_id;
     t.notification_flag = notification_flag;
+    cmd_completions_ref->cmd_queued(notification_id, notification_flag);
+
+    // A waiting thread becomes a waiter before the command is queued, so that its completion cannot be missed
+    bool wait_for_completion = (notification_flag == CMD_WITH_NOTIFICATION) && wait_mgr->set_active_state(notification_id);
     write(tx_pipe[PIPE_WR], &t, sizeof(t));
 
-    // Check for conditions that cause wait for completion.
-    if (wait_mgr->primed_state() &&
-        wait_mgr->match_id(notification_id) &&
-        (notification_flag == CMD_WITH_NOTIFICATION))
+    if (wait_for_completion)
+        wait_mgr->wait_for_completion();
+
+    return 0;
+}
+
+size_t system_layer2_multithreaded_callback::queue_tx_frames(const struct system_tx_entry * entries, size_t count)
+{
+    // Writes of up to PIPE_BUF bytes are atomic, so frames queued by other threads cannot interleave
+    const size_t frames_per_write = PIPE_BUF / sizeof(struct tx_data);
+    std::vector<struct tx_data> pending;
+    pending.reserve(frames_per_write);
+
+    for (size_t i = 0; i < count; i++)
     {
-        int status = 0;
+        struct tx_data t;
+
+        t.frame = new uint8_t[2048];
+        t.mem_buf_len = entries[i].frame_len;
+        memcpy(t.frame, entries[i].frame, entries[i].frame_len);
+        t.notification_id = entries[i].notification_id;
+        t.notification_flag = entries[i].notification_flag;
+        cmd_completions_ref->cmd_queued(t.notification_id, t.notification_flag);
+        pending.push_back(t);
 
-        status = wait_mgr->set_active_state();
-        assert(status == 0);
-        if (sem_wait(waiting_sem) != 0)
+        if (pending.size() == frames_per_write || i + 1 == count)
         {
-            perror("sem_wait");
+            write(tx_pipe[PIPE_WR], &pending[0], pending.size() * sizeof(struct tx_data));
+            pending.clear();
         }
-        resp_status_for_cmd = wait_mgr->get_completion_status();
-        status = wait_mgr->set_idle_state();
-        assert(status == 0);
     }
 
-    return 0;
+    return count;
 }
 
 int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * id)
@@ -181,7 +211,7 @@ int STDCALL system_layer2_multithreaded_callback::set_wait_for_next_cmd(void * i
 
 int STDCALL system_layer2_multithreaded_callback::get_last_resp_status()
 {
-    return resp_status_for_cmd;
+    return wait_mgr->get_completion_status();
 }
 
 int system_layer2_multithreaded_callback::fn_timer_cb(struct kevent * priv)
@@ -199,31 +229,10 @@ int system_layer2_multithreaded_callback::fn_tx_cb(struct kevent * priv)
 
 int system_layer2_multithreaded_callback::fn_timer(struct kevent * priv)
 {
-    bool notification_id_incomplete = false;
-
-    if (wait_mgr->active_state())
-    {
-        if (controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) ||
-            controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-            notification_id_incomplete = true;
-    }
-
-    // If waiting on a command to complete and the command was "inflight" prior to calling the
-    // timer tick update (ie notification_id_incomplete == true) AND after calling the timer tick
-    // update the command is no longer "inflight", timeout processing has removed it, so signal the
-    // waiting app thread.
-
+    // Waiters whose commands are removed by timeout processing are released with a timeout status
+    wait_mgr->tick_begin();
     controller_ref_in_system->time_tick_event();
-
-    bool is_timeout_for_waiting_notify_id = wait_mgr->active_state() && notification_id_incomplete &&
-                                            !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-                                            !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id());
-    if (is_timeout_for_waiting_notify_id)
-    {
-        int status = wait_mgr->set_completion_status(AVDECC_LIB_STATUS_TICK_TIMEOUT);
-        assert(status == 0);
-        sem_post(waiting_sem);
-    }
+    wait_mgr->tick_end();
 
     return 0;
 }
@@ -242,6 +251,7 @@ int system_layer2_multithreaded_callback::fn_tx(struct kevent * priv)
             t.mem_buf_len);
 
         delete[] t.frame;
+        cmd_completions_ref->complete_sent();
     }
 
     return 0;
@@ -272,17 +282,8 @@ int system_layer2_multithreaded_callback::fn_netif(struct kevent * priv)
                                                   operation_id,
                                                   is_operation_id_valid);
 
-        if (
-            wait_mgr->active_state() &&
-            is_notification_id_valid &&
-            wait_mgr->match_id(notification_id) &&
-            !controller_ref_in_system->is_inflight_cmd_with_notification_id(wait_mgr->get_notify_id()) &&
-            !controller_ref_in_system->is_active_operation_with_notification_id(wait_mgr->get_notify_id()))
-        {
-            int status = wait_mgr->set_completion_status(rx_status);
-            assert(status == 0);
-            sem_post(waiting_sem);
-        }
+        if (is_notification_id_valid)
+            wait_mgr->resp_received(notification_id, rx_status);
     }
     return 0;
 }
@@ -374,4 +375,13 @@ int STDCALL system_layer2_multithreaded_callback::process_close()
 
     return 0;
 }
+
+int STDCALL system_layer2_multithreaded_callback::set_rx_worker_count(uint32_t worker_count)
+{
+    if (worker_count == 0)
+        return 0;
+
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "RX workers are not supported on this platform");
+    return -1;
+}
 }
@@ -32,6 +32,7 @@
 #include "avdecc_lib_os.h"
 #include "system.h"
 #include "cmd_wait_mgr.h"
+#include "system_tx_queue.h"
 
 namespace avdecc_lib
 {
@@ -61,6 +62,13 @@ public:
     ///
     int queue_tx_frame(void * notification_id, uint32_t notification_flag, uint8_t * frame, size_t mem_buf_len);
 
+    ///
+    /// Store the frames to be sent in the queue, with as few pipe writes as possible.
+    ///
+    /// \return The number of frames queued.
+    ///
+    size_t queue_tx_frames(const struct system_tx_entry * entries, size_t count);
+
     ///
     /// Set a waiting flag for the command sent.
     ///
@@ -81,6 +89,11 @@ public:
     ///
     int STDCALL process_close();
 
+    ///
+    /// Received frames are always processed by the system thread on this platform.
+    ///
+    int STDCALL set_rx_worker_count(uint32_t worker_count);
+
 private:
     static system_layer2_multithreaded_callback * instance;
     struct epoll_priv;
@@ -108,7 +121,6 @@ private:
     int tx_pipe[2];
     // int tick_timer;
 
-    sem_t * waiting_sem;
     sem_t * shutdown_sem;
 
     // Events to process:
@@ -117,7 +129,6 @@ private:
     // Timer tick - from timer
 
     cmd_wait_mgr * wait_mgr;
-    int resp_status_for_cmd;
     int prep_evt_desc(int fd, handler_fn fn, struct epoll_priv * priv, struct epoll_event * ev);
     static int fn_timer_cb(struct kevent * priv);
     static int fn_netif_cb(struct kevent * priv);
@@ -28,21 +28,49 @@
  */
 
 #include "response_frame.h"
+#include "frame_pool.h"
+#include "descriptor_arena.h"
 #include "log_imp.h"
 #include "enumeration.h"
 #include "avdecc-lib_build.h"
 #include <stdlib.h>
 #include <iostream>
+#include <new>
 
 namespace avdecc_lib
 {
+frame_pool * frame_pool_ref = new frame_pool(); // To share descriptor frames between all end stations
 
-response_frame::response_frame(const uint8_t * frame, size_t size, size_t pos)
+response_frame::response_frame(descriptor_arena * arena, const uint8_t * frame, size_t size, size_t pos)
 {
-    desc_frame_size = size;
-    desc_position = pos;
-    desc_buffer = (uint8_t *)malloc(desc_frame_size * sizeof(uint8_t));
-    memcpy(desc_buffer, frame, desc_frame_size);
+    m_arena = arena;
+    desc_frame = frame_pool_ref->intern(frame, size, pos);
+}
+
+void * response_frame::operator new(size_t size, descriptor_arena & arena)
+{
+    void * p = arena.allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void * response_frame::operator new(size_t size)
+{
+    void * p = descriptor_arena::allocate_unowned(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void response_frame::operator delete(void * p, descriptor_arena &)
+{
+    descriptor_arena::release(p);
+}
+
+void response_frame::operator delete(void * p)
+{
+    descriptor_arena::release(p);
 }
 
 response_frame::~response_frame()
@@ -50,80 +78,59 @@ response_frame::~response_frame()
     typedef std::map<uint16_t, struct cmd_resp_frame_info *>::iterator it;
     for (it i = cmd_resp_buffers.begin(); i != cmd_resp_buffers.end(); i++)
     {
-        free(i->second->buffer);
-        delete i->second;
+        descriptor_arena::release(i->second); // The buffer follows the frame info in the same block
     }
 
-    free(desc_buffer);
+    frame_pool_ref->unreference(*desc_frame);
 }
 
 int response_frame::store_cmd_resp_frame(uint16_t cmd_type, const uint8_t *frame, size_t pos, size_t size)
 {
-    uint8_t * buffer = NULL;
     std::map<uint16_t, struct cmd_resp_frame_info * >::iterator it = cmd_resp_buffers.find(cmd_type);
     if (it != cmd_resp_buffers.end())
     {
-        free(it->second->buffer);
-        delete it->second;
+        descriptor_arena::release(it->second);
+        cmd_resp_buffers.erase(it);
     }
     
-    buffer = (uint8_t *)malloc(size * sizeof(uint8_t));
-    if (!buffer)
+    size_t block_size = sizeof(struct cmd_resp_frame_info) + size;
+    void * block = m_arena ? m_arena->allocate(block_size) : descriptor_arena::allocate_unowned(block_size);
+    if (!block)
     {
         log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Error allocating memory for response buffer");
-        free(buffer);
         return -1;
     }
     
+    uint8_t * buffer = (uint8_t *)block + sizeof(struct cmd_resp_frame_info);
     memcpy(buffer, frame, size);
-    cmd_resp_buffers[cmd_type] = new cmd_resp_frame_info(buffer, size, pos);
+    cmd_resp_buffers[cmd_type] = new (block) cmd_resp_frame_info(buffer, size, pos);
 
     return 0;
 }
 
 int response_frame::replace_desc_frame(const uint8_t * frame, size_t pos, size_t size)
 {
-    uint8_t * replaced_buffer = NULL;
+    std::shared_ptr<const shared_frame> replaced = frame_pool_ref->intern(frame, size, pos);
 
-    if (size <= desc_frame_size)
-    {
-        assert(size <= desc_frame_size);
-        memcpy(desc_buffer, frame, size);
-    }
-    else
-    {
-        replaced_buffer = (uint8_t *)realloc(desc_buffer, size * sizeof(uint8_t));
-        if (replaced_buffer != NULL)
-        {
-            desc_buffer = replaced_buffer;
-            memcpy(desc_buffer, frame, size);
-        }
-        else
-        {
-            log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "Error reallocating memory");
-            free(desc_buffer);
-            return -1;
-        }
-    }
-    desc_position = pos;
-    desc_frame_size = size;
+    frame_pool_ref->unreference(*desc_frame);
+    desc_frame = replaced;
 
     return 0;
 }
 
 uint8_t * response_frame::get_desc_buffer()
 {
-    return desc_buffer;
+    return const_cast<uint8_t *>(desc_frame->bytes.data());
 }
 
 size_t response_frame::get_desc_pos()
 {
-    return desc_position;
+    return desc_frame->position;
 }
 
 size_t response_frame::get_desc_size()
 {
-    return desc_frame_size;
+    return desc_frame->bytes.size();
 }
     
 struct cmd_resp_frame_info * response_frame::get_cmd_resp_frame_info(uint16_t cmd_type)
@@ -0,0 +1,272 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * response_views.cpp
+ *
+ * Response view implementation
+ */
+
+#include <string.h>
+#include "enumeration.h"
+#include "log_imp.h"
+#include "jdksavdecc_acmp.h"
+#include "jdksavdecc_aem_command.h"
+#include "jdksavdecc_aem_descriptor.h"
+#include "util.h"
+#include "response_views.h"
+
+namespace avdecc_lib
+{
+///
+/// Copy len bytes of frame starting at pos into dst, zero filling what is past the end of the frame.
+///
+static void copy_pdu(uint8_t * dst, size_t len, const uint8_t * frame, size_t frame_len, size_t pos)
+{
+    size_t n = (pos < frame_len) ? frame_len - pos : 0;
+    if (n > len)
+        n = len;
+    if (n)
+        memcpy(dst, &frame[pos], n);
+    memset(&dst[n], 0, len - n);
+}
+
+void STDCALL stream_input_get_rx_state_view::assign(const uint8_t * frame, size_t frame_len, size_t pos)
+{
+    copy_pdu(m_pdu, sizeof(m_pdu), frame, frame_len, pos);
+    m_valid = true;
+}
+
+uint64_t STDCALL stream_input_get_rx_state_view::get_rx_state_stream_id() const
+{
+    jdksavdecc_eui64 stream_id = jdksavdecc_common_control_header_get_stream_id(m_pdu, 0);
+    return jdksavdecc_eui64_convert_to_uint64(&stream_id);
+}
+
+uint64_t STDCALL stream_input_get_rx_state_view::get_rx_state_talker_entity_id() const
+{
+    jdksavdecc_eui64 talker_entity_id = jdksavdecc_acmpdu_get_talker_entity_id(m_pdu, 0);
+    return jdksavdecc_eui64_convert_to_uint64(&talker_entity_id);
+}
+
+uint16_t STDCALL stream_input_get_rx_state_view::get_rx_state_talker_unique_id() const
+{
+    return jdksavdecc_acmpdu_get_talker_unique_id(m_pdu, 0);
+}
+
+uint64_t STDCALL stream_input_get_rx_state_view::get_rx_state_listener_entity_id() const
+{
+    jdksavdecc_eui64 listener_entity_id = jdksavdecc_acmpdu_get_listener_entity_id(m_pdu, 0);
+    return jdksavdecc_eui64_convert_to_uint64(&listener_entity_id);
+}
+
+uint16_t STDCALL stream_input_get_rx_state_view::get_rx_state_listener_unique_id() const
+{
+    return jdksavdecc_acmpdu_get_listener_unique_id(m_pdu, 0);
+}
+
+uint64_t STDCALL stream_input_get_rx_state_view::get_rx_state_stream_dest_mac() const
+{
+    jdksavdecc_eui48 stream_dest_mac = jdksavdecc_acmpdu_get_stream_dest_mac(m_pdu, 0);
+    return jdksavdecc_eui48_convert_to_uint64(&stream_dest_mac);
+}
+
+uint16_t STDCALL stream_input_get_rx_state_view::get_rx_state_connection_count() const
+{
+    return jdksavdecc_acmpdu_get_connection_count(m_pdu, 0);
+}
+
+uint16_t STDCALL stream_input_get_rx_state_view::get_rx_state_flags() const
+{
+    return jdksavdecc_acmpdu_get_flags(m_pdu, 0);
+}
+
+uint16_t STDCALL stream_input_get_rx_state_view::get_rx_state_stream_vlan_id() const
+{
+    return jdksavdecc_acmpdu_get_stream_vlan_id(m_pdu, 0);
+}
+
+void STDCALL stream_output_get_tx_state_view::assign(const uint8_t * frame, size_t frame_len, size_t pos)
+{
+    copy_pdu(m_pdu, sizeof(m_pdu), frame, frame_len, pos);
+    m_valid = true;
+}
+
+uint64_t STDCALL stream_output_get_tx_state_view::get_tx_state_stream_id() const
+{
+    jdksavdecc_eui64 stream_id = jdksavdecc_common_control_header_get_stream_id(m_pdu, 0);
+    return jdksavdecc_eui64_convert_to_uint64(&stream_id);
+}
+
+uint64_t STDCALL stream_output_get_tx_state_view::get_tx_state_stream_dest_mac() const
+{
+    jdksavdecc_eui48 stream_dest_mac = jdksavdecc_acmpdu_get_stream_dest_mac(m_pdu, 0);
+    return jdksavdecc_eui48_convert_to_uint64(&stream_dest_mac);
+}
+
+uint16_t STDCALL stream_output_get_tx_state_view::get_tx_state_connection_count() const
+{
+    return jdksavdecc_acmpdu_get_connection_count(m_pdu, 0);
+}
+
+uint16_t STDCALL stream_output_get_tx_state_view::get_tx_state_stream_vlan_id() const
+{
+    return jdksavdecc_acmpdu_get_stream_vlan_id(m_pdu, 0);
+}
+
+void STDCALL stream_input_counters_view::assign(const uint8_t * frame, size_t frame_len, size_t pos)
+{
+    (void)pos;
+    m_counters_valid = 0;
+    memset(m_counters_block, 0, sizeof(m_counters_block));
+
+    jdksavdecc_uint32_read(&m_counters_valid, frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_OFFSET_COUNTERS_VALID,
+                           frame_len);
+    for (int i = 0; i < 32; i++)
+    {
+        int r = jdksavdecc_uint32_read(&m_counters_block[i], frame, ETHER_HDR_SIZE + JDKSAVDECC_AEM_COMMAND_GET_COUNTERS_RESPONSE_OFFSET_COUNTERS_BLOCK + 4 * i,
+                                       frame_len);
+        if (r < 0)
+            break;
+    }
+    m_valid = true;
+}
+
+uint32_t STDCALL stream_input_counters_view::get_counter_valid(int name) const
+{
+    if (name >= STREAM_INPUT_MEDIA_LOCKED && name <= STREAM_INPUT_FRAMES_TX)
+        return m_counters_valid >> (name - STREAM_INPUT_MEDIA_LOCKED) & 0x01;
+
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "counter name not found");
+    return 0;
+}
+
+uint32_t STDCALL stream_input_counters_view::get_counter_by_name(int name) const
+{
+    if (name >= STREAM_INPUT_MEDIA_LOCKED && name <= STREAM_INPUT_FRAMES_TX)
+        return m_counters_block[name - STREAM_INPUT_MEDIA_LOCKED];
+
+    log_imp_ref->post_log_msg(LOGGING_LEVEL_ERROR, "counter name not found");
+    return 0;
+}
+
+void STDCALL entity_descriptor_view::assign(const uint8_t * frame, size_t frame_len, size_t pos)
+{
+    copy_pdu(m_desc, sizeof(m_desc), frame, frame_len, pos);
+    m_valid = true;
+}
+
+uint64_t STDCALL entity_descriptor_view::entity_id() const
+{
+    return jdksavdecc_uint64_get(&m_desc[JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_ID], 0);
+}
+
+uint64_t STDCALL entity_descriptor_view::entity_model_id() const
+{
+    jdksavdecc_eui64 eui = jdksavdecc_descriptor_entity_get_entity_model_id(m_desc, 0);
+    return jdksavdecc_eui64_convert_to_uint64(&eui);
+}
+
+uint32_t STDCALL entity_descriptor_view::entity_capabilities() const
+{
+    return jdksavdecc_descriptor_entity_get_entity_capabilities(m_desc, 0);
+}
+
+uint16_t STDCALL entity_descriptor_view::talker_stream_sources() const
+{
+    return jdksavdecc_descriptor_entity_get_talker_stream_sources(m_desc, 0);
+}
+
+uint16_t STDCALL entity_descriptor_view::talker_capabilities() const
+{
+    return jdksavdecc_descriptor_entity_get_talker_capabilities(m_desc, 0);
+}
+
+uint16_t STDCALL entity_descriptor_view::listener_stream_sinks() const
+{
+    return jdksavdecc_descriptor_entity_get_listener_stream_sinks(m_desc, 0);
+}
+
+uint16_t STDCALL entity_descriptor_view::listener_capabilities() const
+{
+    return jdksavdecc_descriptor_entity_get_listener_capabilities(m_desc, 0);
+}
+
+uint32_t STDCALL entity_descriptor_view::controller_capabilities() const
+{
+    return jdksavdecc_descriptor_entity_get_controller_capabilities(m_desc, 0);
+}
+
+uint32_t STDCALL entity_descriptor_view::available_index() const
+{
+    return jdksavdecc_descriptor_entity_get_available_index(m_desc, 0);
+}
+
+uint64_t STDCALL entity_descriptor_view::association_id() const
+{
+    uint64_t association_id;
+
+    utility::convert_eui48_to_uint64(&m_desc[JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ASSOCIATION_ID], association_id);
+    return association_id;
+}
+
+const uint8_t * STDCALL entity_descriptor_view::entity_name() const
+{
+    return &m_desc[JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_ENTITY_NAME];
+}
+
+uint16_t STDCALL entity_descriptor_view::vendor_name_string() const
+{
+    return jdksavdecc_descriptor_entity_get_vendor_name_string(m_desc, 0);
+}
+
+uint16_t STDCALL entity_descriptor_view::model_name_string() const
+{
+    return jdksavdecc_descriptor_entity_get_model_name_string(m_desc, 0);
+}
+
+const uint8_t * STDCALL entity_descriptor_view::firmware_version() const
+{
+    return &m_desc[JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_FIRMWARE_VERSION];
+}
+
+const uint8_t * STDCALL entity_descriptor_view::group_name() const
+{
+    return &m_desc[JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_GROUP_NAME];
+}
+
+const uint8_t * STDCALL entity_descriptor_view::serial_number() const
+{
+    return &m_desc[JDKSAVDECC_DESCRIPTOR_ENTITY_OFFSET_SERIAL_NUMBER];
+}
+
+uint16_t STDCALL entity_descriptor_view::configurations_count() const
+{
+    return jdksavdecc_descriptor_entity_get_configurations_count(m_desc, 0);
+}
+
+uint16_t STDCALL entity_descriptor_view::current_configuration() const
+{
+    return jdksavdecc_descriptor_entity_get_current_configuration(m_desc, 0);
+}
+}
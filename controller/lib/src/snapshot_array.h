@@ -0,0 +1,114 @@
+/*
+ * Licensed under the MIT License (MIT)
+ *
+ * Copyright (c) 2017 AudioScience Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * snapshot_array.h
+ *
+ * Append-only array with lock-free reads
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <stdexcept>
+
+namespace avdecc_lib
+{
+///
+/// Array that one writer at a time appends to while any number of readers access it without locking.
+///
+/// Elements are stored in fixed size chunks that are never moved or freed while the array exists,
+/// so an element never changes once appended. The number of elements is published after the element
+/// is written, and a reader that loads it sees an immutable snapshot of every element before it.
+///
+template <class T, size_t CHUNK_SIZE = 256, size_t MAX_CHUNKS = 1024>
+class snapshot_array
+{
+private:
+    std::atomic<T *> chunks[MAX_CHUNKS];
+    std::atomic<size_t> count;
+
+public:
+    snapshot_array() : count(0)
+    {
+        for (size_t i = 0; i < MAX_CHUNKS; i++)
+            chunks[i].store(NULL, std::memory_order_relaxed);
+    }
+
+    ~snapshot_array()
+    {
+        for (size_t i = 0; i < MAX_CHUNKS; i++)
+            delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+
+    ///
+    /// \return The number of elements in the current snapshot.
+    ///
+    inline size_t size() const
+    {
+        return count.load(std::memory_order_acquire);
+    }
+
+    ///
+    /// \return The element at index i, which must be less than a size() already read.
+    ///
+    inline const T & operator[](size_t i) const
+    {
+        return chunks[i / CHUNK_SIZE].load(std::memory_order_relaxed)[i % CHUNK_SIZE];
+    }
+
+    ///
+    /// \return The element at index i, throwing std::out_of_range if it is not in the current snapshot.
+    ///
+    inline const T & at(size_t i) const
+    {
+        if (i >= size())
+            throw std::out_of_range("snapshot_array::at");
+        return (*this)[i];
+    }
+
+    ///
+    /// Append an element and publish it to readers. Calls must be serialized by the caller.
+    ///
+    void push_back(const T & value)
+    {
+        size_t n = count.load(std::memory_order_relaxed);
+        size_t chunk = n / CHUNK_SIZE;
+
+        if (chunk >= MAX_CHUNKS)
+            throw std::length_error("snapshot_array::push_back");
+
+        T * c = chunks[chunk].load(std::memory_order_relaxed);
+        if (!c)
+        {
+            c = new T[CHUNK_SIZE];
+            chunks[chunk].store(c, std::memory_order_relaxed);
+        }
+
+        c[n % CHUNK_SIZE] = value;
+        count.store(n + 1, std::memory_order_release);
+    }
+};
+}
@@ -30,18 +30,14 @@
 #pragma once
 
 #include "stream_input_counters_response.h"
-#include "descriptor_base_imp.h"
+#include "response_views.h"
 
 namespace avdecc_lib
 {
 class stream_input_counters_response_imp : public stream_input_counters_response
 {
 private:
-    uint32_t m_counters_valid;
-    uint32_t m_counters_block[32];
-    uint8_t * m_frame;
-    size_t m_size;
-    ssize_t m_position;
+    stream_input_counters_view m_view;
 
 public:
     stream_input_counters_response_imp(const uint8_t * frame, size_t frame_len, ssize_t pos);
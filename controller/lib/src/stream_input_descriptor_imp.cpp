@@ -98,6 +98,28 @@ stream_input_get_rx_state_response * STDCALL stream_input_descriptor_imp::get_st
                                                                           resp_frame->frame_size, resp_frame->position);
 }
 
+bool STDCALL stream_input_descriptor_imp::get_rx_state_view(stream_input_get_rx_state_view & view)
+{
+    std::lock_guard<std::mutex> guard(base_end_station_imp_ref->locker); //mutex lock end station
+    struct cmd_resp_frame_info * resp_frame = resp_ref->get_cmd_resp_frame_info(GET_RX_STATE_RESPONSE);
+    if (!resp_frame)
+        return false;
+
+    view.assign(resp_frame->buffer, resp_frame->frame_size, resp_frame->position);
+    return true;
+}
+
+bool STDCALL stream_input_descriptor_imp::get_counters_view(stream_input_counters_view & view)
+{
+    std::lock_guard<std::mutex> guard(base_end_station_imp_ref->locker); //mutex lock end station
+    struct cmd_resp_frame_info * resp_frame = resp_ref->get_cmd_resp_frame_info(AEM_CMD_GET_COUNTERS);
+    if (!resp_frame)
+        return false;
+
+    view.assign(resp_frame->buffer, resp_frame->frame_size, resp_frame->position);
+    return true;
+}
+
 int STDCALL stream_input_descriptor_imp::send_set_stream_format_cmd(void * notification_id, uint64_t new_stream_format)
 {
     struct jdksavdecc_frame cmd_frame;
@@ -499,11 +521,12 @@ int stream_input_descriptor_imp::proc_stop_streaming_resp(void *& notification_i
 
 int STDCALL stream_input_descriptor_imp::send_connect_rx_cmd(void * notification_id, uint64_t talker_entity_id, uint16_t talker_unique_id, uint16_t flags)
 {
-    entity_descriptor_response * entity_resp_ref = base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_response();
+    entity_descriptor_view entity_view;
+    base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_view(entity_view);
     struct jdksavdecc_frame cmd_frame;
     struct jdksavdecc_acmpdu acmp_cmd_connect_rx;
     ssize_t acmp_cmd_connect_rx_returned;
-    uint64_t listener_entity_id = entity_resp_ref->entity_id();
+    uint64_t listener_entity_id = entity_view.entity_id();
 
     /****************************************** ACMP Common Data *****************************************/
     acmp_cmd_connect_rx.controller_entity_id = base_end_station_imp_ref->get_adp()->get_controller_entity_id();
@@ -534,7 +557,6 @@ int STDCALL stream_input_descriptor_imp::send_connect_rx_cmd(void * notification
     acmp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_ACMP_MESSAGE_TYPE_CONNECT_RX_COMMAND, &cmd_frame);
     system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
 
-    delete entity_resp_ref;
     return 0;
 }
 
@@ -565,11 +587,12 @@ int stream_input_descriptor_imp::proc_connect_rx_resp(void *& notification_id, c
 
 int STDCALL stream_input_descriptor_imp::send_disconnect_rx_cmd(void * notification_id, uint64_t talker_entity_id, uint16_t talker_unique_id)
 {
-    entity_descriptor_response * entity_resp_ref = base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_response();
+    entity_descriptor_view entity_view;
+    base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_view(entity_view);
     struct jdksavdecc_frame cmd_frame;
     struct jdksavdecc_acmpdu acmp_cmd_disconnect_rx;
     ssize_t acmp_cmd_disconnect_rx_returned;
-    uint64_t listener_entity_id = entity_resp_ref->entity_id();
+    uint64_t listener_entity_id = entity_view.entity_id();
 
     /******************************************* ACMP Common Data *******************************************/
     acmp_cmd_disconnect_rx.controller_entity_id = base_end_station_imp_ref->get_adp()->get_controller_entity_id();
@@ -600,7 +623,6 @@ int STDCALL stream_input_descriptor_imp::send_disconnect_rx_cmd(void * notificat
     acmp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_RX_COMMAND, &cmd_frame);
     system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
 
-    delete entity_resp_ref;
     return 0;
 }
 
@@ -631,11 +653,12 @@ int stream_input_descriptor_imp::proc_disconnect_rx_resp(void *& notification_id
 
 int STDCALL stream_input_descriptor_imp::send_get_rx_state_cmd(void * notification_id)
 {
-    entity_descriptor_response * entity_resp_ref = base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_response();
+    entity_descriptor_view entity_view;
+    base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_view(entity_view);
     struct jdksavdecc_frame cmd_frame;
     struct jdksavdecc_acmpdu acmp_cmd_get_rx_state;
     ssize_t acmp_cmd_get_rx_state_returned;
-    uint64_t listener_entity_id = entity_resp_ref->entity_id();
+    uint64_t listener_entity_id = entity_view.entity_id();
 
     /******************************************* ACMP Common Data ******************************************/
     acmp_cmd_get_rx_state.controller_entity_id = base_end_station_imp_ref->get_adp()->get_controller_entity_id();
@@ -666,7 +689,6 @@ int STDCALL stream_input_descriptor_imp::send_get_rx_state_cmd(void * notificati
     acmp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_RX_STATE_COMMAND, &cmd_frame);
     system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
 
-    delete entity_resp_ref;
     return 0;
 }
 
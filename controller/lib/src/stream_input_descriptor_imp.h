@@ -60,6 +60,8 @@ public:
     stream_input_get_stream_format_response * STDCALL get_stream_input_get_stream_format_response();
     stream_input_get_stream_info_response * STDCALL get_stream_input_get_stream_info_response();
     stream_input_get_rx_state_response * STDCALL get_stream_input_get_rx_state_response();
+    bool STDCALL get_rx_state_view(stream_input_get_rx_state_view & view);
+    bool STDCALL get_counters_view(stream_input_counters_view & view);
 
     int STDCALL send_set_stream_format_cmd(void * notification_id, uint64_t new_stream_format);
     int proc_set_stream_format_resp(void *& notification_id, const uint8_t * frame, size_t frame_len, int & status);
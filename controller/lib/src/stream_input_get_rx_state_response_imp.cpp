@@ -36,68 +36,53 @@ namespace avdecc_lib
 {
 stream_input_get_rx_state_response_imp::stream_input_get_rx_state_response_imp(uint8_t * frame, size_t frame_len, ssize_t pos)
 {
-    m_position = pos;
-    m_size = frame_len;
-    m_frame = (uint8_t *)malloc(m_size * sizeof(uint8_t));
-    memcpy(m_frame, frame, m_size);
+    m_view.assign(frame, frame_len, pos);
 }
 
-stream_input_get_rx_state_response_imp::~stream_input_get_rx_state_response_imp()
-{
-    free(m_frame);
-}
+stream_input_get_rx_state_response_imp::~stream_input_get_rx_state_response_imp() {}
 
 uint64_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_stream_id()
 {
-    jdksavdecc_eui64 stream_id;
-    stream_id = jdksavdecc_common_control_header_get_stream_id(m_frame, m_position);
-    return jdksavdecc_eui64_convert_to_uint64(&stream_id);
+    return m_view.get_rx_state_stream_id();
 }
-    
+
 uint64_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_talker_entity_id()
 {
-    jdksavdecc_eui64 talker_entity_id;
-    talker_entity_id = jdksavdecc_acmpdu_get_talker_entity_id(m_frame, m_position);
-    return jdksavdecc_eui64_convert_to_uint64(&talker_entity_id);
+    return m_view.get_rx_state_talker_entity_id();
 }
 
 uint16_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_talker_unique_id()
 {
-    return jdksavdecc_acmpdu_get_talker_unique_id(m_frame, m_position);
+    return m_view.get_rx_state_talker_unique_id();
 }
-    
+
 uint64_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_listener_entity_id()
 {
-    jdksavdecc_eui64 listener_entity_id;
-    listener_entity_id = jdksavdecc_acmpdu_get_listener_entity_id(m_frame, m_position);
-    return jdksavdecc_eui64_convert_to_uint64(&listener_entity_id);
+    return m_view.get_rx_state_listener_entity_id();
 }
 
 uint16_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_listener_unique_id()
 {
-    return jdksavdecc_acmpdu_get_listener_unique_id(m_frame, m_position);
+    return m_view.get_rx_state_listener_unique_id();
 }
 
 uint64_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_stream_dest_mac()
 {
-    jdksavdecc_eui48 stream_dest_mac;
-    stream_dest_mac = jdksavdecc_acmpdu_get_stream_dest_mac(m_frame, m_position);
-
-    return jdksavdecc_eui48_convert_to_uint64(&stream_dest_mac);
+    return m_view.get_rx_state_stream_dest_mac();
 }
 
 uint16_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_connection_count()
 {
-    return jdksavdecc_acmpdu_get_connection_count(m_frame, m_position);
+    return m_view.get_rx_state_connection_count();
 }
 
 uint16_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_flags()
 {
-    return jdksavdecc_acmpdu_get_flags(m_frame, m_position);
+    return m_view.get_rx_state_flags();
 }
 
 uint16_t STDCALL stream_input_get_rx_state_response_imp::get_rx_state_stream_vlan_id()
 {
-    return jdksavdecc_acmpdu_get_stream_vlan_id(m_frame, m_position);
+    return m_view.get_rx_state_stream_vlan_id();
 }
 }
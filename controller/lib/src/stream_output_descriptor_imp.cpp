@@ -90,6 +90,17 @@ stream_output_get_tx_state_response * STDCALL stream_output_descriptor_imp::get_
                                                                            resp_frame->frame_size, resp_frame->position);
 }
 
+bool STDCALL stream_output_descriptor_imp::get_tx_state_view(stream_output_get_tx_state_view & view)
+{
+    std::lock_guard<std::mutex> guard(base_end_station_imp_ref->locker); //mutex lock end station
+    struct cmd_resp_frame_info * resp_frame = resp_ref->get_cmd_resp_frame_info(GET_TX_STATE_RESPONSE);
+    if (!resp_frame)
+        return false;
+
+    view.assign(resp_frame->buffer, resp_frame->frame_size, resp_frame->position);
+    return true;
+}
+
 stream_output_get_tx_connection_response * STDCALL stream_output_descriptor_imp::get_stream_output_get_tx_connection_response()
 {
     std::lock_guard<std::mutex> guard(base_end_station_imp_ref->locker); //mutex lock end station
@@ -458,11 +469,12 @@ int stream_output_descriptor_imp::proc_get_stream_info_resp(void *& notification
     
 int STDCALL stream_output_descriptor_imp::send_disconnect_tx_cmd(void * notification_id, uint64_t listener_entity_id, uint16_t listener_unique_id)
 {
-    entity_descriptor_response * entity_resp_ref = base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_response();
+    entity_descriptor_view entity_view;
+    base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_view(entity_view);
     struct jdksavdecc_frame cmd_frame;
     struct jdksavdecc_acmpdu acmp_cmd_disconnect_tx;
     ssize_t acmp_cmd_disconnect_tx_returned;
-    uint64_t talker_entity_id = entity_resp_ref->entity_id();
+    uint64_t talker_entity_id = entity_view.entity_id();
     
     /******************************************* ACMP Common Data *******************************************/
     acmp_cmd_disconnect_tx.controller_entity_id = base_end_station_imp_ref->get_adp()->get_controller_entity_id();
@@ -493,7 +505,6 @@ int STDCALL stream_output_descriptor_imp::send_disconnect_tx_cmd(void * notifica
     acmp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_ACMP_MESSAGE_TYPE_DISCONNECT_TX_COMMAND, &cmd_frame);
     system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
     
-    delete entity_resp_ref;
     return 0;
 }
 
@@ -669,11 +680,12 @@ int stream_output_descriptor_imp::proc_stop_streaming_resp(void *& notification_
 
 int STDCALL stream_output_descriptor_imp::send_get_tx_state_cmd(void * notification_id)
 {
-    entity_descriptor_response * entity_resp_ref = base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_response();
+    entity_descriptor_view entity_view;
+    base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_view(entity_view);
     struct jdksavdecc_frame cmd_frame;
     struct jdksavdecc_acmpdu acmp_cmd_get_tx_state;
     ssize_t acmp_cmd_get_tx_state_returned;
-    uint64_t talker_entity_id = entity_resp_ref->entity_id();
+    uint64_t talker_entity_id = entity_view.entity_id();
 
     /******************************************* ACMP Common Data ******************************************/
     acmp_cmd_get_tx_state.controller_entity_id = base_end_station_imp_ref->get_adp()->get_controller_entity_id();
@@ -704,7 +716,6 @@ int STDCALL stream_output_descriptor_imp::send_get_tx_state_cmd(void * notificat
     acmp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_STATE_COMMAND, &cmd_frame);
     system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
 
-    delete entity_resp_ref;
     return 0;
 }
 
@@ -738,11 +749,12 @@ int stream_output_descriptor_imp::proc_get_tx_state_resp(void *& notification_id
 
 int STDCALL stream_output_descriptor_imp::send_get_tx_connection_cmd(void * notification_id, uint16_t connection_index)
 {
-    entity_descriptor_response * entity_resp_ref = base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_response();
+    entity_descriptor_view entity_view;
+    base_end_station_imp_ref->get_entity_desc_by_index(0)->get_entity_view(entity_view);
     struct jdksavdecc_frame cmd_frame;
     struct jdksavdecc_acmpdu acmp_cmd_get_tx_connection;
     ssize_t acmp_cmd_get_tx_connection_returned;
-    uint64_t talker_entity_id = entity_resp_ref->entity_id();
+    uint64_t talker_entity_id = entity_view.entity_id();
 
     /********************************************* ACMP Common Data *********************************************/
     acmp_cmd_get_tx_connection.controller_entity_id = base_end_station_imp_ref->get_adp()->get_controller_entity_id();
@@ -773,7 +785,6 @@ int STDCALL stream_output_descriptor_imp::send_get_tx_connection_cmd(void * noti
     acmp_controller_state_machine_ref->common_hdr_init(JDKSAVDECC_ACMP_MESSAGE_TYPE_GET_TX_CONNECTION_COMMAND, &cmd_frame);
     system_queue_tx(notification_id, CMD_WITH_NOTIFICATION, cmd_frame.payload, cmd_frame.length);
 
-    delete entity_resp_ref;
     return 0;
 }
 
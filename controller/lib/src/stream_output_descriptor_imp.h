@@ -64,6 +64,7 @@ public:
     stream_output_get_stream_format_response * STDCALL get_stream_output_get_stream_format_response();
     stream_output_get_stream_info_response * STDCALL get_stream_output_get_stream_info_response();
     stream_output_get_tx_state_response * STDCALL get_stream_output_get_tx_state_response();
+    bool STDCALL get_tx_state_view(stream_output_get_tx_state_view & view);
     stream_output_get_tx_connection_response * STDCALL get_stream_output_get_tx_connection_response();
 
     int STDCALL send_set_stream_format_cmd(void * notification_id, uint64_t new_stream_format);
@@ -30,16 +30,14 @@
 #pragma once
 
 #include "stream_output_get_tx_state_response.h"
-#include "jdksavdecc_acmp.h"
+#include "response_views.h"
 
 namespace avdecc_lib
 {
 class stream_output_get_tx_state_response_imp : public stream_output_get_tx_state_response
 {
 private:
-    uint8_t * m_frame;
-    size_t m_size;
-    ssize_t m_position;
+    stream_output_get_tx_state_view m_view;
 
 public:
     stream_output_get_tx_state_response_imp(uint8_t * frame, size_t frame_len, ssize_t pos);
@@ -31,6 +31,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 namespace avdecc_lib
 {
@@ -38,4 +39,23 @@ namespace avdecc_lib
 /// Store command in a queue to be transmitted.
 ///
 size_t system_queue_tx(void * notification_id, uint32_t notification_flag, uint8_t * frame, size_t frame_len);
+
+///
+/// A command to be transmitted by system_queue_tx_batch().
+///
+struct system_tx_entry
+{
+    void * notification_id;
+    uint32_t notification_flag;
+    const uint8_t * frame;
+    size_t frame_len;
+};
+
+///
+/// Store commands in the queue to be transmitted in one operation, waking the system thread once.
+/// The calling thread never waits for the completion of the commands.
+///
+/// \return The number of commands queued.
+///
+size_t system_queue_tx_batch(const struct system_tx_entry * entries, size_t count);
 }
@@ -99,6 +99,38 @@ uint32_t timer::clk_convert_to_ms(avdecc_lib_os::aTimestamp time_stamp)
 }
 #endif
 
+#ifdef WIN32
+uint64_t timer::clk_monotonic_ms(void)
+{
+    LARGE_INTEGER count;
+    LARGE_INTEGER freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+
+    return (uint64_t)(count.QuadPart / freq.QuadPart) * 1000 +
+           (uint64_t)(count.QuadPart % freq.QuadPart) * 1000 / freq.QuadPart;
+}
+#elif defined __linux__
+uint64_t timer::clk_monotonic_ms(void)
+{
+    struct timespec tp;
+
+    clock_gettime(CLOCK_MONOTONIC, &tp);
+    return (uint64_t)tp.tv_sec * 1000 + (uint64_t)(tp.tv_nsec / 1000000);
+}
+#elif defined __MACH__
+uint64_t timer::clk_monotonic_ms(void)
+{
+    clock_serv_t cclock;
+    mach_timespec_t mts;
+    host_get_clock_service(mach_host_self(), SYSTEM_CLOCK, &cclock);
+    clock_get_time(cclock, &mts);
+    mach_port_deallocate(mach_task_self(), cclock);
+
+    return (uint64_t)mts.tv_sec * 1000 + (uint64_t)(mts.tv_nsec / 1000000);
+}
+#endif
+
 void timer::start(int duration_ms)
 {
     running = true;
@@ -57,5 +57,10 @@ public:
     void stop();
 
     bool timeout();
+
+    ///
+    /// \return A monotonic time in milliseconds that does not wrap, used for absolute deadlines.
+    ///
+    static uint64_t clk_monotonic_ms(void);
 };
 }